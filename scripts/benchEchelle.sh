@@ -0,0 +1,68 @@
+#!/bin/sh
+#
+# Essai de mise à l'échelle: génère des flux GTFS synthétiques de tailles croissantes avec genererGTFS, puis mesure
+# avec benchItineraires le temps de chargement, le temps de construction du graphe, la mémoire et la latence des
+# requêtes. Les résultats sont écrits en CSV; un graphique est aussi produit si gnuplot est disponible.
+#
+# Usage: scripts/benchEchelle.sh [dossier_de_travail] [facteurs...]
+#   Les exécutables genererGTFS et benchItineraires sont cherchés à la racine du projet (sortie de CMake).
+#   Chaque facteur multiplie le nombre de lignes et de stations du flux de base (30 lignes, 900 stations); la densité
+#   de stations et le nombre de voyages par ligne restent constants. Facteurs par défaut: 1 2 5 10 20 50.
+#   Variables d'environnement: REQUETES (défaut 500), VOYAGES (voyages par ligne, défaut 60), GRAINE (défaut 1).
+#
+
+set -e
+
+RACINE=$(cd "$(dirname "$0")/.." && pwd)
+TRAVAIL=${1:-/tmp/rtc-echelle}
+[ $# -gt 0 ] && shift
+FACTEURS=${*:-1 2 5 10 20 50}
+REQUETES=${REQUETES:-500}
+VOYAGES=${VOYAGES:-60}
+GRAINE=${GRAINE:-1}
+
+mkdir -p "$TRAVAIL"
+CSV="$TRAVAIL/echelle.csv"
+
+# valeur numérique d'une clé de premier niveau ou d'un champ d'une distribution (ex.: champ latence_us p50)
+champ() {
+    sed -n "s/.*\"$1\": {.*\"$2\": \([0-9.]*\).*/\1/p" "$3"
+}
+valeur() {
+    sed -n "s/.*\"$1\": \([0-9.]*\),*$/\1/p" "$2"
+}
+
+echo "facteur,lignes,stations,arrets,arcs,chargement_ms,construction_ms,rss_max_ko,latence_p50_us,latence_p90_us,latence_p99_us,requetes_par_seconde" > "$CSV"
+for f in $FACTEURS; do
+    lignes=$((30 * f))
+    stations=$((900 * f))
+    flux="$TRAVAIL/flux_x$f"
+    "$RACINE/genererGTFS" "$flux" --lignes $lignes --stations $stations --voyages $VOYAGES --graine $GRAINE > /dev/null
+    json="$TRAVAIL/bench_x$f.json"
+    "$RACINE/benchItineraires" "$flux" $REQUETES > "$json"
+    echo "$f,$lignes,$stations,$(valeur arrets "$json"),$(valeur arcs "$json"),$(valeur chargement_ms "$json"),$(valeur construction_ms "$json"),$(valeur rss_max_ko "$json"),$(champ latence_us p50 "$json"),$(champ latence_us p90 "$json"),$(champ latence_us p99 "$json"),$(valeur requetes_par_seconde "$json")" >> "$CSV"
+    tail -n 1 "$CSV"
+done
+
+if command -v gnuplot > /dev/null 2>&1; then
+    gnuplot <<GNUPLOT
+set terminal png size 1200,900
+set output "$TRAVAIL/echelle.png"
+set datafile separator ","
+set key autotitle columnhead left top
+set logscale xy
+set xlabel "arrêts dans la fenêtre"
+set multiplot layout 2,2
+set ylabel "ms"
+plot "$CSV" using 4:6 with linespoints title "chargement", "" using 4:7 with linespoints title "construction du graphe"
+set ylabel "Ko"
+plot "$CSV" using 4:8 with linespoints title "mémoire résidente maximale"
+set ylabel "microsecondes"
+plot "$CSV" using 4:9 with linespoints title "latence p50", "" using 4:11 with linespoints title "latence p99"
+set ylabel "requêtes/s"
+plot "$CSV" using 4:12 with linespoints title "débit"
+unset multiplot
+GNUPLOT
+    echo "Graphique: $TRAVAIL/echelle.png"
+fi
+echo "Résultats: $CSV"
@@ -4,6 +4,7 @@
 //
 
 #include "DonneesGTFS.h"
+#include <cstdint>
 
 using namespace std;
 
@@ -13,27 +14,14 @@ using namespace std;
 //! \param[in] p_now2: l'heure de fin de l'intervalle considéré
 //! \brief Ces deux heures définissent l'intervalle de temps du GTFS; seuls les moments de [p_now1, p_now2) sont considérés
 DonneesGTFS::DonneesGTFS(const Date &p_date, const Heure &p_now1, const Heure &p_now2)
-        : m_date(p_date), m_now1(p_now1), m_now2(p_now2), m_nbArrets(0), m_tousLesArretsPresents(false)
+        : m_date(p_date), m_now1(p_now1), m_now2(p_now2), m_nbArrets(0), m_tousLesArretsPresents(false),
+          m_arena(std::make_shared<ArenaMemoire>()), m_rayonTrajetsAPied(0), m_versionTransferts(0),
+          m_fenetreGlissante(false),
+          m_prochainArretAVenir(0), m_multiJours(false), m_premiereDate(p_date), m_derniereDate(p_date),
+          m_instrumentation(nullptr)
 {
 }
 
-//! \brief partitionne un string en un vecteur de strings
-//! \param[in] s: le string à être partitionner
-//! \param[in] delim: le caractère utilisé pour le partitionnement
-//! \return le vecteur de string sans le caractère utilisé pour le partitionnement
-vector<string> DonneesGTFS::string_to_vector(const string &s, char delim)
-{
-    stringstream ss(s);
-    string item;
-    vector<string> elems;
-    while (getline(ss, item, delim))
-    {
-        elems.push_back(item);
-    }
-    return elems;
-}
-
-
 unsigned int DonneesGTFS::getNbArrets() const
 {
     return m_nbArrets;
@@ -72,7 +60,7 @@ void DonneesGTFS::afficherLignes() const
     std::cout << "======================" << std::endl;
     for (const auto & ligneM : m_lignes_par_numero)
     {
-        cout << ligneM.second;
+        cout << m_lignes.at(ligneM.second);
     }
     std::cout << std::endl;
 }
@@ -197,6 +185,33 @@ const std::vector<std::tuple<unsigned int, unsigned int, unsigned int> > &Donnee
     return m_transferts;
 }
 
+const std::vector<TrajetAPied> &DonneesGTFS::getTrajetsAPied() const
+{
+    return m_trajetsAPied;
+}
+
+//! \brief retourne un numéro qui change chaque fois que m_transferts ou m_trajetsAPied sont recalculés, afin qu'un
+//! réseau construit avec cet objet puisse savoir si ses transferts sont encore à jour
+unsigned int DonneesGTFS::getVersionTransferts() const
+{
+    return m_versionTransferts;
+}
+
+Date DonneesGTFS::getDate() const
+{
+    return m_date;
+}
+
+Date DonneesGTFS::getPremiereDate() const
+{
+    return m_premiereDate;
+}
+
+Date DonneesGTFS::getDerniereDate() const
+{
+    return m_derniereDate;
+}
+
 Heure DonneesGTFS::getTempsFin() const
 {
     return m_now2;
@@ -214,3 +229,132 @@ const std::unordered_map<unsigned int, Ligne> &DonneesGTFS::getLignes() const
 
 
 
+
+//! \brief instrumente les phases de chargement et de mise à jour de cet objet
+//! \param[in] p_instrumentation: l'objet qui reçoit les mesures (nullptr pour cesser de mesurer); il doit survivre
+//! à cet objet. Un ReseauGTFS construit à partir de cet objet reprend la même instrumentation.
+void DonneesGTFS::setInstrumentation(Instrumentation *p_instrumentation)
+{
+    m_instrumentation = p_instrumentation;
+}
+
+Instrumentation *DonneesGTFS::getInstrumentation() const
+{
+    return m_instrumentation;
+}
+
+//! \brief retourne l'arène des arrêts; un objet qui conserve des arrêts au-delà de la vie de cet objet doit en garder une
+//! copie (voir ReseauGTFS)
+const std::shared_ptr<ArenaMemoire> &DonneesGTFS::getArena() const
+{
+    return m_arena;
+}
+
+//! \brief ajoute au bilan la mémoire estimée des données chargées, par composante: lignes, stations, arrêts des
+//! stations, voyages, arrêts des voyages, arrêts (objets partagés), services, transferts, horaire complet (multi-jours
+//! et fenêtre glissante) et arrêts à venir (fenêtre glissante)
+//! \param[in,out] p_bilan: le bilan à compléter
+void DonneesGTFS::comptabiliserMemoire(BilanMemoire &p_bilan) const
+{
+    BilanMemoire::Composante &lignes = p_bilan.composante("lignes");
+    lignes.nbElements += m_lignes.size();
+    lignes.ajouterTableHachage(m_lignes.size(), sizeof(std::pair<const unsigned int, Ligne>), m_lignes.bucket_count(),
+                               false);
+    lignes.ajouterNoeudsArbre(m_lignes_par_numero.size(), sizeof(std::pair<const std::string, unsigned int>));
+    for (const auto &ligne : m_lignes)
+    {
+        lignes.ajouterChaine(ligne.second.getNumero().size());
+        lignes.ajouterChaine(ligne.second.getDescription().capacity());
+    }
+    for (const auto &ligne : m_lignes_par_numero)
+    {
+        lignes.ajouterChaine(ligne.first.capacity());
+    }
+
+    BilanMemoire::Composante &stations = p_bilan.composante("stations");
+    BilanMemoire::Composante &arretsDesStations = p_bilan.composante("stations.arrets");
+    for (const std::map<unsigned int, Station> *lesStations : {&m_stations, &m_toutesLesStations})
+    {
+        stations.nbElements += lesStations->size();
+        stations.ajouterNoeudsArbre(lesStations->size(), sizeof(std::pair<const unsigned int, Station>));
+        for (const auto &station : *lesStations)
+        {
+            stations.ajouterChaine(station.second.getNom().capacity());
+            stations.ajouterChaine(station.second.getDescription().capacity());
+            arretsDesStations.nbElements += station.second.getArrets().size();
+            arretsDesStations.ajouterNoeudsArbre(station.second.getArrets().size(),
+                                                 sizeof(std::pair<const Heure, Arret::Ptr>),
+                                                 station.second.getArrets().get_allocator().getArena() != nullptr);
+        }
+    }
+
+    // chaque arrêt appartient à exactement un voyage: on dénombre la population des arrêts par les voyages
+    BilanMemoire::Composante &voyages = p_bilan.composante("voyages");
+    BilanMemoire::Composante &arretsDesVoyages = p_bilan.composante("voyages.arrets");
+    BilanMemoire::Composante &arrets = p_bilan.composante("arrets");
+    voyages.nbElements += m_voyages.size();
+    voyages.ajouterNoeudsArbre(m_voyages.size(), sizeof(std::pair<const std::string, Voyage>));
+    for (const auto &voyage : m_voyages)
+    {
+        voyages.ajouterChaine(voyage.first.capacity());
+        voyages.ajouterChaine(voyage.second.getId().size());
+        voyages.ajouterChaine(voyage.second.getServiceId().size());
+        voyages.ajouterChaine(voyage.second.getDestination().capacity());
+        const size_t nbArrets = voyage.second.getArrets().size();
+        arretsDesVoyages.nbElements += nbArrets;
+        arretsDesVoyages.ajouterNoeudsArbre(nbArrets, sizeof(Arret::Ptr),
+                                            voyage.second.getArrets().get_allocator().getArena() != nullptr);
+        arrets.nbElements += nbArrets;
+        arrets.ajouterBlocs(nbArrets, sizeof(Arret), BilanMemoire::blocControlePartageArena, true); // allocate_shared()
+        for (const auto &arret : voyage.second.getArrets())
+            arrets.ajouterChaine(arret->getVoyageId().size());
+    }
+
+    if (m_arena) p_bilan.ajouterArena("arrets", *m_arena);
+
+    BilanMemoire::Composante &services = p_bilan.composante("services");
+    services.nbElements += m_indexServices.size();
+    services.ajouterTableHachage(m_services.size(), sizeof(std::string), m_services.bucket_count(), true);
+    for (const auto &service : m_services) services.ajouterChaine(service.capacity());
+    services.ajouterTableHachage(m_indexServices.size(), sizeof(std::pair<const std::string, unsigned int>),
+                                 m_indexServices.bucket_count(), true);
+    for (const auto &service : m_indexServices) services.ajouterChaine(service.first.capacity());
+    services.ajouterTableau(m_joursDeService.size(), m_joursDeService.capacity(), sizeof(std::vector<bool>));
+    for (const auto &jours : m_joursDeService) // un vector<bool> réserve des mots de 64 bits
+        services.ajouterTableau((jours.size() + 63) / 64, (jours.capacity() + 63) / 64, sizeof(uint64_t));
+
+    BilanMemoire::Composante &transferts = p_bilan.composante("transferts");
+    typedef std::tuple<unsigned int, unsigned int, unsigned int> Transfert;
+    transferts.nbElements += m_transferts.size();
+    transferts.ajouterTableau(m_transferts.size(), m_transferts.capacity(), sizeof(Transfert));
+    transferts.ajouterTableau(m_tousLesTransferts.size(), m_tousLesTransferts.capacity(), sizeof(Transfert));
+    transferts.ajouterNoeudsArbre(m_stationsDeTransfert.size(), sizeof(unsigned int));
+
+    BilanMemoire::Composante &trajetsAPied = p_bilan.composante("trajets_a_pied");
+    trajetsAPied.nbElements += m_trajetsAPied.size();
+    trajetsAPied.ajouterTableau(m_trajetsAPied.size(), m_trajetsAPied.capacity(), sizeof(TrajetAPied));
+
+    BilanMemoire::Composante &horaire = p_bilan.composante("horaire");
+    horaire.nbElements += m_horaire.size();
+    horaire.ajouterNoeudsArbre(m_horaire.size(), sizeof(std::pair<const std::string, VoyageHoraire>));
+    for (const auto &voyage : m_horaire)
+    {
+        horaire.ajouterChaine(voyage.first.capacity());
+        horaire.ajouterChaine(voyage.second.voyage.getId().size());
+        horaire.ajouterChaine(voyage.second.voyage.getServiceId().size());
+        horaire.ajouterChaine(voyage.second.voyage.getDestination().capacity());
+        horaire.ajouterTableau(voyage.second.arrets.size(), voyage.second.arrets.capacity(), sizeof(ArretHoraire));
+    }
+
+    BilanMemoire::Composante &aVenir = p_bilan.composante("arrets_a_venir");
+    aVenir.nbElements += m_arretsAVenir.size() - m_prochainArretAVenir;
+    aVenir.ajouterTableau(m_arretsAVenir.size(), m_arretsAVenir.capacity(), sizeof(ArretAVenir));
+    aVenir.ajouterTableHachage(m_retardsAVenir.size(),
+                               sizeof(std::pair<const std::string, std::vector<std::pair<unsigned int, int>>>),
+                               m_retardsAVenir.bucket_count(), true);
+    for (const auto &retards : m_retardsAVenir)
+    {
+        aVenir.ajouterChaine(retards.first.capacity());
+        aVenir.ajouterTableau(retards.second.size(), retards.second.capacity(), sizeof(std::pair<unsigned int, int>));
+    }
+}
@@ -9,19 +9,38 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "arena.h"
 #include "arret.h"
 #include "auxiliaires.h"
 #include "coordonnees.h"
+#include "instrumentation.h"
 #include "ligne.h"
+#include "memoire.h"
 #include "station.h"
 #include "voyage.h"
 
+//! \brief retard (ou avance) d'un voyage, tel que reçu d'un flux temps réel (ex: GTFS-Realtime TripUpdate)
+//! \brief le décalage s'applique à l'arrêt de numéro de séquence numero_sequence et à tous les arrêts suivants du voyage
+struct RetardVoyage {
+    std::string voyage_id;        // l'identifiant (trip_id) du voyage touché
+    unsigned int numero_sequence; // le numéro de séquence du premier arrêt touché
+    int delai;                    // le décalage en secondes par rapport aux heures courantes (négatif pour une avance)
+};
+
+//! \brief trajet à pieds d'une station à une station voisine (voir DonneesGTFS::calculerTrajetsAPied())
+struct TrajetAPied {
+    unsigned int from_station_id;
+    unsigned int to_station_id;
+    double distance; // en km, à vol d'oiseau
+};
+
 class DonneesGTFS {
 
   public:
@@ -29,10 +48,29 @@ class DonneesGTFS {
 
     void ajouterLignes(const std::string &);
     void ajouterStations(const std::string &);
+    void chargerDossier(const std::string &);
+    void ajouterCalendrier(const std::string &);
     void ajouterServices(const std::string &);
     void ajouterVoyagesDeLaDate(const std::string &);
     void ajouterArretsDesVoyagesDeLaDate(const std::string &);
     void ajouterTransferts(const std::string &);
+    void calculerTrajetsAPied(double);
+
+    std::vector<RetardVoyage> lireRetards(const std::string &);
+    std::vector<Arret::Ptr> appliquerRetard(const RetardVoyage &);
+
+    void activerFenetreGlissante();
+    void avancerFenetre(const Heure &, const Heure &, std::vector<Arret::Ptr> &, std::vector<Arret::Ptr> &);
+    size_t getNbArretsAVenir() const;
+    size_t getNbRetardsAVenir() const;
+
+    void activerMultiJours();
+    void changerDate(const Date &, const Heure &, const Heure &);
+    bool isServiceActif(const std::string &, const Date &) const;
+    bool isServiceActif(unsigned int, const Date &) const;
+    Date getDate() const;
+    Date getPremiereDate() const;
+    Date getDerniereDate() const;
 
     void afficherLignes() const;
     void afficherStations() const;
@@ -54,9 +92,44 @@ class DonneesGTFS {
     const std::unordered_map<unsigned int, Ligne> &getLignes() const;
     const std::set<unsigned int> &getStationsDeTransfert() const;
     const std::vector<std::tuple<unsigned int, unsigned int, unsigned int>> &getTransferts() const;
+    const std::vector<TrajetAPied> &getTrajetsAPied() const;
+    unsigned int getVersionTransferts() const;
+
+    void setInstrumentation(Instrumentation *);
+    Instrumentation *getInstrumentation() const;
+    const std::shared_ptr<ArenaMemoire> &getArena() const;
+
+    void comptabiliserMemoire(BilanMemoire &) const;
 
   private:
-    std::vector<std::string> string_to_vector(const std::string &s, char delim);
+    //! \brief arrêt d'un voyage tel que lu dans stop_times.txt, sous forme compacte
+    struct ArretHoraire {
+        unsigned int station_id;
+        unsigned int numero_sequence;
+        unsigned int arrivee; // en secondes depuis le début du jour de service (peut dépasser 24h)
+        unsigned int depart;  // en secondes depuis le début du jour de service (peut dépasser 24h)
+    };
+
+    //! \brief voyage de l'horaire complet: ses attributs (sans arrêts) et tous ses arrêts en ordre de séquence
+    struct VoyageHoraire {
+        Voyage voyage;
+        unsigned int service; // indice du service dans m_joursDeService
+        std::vector<ArretHoraire> arrets;
+    };
+
+    //! \brief arrêt de la journée qui n'est pas encore entré dans la fenêtre [m_now1, m_now2)
+    struct ArretAVenir {
+        ArretHoraire horaire;                           // heures déjà ramenées au jour de m_date
+        std::map<std::string, Voyage>::iterator voyage; // les voyages ne sont jamais retirés en fenêtre glissante
+        bool dernier;                                   // dernier arrêt à venir du voyage (libère ses retards à venir)
+    };
+
+    void etendrePlageDeDates(const Date &, const Date &);
+    unsigned int indexerService(const std::string &);
+    void mettreAJourServicesDeLaDate();
+    void materialiserFenetre();
+    void filtrerTransferts();
+    void joindreStationsVoisines();
 
     Date m_date;  // la date d'intérêt
     Heure m_now1; // l'heure de début d'intérêt (à partir de laquelle on considère les arrêts)
@@ -65,6 +138,9 @@ class DonneesGTFS {
     unsigned int m_nbArrets;      // le nombre d'arrets au total présents dans cet objet
     bool m_tousLesArretsPresents; // indique si tous les arrêts de la date et de l'intervalle [now1, now2) ont été
                                   // ajoutés
+    std::shared_ptr<ArenaMemoire>
+        m_arena; // fournit les arrêts et les noeuds des conteneurs d'arrêts des stations et des voyages; déclarée avant
+                 // ces conteneurs afin d'être détruite après eux
 
     std::unordered_map<unsigned int, Ligne> m_lignes; // la clé unsigned int est l'identifiant m_id de l'objet Ligne
     std::map<unsigned int, Station> m_stations;       // la clé unsigned int est l'identifiant m_id de l'objet Station
@@ -74,8 +150,33 @@ class DonneesGTFS {
         m_transferts;                             // <from_station_id, to_station_id, min_transfer_time>
     std::set<unsigned int> m_stationsDeTransfert; // Chaque élément est l'identifiant from_station_id d'une station
                                                   // présente dans m_transferts
+    double m_rayonTrajetsAPied;              // distance maximale des trajets à pieds entre stations (0: aucun trajet)
+    std::vector<TrajetAPied> m_trajetsAPied; // entre toutes les paires de stations à moins de m_rayonTrajetsAPied km,
+                                             // triés par from_station_id puis to_station_id
+    unsigned int m_versionTransferts;        // incrémenté à chaque calcul de m_transferts ou de m_trajetsAPied
+
+    bool m_fenetreGlissante;                  // indique si les arrêts à venir de la journée sont conservés en mémoire
+    std::vector<ArretAVenir> m_arretsAVenir;  // arrêts dont l'heure d'arrivée est >= m_now2, triés par heure d'arrivée
+    size_t m_prochainArretAVenir;             // indice du prochain arrêt de m_arretsAVenir à admettre dans la fenêtre
+    std::unordered_map<std::string, std::vector<std::pair<unsigned int, int>>>
+        m_retardsAVenir; // trip_id -> <numero_sequence, delai> des retards reçus, à appliquer aux arrêts à venir;
+                         // une entrée par voyage ayant encore des arrêts à venir, retirée avec le dernier d'entre eux
+
+    bool m_multiJours;      // indique si l'horaire de toutes les dates du GTFS est conservé (voir changerDate())
+    Date m_premiereDate;    // la première date couverte par les services du GTFS
+    Date m_derniereDate;    // la dernière date couverte par les services du GTFS
+    std::unordered_map<std::string, unsigned int> m_indexServices; // service_id -> indice dans m_joursDeService
+    std::vector<std::vector<bool>>
+        m_joursDeService; // bit i du service vrai si le service est offert à la date m_premiereDate + i
+    std::map<std::string, VoyageHoraire> m_horaire; // trip_id -> horaire complet des voyages pouvant rouler à une date
+                                                    // d'intérêt (ou la veille, pour les voyages après minuit)
+    std::map<unsigned int, Station> m_toutesLesStations; // toutes les stations, sans arrêts (multi-jours seulement)
+    std::vector<std::tuple<unsigned int, unsigned int, unsigned int>>
+        m_tousLesTransferts; // tous les transferts du fichier, avant le filtrage sur les stations présentes
+
+    Instrumentation *m_instrumentation; // reçoit les mesures des phases de chargement (nullptr: non instrumenté)
 
-    std::multimap<std::string, Ligne> m_lignes_par_numero; // le string est l'attribut m_numero de l'objejjjjkt ligne
+    std::multimap<std::string, unsigned int> m_lignes_par_numero; // m_numero -> route_id de la ligne dans m_lignes
 };
 
 #endif // TP1_GTFS_H
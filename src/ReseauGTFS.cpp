@@ -3,21 +3,11 @@
 //
 
 #include "ReseauGTFS.h"
-#include <sys/time.h>
+#include <atomic>
+#include <chrono>
 
 using namespace std;
 
-//détermine le temps d'exécution (en microseconde) entre tv2 et tv2
-long tempsExecution(const timeval &tv1, const timeval &tv2)
-{
-    const long unMillion = 1000000;
-    long dt_usec = tv2.tv_usec - tv1.tv_usec;
-    long dt_sec = tv2.tv_sec - tv1.tv_sec;
-    long dtms = unMillion * dt_sec + dt_usec;
-    if (dtms < 0) throw logic_error("ReaseauGTFS::tempsExecution(): dtms doit être non négatif");
-    return dtms;
-}
-
 size_t ReseauGTFS::getNbArcsOrigineVersStations() const
 {
     return m_nbArcsOrigineVersStations;
@@ -44,167 +34,280 @@ double ReseauGTFS::getDistMaxMarche() const
 //! \post initialise la variable m_origine_dest_ajoute à false car les points origine et destination ne font pas parti du graphe
 //! \post insère les données requises dans m_arretDuSommet et m_sommetDeArret et construit le graphe m_leGraphe
 ReseauGTFS::ReseauGTFS(const DonneesGTFS &p_gtfs)
-        : m_leGraphe(p_gtfs.getNbArrets()), m_origine_dest_ajoute(false)
+        : m_arenaDesArrets(p_gtfs.getArena()), m_leGraphe(p_gtfs.getNbArrets()), m_origine_dest_ajoute(false),
+          m_versionTransferts(0),
+          m_instrumentation(p_gtfs.getInstrumentation()), m_version(nouvelleVersion()),
+          m_premierContracte(numeric_limits<size_t>::max()), m_pointOrigine(0, 0), m_pointDestination(0, 0)
 {
     //Le graphe possède p_gtfs.getNbArrets() sommets, mais il n'a pas encore d'arcs
+    //Les stations sont indexées d'abord: chaque arc entre deux stations abaisse m_tempsMinimauxVersStation
+    indexerStations(p_gtfs);
+    size_t nbArcs = getNbArcs();
+    Instrumentation::MesurePhase mesureVoyages(m_instrumentation, "ajouterArcsVoyages");
     ajouterArcsVoyages(p_gtfs);
+    mesureVoyages.terminer(getNbArcs() - nbArcs);
+    nbArcs = getNbArcs();
+    Instrumentation::MesurePhase mesureTransferts(m_instrumentation, "ajouterArcsTransferts");
     ajouterArcsTransferts(p_gtfs);
+    mesureTransferts.terminer(getNbArcs() - nbArcs);
+    nbArcs = getNbArcs();
+    Instrumentation::MesurePhase mesureTrajetsAPied(m_instrumentation, "ajouterArcsTrajetsAPied");
+    ajouterArcsTrajetsAPied(p_gtfs);
+    mesureTrajetsAPied.terminer(getNbArcs() - nbArcs);
+    nbArcs = getNbArcs();
+    Instrumentation::MesurePhase mesureAttente(m_instrumentation, "ajouterArcsAttente");
     ajouterArcsAttente(p_gtfs);
+    mesureAttente.terminer(getNbArcs() - nbArcs);
 }
 
+//! \brief instrumente la construction, les mises à jour et les requêtes de ce réseau
+//! \param[in] p_instrumentation: l'objet qui reçoit les mesures (nullptr pour cesser de mesurer); il doit survivre
+//! à cet objet
+void ReseauGTFS::setInstrumentation(Instrumentation *p_instrumentation)
+{
+    m_instrumentation = p_instrumentation;
+}
 
+Instrumentation *ReseauGTFS::getInstrumentation() const
+{
+    return m_instrumentation;
+}
 
-//! \brief Trouve le plus court chemin menant du point d'origine au point destination préalablement choisis
-//! \brief Permet également d'affichier l'itinéraire du voyage et retourne le temps d'exécution de l'algorithme de plus court chemin utilisé
-//! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement
-//! \param[out] p_tempsExecution: le temps d'exécution de l'algorithme de plus court chemin utilisé
-//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
-//! \throws logic_error si un problème survient durant l'exécution de la méthode
-unsigned int ReseauGTFS::itineraire(const DonneesGTFS &p_gtfs, bool p_afficherItineraire, long &p_tempsExecution) const
+//! \brief retourne la version des résultats de ce réseau: elle change lorsque le réseau est construit ou que les heures
+//! de ses arrêts ou sa fenêtre sont mises à jour (appliquerRetards(), avancerFenetre()), et deux réseaux n'ont jamais la
+//! même version. Un résultat mémorisé pour une version reste donc valide tant que la version est inchangée.
+unsigned long ReseauGTFS::getVersion() const
 {
-    if (!m_origine_dest_ajoute)
-        throw logic_error(
-                "ReseauGTFS::afficherItineraire(): il faut ajouter un point origine et un point destination avant d'obtenir un itinéraire");
+    return m_version;
+}
 
-    vector<size_t> chemin;
+unsigned long ReseauGTFS::nouvelleVersion()
+{
+    static atomic<unsigned long> prochaineVersion(1);
+    return prochaineVersion++;
+}
 
-    timeval tv1;
-    timeval tv2;
-    if (gettimeofday(&tv1, 0) != 0)
-        throw logic_error("ReseauGTFS::afficherItineraire(): gettimeofday() a échoué pour tv1");
-    unsigned int tempsDuTrajet = m_leGraphe.plusCourtChemin(m_sommetOrigine, m_sommetDestination, chemin);
-    if (gettimeofday(&tv2, 0) != 0)
-        throw logic_error("ReseauGTFS::afficherItineraire(): gettimeofday() a échoué pour tv2");
-    p_tempsExecution = tempsExecution(tv1, tv2);
+//! \brief ajoute au bilan la mémoire estimée du réseau: listes d'adjacence du graphe, correspondances entre sommets et
+//! arrêts, et tables de transferts (les arrêts eux-mêmes appartiennent aux données GTFS)
+//! \param[in,out] p_bilan: le bilan à compléter
+void ReseauGTFS::comptabiliserMemoire(BilanMemoire &p_bilan) const
+{
+    m_leGraphe.comptabiliserMemoire(p_bilan, "graphe.listes_adjacence");
 
-    if (tempsDuTrajet == numeric_limits<unsigned int>::max())
-    {
-        if (p_afficherItineraire)
-            cout << "La destination n'est pas atteignable de l'orignine avec cette distance maximale de marche" << endl;
-        return tempsDuTrajet;
-    }
+    BilanMemoire::Composante &correspondances = p_bilan.composante("graphe.sommets_arrets");
+    correspondances.nbElements += m_sommetDeArret.size();
+    correspondances.ajouterTableau(m_arretDuSommet.size(), m_arretDuSommet.capacity(), sizeof(Arret::Ptr));
+    correspondances.ajouterTableHachage(m_sommetDeArret.size(), sizeof(std::pair<const Arret::Ptr, size_t>),
+                                        m_sommetDeArret.bucket_count(), false);
+    correspondances.ajouterTableau(m_sommetsLibres.size(), m_sommetsLibres.capacity(), sizeof(size_t));
+    correspondances.ajouterTableau(m_sommetsVersDestination.size(), m_sommetsVersDestination.capacity(),
+                                   sizeof(size_t));
+    correspondances.ajouterTableHachage(m_tempsMarcheDepuisOrigine.size(),
+                                        sizeof(std::pair<const unsigned int, unsigned int>),
+                                        m_tempsMarcheDepuisOrigine.bucket_count(), false);
+    correspondances.ajouterTableHachage(m_sourcesArcsDesactives.size(),
+                                        sizeof(std::pair<const size_t, std::vector<size_t>>),
+                                        m_sourcesArcsDesactives.bucket_count(), false);
+    for (const auto &sources: m_sourcesArcsDesactives)
+        correspondances.ajouterTableau(sources.second.size(), sources.second.capacity(), sizeof(size_t));
+
+    BilanMemoire::Composante &contractes = p_bilan.composante("graphe.arrets_contractes");
+    contractes.nbElements += m_arretsContractes.size();
+    contractes.ajouterTableau(m_arretsContractes.size(), m_arretsContractes.capacity(), sizeof(ArretContracte));
+    contractes.ajouterTableau(m_debutChaine.size(), m_debutChaine.capacity(), sizeof(size_t));
+    contractes.ajouterTableau(m_franchisDesChaines.size(), m_franchisDesChaines.capacity(), sizeof(SommetPondere));
 
-    if (tempsDuTrajet == 0)
+    BilanMemoire::Composante &transferts = p_bilan.composante("graphe.transferts");
+    for (const auto *table : {&m_transfertsVersStation, &m_transfertsDepuisStation})
     {
-        if (p_afficherItineraire) cout << "Vous êtes déjà situé à la destination demandée" << endl;
-        return tempsDuTrajet;
+        transferts.nbElements += table->size();
+        transferts.ajouterTableHachage(table->size(),
+                                       sizeof(std::pair<const unsigned int,
+                                                        std::vector<std::pair<unsigned int, unsigned int>>>),
+                                       table->bucket_count(), false);
+        for (const auto &station : *table)
+            transferts.ajouterTableau(station.second.size(), station.second.capacity(),
+                                      sizeof(std::pair<unsigned int, unsigned int>));
     }
 
-    //un chemin non trivial a été trouvé
-    if (chemin.size() <= 2)
-        throw logic_error("ReseauGTFS::afficherItineraire(): un chemin non trivial doit contenir au moins 3 sommets");
+    BilanMemoire::Composante &stations = p_bilan.composante("graphe.coordonnees_stations");
+    stations.nbElements += m_idStations.size();
+    stations.ajouterTableau(m_coordonneesStations.getTaille(), m_coordonneesStations.getTaille(),
+                            6 * sizeof(double) + sizeof(Coordonnees));
+    stations.ajouterTableau(m_idStations.size(), m_idStations.capacity(), sizeof(unsigned int));
+
+    BilanMemoire::Composante &bornes = p_bilan.composante("graphe.bornes_stations");
+    bornes.nbElements += m_stationDuSommet.size();
+    bornes.ajouterTableau(m_stationDuSommet.size(), m_stationDuSommet.capacity(), sizeof(unsigned int));
+    bornes.ajouterTableau(m_tempsMinimauxVersStation.size(), m_tempsMinimauxVersStation.capacity(),
+                          sizeof(std::vector<std::pair<unsigned int, unsigned int>>));
+    for (const auto &entrants : m_tempsMinimauxVersStation)
+        bornes.ajouterTableau(entrants.size(), entrants.capacity(), sizeof(std::pair<unsigned int, unsigned int>));
+    bornes.ajouterTableau(m_borneVersDestination.size(), m_borneVersDestination.capacity(), sizeof(unsigned int));
+    bornes.ajouterTableau(m_sortieVersDestination.size(), m_sortieVersDestination.capacity(), sizeof(unsigned int));
 
-    if (m_arretDuSommet[chemin[0]]->getStationId() != stationIdOrigine)
+    BilanMemoire::Composante &dessertes = p_bilan.composante("graphe.dessertes_lignes");
+    dessertes.nbElements += m_stationsDeLigne.size();
+    dessertes.ajouterTableau(m_ligneDuSommet.size(), m_ligneDuSommet.capacity(), sizeof(unsigned int));
+    dessertes.ajouterTableHachage(m_indiceDeLigne.size(), sizeof(std::pair<const unsigned int, unsigned int>),
+                                  m_indiceDeLigne.bucket_count(), false);
+    for (const auto *table : {&m_stationsDeLigne, &m_lignesDeStation})
     {
-        cout << "m_arretDuSommet[chemin[0]]->getStationId() = " << m_arretDuSommet[chemin[0]]->getStationId() << endl;
-        cout << "chemin[0] = " << chemin[0] << " m_sommetOrigine = " << m_sommetOrigine << endl;
-        for (const auto & i : chemin)
-        {
-            cout << "chemin[" << i << "] = " << chemin[i] << endl;
-        }
-        throw logic_error("ReseauGTFS::afficherItineraire(): le premier noeud du chemin doit être le point origine");
+        dessertes.ajouterTableau(table->size(), table->capacity(), sizeof(std::vector<unsigned int>));
+        for (const auto &indices : *table)
+            dessertes.ajouterTableau(indices.size(), indices.capacity(), sizeof(unsigned int));
     }
-    if (m_arretDuSommet[chemin[chemin.size() - 1]]->getStationId() != stationIdDestination)
-        throw logic_error(
-                "ReseauGTFS::afficherItineraire(): le dernier noeud du chemin doit être le point destination");
+}
+
 
 
-    if (p_afficherItineraire)
+//! \brief Trouve le plus court chemin menant du point d'origine au point destination préalablement choisis
+//! \brief Permet également d'affichier l'itinéraire du voyage et retourne le temps d'exécution de l'algorithme de plus court chemin utilisé
+//! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement (le chemin n'est alors
+//! pas découpé en étapes)
+//! \param[out] p_tempsExecution: le temps d'exécution de l'algorithme de plus court chemin utilisé
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si un problème survient durant l'exécution de la méthode
+unsigned int ReseauGTFS::itineraire(const DonneesGTFS &p_gtfs, bool p_afficherItineraire, long &p_tempsExecution) const
+{
+    StatistiquesRecherche statistiques;
+    return itineraire(p_gtfs, p_afficherItineraire, p_tempsExecution, statistiques);
+}
+
+//! \brief Comme itineraire(p_gtfs, p_afficherItineraire, p_tempsExecution), en comptabilisant le travail de la recherche
+//! \param[out] p_statistiques: les compteurs de la recherche de plus court chemin
+unsigned int ReseauGTFS::itineraire(const DonneesGTFS &p_gtfs, bool p_afficherItineraire, long &p_tempsExecution,
+                                    StatistiquesRecherche &p_statistiques) const
+{
+    if (!p_afficherItineraire)
     {
-        std::cout << std::endl;
-        std::cout << "=====================" << std::endl;
-        std::cout << "     ITINÉRAIRE      " << std::endl;
-        std::cout << "=====================" << std::endl;
-        std::cout << std::endl;
+        vector<size_t> chemin;
+        return rechercherChemin(chemin, p_tempsExecution, p_statistiques);
     }
+    Itineraire resultat;
+    itineraire(p_gtfs, resultat, p_tempsExecution, p_statistiques);
+    afficherItineraire(cout, p_gtfs, resultat);
+    return resultat.duree;
+}
+
+//! \brief Trouve le plus court chemin menant du point d'origine au point destination préalablement choisis et le
+//! découpe en étapes, sans rien afficher (voir afficherItineraire())
+//! \param[out] p_itineraire: l'itinéraire trouvé (sans étapes si la destination n'est pas atteignable)
+//! \param[out] p_tempsExecution: le temps d'exécution de l'algorithme de plus court chemin utilisé
+//! \param[out] p_statistiques: les compteurs de la recherche de plus court chemin
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si un problème survient durant l'exécution de la méthode
+unsigned int ReseauGTFS::itineraire(const DonneesGTFS &p_gtfs, Itineraire &p_itineraire, long &p_tempsExecution,
+                                    StatistiquesRecherche &p_statistiques) const
+{
+    vector<size_t> chemin;
+    const unsigned int tempsDuTrajet = rechercherChemin(chemin, p_tempsExecution, p_statistiques);
+    const auto debut = Instrumentation::Horloge::now();
+    p_itineraire.heureDepart = m_heureDepart;
+    p_itineraire.duree = tempsDuTrajet;
+    p_itineraire.etapes.clear();
+    if (tempsDuTrajet == numeric_limits<unsigned int>::max()) return tempsDuTrajet;
 
-    if (p_afficherItineraire) cout << "Heure de départ du point d'origine: "  << p_gtfs.getTempsDebut() << endl;
-    Arret::Ptr ptr_a = m_arretDuSommet.at(chemin[0]);
-    Arret::Ptr ptr_b = m_arretDuSommet.at(chemin[1]);
-    if (p_afficherItineraire)
-        cout << "Rendez vous à la station " << p_gtfs.getStations().at(ptr_b->getStationId()) << endl;
+    //un chemin a été trouvé: il va du point origine au point destination en passant par au moins un arrêt
+    if (chemin.size() <= 2)
+        throw logic_error("ReseauGTFS::itineraire(): un chemin doit contenir au moins 3 sommets");
+    if (chemin.front() != m_sommetOrigine)
+        throw logic_error("ReseauGTFS::itineraire(): le premier noeud du chemin doit être le point origine");
+    if (chemin.back() != m_sommetDestination)
+        throw logic_error("ReseauGTFS::itineraire(): le dernier noeud du chemin doit être le point destination");
 
-    unsigned int sommet = 1;
+    const unsigned int tempsDeMarche = m_tempsMarcheDepuisOrigine.at(arretDe(chemin[1])->getStationId());
+    extraireEtapes(p_gtfs, chemin, 1, chemin.size() - 1, tempsDeMarche, p_itineraire);
+    if (m_instrumentation)
+        m_instrumentation->requeteCourante().reconstructionUs = Instrumentation::microsecondesDepuis(debut);
+
+    return tempsDuTrajet;
+}
+
+//! \brief recherche le plus court chemin entre les points ajoutés par ajouterArcsOrigineDestination()
+//! \param[out] p_chemin: les sommets du chemin, du point origine au point destination (vide s'il n'y en a pas)
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche, en microsecondes
+//! \param[out] p_statistiques: les compteurs de la recherche
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si les points origine et destination n'ont pas été ajoutés
+unsigned int ReseauGTFS::rechercherChemin(vector<size_t> &p_chemin, long &p_tempsExecution,
+                                          StatistiquesRecherche &p_statistiques) const
+{
+    if (!m_origine_dest_ajoute)
+        throw logic_error(
+                "ReseauGTFS::itineraire(): il faut ajouter un point origine et un point destination avant d'obtenir un itinéraire");
 
-    while (sommet < chemin.size() - 1)
+    // horloge monotone: la mesure n'est pas faussée par un ajustement de l'heure du système
+    auto debut = chrono::steady_clock::now();
+    unsigned int tempsDuTrajet = m_leGraphe.plusCourtChemin(m_sommetOrigine, m_sommetDestination, p_chemin,
+                                                            p_statistiques, m_stationDuSommet, m_borneVersDestination);
+    if (estCompacte())
     {
-        ptr_a = ptr_b;
-        ++sommet;
-        ptr_b = m_arretDuSommet.at(chemin[sommet]);
-        while (ptr_b->getStationId() == ptr_a->getStationId())
+        // les extrémités contractées se placent entre les points origine et destination et les sommets du chemin
+        vector<size_t> sommets;
+        if (p_chemin.size() > 2) sommets.assign(p_chemin.begin() + 1, p_chemin.end() - 1);
+        completerChemin(sommets, tempsDuTrajet, m_extremitesOrigineDestination, m_sortieVersDestination);
+        p_chemin.clear();
+        if (!sommets.empty())
         {
-            ptr_a = ptr_b;
-            ++sommet;
-            ptr_b = m_arretDuSommet.at(chemin[sommet]);
+            p_chemin.push_back(m_sommetOrigine);
+            p_chemin.insert(p_chemin.end(), sommets.begin(), sommets.end());
+            p_chemin.push_back(m_sommetDestination);
         }
-        //on a changé de station
-        if (ptr_b->getStationId() == stationIdDestination) //cas où on est arrivé à la destination
-        {
-            if (sommet != chemin.size() - 1)
-                throw logic_error(
-                        "ReseauGTFS::afficherItineraire(): incohérence de fin de chemin lors d'un changement de station");
-            break;
-        }
-        if (sommet == chemin.size() - 1)
-            throw logic_error("ReseauGTFS::afficherItineraire(): on ne devrait pas être arrivé à destination");
-        //on a changé de station mais sommet n'est pas le noeud destination
-        string voyage_id_a = ptr_a->getVoyageId();
-        string voyage_id_b = ptr_b->getVoyageId();
-        if (voyage_id_a != voyage_id_b) //on a changé de station à pieds
-        {
-            if (p_afficherItineraire)
-                cout << "De cette station, rendez-vous à pieds à la station " << p_gtfs.getStations().at(ptr_b->getStationId()) << endl;
-        }
-        else //on a changé de station avec un voyage
-        {
-            Heure heure = ptr_a->getHeureArrivee();
-            unsigned int ligne_id = p_gtfs.getVoyages().at(voyage_id_a).getLigne();
-            string ligne_numero = p_gtfs.getLignes().at(ligne_id).getNumero();
-            if (p_afficherItineraire)
-                cout << "De cette station, prenez l'autobus numéro " << ligne_numero << " à l'heure " << heure << " "
-                     << p_gtfs.getVoyages().at(voyage_id_a) << endl;
-            //maintenant allons à la dernière station de ce voyage
-            ptr_a = ptr_b;
-            ++sommet;
-            ptr_b = m_arretDuSommet.at(chemin[sommet]);
-            while (ptr_b->getVoyageId() == ptr_a->getVoyageId())
-            {
-                ptr_a = ptr_b;
-                ++sommet;
-                ptr_b = m_arretDuSommet.at(chemin[sommet]);
-            }
-            //on a changé de voyage
-            if (p_afficherItineraire)
-                cout << "et arrêtez-vous à la station " << p_gtfs.getStations().at(ptr_a->getStationId()) << " à l'heure "
-                     << ptr_a->getHeureArrivee() << endl;
-            if (ptr_b->getStationId() == stationIdDestination) //cas où on est arrivé à la destination
-            {
-                if (sommet != chemin.size() - 1)
-                    throw logic_error(
-                            "ReseauGTFS::afficherItineraire(): incohérence de fin de chemin lors d'u changement de voyage");
-                break;
-            }
-            if (ptr_a->getStationId() != ptr_b->getStationId()) //alors on s'est rendu à pieds à l'autre station
-                if (p_afficherItineraire)
-                    cout << "De cette station, rendez-vous à pieds à la station " << p_gtfs.getStations().at(ptr_b->getStationId()) << endl;
-        }
-    }
-
-    if (p_afficherItineraire)
-    {
-        cout << "Déplacez-vous à pieds de cette station au point destination" << endl;
-        cout << "Heure d'arrivée à la destination: " << p_gtfs.getTempsDebut().add_secondes(tempsDuTrajet) << endl;
     }
-    unsigned int h = tempsDuTrajet / 3600;
-    unsigned int reste_sec = tempsDuTrajet % 3600;
-    unsigned int m = reste_sec / 60;
-    unsigned int s = reste_sec % 60;
-    if (p_afficherItineraire)
+    auto fin = chrono::steady_clock::now();
+    p_tempsExecution = chrono::duration_cast<chrono::microseconds>(fin - debut).count();
+    if (m_instrumentation)
     {
-        cout << "Durée du trajet: " << h << " heures, " << m << " minutes, " << s << " secondes" << endl;
+        Instrumentation::Requete &requete = m_instrumentation->requeteCourante();
+        requete.rechercheUs = chrono::duration<double, micro>(fin - debut).count();
+        requete.sommetsSolutionnes = p_statistiques.sommetsSolutionnes;
+        requete.sommetsEmpiles = p_statistiques.sommetsEmpiles;
+        requete.arcsRelaches = p_statistiques.arcsRelaches;
     }
-
     return tempsDuTrajet;
 }
 
+//! \brief découpe en étapes (voir Etape) les arrêts p_chemin[p_debut], ..., p_chemin[p_fin - 1] d'un plus court chemin
+//! \param[in] p_tempsDeMarche: le temps de marche, en secondes, du point origine à la station du premier arrêt
+//! \param[in,out] p_itineraire: reçoit les étapes; son heure de départ et sa durée doivent être déjà établies
+//! \pre p_debut < p_fin
+void ReseauGTFS::extraireEtapes(const DonneesGTFS &p_gtfs, const vector<size_t> &p_chemin, size_t p_debut,
+                                size_t p_fin, unsigned int p_tempsDeMarche, Itineraire &p_itineraire) const
+{
+    vector<Etape> &etapes = p_itineraire.etapes;
+    const Arret::Ptr &premier = arretDe(p_chemin[p_debut]);
+    const Arret::Ptr &dernier = arretDe(p_chemin[p_fin - 1]);
+    etapes.emplace_back(Etape::MARCHE, Etape::pointOrigineDestination, premier->getStationId(),
+                        p_itineraire.heureDepart, p_itineraire.heureDepart.add_secondes(p_tempsDeMarche));
 
+    const Arret *position = premier.get(); //le dernier arrêt où l'on est descendu (ou le premier arrêt)
+    bool aVoyage = false;
+    for (size_t i = p_debut; i < p_fin; ++i)
+    {
+        const Arret::Ptr &embarquement = arretDe(p_chemin[i]);
+        size_t j = i;
+        while (j + 1 < p_fin && arretDe(p_chemin[j + 1])->getVoyageId() == embarquement->getVoyageId()) ++j;
+        if (j == i) continue; //attente à la station ou transfert: l'étape est produite au prochain embarquement
+
+        if (aVoyage || position->getStationId() != embarquement->getStationId())
+            etapes.emplace_back(Etape::TRANSFERT, position->getStationId(), embarquement->getStationId(),
+                                position->getHeureArrivee(), embarquement->getHeureArrivee());
+        const Arret::Ptr &debarquement = arretDe(p_chemin[j]);
+        etapes.emplace_back(Etape::TRAJET, embarquement->getStationId(), debarquement->getStationId(),
+                            embarquement->getHeureArrivee(), debarquement->getHeureArrivee());
+        Etape &trajet = etapes.back();
+        trajet.ligne = p_gtfs.getVoyages().at(embarquement->getVoyageId()).getLigne();
+        trajet.embarquement = embarquement;
+        trajet.debarquement = debarquement;
+        position = debarquement.get();
+        aVoyage = true;
+        i = j;
+    }
+
+    if (position->getStationId() != dernier->getStationId())
+        etapes.emplace_back(Etape::TRANSFERT, position->getStationId(), dernier->getStationId(),
+                            position->getHeureArrivee(), dernier->getHeureArrivee());
+    etapes.emplace_back(Etape::MARCHE, dernier->getStationId(), Etape::pointOrigineDestination,
+                        dernier->getHeureArrivee(), p_itineraire.getHeureArrivee());
+}
@@ -7,6 +7,11 @@
 
 #include "DonneesGTFS.h"
 #include "graphe.h"
+#include "itineraire.h"
+#include "motifsTransfert.h"
+#include "routageParVoyages.h"
+#include "tableCoordonnees.h"
+#include "traceRecherche.h"
 
 
 class ReseauGTFS
@@ -15,14 +20,58 @@ class ReseauGTFS
 public:
     explicit ReseauGTFS(const DonneesGTFS &);
     void ajouterArcsOrigineDestination(const DonneesGTFS &, const Coordonnees &, const Coordonnees &);
+    void ajouterArcsOrigineDestination(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &);
     void enleverArcsOrigineDestination();
     unsigned int itineraire(const DonneesGTFS &, bool, long &) const;
+    unsigned int itineraire(const DonneesGTFS &, bool, long &, StatistiquesRecherche &) const;
+    unsigned int itineraire(const DonneesGTFS &, Itineraire &, long &, StatistiquesRecherche &) const;
+    unsigned int calculerItineraire(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &,
+                                    Itineraire &, StatistiquesRecherche &) const;
+    unsigned int calculerItineraire(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &,
+                                    Itineraire &, StatistiquesRecherche &, TraceRecherche &) const;
+    unsigned int calculerItineraireEntreStations(const DonneesGTFS &, unsigned int, unsigned int, const Heure &,
+                                                 Itineraire &, StatistiquesRecherche &) const;
+    void calculerItinerairesPareto(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &,
+                                   std::vector<ItinerairePareto> &, StatistiquesRecherche &) const;
+    void calculerAlternatives(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &,
+                              unsigned int, unsigned int, std::vector<Itineraire> &, StatistiquesRecherche &) const;
+    Heure departLimiteMemesEntrees(const DonneesGTFS &, const Coordonnees &, const Heure &) const;
+    MotifsDeTransfert precalculerMotifsDeTransfert(const DonneesGTFS &, unsigned int) const;
+    RoutageParVoyages preparerRoutageParVoyages(const DonneesGTFS &) const;
+    void compacterVoyages();
+    bool estCompacte() const;
+    size_t getNbSommets() const;
+    size_t getNbArretsContractes() const;
+    size_t getNbRaccourcis() const;
+    void appliquerRetards(DonneesGTFS &, const std::vector<RetardVoyage> &);
+    void avancerFenetre(DonneesGTFS &, const Heure &, const Heure &);
     size_t getNbArcsOrigineVersStations() const;
     size_t getNbArcsStationsVersDestination() const;
     size_t getNbArcs() const;
     double getDistMaxMarche() const;
+    void setInstrumentation(Instrumentation *);
+    Instrumentation *getInstrumentation() const;
+    void comptabiliserMemoire(BilanMemoire &) const;
+    unsigned long getVersion() const;
 
 private:
+    //! \brief arrêt retiré du graphe par compacterVoyages(): son seul arc entrant venait de l'arrêt précédent de son
+    //! voyage et son seul arc sortant allait à l'arrêt suivant
+    struct ArretContracte {
+        Arret::Ptr arret;
+        size_t amont;         // le sommet d'où part le raccourci qui saute l'arrêt
+        size_t aval;          // le sommet où aboutit ce raccourci
+        unsigned int station; // l'indice de la station de l'arrêt
+    };
+
+    //! \brief extrémités d'une recherche qui tombent sur des arrêts contractés (voir reporterExtremites())
+    struct ExtremitesContractees {
+        std::vector<std::pair<size_t, size_t>> montees; // <sommet d'entrée, arrêt contracté où l'on monte>, triées
+        std::vector<size_t> direct; // meilleur chemin sans quitter un raccourci: [montée, descente] (vide si aucun)
+        unsigned int coutDirect;    // son coût, entrée et sortie comprises
+    };
+
+    std::shared_ptr<ArenaMemoire> m_arenaDesArrets; //garde en vie l'arène des arrêts de p_gtfs tant que ce réseau en conserve (déclarée en premier pour être détruite en dernier)
     Graphe m_leGraphe;
     std::vector<Arret::Ptr> m_arretDuSommet; //m_arretDuSommet[i] est le pointeur (shared_ptr) de l'arret (associé au sommet i du graphe
     std::unordered_map<Arret::Ptr,size_t> m_sommetDeArret; //m_sommetDeArret[a_ptr] est le sommet du graphe associé au pointeur de l'arret a_ptr
@@ -33,6 +82,32 @@ private:
     size_t m_sommetDestination; //le sommet du graphe qui représente le point destination
     size_t m_nbArcsOrigineVersStations; //le nombre d'arcs du point origine vers des stations
     size_t m_nbArcsStationsVersDestination; //le nombre d'arcs d'une station vers le point destination
+    std::vector<unsigned int> m_borneVersDestination; //borne inférieure du reste d'un trajet vers le point destination ajouté, par indice de station (voir calculerBornes())
+    std::vector<unsigned int> m_sortieVersDestination; //temps de marche vers le point destination ajouté, par indice de station (numeric_limits<unsigned int>::max() hors de portée)
+    Heure m_heureDepart; //l'heure de départ du point d'origine
+    std::unordered_map<unsigned int, unsigned int> m_tempsMarcheDepuisOrigine; //temps de marche (s) du point origine vers chaque station reliée
+    std::unordered_map<unsigned int, std::vector<std::pair<unsigned int, unsigned int>>> m_transfertsVersStation; //to_station_id -> <from_station_id, min_transfer_time>
+    std::unordered_map<unsigned int, std::vector<std::pair<unsigned int, unsigned int>>> m_transfertsDepuisStation; //from_station_id -> <to_station_id, min_transfer_time>
+    unsigned int m_versionTransferts; //DonneesGTFS::getVersionTransferts() des transferts de m_transfertsVersStation et m_transfertsDepuisStation
+    Instrumentation *m_instrumentation; //reçoit les mesures de construction et des requêtes (nullptr: non instrumenté)
+    std::vector<size_t> m_sommetsLibres; //sommets d'arrêts expirés (fenêtre glissante), réutilisés pour les arrêts admis
+    std::unordered_map<size_t, std::vector<size_t>> m_sourcesArcsDesactives; //sommet -> sources des arcs désactivés (retards) qui y aboutissent, retirés avec lui s'il expire
+    unsigned long m_version; //change à chaque construction et à chaque mise à jour des heures ou de la fenêtre (voir getVersion())
+    TableCoordonnees m_coordonneesStations; //coordonnées des stations de p_gtfs, pour la recherche des stations à distance de marche (fixes: voir indexerStations())
+    std::vector<unsigned int> m_idStations; //m_idStations[i] est l'identifiant de la station d'indice i dans m_coordonneesStations
+    std::vector<unsigned int> m_stationDuSommet; //m_stationDuSommet[i] est l'indice de la station de l'arrêt du sommet i: son groupe dans les recherches
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> m_tempsMinimauxVersStation; //pour chaque indice de station: <indice d'une autre station, plus petit poids d'un arc de celle-ci vers elle>
+    std::unordered_map<unsigned int, unsigned int> m_indiceDeLigne; //route_id -> indice de la ligne dans m_stationsDeLigne
+    std::vector<unsigned int> m_ligneDuSommet; //m_ligneDuSommet[i] est l'indice de la ligne du voyage du sommet i
+    std::vector<std::vector<unsigned int>> m_stationsDeLigne; //pour chaque indice de ligne: les indices des stations où passe un de ses voyages
+    std::vector<std::vector<unsigned int>> m_lignesDeStation; //pour chaque indice de station: les indices des lignes qui y passent
+    size_t m_premierContracte; //numéro du premier arrêt contracté: l'arrêt contracté i a le numéro m_premierContracte + i (numeric_limits<size_t>::max() si le réseau n'est pas compacté)
+    std::vector<ArretContracte> m_arretsContractes; //les arrêts contractés, par sommet amont puis dans l'ordre de leur voyage (voir compacterVoyages())
+    std::vector<size_t> m_debutChaine; //les arrêts contractés que saute le raccourci du sommet u sont m_arretsContractes[m_debutChaine[u]], ..., m_arretsContractes[m_debutChaine[u + 1] - 1]
+    std::vector<SommetPondere> m_franchisDesChaines; //pour chaque arrêt contracté: <indice de sa station, secondes depuis son sommet amont> (numeric_limits<unsigned int>::max() si un arc désactivé l'en sépare), voir DestinationParGroupes::franchis
+    ExtremitesContractees m_extremitesOrigineDestination; //extrémités contractées des arcs ajoutés par ajouterArcsOrigineDestination()
+    Coordonnees m_pointOrigine; //le point origine ajouté par ajouterArcsOrigineDestination()
+    Coordonnees m_pointDestination; //le point destination ajouté par ajouterArcsOrigineDestination()
 
     const double vitesseDeMarche = 5.0; // vitesse moyenne de marche, en km/heure, d'un humain selon wikipedia */
     const double distanceMaxMarche = 1.5; // distance maximale de marche permise, en km
@@ -40,9 +115,54 @@ private:
     const unsigned int stationIdOrigine = 0; //numéro de stationID donné pour l'arret fantôme de départ
     const unsigned int stationIdDestination = 1; //numéro de stationID donné pour les arrets fantômes de destination
 
+    static unsigned long nouvelleVersion(); //numéro de version jamais attribué à un autre réseau
     void ajouterArcsVoyages(const DonneesGTFS &); //ajout des arcs dus aux voyages
     void ajouterArcsTransferts(const DonneesGTFS &); //ajout des arcs dus aux transferts
+    void ajouterArcsTrajetsAPied(const DonneesGTFS &); //ajout des arcs dus aux trajets à pieds entre stations voisines
+    void ajouterArcsEntreStations(const DonneesGTFS &, unsigned int, unsigned int, unsigned int, ArenaMemoire &); //arcs de transfert d'une station à une autre
+    void actualiserTransferts(const DonneesGTFS &); //reconstruit les arcs entre voyages si les transferts de p_gtfs ont été recalculés
     void ajouterArcsAttente(const DonneesGTFS & p_gtfs); //ajout des arcs d'attente
+    void indexerStations(const DonneesGTFS &); //remplit m_coordonneesStations et m_idStations
+    unsigned int indiceDeStation(unsigned int) const; //indice d'une station dans m_idStations
+    void abaisserTempsMinimal(size_t, size_t, unsigned int); //tient compte d'un arc dans m_tempsMinimauxVersStation
+    unsigned int stationDe(size_t) const; //indice de la station d'un sommet ou d'un arrêt contracté
+    void calculerBornes(DestinationParGroupes &) const; //bornes inférieures du reste d'un trajet, par station, à partir des sorties
+    void associerLigne(size_t, unsigned int); //note la ligne (route_id) du voyage d'un sommet dans m_ligneDuSommet et les dessertes
+    void calculerMonteesMinimales(const DestinationParGroupes &, std::vector<unsigned int> &,
+                                  std::vector<unsigned int> &) const; //montées minimales jusqu'à la destination, par station et par ligne
+    void sommetsEntreeSortie(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &,
+                             std::vector<SommetPondere> &, DestinationParGroupes &) const; //sommets d'entrée et stations de sortie d'une recherche
+    unsigned int tempsDeMarche(const Coordonnees &, const Coordonnees &) const; //en secondes, à vitesseDeMarche
+    unsigned int tempsDeTransfert(unsigned int, unsigned int) const; //temps minimal d'un transfert entre deux stations (0 s'il n'y en a pas)
+    std::vector<std::pair<const Station *, unsigned int>> stationsAMoinsDe(const DonneesGTFS &, const Coordonnees &, double) const; //stations à au plus une distance (km) d'un point, avec le temps de marche
+    unsigned int poidsArc(size_t, size_t) const; //poids à jour d'un arc selon les heures courantes des arrêts
+    void mettreAJourArcsDuSommet(const DonneesGTFS &, size_t); //recalcule les poids des arcs entrants et sortants d'un sommet
+    void noterArcDesactive(size_t, size_t); //note un arc désactivé dans m_sourcesArcsDesactives
+    std::vector<size_t> getSommetsDesStationsSources(const DonneesGTFS &, const Arret::Ptr &) const; //sources possibles d'arcs d'attente ou de transfert
+    enum EtatSommet : char { arretInchange, arretRecalcule, arretAdmis }; //rôle d'un sommet lors d'un avancement de la fenêtre
+    void retirerSommet(const Arret::Ptr &); //retire du graphe le sommet d'un arrêt expiré
+    void ajouterArcsVoyageArretAdmis(const DonneesGTFS &, const Arret::Ptr &, const std::vector<EtatSommet> &); //arcs de voyage d'un arrêt admis
+    void ajouterArcsSortantsEntreVoyages(const DonneesGTFS &, unsigned int, const std::vector<size_t> &,
+                                         const std::vector<unsigned int> &, const std::vector<unsigned int> &); //arcs d'attente et de transfert sortant d'arrêts admis ou à quai d'une station
+    void ajouterArcsVersArretsAdmis(const DonneesGTFS &, unsigned int, const std::vector<size_t> &,
+                                    const std::vector<EtatSommet> &, const std::vector<unsigned int> &,
+                                    const std::vector<unsigned int> &); //arcs vers les arrêts admis d'une station
+    unsigned int rechercherChemin(std::vector<size_t> &, long &, StatistiquesRecherche &) const; //plus court chemin de l'origine à la destination ajoutées
+    unsigned int rechercherItineraire(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &,
+                                      Itineraire &, StatistiquesRecherche &, TraceSommets *) const; //corps de calculerItineraire(), tracé si le dernier paramètre n'est pas nullptr
+    void construireOrigineDestination(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &); //corps de ajouterArcsOrigineDestination(), sans instrumentation
+    void retirerOrigineDestination(); //corps de enleverArcsOrigineDestination(), sans instrumentation
+    bool estContracte(size_t) const; //vrai si le numéro est celui d'un arrêt contracté par compacterVoyages()
+    const Arret::Ptr &arretDe(size_t) const; //arrêt d'un sommet du graphe ou d'un arrêt contracté
+    int secondesEntre(size_t, size_t) const; //écart des heures d'arrivée de deux arrêts (sommets ou arrêts contractés)
+    std::pair<size_t, size_t> chaineDe(size_t) const; //indices dans m_arretsContractes des arrêts que saute le raccourci d'un sommet
+    bool estRaccourci(size_t, size_t) const; //vrai si l'arc est le raccourci d'un sommet
+    unsigned int poidsRaccourci(size_t); //poids à jour du raccourci d'un sommet
+    void developperVoyages(); //rétablit dans le graphe les arrêts contractés par compacterVoyages()
+    void reporterExtremites(std::vector<SommetPondere> &, DestinationParGroupes &, ExtremitesContractees &) const; //adapte les extrémités d'une recherche aux arrêts contractés
+    unsigned int sortieFranchie(size_t, const std::vector<unsigned int> &, size_t &) const; //meilleure sortie d'un sommet par un arrêt contracté de son raccourci
+    void completerChemin(std::vector<size_t> &, unsigned int &, const ExtremitesContractees &, const std::vector<unsigned int> &) const; //ajoute à un chemin les arrêts contractés où l'on monte et descend
+    void extraireEtapes(const DonneesGTFS &, const std::vector<size_t> &, size_t, size_t, unsigned int, Itineraire &) const; //découpe en étapes les arrêts d'un chemin
 
 };
 
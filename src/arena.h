@@ -0,0 +1,183 @@
+//
+// Arène de mémoire pour les petits objets nombreux (arrêts, noeuds des conteneurs, arcs du graphe).
+//
+
+#ifndef RTC_ARENA_H
+#define RTC_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Sous AddressSanitizer (option RTC_SANITIZE de CMake), les octets d'une arène qui ne sont pas alloués sont
+// empoisonnés: un accès à un arrêt, à un noeud ou à un arc déjà libéré est signalé comme pour le tas du système.
+#if defined(__SANITIZE_ADDRESS__)
+#define RTC_ARENA_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define RTC_ARENA_ASAN 1
+#endif
+#endif
+
+#ifdef RTC_ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#define RTC_ARENA_EMPOISONNER(adresse, octets) ASAN_POISON_MEMORY_REGION(adresse, octets)
+#define RTC_ARENA_DESEMPOISONNER(adresse, octets) ASAN_UNPOISON_MEMORY_REGION(adresse, octets)
+#else
+#define RTC_ARENA_EMPOISONNER(adresse, octets) ((void) (adresse), (void) (octets))
+#define RTC_ARENA_DESEMPOISONNER(adresse, octets) ((void) (adresse), (void) (octets))
+#endif
+
+/*!
+ * \class ArenaMemoire
+ * \brief Alloue les petits blocs (au plus tailleMaxPetitBloc octets) par avancement d'un pointeur dans de grands blocs
+ * réservés d'un coup, et recycle les blocs libérés dans une liste par classe de taille (multiples de 16 octets).
+ * \brief Les grands blocs ne sont rendus au système qu'à la destruction de l'arène, en une seule fois: le chargement
+ * et la construction du graphe ne font plus qu'un appel à l'allocateur du système par tailleGrandBloc octets, et les
+ * petits objets d'une même phase sont contigus en mémoire. Les demandes plus grandes que tailleMaxPetitBloc, ou plus
+ * alignées que 16 octets, sont transmises à ::operator new.
+ * \note L'arène n'est pas synchronisée: les objets qui la partagent ne doivent pas allouer ou libérer depuis plusieurs
+ * fils d'exécution à la fois. Elle doit survivre à tous les blocs qu'elle a alloués.
+ */
+class ArenaMemoire {
+
+public:
+
+    static const size_t granularite = 16;
+    static const size_t tailleMaxPetitBloc = 256;
+    static const size_t tailleGrandBlocParDefaut = 256 * 1024;
+
+    explicit ArenaMemoire(size_t p_tailleGrandBloc = tailleGrandBlocParDefaut)
+            : m_tailleGrandBloc(p_tailleGrandBloc), m_courant(nullptr), m_restant(0), m_octetsReserves(0),
+              m_octetsAlloues(0) {
+        for (auto &liste : m_listesLibres) liste = nullptr;
+    }
+
+    ~ArenaMemoire() {
+        for (char *bloc : m_grandsBlocs) {
+            RTC_ARENA_DESEMPOISONNER(bloc, m_tailleGrandBloc);
+            ::operator delete(bloc);
+        }
+    }
+
+    ArenaMemoire(const ArenaMemoire &) = delete;
+    ArenaMemoire &operator=(const ArenaMemoire &) = delete;
+
+    //! \brief alloue p_octets octets alignés sur p_alignement
+    //! \throws bad_alloc si la mémoire est épuisée
+    void *allouer(size_t p_octets, size_t p_alignement) {
+        if (p_octets > tailleMaxPetitBloc || p_alignement > granularite) return ::operator new(p_octets);
+        const size_t classe = classeDe(p_octets);
+        const size_t taille = (classe + 1) * granularite;
+        m_octetsAlloues += taille;
+        if (m_listesLibres[classe]) {
+            BlocLibre *bloc = m_listesLibres[classe];
+            RTC_ARENA_DESEMPOISONNER(bloc, sizeof(BlocLibre));
+            m_listesLibres[classe] = bloc->suivant;
+            RTC_ARENA_EMPOISONNER(bloc, taille);
+            RTC_ARENA_DESEMPOISONNER(bloc, p_octets);
+            return bloc;
+        }
+        if (m_restant < taille) nouveauGrandBloc();
+        void *bloc = m_courant;
+        m_courant += taille;
+        m_restant -= taille;
+        RTC_ARENA_DESEMPOISONNER(bloc, p_octets);
+        return bloc;
+    }
+
+    //! \brief rend un bloc obtenu de allouer() avec les mêmes p_octets et p_alignement
+    void liberer(void *p_bloc, size_t p_octets, size_t p_alignement) noexcept {
+        if (p_octets > tailleMaxPetitBloc || p_alignement > granularite) {
+            ::operator delete(p_bloc);
+            return;
+        }
+        const size_t classe = classeDe(p_octets);
+        const size_t taille = (classe + 1) * granularite;
+        m_octetsAlloues -= taille;
+        BlocLibre *bloc = static_cast<BlocLibre *>(p_bloc);
+        RTC_ARENA_DESEMPOISONNER(bloc, sizeof(BlocLibre));
+        bloc->suivant = m_listesLibres[classe];
+        m_listesLibres[classe] = bloc;
+        RTC_ARENA_EMPOISONNER(bloc, taille);
+    }
+
+    //! \brief octets réservés au système pour les petits blocs
+    size_t getOctetsReserves() const { return m_octetsReserves; }
+
+    //! \brief octets des petits blocs présentement alloués (arrondis à la granularité)
+    size_t getOctetsAlloues() const { return m_octetsAlloues; }
+
+private:
+
+    struct BlocLibre {
+        BlocLibre *suivant;
+    };
+
+    static size_t classeDe(size_t p_octets) { return p_octets == 0 ? 0 : (p_octets - 1) / granularite; }
+
+    void nouveauGrandBloc() {
+        // le reste du bloc courant est abandonné: il est plus petit que le plus grand des petits blocs
+        m_courant = static_cast<char *>(::operator new(m_tailleGrandBloc));
+        m_grandsBlocs.push_back(m_courant);
+        RTC_ARENA_EMPOISONNER(m_courant, m_tailleGrandBloc);
+        m_restant = m_tailleGrandBloc;
+        m_octetsReserves += m_tailleGrandBloc;
+    }
+
+    size_t m_tailleGrandBloc;
+    std::vector<char *> m_grandsBlocs;
+    char *m_courant;   // prochain octet libre du grand bloc courant
+    size_t m_restant;  // octets libres du grand bloc courant
+    BlocLibre *m_listesLibres[tailleMaxPetitBloc / granularite]; // blocs rendus, par classe de taille
+    size_t m_octetsReserves;
+    size_t m_octetsAlloues;
+};
+
+/*!
+ * \class AllocateurArena
+ * \brief Allocateur des conteneurs standards qui puise dans une ArenaMemoire; sans arène (nullptr), il se comporte
+ * comme std::allocator. Deux allocateurs sont égaux s'ils partagent la même arène.
+ */
+template<typename T>
+class AllocateurArena {
+
+public:
+
+    typedef T value_type;
+
+    AllocateurArena() noexcept : m_arena(nullptr) {}
+
+    explicit AllocateurArena(ArenaMemoire *p_arena) noexcept : m_arena(p_arena) {}
+
+    template<typename U>
+    AllocateurArena(const AllocateurArena<U> &p_autre) noexcept : m_arena(p_autre.getArena()) {}
+
+    T *allocate(size_t p_nb) {
+        if (!m_arena) return static_cast<T *>(::operator new(p_nb * sizeof(T)));
+        return static_cast<T *>(m_arena->allouer(p_nb * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p_bloc, size_t p_nb) noexcept {
+        if (!m_arena) ::operator delete(p_bloc);
+        else m_arena->liberer(p_bloc, p_nb * sizeof(T), alignof(T));
+    }
+
+    ArenaMemoire *getArena() const noexcept { return m_arena; }
+
+private:
+
+    ArenaMemoire *m_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const AllocateurArena<T> &p_a, const AllocateurArena<U> &p_b) noexcept {
+    return p_a.getArena() == p_b.getArena();
+}
+
+template<typename T, typename U>
+bool operator!=(const AllocateurArena<T> &p_a, const AllocateurArena<U> &p_b) noexcept {
+    return !(p_a == p_b);
+}
+
+#endif //RTC_ARENA_H
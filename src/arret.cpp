@@ -106,8 +106,27 @@ std::ostream &operator<<(std::ostream &flux, const Arret &p_arret)
     return flux;
 }
 
-std::string Arret::getVoyageId() const
+const std::string & Arret::getVoyageId() const
 {
     return m_voyage_id;
 }
 
+
+/*!
+ * \brief Décale l'heure d'arrivée et l'heure de départ de l'arrêt, par exemple suite à un retard signalé en temps réel
+ * \param[in] p_secondes: le décalage en secondes (positif pour un retard, négatif pour une avance)
+ * \exception logic_error si l'une des heures obtenues précède 00h00m00s
+ * \note l'arrêt doit d'abord être retiré des conteneurs triés par heure (ex: Station::m_arrets) puis y être remis
+ */
+void Arret::decaler(int p_secondes)
+{
+    if (p_secondes >= 0)
+    {
+        m_heure_arrivee = m_heure_arrivee.add_secondes((unsigned int) p_secondes);
+        m_heure_depart = m_heure_depart.add_secondes((unsigned int) p_secondes);
+    } else
+    {
+        m_heure_arrivee = m_heure_arrivee.sub_secondes((unsigned int) -p_secondes);
+        m_heure_depart = m_heure_depart.sub_secondes((unsigned int) -p_secondes);
+    }
+}
@@ -33,7 +33,8 @@ public:
 	const Heure & getHeureDepart() const;
 	unsigned int getNumeroSequence() const;
 	unsigned int getStationId() const;
-	std::string getVoyageId() const;
+	const std::string & getVoyageId() const;
+	void decaler(int p_secondes);
 
 	bool operator< (const Arret & p_other) const;
 	bool operator> (const Arret & p_other) const;
@@ -80,14 +80,66 @@ bool Date::operator>(const Date &other) const
  */
 void Date::encode(unsigned int an, unsigned int mois, unsigned int jour)
 {
-    mois -= 2;
-    if (mois <= 0)
+    int a = (int) an;
+    int m = (int) mois - 2; // signé: janvier doit devenir le 11e mois de l'année précédente
+    if (m <= 0)
     {
-        mois += 12;
-        an -= 1;
+        m += 12;
+        a -= 1;
     }
-    m_code = an / 4 - an / 100 + an / 400 + 367 * mois / 12 + jour;
-    m_code = m_code + 365 * an - 719499;
+    m_code = a / 4 - a / 100 + a / 400 + 367 * m / 12 + (int) jour;
+    m_code = m_code + 365 * a - 719499;
+}
+
+/*!
+ * \brief Retrouve l'année, le mois et le jour à partir du code d'une date (nombre de jours depuis 1970-01-01)
+ * \param[in] code: le code de la date
+ */
+void Date::decode(int code)
+{
+    // calendrier grégorien proleptique, années débutant le 1er mars
+    int z = code + 719468;
+    int ere = (z >= 0 ? z : z - 146096) / 146097;
+    int jourDeLEre = z - ere * 146097;
+    int anDeLEre = (jourDeLEre - jourDeLEre / 1460 + jourDeLEre / 36524 - jourDeLEre / 146096) / 365;
+    int jourDeLAn = jourDeLEre - (365 * anDeLEre + anDeLEre / 4 - anDeLEre / 100);
+    int moisDecale = (5 * jourDeLAn + 2) / 153;
+    m_jour = (unsigned int) (jourDeLAn - (153 * moisDecale + 2) / 5 + 1);
+    m_mois = (unsigned int) (moisDecale < 10 ? moisDecale + 3 : moisDecale - 9);
+    m_an = (unsigned int) (anDeLEre + ere * 400 + (m_mois <= 2 ? 1 : 0));
+    m_code = code;
+}
+
+/*!
+ * \brief Différence entre deux dates
+ * \param[in] other: l'autre date avec qui l'on fait l'opération
+ * \return le nombre de jours (positif ou négatif) qui sépare les deux dates
+ */
+int Date::operator-(const Date &other) const
+{
+    return m_code - other.m_code;
+}
+
+/*!
+ * \brief Ajoute un certain nombre de jours à la date de l'objet courant
+ * \param[in] jours: le nombre de jours à ajouter (négatif pour reculer)
+ * \return la nouvelle date obtenue
+ */
+Date Date::add_jours(int jours) const
+{
+    Date date(*this);
+    date.decode(m_code + jours);
+    return date;
+}
+
+/*!
+ * \brief Donne le jour de la semaine de la date
+ * \return 0 pour lundi, 1 pour mardi, ..., 6 pour dimanche
+ */
+unsigned int Date::getJourDeLaSemaine() const
+{
+    // le 1970-01-01 (code 0) était un jeudi
+    return (unsigned int) (((m_code + 3) % 7 + 7) % 7);
 }
 
 /*!
@@ -127,112 +179,7 @@ Heure::Heure()
 {
     time_t lt = time(nullptr);   //epoch seconds
     struct tm *p = localtime(&lt);
-    m_heure = (unsigned int) (p->tm_hour);
-    m_min = (unsigned int) (p->tm_min);
-    m_sec = (unsigned int) (p->tm_sec);
-    encode(m_heure, m_min, m_sec);
-}
-
-/*!
- * \brief Constructeur avec paramètre de la classe Heure. Instancie une Heure avec les paramètres.
- * \param[in] p_heure: le nombre d'heure de l'heure à instancier
- * \param[in] p_min: le nombre de minutes dans l'heure
- * \param[in] p_sec: le nombre de secondes dans la minute
- */
-Heure::Heure(unsigned int p_heure, unsigned int p_min, unsigned int p_sec)
-{
-    m_heure = p_heure;
-    m_min = p_min;
-    m_sec = p_sec;
-    encode(m_heure, m_min, m_sec);
-}
-
-/*!
- * \brief Égalité entre deux heures
- * Deux heures sont égales s'ils ont la même heure, la même minute et la même seconde
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les deux Heures sont égales.
- *
- */
-bool Heure::operator==(const Heure &other) const
-{
-    return m_code == other.m_code;
-}
-
-/*!
- * \brief Inégalité inférieure stricte entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est inférieur à celle de l'objet en paramètre.
- */
-bool Heure::operator<(const Heure &other) const
-{
-    return m_code < other.m_code;
-}
-
-/*!
- * \brief Inégalité supérieure stricte entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est supérieur à celle de l'objet en paramètre.
- */
-bool Heure::operator>(const Heure &other) const
-{
-    return m_code > other.m_code;
-}
-
-/*!
- * \brief Inégalité inférieure entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est inférieur ou égale à celle de l'objet en paramètre.
- */
-bool Heure::operator<=(const Heure &other) const
-{
-    return m_code <= other.m_code;
-}
-
-/*!
- * \brief Inégalité supérieure entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est supérieur ou égale à celle de l'objet en paramètre.
- */
-bool Heure::operator>=(const Heure &other) const
-{
-    return m_code >= other.m_code;
-}
-
-/*!
- * \brief Différence entre deux heures
- * \param[in] other: l'autre heure avec qui l'on fait l'opération
- * \return le nombre de secondes (positif ou négatif) qui sépare les deux heures.
- */
-int Heure::operator-(const Heure &other) const
-{
-    return m_code - other.m_code;
-}
-
-/*!
- * \brief Ajoute un certain nombre de secondes à l'heure de l'objet courant
- * \param[in] secs: le nombre de secondes à ajouter
- * \return la nouvelle heure obtenue après l'ajout des secondes
- */
-Heure Heure::add_secondes(unsigned int secs) const
-{
-    unsigned int code = m_code + secs; //la nouvelle heure en secondes
-    unsigned int h = code / 3600; //le nombre d'heures de cette nouvelle heure
-    unsigned int reste = code % 3600; //le reste en secondes
-    unsigned int m = reste / 60; //le nombre de minutes de cette nouvelle heure
-    unsigned int s = reste % 60; //le nombre de secondes de cette nouvelle heure
-    return Heure(h, m, s);
-}
-
-/*!
- * \brief Encode et modifie l'attribut hour_code de l'objet. L'encodage revient à déterminier le nombre de secondes depuis 00h00m00s
- * \param[in] p_heure: le nombre d'heure de l'heure à instancier
- * \param[in] p_min: le nombre de minutes dans l'heure
- * \param[in] p_sec: le nombre de secondes dans la minute
- */
-void Heure::encode(unsigned int p_heure, unsigned int p_min, unsigned int p_sec)
-{
-    m_code = (((60 * p_heure) + p_min) * 60) + p_sec;
+    m_code = (unsigned int) ((p->tm_hour * 60 + p->tm_min) * 60 + p->tm_sec);
 }
 
 /*!
@@ -243,28 +190,11 @@ void Heure::encode(unsigned int p_heure, unsigned int p_min, unsigned int p_sec)
  */
 std::ostream &operator<<(std::ostream &flux, const Heure &p_heure)
 {
-    if (p_heure.m_heure < 10)
-    {
-        flux << "0" << p_heure.m_heure << ":";
-    } else
-    {
-        flux << p_heure.m_heure << ":";
-    }
-
-    if (p_heure.m_min < 10)
-    {
-        flux << "0" << p_heure.m_min << ":";
-    } else
-    {
-        flux << p_heure.m_min << ":";
-    }
-
-    if (p_heure.m_sec < 10)
-    {
-        flux << "0" << p_heure.m_sec;
-    } else
-    {
-        flux << p_heure.m_sec;
-    }
+    // les heures, minutes et secondes ne sont calculées qu'ici
+    const unsigned int heures = p_heure.m_code / 3600;
+    const unsigned int minutes = p_heure.m_code / 60 % 60;
+    const unsigned int secondes = p_heure.m_code % 60;
+    flux << (heures < 10 ? "0" : "") << heures << ":" << (minutes < 10 ? "0" : "") << minutes << ":"
+         << (secondes < 10 ? "0" : "") << secondes;
     return flux;
 }
@@ -15,6 +15,8 @@
 #include "time.h"
 #include <unordered_set>
 #include <algorithm>
+#include <stdexcept>
+#include <type_traits>
 
 /*!
  * \class Date
@@ -29,6 +31,9 @@ public:
     bool operator==(const Date &other) const;
     bool operator<(const Date &other) const;
     bool operator>(const Date &other) const;
+    int operator-(const Date &other) const;
+    Date add_jours(int jours) const;
+    unsigned int getJourDeLaSemaine() const;
     friend std::ostream &operator<<(std::ostream &flux, const Date &p_date);
 
 
@@ -39,6 +44,7 @@ private:
     unsigned int m_jour;
 
     void encode(unsigned int an, unsigned int mois, unsigned int jour);
+    void decode(int code);
 
 };
 
@@ -47,30 +53,82 @@ private:
  * \class Heure
  * \brief Cette classe représente l'heure d'une journée.
  * Cependant pour les besoins du travail pratique nous permettont qu'elle puisse encoder un nombre d'heures supérieurs à 24
+ * \brief L'heure est le seul nombre de secondes depuis le début de la journée de service (4 octets, trivialement
+ * copiable): les comparaisons et l'arithmétique sont constexpr et en ligne, et les heures, minutes et secondes ne sont
+ * calculées qu'à l'affichage. C'est la clé de Station::Arrets et chaque Arret en contient deux.
  */
 class Heure
 {
 public:
     Heure();
 
-    Heure(unsigned int heure, unsigned int min, unsigned int sec);
-    Heure add_secondes(unsigned int secs) const;
-    bool operator==(const Heure &other) const;
-    bool operator<(const Heure &other) const;
-    bool operator>(const Heure &other) const;
-    bool operator<=(const Heure &other) const;
-    bool operator>=(const Heure &other) const;
-    int operator-(const Heure &other) const;
+    //! \brief Instancie une Heure avec les paramètres (les minutes et les secondes peuvent dépasser 59: elles sont
+    //! reportées sur les unités supérieures)
+    //! \param[in] heure: le nombre d'heures \param[in] min: le nombre de minutes \param[in] sec: le nombre de secondes
+    constexpr Heure(unsigned int heure, unsigned int min, unsigned int sec)
+            : m_code((60 * heure + min) * 60 + sec)
+    {
+    }
+
+    //! \return la nouvelle heure obtenue après l'ajout de secs secondes
+    constexpr Heure add_secondes(unsigned int secs) const
+    {
+        return Heure(0, 0, m_code + secs);
+    }
+
+    //! \return la nouvelle heure obtenue après le retrait de secs secondes
+    //! \exception logic_error si l'heure obtenue précède 00h00m00s
+    constexpr Heure sub_secondes(unsigned int secs) const
+    {
+        return secs > m_code ? throw std::logic_error("Heure::sub_secondes(): l'heure obtenue serait négative")
+                             : Heure(0, 0, m_code - secs);
+    }
+
+    //! \return le nombre de secondes depuis 00h00m00s
+    constexpr unsigned int getSecondes() const
+    {
+        return m_code;
+    }
+
+    constexpr bool operator==(const Heure &other) const
+    {
+        return m_code == other.m_code;
+    }
+
+    constexpr bool operator<(const Heure &other) const
+    {
+        return m_code < other.m_code;
+    }
+
+    constexpr bool operator>(const Heure &other) const
+    {
+        return m_code > other.m_code;
+    }
+
+    constexpr bool operator<=(const Heure &other) const
+    {
+        return m_code <= other.m_code;
+    }
+
+    constexpr bool operator>=(const Heure &other) const
+    {
+        return m_code >= other.m_code;
+    }
+
+    //! \return le nombre de secondes (positif ou négatif) qui sépare les deux heures
+    constexpr int operator-(const Heure &other) const
+    {
+        return (int) m_code - (int) other.m_code;
+    }
+
     friend std::ostream &operator<<(std::ostream &flux, const Heure &p_heure);
 
 private:
-    unsigned int m_code;
-    unsigned int m_heure;
-    unsigned int m_min;
-    unsigned int m_sec;
-
-    void encode(unsigned int heure, unsigned int min, unsigned int sec);
+    unsigned int m_code; // nombre de secondes depuis 00h00m00s
 };
 
+static_assert(sizeof(Heure) == sizeof(unsigned int), "Heure doit rester un nombre de secondes");
+static_assert(std::is_trivially_copyable<Heure>::value, "Heure doit rester trivialement copiable");
+
 
 #endif //RTC_AUXILIAIRES_H
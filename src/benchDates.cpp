@@ -0,0 +1,146 @@
+//
+// Banc d'essai du mode multi-jours (DonneesGTFS::activerMultiJours(), DonneesGTFS::changerDate()).
+// L'horaire complet est chargé une seule fois, puis la date change d'un jour à l'autre, pour deux fenêtres: le début de
+// la journée, où circulent les voyages de la veille qui se poursuivent après minuit (trip_id + "@veille"), et la fin de
+// la journée, dont les arrêts dépassent 24:00:00. Pour chaque date et chaque fenêtre, les données sont aussi chargées
+// pour cette seule date: les voyages (identifiants et nombre d'arrêts) doivent être les mêmes, et un corpus de requêtes
+// entre stations, tiré d'une graine donnée, doit donner les mêmes durées dans les deux réseaux. Un changement de date
+// exige de reconstruire le réseau: le temps mesuré comprend cette reconstruction. Les résultats sont écrits en JSON
+// sur la sortie standard.
+//
+// Usage: benchDates [dossier_gtfs] [premiere_date_AAAAMMJJ] [nombre_de_jours] [requetes_par_fenetre] [graine]
+//
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    //! \brief fenêtre [debut, fin) comparée à chaque date, en secondes depuis le début du jour de service
+    struct Fenetre {
+        unsigned int debut;
+        unsigned int fin;
+    };
+
+    const Fenetre fenetres[] = {{0, 6 * 3600}, {20 * 3600, 28 * 3600}};
+    const string suffixeVeille = "@veille";
+
+    Heure heure(unsigned int p_secondes) {
+        return Heure(0, 0, 0).add_secondes(p_secondes);
+    }
+
+    bool estDeLaVeille(const string &p_voyage_id) {
+        return p_voyage_id.size() > suffixeVeille.size() &&
+               p_voyage_id.compare(p_voyage_id.size() - suffixeVeille.size(), suffixeVeille.size(), suffixeVeille) == 0;
+    }
+
+    //! \brief vrai si les deux objets GTFS ont les mêmes voyages, avec le même nombre d'arrêts
+    bool memesVoyages(const DonneesGTFS &p_a, const DonneesGTFS &p_b) {
+        const map<string, Voyage> &voyagesA = p_a.getVoyages();
+        const map<string, Voyage> &voyagesB = p_b.getVoyages();
+        if (voyagesA.size() != voyagesB.size()) return false;
+        for (auto itA = voyagesA.begin(), itB = voyagesB.begin(); itA != voyagesA.end(); ++itA, ++itB)
+            if (itA->first != itB->first || itA->second.getArrets().size() != itB->second.getArrets().size())
+                return false;
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const Date premiereDate = argc > 2 ? dateDepuisArgument(argv[2], "benchDates") : Date(2020, 9, 20);
+    const unsigned int nbJours = argc > 3 ? stoul(argv[3]) : 7;
+    const size_t requetesParFenetre = argc > 4 ? stoul(argv[4]) : 100;
+    const uint32_t graine = argc > 5 ? (uint32_t) stoul(argv[5]) : 2021;
+
+    auto debut = chrono::steady_clock::now();
+    DonneesGTFS multiJours(premiereDate, heure(fenetres[0].debut), heure(fenetres[0].debut));
+    multiJours.activerMultiJours();
+    multiJours.chargerDossier(chemin_dossier);
+    const double chargementMs = chrono::duration<double, milli>(chrono::steady_clock::now() - debut).count();
+
+    std::mt19937 generateur(graine);
+    vector<double> changementsMs, chargementsSimplesMs;
+    size_t nbComparaisons = 0, nbVoyagesDifferents = 0, nbArretsDifferents = 0;
+    size_t nbRequetes = 0, nbAtteignables = 0, nbDureesDifferentes = 0;
+    size_t nbVoyagesDeLaVeille = 0, nbArretsApresMinuit = 0;
+    for (unsigned int jour = 0; jour < nbJours; ++jour)
+    {
+        const Date date = premiereDate.add_jours(jour);
+        for (const Fenetre &fenetre : fenetres)
+        {
+            auto t0 = chrono::steady_clock::now();
+            multiJours.changerDate(date, heure(fenetre.debut), heure(fenetre.fin));
+            auto t1 = chrono::steady_clock::now();
+            DonneesGTFS simple(date, heure(fenetre.debut), heure(fenetre.fin));
+            simple.chargerDossier(chemin_dossier);
+            auto t2 = chrono::steady_clock::now();
+
+            ++nbComparaisons;
+            if (!memesVoyages(multiJours, simple)) ++nbVoyagesDifferents;
+            if (multiJours.getNbArrets() != simple.getNbArrets()) ++nbArretsDifferents;
+            for (const auto &voyage : multiJours.getVoyages())
+            {
+                if (estDeLaVeille(voyage.first)) ++nbVoyagesDeLaVeille;
+                for (const auto &arret : voyage.second.getArrets())
+                    if (arret->getHeureArrivee().getSecondes() >= 24 * 3600) ++nbArretsApresMinuit;
+            }
+            if (multiJours.getNbArrets() == 0 || simple.getNbArrets() == 0) continue; // pas de réseau sans arrêts
+
+            auto t3 = chrono::steady_clock::now();
+            ReseauGTFS reseauMultiJours(multiJours);
+            auto t4 = chrono::steady_clock::now();
+            ReseauGTFS reseauSimple(simple);
+            auto t5 = chrono::steady_clock::now();
+            changementsMs.push_back(chrono::duration<double, milli>((t1 - t0) + (t4 - t3)).count());
+            chargementsSimplesMs.push_back(chrono::duration<double, milli>((t2 - t1) + (t5 - t4)).count());
+
+            vector<unsigned int> station_ids;
+            for (const auto &station : simple.getStations()) station_ids.push_back(station.first);
+            if (station_ids.size() < 2) continue;
+            for (size_t i = 0; i < requetesParFenetre; ++i)
+            {
+                const unsigned int origine = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+                const unsigned int destination = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+                const Heure depart = heure(fenetre.debut + tirer(generateur, (fenetre.fin - fenetre.debut) / 2));
+                if (destination == origine) continue;
+                Itineraire parMultiJours, parSimple;
+                StatistiquesRecherche statistiques;
+                const unsigned int dureeMultiJours = reseauMultiJours.calculerItineraireEntreStations(
+                        multiJours, origine, destination, depart, parMultiJours, statistiques);
+                const unsigned int dureeSimple = reseauSimple.calculerItineraireEntreStations(
+                        simple, origine, destination, depart, parSimple, statistiques);
+                ++nbRequetes;
+                if (parSimple.estAtteignable()) ++nbAtteignables;
+                if (dureeMultiJours != dureeSimple) ++nbDureesDifferentes;
+            }
+        }
+    }
+
+    cout << fixed << setprecision(3) << "{\n";
+    cout << "  \"dossier\": \"" << chemin_dossier << "\",\n";
+    cout << "  \"jours\": " << nbJours << ",\n";
+    cout << "  \"chargement_multi_jours_ms\": " << chargementMs << ",\n";
+    cout << "  \"comparaisons\": " << nbComparaisons << ",\n";
+    cout << "  \"comparaisons_voyages_differents\": " << nbVoyagesDifferents << ",\n";
+    cout << "  \"comparaisons_arrets_differents\": " << nbArretsDifferents << ",\n";
+    cout << "  \"voyages_de_la_veille\": " << nbVoyagesDeLaVeille << ",\n";
+    cout << "  \"arrets_apres_minuit\": " << nbArretsApresMinuit << ",\n";
+    cout << "  \"requetes\": " << nbRequetes << ",\n";
+    cout << "  \"atteignables\": " << nbAtteignables << ",\n";
+    afficherDistribution(cout, "changement_de_date_ms", changementsMs);
+    afficherDistribution(cout, "chargement_simple_ms", chargementsSimplesMs);
+    cout << "  \"durees_differentes\": " << nbDureesDifferentes << "\n";
+    cout << "}\n";
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+//
+// Banc d'essai du calcul des distances entre un point et toutes les stations.
+// Compare le débit de Coordonnees::operator-() appelé station par station à celui des noyaux en lot de
+// TableCoordonnees, vérifie que TableCoordonnees::indicesAMoinsDe() retient exactement les mêmes stations qu'une
+// boucle sur Coordonnees::operator-() (dont un NaN, pour des points confondus, compte pour 0) et que chaque station est
+// retenue à sa propre position, et mesure l'écart de l'approximation équirectangulaire sur des paires de points
+// à au plus 10 km l'une de l'autre, sous 70° de latitude. Les résultats sont écrits en JSON sur la sortie standard.
+//
+// Usage: benchDistances [dossier_gtfs] [nombre_de_points] [graine]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "DonneesGTFS.h"
+#include "outilsMesure.h"
+#include "tableCoordonnees.h"
+
+using namespace std;
+
+namespace {
+
+    const double distanceDeMarche = 1.5;      // km, celle de ReseauGTFS
+    const double distanceMaxEcart = 10.0;     // km, distance maximale des paires de la mesure d'écart
+    const double latitudeMaxEcart = 70.0;     // degrés
+    const size_t nbCentresEcart = 500;
+    const size_t nbPointsParCentre = 1000;
+
+    //! \brief tire un réel dans [0, 1), identique sur toutes les plateformes
+    double tirerReel(std::mt19937 &p_generateur) {
+        return p_generateur() / 4294967296.0;
+    }
+
+    //! \brief distance de référence, en km: formule de haversine en précision étendue, bien conditionnée aux petites
+    //! distances (contrairement à l'arc cosinus)
+    double distanceReference(const Coordonnees &p_a, const Coordonnees &p_b) {
+        const long double radParDegre = 3.14159265358979323846264338327950288L / 180.0L;
+        const long double lat1 = p_a.getLatitude() * radParDegre;
+        const long double lat2 = p_b.getLatitude() * radParDegre;
+        const long double sinDLat = sinl((lat2 - lat1) / 2);
+        const long double sinDLon = sinl((p_b.getLongitude() - p_a.getLongitude()) * radParDegre / 2);
+        const long double h = sinDLat * sinDLat + cosl(lat1) * cosl(lat2) * sinDLon * sinDLon;
+        return (double) (2.0L * TableCoordonnees::rayonTerre * asinl(sqrtl(h)));
+    }
+
+    //! \brief tire un point à au plus p_distance km (environ) de p_centre
+    Coordonnees pointVoisin(std::mt19937 &p_generateur, const Coordonnees &p_centre, double p_distance) {
+        const double radParDegre = 3.14159265358979323846 / 180.0;
+        const double angle = 2 * 3.14159265358979323846 * tirerReel(p_generateur);
+        const double distance = p_distance * sqrt(tirerReel(p_generateur));
+        const double degres = distance / TableCoordonnees::rayonTerre / radParDegre;
+        const double latitude = p_centre.getLatitude() + degres * sin(angle);
+        const double longitude = p_centre.getLongitude() +
+                                 degres * cos(angle) / cos(p_centre.getLatitude() * radParDegre);
+        return Coordonnees(max(0.0, latitude), longitude);
+    }
+
+    //! \brief écart maximal absolu (en m), et sa moyenne, d'une série de comparaisons
+    struct Ecart {
+        double max = 0;
+        double somme = 0;
+        size_t nb = 0;
+        void ajouter(double p_ecartKm) {
+            const double ecart = fabs(p_ecartKm) * 1000;
+            if (ecart == ecart) max = std::max(max, ecart);
+            somme += ecart == ecart ? ecart : 0;
+            ++nb;
+        }
+    };
+
+    void afficherEcart(ostream &p_flux, const char *p_nom, const Ecart &p_ecart) {
+        p_flux << setprecision(6) << "  \"" << p_nom << "\": {\"max_m\": " << p_ecart.max << ", \"moyenne_m\": "
+               << (p_ecart.nb ? p_ecart.somme / p_ecart.nb : 0.0) << "},\n" << setprecision(3);
+    }
+
+    double nsParDistance(chrono::steady_clock::duration p_duree, size_t p_nbDistances) {
+        return chrono::duration<double, nano>(p_duree).count() / (double) p_nbDistances;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const size_t nbPoints = argc > 2 ? stoul(argv[2]) : 20000;
+    const uint32_t graine = argc > 3 ? (uint32_t) stoul(argv[3]) : 2021;
+
+    DonneesGTFS donnees(Date(2020, 9, 25), Heure(0, 0, 0), Heure(23, 59, 59));
+    donnees.ajouterStations(chemin_dossier + "/stops.txt");
+    TableCoordonnees table;
+    table.reserver(donnees.getNbStations());
+    vector<Coordonnees> stations;
+    for (const auto &station : donnees.getStations())
+    {
+        table.ajouter(station.second.getCoords());
+        stations.push_back(station.second.getCoords());
+    }
+    if (stations.empty()) throw logic_error("benchDistances: aucune station");
+
+    // points de requête: des stations tirées au hasard, déplacées d'au plus 500 m
+    mt19937 generateur(graine);
+    vector<Coordonnees> points;
+    points.reserve(nbPoints);
+    for (size_t i = 0; i < nbPoints; ++i)
+        points.push_back(pointVoisin(generateur, stations[tirer(generateur, (uint32_t) stations.size())], 0.5));
+    const size_t nbDistances = nbPoints * stations.size();
+    vector<double> sortie(stations.size());
+
+    double sommeScalaire = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (const Coordonnees &point : points)
+        for (const Coordonnees &station : stations) sommeScalaire += point - station;
+    auto t1 = chrono::steady_clock::now();
+
+    double sommeCosinus = 0;
+    for (const Coordonnees &point : points)
+    {
+        table.cosinusAngles(point, sortie.data());
+        sommeCosinus += sortie[point.getLatitude() > 0 ? sortie.size() / 2 : 0];
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    double sommeEquirectangulaire = 0;
+    for (const Coordonnees &point : points)
+    {
+        table.distancesEquirectangulaires(point, sortie.data());
+        sommeEquirectangulaire += sortie[point.getLatitude() > 0 ? sortie.size() / 2 : 0];
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    // recherche des stations à distance de marche: boucle sur operator-() contre filtre en lot et vérification
+    size_t nbRetenues = 0, nbDivergences = 0;
+    vector<size_t> indices;
+    chrono::steady_clock::duration dureeBoucle(0), dureeFiltre(0);
+    for (const Coordonnees &point : points)
+    {
+        auto debut = chrono::steady_clock::now();
+        vector<size_t> attendus;
+        for (size_t i = 0; i < stations.size(); ++i)
+        {
+            const double distance = point - stations[i];
+            if (distance <= distanceDeMarche || distance != distance) attendus.push_back(i); // NaN: points confondus
+        }
+        auto milieu = chrono::steady_clock::now();
+        table.indicesAMoinsDe(point, distanceDeMarche, indices);
+        auto fin = chrono::steady_clock::now();
+        dureeBoucle += milieu - debut;
+        dureeFiltre += fin - milieu;
+        nbRetenues += indices.size();
+        if (indices != attendus) ++nbDivergences;
+    }
+
+    // chaque station, prise comme point de requête, doit être retenue à sa propre position, même quand operator-()
+    // donne NaN pour sa distance à elle-même
+    size_t nbDistancesPropresNaN = 0, nbStationsOubliees = 0;
+    for (size_t i = 0; i < stations.size(); ++i)
+    {
+        const double distance = stations[i] - stations[i];
+        if (distance != distance) ++nbDistancesPropresNaN;
+        table.indicesAMoinsDe(stations[i], distanceDeMarche, indices);
+        if (find(indices.begin(), indices.end(), i) == indices.end()) ++nbStationsOubliees;
+    }
+
+    // écart de l'approximation équirectangulaire et bruit de l'arc cosinus, par rapport à la référence
+    Ecart equirectangulaireReference, arcCosinusReference, equirectangulaireArcCosinus;
+    TableCoordonnees voisins;
+    vector<Coordonnees> pointsVoisins;
+    vector<double> distances(nbPointsParCentre);
+    for (size_t c = 0; c < nbCentresEcart; ++c)
+    {
+        const Coordonnees centre(1 + (latitudeMaxEcart - 2) * tirerReel(generateur),
+                                 -170 + 340 * tirerReel(generateur));
+        voisins = TableCoordonnees();
+        pointsVoisins.clear();
+        for (size_t i = 0; i < nbPointsParCentre; ++i)
+        {
+            pointsVoisins.push_back(pointVoisin(generateur, centre, distanceMaxEcart));
+            voisins.ajouter(pointsVoisins.back());
+        }
+        voisins.distancesEquirectangulaires(centre, distances.data());
+        for (size_t i = 0; i < nbPointsParCentre; ++i)
+        {
+            const double reference = distanceReference(centre, pointsVoisins[i]);
+            if (reference > distanceMaxEcart) continue;
+            double arcCosinus = centre - pointsVoisins[i];
+            if (arcCosinus != arcCosinus) arcCosinus = 0; // acos() d'un arrondi au-delà de 1: points confondus
+            equirectangulaireReference.ajouter(distances[i] - reference);
+            arcCosinusReference.ajouter(arcCosinus - reference);
+            equirectangulaireArcCosinus.ajouter(distances[i] - arcCosinus);
+        }
+    }
+
+    cout << fixed << setprecision(3) << "{\n";
+    cout << "  \"dossier\": \"" << chemin_dossier << "\",\n";
+    cout << "  \"graine\": " << graine << ",\n";
+    cout << "  \"stations\": " << stations.size() << ",\n";
+    cout << "  \"points\": " << nbPoints << ",\n";
+    cout << "  \"operateur_moins_ns\": " << nsParDistance(t1 - t0, nbDistances) << ",\n";
+    cout << "  \"cosinus_en_lot_ns\": " << nsParDistance(t2 - t1, nbDistances) << ",\n";
+    cout << "  \"equirectangulaire_en_lot_ns\": " << nsParDistance(t3 - t2, nbDistances) << ",\n";
+    cout << "  \"a_distance_de_marche_boucle_ns\": " << nsParDistance(dureeBoucle, nbDistances) << ",\n";
+    cout << "  \"a_distance_de_marche_filtre_ns\": " << nsParDistance(dureeFiltre, nbDistances) << ",\n";
+    cout << "  \"a_distance_de_marche_retenues\": " << nbRetenues << ",\n";
+    cout << "  \"a_distance_de_marche_divergences\": " << nbDivergences << ",\n";
+    cout << "  \"distances_propres_nan\": " << nbDistancesPropresNaN << ",\n";
+    cout << "  \"stations_oubliees_a_leur_position\": " << nbStationsOubliees << ",\n";
+    afficherEcart(cout, "ecart_equirectangulaire_reference", equirectangulaireReference);
+    afficherEcart(cout, "ecart_arc_cosinus_reference", arcCosinusReference);
+    afficherEcart(cout, "ecart_equirectangulaire_arc_cosinus", equirectangulaireArcCosinus);
+    cout << "  \"paires_ecart\": " << equirectangulaireReference.nb << ",\n";
+    // empêche le compilateur d'éliminer les boucles mesurées
+    cout << "  \"somme_de_controle\": " << sommeScalaire + sommeCosinus + sommeEquirectangulaire << "\n";
+    cout << "}\n";
+
+    return 0;
+}
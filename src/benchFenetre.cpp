@@ -0,0 +1,138 @@
+//
+// Banc d'essai de la fenêtre glissante (DonneesGTFS::activerFenetreGlissante(), ReseauGTFS::avancerFenetre()).
+// Le réseau est construit pour la fenêtre [06:00, 06:00 + largeur), puis la fenêtre avance d'un pas à la fois. À chaque
+// pas, des données et un réseau neufs sont chargés pour la même fenêtre: le nombre d'arrêts doit être le même, et un
+// corpus de requêtes entre stations, tiré d'une graine donnée, doit donner les mêmes durées dans les deux réseaux.
+// Une seconde passe, sans comparaison, applique des retards aléatoires entre les pas et suit le nombre de retards
+// mémorisés pour les arrêts à venir, qui doit retomber à 0 une fois la journée écoulée. Les résultats sont écrits en
+// JSON sur la sortie standard.
+//
+// Usage: benchFenetre [dossier_gtfs] [date_AAAAMMJJ] [largeur_min] [pas_min] [requetes_par_pas] [graine]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    const unsigned int debutDeLaFenetre = 6 * 3600;
+    const unsigned int finDeLaJournee = 30 * 3600;   // au-delà des derniers voyages qui se poursuivent après minuit
+    const unsigned int retardsParPas = 200;          // retards aléatoires appliqués à chaque pas de la seconde passe
+    const unsigned int retardMaximal = 10 * 60;      // en secondes
+
+    Heure heure(unsigned int p_secondes) {
+        return Heure(0, 0, 0).add_secondes(p_secondes);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const Date date = argc > 2 ? dateDepuisArgument(argv[2], "benchFenetre") : Date(2020, 9, 25);
+    const unsigned int largeur = (argc > 3 ? stoul(argv[3]) : 120) * 60;
+    const unsigned int pas = (argc > 4 ? stoul(argv[4]) : 60) * 60;
+    const size_t requetesParPas = argc > 5 ? stoul(argv[5]) : 100;
+    const uint32_t graine = argc > 6 ? (uint32_t) stoul(argv[6]) : 2021;
+    if (pas == 0) throw logic_error("benchFenetre: le pas doit être positif");
+
+    // première passe: chaque avancement est comparé à une reconstruction complète
+    DonneesGTFS glissante(date, heure(debutDeLaFenetre), heure(debutDeLaFenetre + largeur));
+    glissante.activerFenetreGlissante();
+    glissante.chargerDossier(chemin_dossier);
+    ReseauGTFS reseau(glissante);
+
+    std::mt19937 generateur(graine);
+    vector<double> avancementsMs, reconstructionsMs;
+    size_t nbPas = 0, nbArretsDifferents = 0, nbRequetes = 0, nbDureesDifferentes = 0, nbAtteignables = 0;
+    for (unsigned int now1 = debutDeLaFenetre + pas; now1 + largeur <= finDeLaJournee; now1 += pas)
+    {
+        const unsigned int now2 = now1 + largeur;
+        auto t0 = chrono::steady_clock::now();
+        reseau.avancerFenetre(glissante, heure(now1), heure(now2));
+        auto t1 = chrono::steady_clock::now();
+        if (glissante.getNbArrets() == 0) break; // plus aucun arrêt: un chargement neuf échouerait
+        DonneesGTFS neuves(date, heure(now1), heure(now2));
+        neuves.chargerDossier(chemin_dossier);
+        ReseauGTFS reseauNeuf(neuves);
+        auto t2 = chrono::steady_clock::now();
+        avancementsMs.push_back(chrono::duration<double, milli>(t1 - t0).count());
+        reconstructionsMs.push_back(chrono::duration<double, milli>(t2 - t1).count());
+        ++nbPas;
+        if (glissante.getNbArrets() != neuves.getNbArrets()) ++nbArretsDifferents;
+
+        vector<unsigned int> station_ids;
+        for (const auto &station : neuves.getStations())
+            if (glissante.getStations().count(station.first)) station_ids.push_back(station.first);
+        if (station_ids.size() < 2) continue;
+        for (size_t i = 0; i < requetesParPas; ++i)
+        {
+            const unsigned int origine = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+            const unsigned int destination = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+            const Heure depart = heure(now1 + tirer(generateur, largeur / 2 + 1));
+            if (destination == origine) continue;
+            Itineraire parFenetre, parReconstruction;
+            StatistiquesRecherche statistiques;
+            const unsigned int dureeFenetre = reseau.calculerItineraireEntreStations(
+                    glissante, origine, destination, depart, parFenetre, statistiques);
+            const unsigned int dureeReconstruction = reseauNeuf.calculerItineraireEntreStations(
+                    neuves, origine, destination, depart, parReconstruction, statistiques);
+            ++nbRequetes;
+            if (parFenetre.estAtteignable()) ++nbAtteignables;
+            if (dureeFenetre != dureeReconstruction) ++nbDureesDifferentes;
+        }
+    }
+
+    // seconde passe: des retards sont reçus entre les pas; ceux des voyages terminés doivent être libérés
+    DonneesGTFS retardee(date, heure(debutDeLaFenetre), heure(debutDeLaFenetre + largeur));
+    retardee.activerFenetreGlissante();
+    retardee.chargerDossier(chemin_dossier);
+    ReseauGTFS reseauRetarde(retardee);
+    vector<string> voyage_ids;
+    for (const auto &voyage : retardee.getVoyages()) voyage_ids.push_back(voyage.first);
+    size_t nbRetardsAppliques = 0, maxRetardsAVenir = 0;
+    for (unsigned int now1 = debutDeLaFenetre + pas; now1 < finDeLaJournee + pas; now1 += pas)
+    {
+        vector<RetardVoyage> retards;
+        for (unsigned int i = 0; i < retardsParPas && !voyage_ids.empty(); ++i)
+        {
+            RetardVoyage retard;
+            retard.voyage_id = voyage_ids[tirer(generateur, (uint32_t) voyage_ids.size())];
+            retard.numero_sequence = 1 + tirer(generateur, 40);
+            retard.delai = (int) tirer(generateur, 2 * retardMaximal + 1) - (int) retardMaximal;
+            retards.push_back(retard);
+        }
+        reseauRetarde.appliquerRetards(retardee, retards);
+        nbRetardsAppliques += retards.size();
+        maxRetardsAVenir = max(maxRetardsAVenir, retardee.getNbRetardsAVenir());
+        const unsigned int debut = min(now1, finDeLaJournee);
+        reseauRetarde.avancerFenetre(retardee, heure(debut), heure(min(debut + largeur, finDeLaJournee)));
+    }
+
+    cout << fixed << setprecision(3) << "{\n";
+    cout << "  \"dossier\": \"" << chemin_dossier << "\",\n";
+    cout << "  \"largeur_min\": " << largeur / 60 << ",\n";
+    cout << "  \"pas_min\": " << pas / 60 << ",\n";
+    cout << "  \"pas\": " << nbPas << ",\n";
+    cout << "  \"pas_arrets_differents\": " << nbArretsDifferents << ",\n";
+    cout << "  \"requetes\": " << nbRequetes << ",\n";
+    cout << "  \"atteignables\": " << nbAtteignables << ",\n";
+    cout << "  \"durees_differentes\": " << nbDureesDifferentes << ",\n";
+    afficherDistribution(cout, "avancement_ms", avancementsMs);
+    afficherDistribution(cout, "reconstruction_ms", reconstructionsMs);
+    cout << "  \"retards_appliques\": " << nbRetardsAppliques << ",\n";
+    cout << "  \"retards_a_venir_max\": " << maxRetardsAVenir << ",\n";
+    cout << "  \"retards_a_venir_fin\": " << retardee.getNbRetardsAVenir() << ",\n";
+    cout << "  \"arrets_a_venir_fin\": " << retardee.getNbArretsAVenir() << "\n";
+    cout << "}\n";
+
+    return 0;
+}
@@ -0,0 +1,523 @@
+//
+// Banc d'essai reproductible du calcul d'itinéraires.
+// Le réseau est chargé une seule fois, puis un corpus fixe de requêtes (origine, destination, heure de départ), tiré
+// d'une graine donnée, est rejoué sans affichage. Les résultats sont écrits en JSON sur la sortie standard afin de
+// pouvoir comparer deux exécutions.
+// Un second corpus, concentré sur quelques paires populaires comme le trafic réel, est ensuite rejoué à travers un
+// CacheItineraires afin de mesurer son taux de succès et la latence qui en résulte. Chacune de ses réponses est ensuite
+// comparée, hors mesure, à une recherche directe entre les stations d'accrochage, dont la durée doit être la même, et
+// à une recherche partant à un centimètre de ces stations, qui ne doit s'en écarter que de l'arrondi de la marche.
+// Le début du corpus est enfin rejoué par la recherche multicritère (ReseauGTFS::calculerItinerairesPareto()) et par
+// la recherche d'itinéraires par des lignes différentes (ReseauGTFS::calculerAlternatives()), dont les coûts sont
+// comparés à celui de la recherche simple (ReseauGTFS::calculerItineraire()) sur les mêmes requêtes.
+// Un corpus hors station reprend les requêtes du premier en éloignant l'origine et la destination de 150 à 600 m de
+// leur station, de sorte que la marche aux extrémités ne soit pas nulle: il est rejoué par ajouterArcsOrigineDestination()
+// et itineraire(), puis par calculerItineraire(), dont les durées doivent être les mêmes.
+// Le réseau est enfin compacté (ReseauGTFS::compacterVoyages()): le corpus est rejoué juste avant et juste après, puis
+// le corpus hors station et les recherches multicritères le sont aussi, et leurs sommes de contrôle doivent être
+// celles du réseau développé. La réduction des sommets et des arcs et l'accélération des recherches sont rapportées.
+// Un rayon positif ajoute au réseau les trajets à pieds entre stations voisines; le temps de leur calcul et le nombre
+// d'arcs qui en résultent figurent dans les phases.
+//
+// Usage: benchItineraires [dossier_gtfs] [nombre_de_requetes] [graine] [date_AAAAMMJJ] [rayon_trajets_a_pied_km]
+//
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "cacheItineraires.h"
+#include "DonneesGTFS.h"
+#include "instrumentation.h"
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    //! \brief une requête du corpus
+    struct Requete {
+        unsigned int stationOrigine;
+        unsigned int stationDestination;
+        unsigned int departSecondes; // heure de départ, en secondes depuis 00:00:00
+    };
+
+    const unsigned int debutDesDeparts = 6 * 3600;    // les heures de départ sont tirées dans [06:00, 18:00)
+    const unsigned int plageDesDeparts = 12 * 3600;
+    const unsigned int finDeLaFenetre = 23 * 3600 + 59 * 60 + 59;
+    const size_t nbPairesPopulaires = 200;            // paires du corpus avec cache
+    const unsigned int ecartDesDepartsPopulaires = 900; // les départs d'une paire populaire s'étalent sur 15 minutes
+    const size_t capaciteDuCache = 1024;
+    const double rayonAccrochage = 0.15;              // km, celui de CacheItineraires par défaut
+    const double decalageReference = 1e-7;            // degrés (~1 cm): référence du cache hors des points confondus
+    const size_t nbRequetesPareto = 500;              // requêtes du corpus rejouées par la recherche multicritère
+    const unsigned int nbAlternatives = 3;            // itinéraires demandés à la recherche d'alternatives
+    const unsigned int retardMaximalAlternatives = 1800; // secondes
+    const unsigned int eloignementMin = 150;          // en mètres: éloignement des extrémités du corpus hors station
+    const unsigned int eloignementMax = 600;
+    const double metresParDegre = 111320.0;           // longueur d'un degré de latitude
+
+    //! \brief construit le corpus de requêtes; les paires trop proches pour nécessiter l'autobus sont rejetées
+    vector<Requete> construireCorpus(const DonneesGTFS &p_gtfs, size_t p_nbRequetes, uint32_t p_graine,
+                                     double p_distanceMin) {
+        vector<unsigned int> station_ids;
+        for (const auto &station : p_gtfs.getStations()) station_ids.push_back(station.first);
+        if (station_ids.size() < 2) throw logic_error("benchItineraires: il faut au moins deux stations");
+
+        std::mt19937 generateur(p_graine);
+        vector<Requete> corpus;
+        corpus.reserve(p_nbRequetes);
+        const size_t essaisMax = 1000 * p_nbRequetes;
+        for (size_t essai = 0; corpus.size() < p_nbRequetes; ++essai) {
+            if (essai == essaisMax)
+                throw logic_error("benchItineraires: impossible de trouver des paires de stations assez éloignées");
+            Requete requete;
+            requete.stationOrigine = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+            requete.stationDestination = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+            requete.departSecondes = debutDesDeparts + 60 * tirer(generateur, plageDesDeparts / 60);
+            const Coordonnees &origine = p_gtfs.getStations().at(requete.stationOrigine).getCoords();
+            const Coordonnees &destination = p_gtfs.getStations().at(requete.stationDestination).getCoords();
+            if (origine - destination > p_distanceMin) corpus.push_back(requete);
+        }
+        return corpus;
+    }
+
+    //! \brief requête entre deux points quelconques
+    struct RequeteEntrePoints {
+        Coordonnees origine;
+        Coordonnees destination;
+        unsigned int departSecondes;
+    };
+
+    //! \brief les requêtes du corpus, entre les coordonnées de leurs stations
+    vector<RequeteEntrePoints> corpusEntreStations(const DonneesGTFS &p_gtfs, const vector<Requete> &p_corpus) {
+        vector<RequeteEntrePoints> corpus;
+        corpus.reserve(p_corpus.size());
+        for (const Requete &requete : p_corpus)
+            corpus.push_back({p_gtfs.getStations().at(requete.stationOrigine).getCoords(),
+                              p_gtfs.getStations().at(requete.stationDestination).getCoords(), requete.departSecondes});
+        return corpus;
+    }
+
+    //! \brief le corpus hors station: chaque extrémité est éloignée de sa station de eloignementMin à eloignementMax
+    //! mètres, dans une direction quelconque
+    vector<RequeteEntrePoints> construireCorpusHorsStation(const DonneesGTFS &p_gtfs, const vector<Requete> &p_corpus,
+                                                           uint32_t p_graine) {
+        std::mt19937 generateur(p_graine + 2);
+        auto eloigner = [&generateur](const Coordonnees &p_coords) {
+            const double distance = eloignementMin + tirer(generateur, eloignementMax - eloignementMin + 1);
+            const double angle = 2 * M_PI * tirer(generateur, 360) / 360.0;
+            const double latitude = p_coords.getLatitude() + distance * cos(angle) / metresParDegre;
+            const double metresParDegreDeLongitude = metresParDegre * cos(p_coords.getLatitude() * M_PI / 180);
+            const double longitude = p_coords.getLongitude() + distance * sin(angle) / metresParDegreDeLongitude;
+            return Coordonnees(latitude, longitude);
+        };
+        vector<RequeteEntrePoints> corpus = corpusEntreStations(p_gtfs, p_corpus);
+        for (RequeteEntrePoints &requete : corpus) {
+            requete.origine = eloigner(requete.origine);
+            requete.destination = eloigner(requete.destination);
+        }
+        return corpus;
+    }
+
+    //! \brief requête du corpus avec cache: une paire populaire, choisie d'autant plus souvent que son rang est petit,
+    //! dont l'origine et la destination sont déplacées d'au plus une cinquantaine de mètres de leur station
+    vector<RequeteEntrePoints> construireCorpusPopulaire(const DonneesGTFS &p_gtfs, const vector<Requete> &p_corpus,
+                                                       size_t p_nbRequetes, uint32_t p_graine) {
+        std::mt19937 generateur(p_graine + 1);
+        const uint32_t nbPaires = (uint32_t) min(nbPairesPopulaires, p_corpus.size());
+        auto deplacer = [&generateur](const Coordonnees &p_coords) {
+            return Coordonnees(p_coords.getLatitude() + (double) ((int) tirer(generateur, 801) - 400) * 1e-6,
+                               p_coords.getLongitude() + (double) ((int) tirer(generateur, 801) - 400) * 1e-6);
+        };
+        vector<RequeteEntrePoints> corpus;
+        corpus.reserve(p_nbRequetes);
+        for (size_t i = 0; i < p_nbRequetes && nbPaires > 0; ++i) {
+            const Requete &paire = p_corpus[tirer(generateur, tirer(generateur, nbPaires) + 1)];
+            const Coordonnees origine = deplacer(p_gtfs.getStations().at(paire.stationOrigine).getCoords());
+            const Coordonnees destination = deplacer(p_gtfs.getStations().at(paire.stationDestination).getCoords());
+            corpus.push_back({origine, destination,
+                              paire.departSecondes + tirer(generateur, ecartDesDepartsPopulaires)});
+        }
+        return corpus;
+    }
+
+    //! \brief la station la plus proche de p_point, à au plus rayonAccrochage km, comme l'accrochage du cache; 0 si
+    //! aucune (les identifiants de station sont positifs)
+    unsigned int stationAccrochee(const DonneesGTFS &p_gtfs, const Coordonnees &p_point) {
+        unsigned int meilleure = 0;
+        double distanceMeilleure = rayonAccrochage;
+        for (const auto &station : p_gtfs.getStations()) {
+            double distance = p_point - station.second.getCoords();
+            if (distance != distance) distance = 0; // acos() d'un arrondi au-delà de 1: points confondus
+            if (distance <= distanceMeilleure) {
+                distanceMeilleure = distance;
+                meilleure = station.first;
+            }
+        }
+        return meilleure;
+    }
+
+    //! \brief mesures du rejeu d'un corpus par ajouterArcsOrigineDestination() et itineraire()
+    struct MesuresCorpus {
+        vector<double> latences, recherches, solutionnes, relaches, empiles, elaguees, arcsVersDestination;
+        size_t nbAtteignables = 0;
+        unsigned long long sommeDurees = 0; // somme de contrôle des durées de trajet, pour comparer les résultats
+        double dureeSecondes = 0.0;
+    };
+
+    MesuresCorpus rejouerCorpus(const DonneesGTFS &p_gtfs, ReseauGTFS &p_reseau,
+                                const vector<RequeteEntrePoints> &p_corpus) {
+        MesuresCorpus mesures;
+        mesures.latences.reserve(p_corpus.size());
+        auto debutRequetes = chrono::steady_clock::now();
+        for (const RequeteEntrePoints &requete : p_corpus) {
+            StatistiquesRecherche statistiques;
+            long tempsExecution(0);
+
+            auto t0 = chrono::steady_clock::now();
+            p_reseau.ajouterArcsOrigineDestination(p_gtfs, requete.origine, requete.destination,
+                                                   Heure(0, 0, 0).add_secondes(requete.departSecondes));
+            const size_t nbArcsVersDestination = p_reseau.getNbArcsStationsVersDestination();
+            unsigned int duree = p_reseau.itineraire(p_gtfs, false, tempsExecution, statistiques);
+            p_reseau.enleverArcsOrigineDestination();
+            auto t1 = chrono::steady_clock::now();
+
+            mesures.latences.push_back(chrono::duration<double, micro>(t1 - t0).count());
+            mesures.recherches.push_back((double) tempsExecution);
+            mesures.solutionnes.push_back((double) statistiques.sommetsSolutionnes);
+            mesures.relaches.push_back((double) statistiques.arcsRelaches);
+            mesures.empiles.push_back((double) statistiques.sommetsEmpiles);
+            mesures.elaguees.push_back((double) statistiques.etiquettesElaguees);
+            mesures.arcsVersDestination.push_back((double) nbArcsVersDestination);
+            if (duree != numeric_limits<unsigned int>::max()) {
+                ++mesures.nbAtteignables;
+                mesures.sommeDurees += duree;
+            }
+        }
+        mesures.dureeSecondes = chrono::duration<double>(chrono::steady_clock::now() - debutRequetes).count();
+        return mesures;
+    }
+
+    //! \brief mesures et sommes de contrôle du rejeu du début du corpus par les recherches multicritères
+    struct MesuresMulticriteres {
+        vector<double> latencesSimples, latencesPareto, taillesPareto, latencesAlternatives, taillesAlternatives;
+        unsigned long long sommeDureesSimples = 0, sommeDureesEntreStations = 0;
+        unsigned long long sommeDureesPareto = 0, sommeChangementsPareto = 0, sommeMarchePareto = 0;
+        unsigned long long sommeDureesAlternatives = 0;
+    };
+
+    double somme(const vector<double> &p_valeurs) {
+        double total = 0;
+        for (double valeur : p_valeurs) total += valeur;
+        return total;
+    }
+
+    //! \brief rejoue les nbRequetesPareto premières requêtes du corpus par calculerItineraire(),
+    //! calculerItinerairesPareto() et calculerAlternatives(), puis, hors mesure, par calculerItineraireEntreStations()
+    MesuresMulticriteres rejouerMulticriteres(const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau,
+                                              const vector<Requete> &p_corpus) {
+        MesuresMulticriteres mesures;
+        for (size_t i = 0; i < min(nbRequetesPareto, p_corpus.size()); ++i) {
+            const Requete &requete = p_corpus[i];
+            const Coordonnees &origine = p_gtfs.getStations().at(requete.stationOrigine).getCoords();
+            const Coordonnees &destination = p_gtfs.getStations().at(requete.stationDestination).getCoords();
+            const Heure depart = Heure(0, 0, 0).add_secondes(requete.departSecondes);
+            Itineraire itineraire;
+            vector<ItinerairePareto> itineraires;
+            vector<Itineraire> alternatives;
+            StatistiquesRecherche statistiques;
+            auto t0 = chrono::steady_clock::now();
+            const unsigned int duree = p_reseau.calculerItineraire(p_gtfs, origine, destination, depart, itineraire,
+                                                                   statistiques);
+            auto t1 = chrono::steady_clock::now();
+            p_reseau.calculerItinerairesPareto(p_gtfs, origine, destination, depart, itineraires, statistiques);
+            auto t2 = chrono::steady_clock::now();
+            p_reseau.calculerAlternatives(p_gtfs, origine, destination, depart, nbAlternatives,
+                                          retardMaximalAlternatives, alternatives, statistiques);
+            auto t3 = chrono::steady_clock::now();
+            mesures.latencesSimples.push_back(chrono::duration<double, micro>(t1 - t0).count());
+            mesures.latencesPareto.push_back(chrono::duration<double, micro>(t2 - t1).count());
+            mesures.taillesPareto.push_back((double) itineraires.size());
+            mesures.latencesAlternatives.push_back(chrono::duration<double, micro>(t3 - t2).count());
+            mesures.taillesAlternatives.push_back((double) alternatives.size());
+            if (duree != numeric_limits<unsigned int>::max()) mesures.sommeDureesSimples += duree;
+            for (const ItinerairePareto &pareto : itineraires) {
+                mesures.sommeDureesPareto += pareto.itineraire.duree;
+                mesures.sommeChangementsPareto += pareto.nbChangements;
+                mesures.sommeMarchePareto += pareto.secondesDeMarche;
+            }
+            for (const Itineraire &alternative : alternatives) mesures.sommeDureesAlternatives += alternative.duree;
+            const unsigned int dureeEntreStations =
+                    p_reseau.calculerItineraireEntreStations(p_gtfs, requete.stationOrigine,
+                                                             requete.stationDestination, depart, itineraire,
+                                                             statistiques);
+            if (dureeEntreStations != numeric_limits<unsigned int>::max())
+                mesures.sommeDureesEntreStations += dureeEntreStations;
+        }
+        return mesures;
+    }
+
+    //! \brief somme des durées de calculerItineraire() sur un corpus
+    unsigned long long sommeDureesCalculees(const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau,
+                                            const vector<RequeteEntrePoints> &p_corpus) {
+        unsigned long long sommeDurees = 0;
+        for (const RequeteEntrePoints &requete : p_corpus) {
+            Itineraire itineraire;
+            StatistiquesRecherche statistiques;
+            const unsigned int duree = p_reseau.calculerItineraire(p_gtfs, requete.origine, requete.destination,
+                                                                   Heure(0, 0, 0).add_secondes(requete.departSecondes),
+                                                                   itineraire, statistiques);
+            if (duree != numeric_limits<unsigned int>::max()) sommeDurees += duree;
+        }
+        return sommeDurees;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const size_t nbRequetes = argc > 2 ? stoul(argv[2]) : 2000;
+    const uint32_t graine = argc > 3 ? (uint32_t) stoul(argv[3]) : 2021;
+    const Date date = argc > 4 ? dateDepuisArgument(argv[4], "benchItineraires") : Date(2020, 9, 25);
+    const double rayonTrajetsAPied = argc > 5 ? stod(argv[5]) : 0.0;
+    const Heure now1 = Heure(0, 0, 0).add_secondes(debutDesDeparts);
+    const Heure now2 = Heure(0, 0, 0).add_secondes(finDeLaFenetre);
+
+    // seuls le chargement et la construction sont instrumentés; les requêtes sont mesurées ci-dessous
+    Instrumentation instrumentation;
+    auto debut = chrono::steady_clock::now();
+    DonneesGTFS donnees(date, now1, now2);
+    donnees.setInstrumentation(&instrumentation);
+    donnees.chargerDossier(chemin_dossier);
+    if (rayonTrajetsAPied > 0) donnees.calculerTrajetsAPied(rayonTrajetsAPied);
+    auto finChargement = chrono::steady_clock::now();
+    ReseauGTFS reseau(donnees);
+    auto finConstruction = chrono::steady_clock::now();
+    donnees.setInstrumentation(nullptr);
+    reseau.setInstrumentation(nullptr);
+
+    const vector<Requete> corpus = construireCorpus(donnees, nbRequetes, graine, 2.1 * reseau.getDistMaxMarche());
+
+    // réchauffement des caches et de l'allocateur sur le début du corpus, hors mesure
+    const size_t nbRechauffement = min<size_t>(100, corpus.size() / 10);
+    for (size_t i = 0; i < nbRechauffement; ++i) {
+        const Requete &requete = corpus[i];
+        reseau.ajouterArcsOrigineDestination(donnees, donnees.getStations().at(requete.stationOrigine).getCoords(),
+                                             donnees.getStations().at(requete.stationDestination).getCoords(),
+                                             Heure(0, 0, 0).add_secondes(requete.departSecondes));
+        long tempsExecution(0);
+        reseau.itineraire(donnees, false, tempsExecution);
+        reseau.enleverArcsOrigineDestination();
+    }
+
+    const MesuresCorpus mesures = rejouerCorpus(donnees, reseau, corpusEntreStations(donnees, corpus));
+
+    // corpus hors station: superposition, puis recherche sans modifier le réseau, qui doit donner les mêmes durées
+    const vector<RequeteEntrePoints> corpusHorsStation = construireCorpusHorsStation(donnees, corpus, graine);
+    const MesuresCorpus mesuresHorsStation = rejouerCorpus(donnees, reseau, corpusHorsStation);
+    vector<double> latencesHorsStation, solutionnesHorsStation, elagueesHorsStation;
+    unsigned long long sommeDureesHorsStation = 0;
+    for (const RequeteEntrePoints &requete : corpusHorsStation) {
+        Itineraire itineraire;
+        StatistiquesRecherche statistiques;
+        auto t0 = chrono::steady_clock::now();
+        const unsigned int duree = reseau.calculerItineraire(donnees, requete.origine, requete.destination,
+                                                             Heure(0, 0, 0).add_secondes(requete.departSecondes),
+                                                             itineraire, statistiques);
+        auto t1 = chrono::steady_clock::now();
+        latencesHorsStation.push_back(chrono::duration<double, micro>(t1 - t0).count());
+        solutionnesHorsStation.push_back((double) statistiques.sommetsSolutionnes);
+        elagueesHorsStation.push_back((double) statistiques.etiquettesElaguees);
+        if (duree != numeric_limits<unsigned int>::max()) sommeDureesHorsStation += duree;
+    }
+
+    CacheItineraires cache(capaciteDuCache, 300, rayonAccrochage);
+    const vector<RequeteEntrePoints> corpusPopulaire =
+            construireCorpusPopulaire(donnees, corpus, corpus.size(), graine);
+    vector<double> latencesCache, latencesSucces, latencesEchecs;
+    vector<unsigned int> dureesCache;
+    latencesCache.reserve(corpusPopulaire.size());
+    dureesCache.reserve(corpusPopulaire.size());
+    for (const RequeteEntrePoints &requete : corpusPopulaire) {
+        Itineraire itineraire;
+        StatistiquesRecherche statistiques;
+        const size_t succesAvant = cache.getStatistiques().succes;
+        auto t0 = chrono::steady_clock::now();
+        dureesCache.push_back(cache.calculerItineraire(donnees, reseau, requete.origine, requete.destination,
+                                                       Heure(0, 0, 0).add_secondes(requete.departSecondes),
+                                                       itineraire, statistiques));
+        auto t1 = chrono::steady_clock::now();
+        const double latence = chrono::duration<double, micro>(t1 - t0).count();
+        latencesCache.push_back(latence);
+        (cache.getStatistiques().succes > succesAvant ? latencesSucces : latencesEchecs).push_back(latence);
+    }
+    const CacheItineraires::Statistiques statistiquesCache = cache.getStatistiques();
+
+    // vérification, hors mesure: chaque réponse du cache doit être la durée d'une recherche directe entre les stations
+    // d'accrochage, à la même heure de départ. Une seconde référence part à un centimètre de ces stations, de sorte
+    // qu'elle ne dépende pas du traitement des points confondus avec une station: seul l'arrondi des temps de marche,
+    // d'au plus une seconde à chaque extrémité, l'en sépare.
+    size_t nbCacheVerifiees = 0, nbCacheDifferentes = 0;
+    unsigned int ecartMaxDecale = 0;
+    for (size_t i = 0; i < corpusPopulaire.size(); ++i) {
+        const unsigned int origine = stationAccrochee(donnees, corpusPopulaire[i].origine);
+        const unsigned int destination = stationAccrochee(donnees, corpusPopulaire[i].destination);
+        if (origine == 0 || destination == 0) continue;
+        auto decaler = [&donnees](unsigned int p_station) {
+            const Coordonnees &coords = donnees.getStations().at(p_station).getCoords();
+            return Coordonnees(coords.getLatitude() + decalageReference, coords.getLongitude());
+        };
+        const Heure depart = Heure(0, 0, 0).add_secondes(corpusPopulaire[i].departSecondes);
+        Itineraire itineraire;
+        StatistiquesRecherche statistiques;
+        const unsigned int duree = reseau.calculerItineraire(donnees, donnees.getStations().at(origine).getCoords(),
+                                                             donnees.getStations().at(destination).getCoords(), depart,
+                                                             itineraire, statistiques);
+        const unsigned int dureeDecalee = reseau.calculerItineraire(donnees, decaler(origine), decaler(destination),
+                                                                    depart, itineraire, statistiques);
+        ++nbCacheVerifiees;
+        if (duree != dureesCache[i]) ++nbCacheDifferentes;
+        ecartMaxDecale = max(ecartMaxDecale, max(dureeDecalee, dureesCache[i]) - min(dureeDecalee, dureesCache[i]));
+    }
+
+    const MesuresMulticriteres multicriteres = rejouerMulticriteres(donnees, reseau, corpus);
+    const double sommeSimples = somme(multicriteres.latencesSimples);
+
+    // compaction des arrêts de passage: le corpus est rejoué juste avant et juste après, sur les mêmes requêtes, et
+    // chaque recherche doit donner les mêmes sommes de contrôle
+    const vector<RequeteEntrePoints> corpusStations = corpusEntreStations(donnees, corpus);
+    const MesuresCorpus mesuresAvantCompaction = rejouerCorpus(donnees, reseau, corpusStations);
+    const size_t sommetsAvantCompaction = reseau.getNbSommets(), arcsAvantCompaction = reseau.getNbArcs();
+    auto debutCompaction = chrono::steady_clock::now();
+    reseau.compacterVoyages();
+    auto finCompaction = chrono::steady_clock::now();
+    const MesuresCorpus mesuresCompacte = rejouerCorpus(donnees, reseau, corpusStations);
+    const MesuresCorpus mesuresHorsStationCompacte = rejouerCorpus(donnees, reseau, corpusHorsStation);
+    const unsigned long long sommeCalculHorsStationCompacte =
+            sommeDureesCalculees(donnees, reseau, corpusHorsStation);
+    const MesuresMulticriteres multicriteresCompacte = rejouerMulticriteres(donnees, reseau, corpus);
+
+    cout << fixed << setprecision(3) << "{\n";
+    cout << "  \"dossier\": \"" << chemin_dossier << "\",\n";
+    cout << "  \"date\": \"" << date << "\",\n";
+    cout << "  \"graine\": " << graine << ",\n";
+    cout << "  \"requetes\": " << corpus.size() << ",\n";
+    cout << "  \"rayon_trajets_a_pied_km\": " << rayonTrajetsAPied << ",\n";
+    cout << "  \"trajets_a_pied\": " << donnees.getTrajetsAPied().size() << ",\n";
+    cout << "  \"chargement_ms\": " << chrono::duration<double, milli>(finChargement - debut).count() << ",\n";
+    cout << "  \"construction_ms\": " << chrono::duration<double, milli>(finConstruction - finChargement).count()
+         << ",\n";
+    cout << "  \"phases\": [";
+    const vector<Instrumentation::Phase> &phases = instrumentation.getPhases();
+    for (size_t i = 0; i < phases.size(); ++i)
+        cout << (i ? ",\n" : "\n") << "    {\"nom\": \"" << phases[i].nom << "\", \"duree_ms\": " << phases[i].dureeMs
+             << ", \"elements\": " << phases[i].nbElements << "}";
+    cout << "\n  ],\n";
+    cout << "  \"arrets\": " << donnees.getNbArrets() << ",\n";
+    cout << "  \"arcs\": " << reseau.getNbArcs() << ",\n";
+    cout << "  \"atteignables\": " << mesures.nbAtteignables << ",\n";
+    cout << "  \"somme_durees_trajet\": " << mesures.sommeDurees << ",\n";
+    afficherDistribution(cout, "latence_us", mesures.latences);
+    afficherDistribution(cout, "recherche_us", mesures.recherches);
+    afficherDistribution(cout, "sommets_solutionnes", mesures.solutionnes);
+    afficherDistribution(cout, "arcs_relaches", mesures.relaches);
+    afficherDistribution(cout, "sommets_empiles", mesures.empiles);
+    afficherDistribution(cout, "etiquettes_elaguees", mesures.elaguees);
+    afficherDistribution(cout, "arcs_vers_destination", mesures.arcsVersDestination);
+    cout << "  \"hors_station_atteignables\": " << mesuresHorsStation.nbAtteignables << ",\n";
+    cout << "  \"hors_station_somme_durees_trajet\": " << mesuresHorsStation.sommeDurees << ",\n";
+    afficherDistribution(cout, "hors_station_latence_us", mesuresHorsStation.latences);
+    afficherDistribution(cout, "hors_station_recherche_us", mesuresHorsStation.recherches);
+    afficherDistribution(cout, "hors_station_sommets_solutionnes", mesuresHorsStation.solutionnes);
+    afficherDistribution(cout, "hors_station_etiquettes_elaguees", mesuresHorsStation.elaguees);
+    cout << "  \"hors_station_calcul_somme_durees_trajet\": " << sommeDureesHorsStation << ",\n";
+    afficherDistribution(cout, "hors_station_calcul_latence_us", latencesHorsStation);
+    afficherDistribution(cout, "hors_station_calcul_sommets_solutionnes", solutionnesHorsStation);
+    afficherDistribution(cout, "hors_station_calcul_etiquettes_elaguees", elagueesHorsStation);
+    cout << "  \"cache_succes\": " << statistiquesCache.succes << ",\n";
+    cout << "  \"cache_echecs\": " << statistiquesCache.echecs << ",\n";
+    cout << "  \"cache_hors_cache\": " << statistiquesCache.horsCache << ",\n";
+    cout << "  \"cache_evictions\": " << statistiquesCache.evictions << ",\n";
+    cout << "  \"cache_verifiees\": " << nbCacheVerifiees << ",\n";
+    cout << "  \"cache_durees_differentes\": " << nbCacheDifferentes << ",\n";
+    cout << "  \"cache_ecart_max_a_un_centimetre_s\": " << ecartMaxDecale << ",\n";
+    cout << "  \"cache_taux_succes\": "
+         << (latencesCache.empty() ? 0.0 : (double) statistiquesCache.succes / latencesCache.size()) << ",\n";
+    afficherDistribution(cout, "cache_latence_us", latencesCache);
+    afficherDistribution(cout, "cache_latence_succes_us", latencesSucces);
+    afficherDistribution(cout, "cache_latence_echec_us", latencesEchecs);
+    afficherDistribution(cout, "pareto_latence_us", multicriteres.latencesPareto);
+    afficherDistribution(cout, "pareto_taille", multicriteres.taillesPareto);
+    cout << "  \"pareto_cout_relatif\": "
+         << (sommeSimples > 0 ? somme(multicriteres.latencesPareto) / sommeSimples : 0.0) << ",\n";
+    cout << "  \"alternatives_demandees\": " << nbAlternatives << ",\n";
+    afficherDistribution(cout, "alternatives_latence_us", multicriteres.latencesAlternatives);
+    afficherDistribution(cout, "alternatives_taille", multicriteres.taillesAlternatives);
+    cout << "  \"alternatives_cout_relatif\": "
+         << (sommeSimples > 0 ? somme(multicriteres.latencesAlternatives) / sommeSimples : 0.0) << ",\n";
+    cout << "  \"compaction_ms\": " << chrono::duration<double, milli>(finCompaction - debutCompaction).count()
+         << ",\n";
+    cout << "  \"compacte_sommets_avant\": " << sommetsAvantCompaction << ",\n";
+    cout << "  \"compacte_sommets_apres\": " << reseau.getNbSommets() << ",\n";
+    cout << "  \"compacte_arcs_avant\": " << arcsAvantCompaction << ",\n";
+    cout << "  \"compacte_arcs_apres\": " << reseau.getNbArcs() << ",\n";
+    cout << "  \"compacte_arrets_contractes\": " << reseau.getNbArretsContractes() << ",\n";
+    cout << "  \"compacte_raccourcis\": " << reseau.getNbRaccourcis() << ",\n";
+    cout << "  \"compacte_somme_durees_trajet_avant\": " << mesuresAvantCompaction.sommeDurees << ",\n";
+    cout << "  \"compacte_somme_durees_trajet\": " << mesuresCompacte.sommeDurees << ",\n";
+    cout << "  \"compacte_hors_station_somme_durees_trajet\": " << mesuresHorsStationCompacte.sommeDurees << ",\n";
+    cout << "  \"compacte_hors_station_calcul_somme_durees_trajet\": " << sommeCalculHorsStationCompacte << ",\n";
+    const MesuresMulticriteres *sommesMulticriteres[] = {&multicriteres, &multicriteresCompacte};
+    for (size_t i = 0; i < 2; ++i) {
+        const MesuresMulticriteres &sommes = *sommesMulticriteres[i];
+        const string suffixe = i == 0 ? "_avant" : "";
+        cout << "  \"compacte_simple_somme_durees" << suffixe << "\": " << sommes.sommeDureesSimples << ",\n";
+        cout << "  \"compacte_entre_stations_somme_durees" << suffixe << "\": " << sommes.sommeDureesEntreStations
+             << ",\n";
+        cout << "  \"compacte_pareto_itineraires" << suffixe << "\": " << somme(sommes.taillesPareto) << ",\n";
+        cout << "  \"compacte_pareto_somme_durees" << suffixe << "\": " << sommes.sommeDureesPareto << ",\n";
+        cout << "  \"compacte_pareto_somme_changements" << suffixe << "\": " << sommes.sommeChangementsPareto
+             << ",\n";
+        cout << "  \"compacte_pareto_somme_marche" << suffixe << "\": " << sommes.sommeMarchePareto << ",\n";
+        cout << "  \"compacte_alternatives_itineraires" << suffixe << "\": " << somme(sommes.taillesAlternatives)
+             << ",\n";
+        cout << "  \"compacte_alternatives_somme_durees" << suffixe << "\": " << sommes.sommeDureesAlternatives
+             << ",\n";
+    }
+    afficherDistribution(cout, "compacte_recherche_us_avant", mesuresAvantCompaction.recherches);
+    afficherDistribution(cout, "compacte_recherche_us", mesuresCompacte.recherches);
+    afficherDistribution(cout, "compacte_latence_us_avant", mesuresAvantCompaction.latences);
+    afficherDistribution(cout, "compacte_latence_us", mesuresCompacte.latences);
+    afficherDistribution(cout, "compacte_sommets_solutionnes", mesuresCompacte.solutionnes);
+    afficherDistribution(cout, "compacte_arcs_relaches", mesuresCompacte.relaches);
+    const double sommeRecherchesCompacte = somme(mesuresCompacte.recherches);
+    const double sommeLatencesCompacte = somme(mesuresCompacte.latences);
+    const double sommeSimplesCompacte = somme(multicriteresCompacte.latencesSimples);
+    cout << "  \"compacte_acceleration_recherche\": "
+         << (sommeRecherchesCompacte > 0 ? somme(mesuresAvantCompaction.recherches) / sommeRecherchesCompacte : 0.0)
+         << ",\n";
+    cout << "  \"compacte_acceleration_latence\": "
+         << (sommeLatencesCompacte > 0 ? somme(mesuresAvantCompaction.latences) / sommeLatencesCompacte : 0.0)
+         << ",\n";
+    cout << "  \"compacte_acceleration_calcul\": "
+         << (sommeSimplesCompacte > 0 ? sommeSimples / sommeSimplesCompacte : 0.0) << ",\n";
+    cout << "  \"compacte_acceleration_pareto\": "
+         << (somme(multicriteresCompacte.latencesPareto) > 0
+             ? somme(multicriteres.latencesPareto) / somme(multicriteresCompacte.latencesPareto) : 0.0) << ",\n";
+    rusage ressources;
+    getrusage(RUSAGE_SELF, &ressources);
+    cout << "  \"rss_max_ko\": " << ressources.ru_maxrss << ",\n"; // en Ko sous Linux
+    cout << "  \"requetes_par_seconde\": " << (mesures.dureeSecondes > 0 ? corpus.size() / mesures.dureeSecondes : 0.0) << "\n";
+    cout << "}\n";
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+//
+// Banc d'essai des mises à jour en temps réel du réseau GTFS.
+// Un fil d'exécution applique des retards aléatoires (comme le ferait un flux GTFS-Realtime) pendant qu'un autre
+// continue de calculer des itinéraires; on mesure le débit des mises à jour et celui des requêtes.
+//
+// Usage: benchTempsReel [dossier_gtfs] [durée_en_secondes] [fichier_de_retards]
+//
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "DonneesGTFS.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const double dureeSecondes = argc > 2 ? stod(argv[2]) : 5.0;
+    Date today(2020, 9, 25);
+    Heure now1(7, 30, 0);
+    Heure now2 = now1.add_secondes(72000);
+
+    DonneesGTFS donnees_rtc(today, now1, now2);
+    donnees_rtc.chargerDossier(chemin_dossier);
+    ReseauGTFS reseau_rtc(donnees_rtc);
+    cout << "Nombre d'arrêts = " << donnees_rtc.getNbArrets() << ", nombre d'arcs = " << reseau_rtc.getNbArcs() << endl;
+
+    if (argc > 3)
+    {
+        vector<RetardVoyage> retards = donnees_rtc.lireRetards(argv[3]);
+        auto debut = chrono::steady_clock::now();
+        reseau_rtc.appliquerRetards(donnees_rtc, retards);
+        auto fin = chrono::steady_clock::now();
+        cout << retards.size() << " retards du fichier " << argv[3] << " appliqués en "
+             << chrono::duration_cast<chrono::microseconds>(fin - debut).count() << " microsecondes" << endl;
+    }
+
+    vector<unsigned int> station_ids;
+    for (const auto &station : donnees_rtc.getStations()) station_ids.push_back(station.first);
+    vector<string> voyage_ids;
+    for (const auto &voyage : donnees_rtc.getVoyages()) voyage_ids.push_back(voyage.first);
+
+    mutex verrou; // les requêtes modifient temporairement le graphe (points origine et destination)
+    atomic<bool> arreter(false);
+    unsigned long nbRequetes = 0;
+    unsigned long nbMisesAJour = 0;
+    long dureeMisesAJour = 0; // en microsecondes, verrou détenu
+    long dureeMaxMiseAJour = 0;
+
+    thread requetes([&]()
+    {
+        std::mt19937 generateur(653);
+        std::uniform_int_distribution<size_t> distribution(0, station_ids.size() - 1);
+        const auto &stations = donnees_rtc.getStations();
+        while (!arreter)
+        {
+            Coordonnees pointOrigine = stations.at(station_ids[distribution(generateur)]).getCoords();
+            Coordonnees pointDestination = stations.at(station_ids[distribution(generateur)]).getCoords();
+            if (pointOrigine - pointDestination <= 2.1 * reseau_rtc.getDistMaxMarche()) continue;
+
+            lock_guard<mutex> garde(verrou);
+            reseau_rtc.ajouterArcsOrigineDestination(donnees_rtc, pointOrigine, pointDestination);
+            long tempsExecution(0);
+            reseau_rtc.itineraire(donnees_rtc, false, tempsExecution);
+            reseau_rtc.enleverArcsOrigineDestination();
+            ++nbRequetes;
+        }
+    });
+
+    thread misesAJour([&]()
+    {
+        std::mt19937 generateur(2021);
+        std::uniform_int_distribution<size_t> choixVoyage(0, voyage_ids.size() - 1);
+        std::uniform_int_distribution<int> choixDelai(-120, 300);
+        while (!arreter)
+        {
+            RetardVoyage retard;
+            retard.voyage_id = voyage_ids[choixVoyage(generateur)];
+            const auto &arrets = donnees_rtc.getVoyages().at(retard.voyage_id).getArrets();
+            std::uniform_int_distribution<size_t> choixArret(0, arrets.size() - 1);
+            auto itArret = arrets.begin();
+            advance(itArret, choixArret(generateur));
+            retard.numero_sequence = (*itArret)->getNumeroSequence();
+            retard.delai = choixDelai(generateur);
+
+            lock_guard<mutex> garde(verrou);
+            auto debut = chrono::steady_clock::now();
+            reseau_rtc.appliquerRetards(donnees_rtc, vector<RetardVoyage>(1, retard));
+            auto fin = chrono::steady_clock::now();
+            long duree = chrono::duration_cast<chrono::microseconds>(fin - debut).count();
+            dureeMisesAJour += duree;
+            dureeMaxMiseAJour = max(dureeMaxMiseAJour, duree);
+            ++nbMisesAJour;
+        }
+    });
+
+    this_thread::sleep_for(chrono::duration<double>(dureeSecondes));
+    arreter = true;
+    requetes.join();
+    misesAJour.join();
+
+    cout << "Durée de la mesure: " << dureeSecondes << " secondes" << endl;
+    cout << "Mises à jour appliquées: " << nbMisesAJour << " (" << nbMisesAJour / dureeSecondes << " par seconde)"
+         << endl;
+    cout << "Temps moyen d'une mise à jour: " << (nbMisesAJour ? (double) dureeMisesAJour / nbMisesAJour : 0.0)
+         << " microsecondes (max " << dureeMaxMiseAJour << ")" << endl;
+    cout << "Requêtes d'itinéraire effectuées en parallèle: " << nbRequetes << " (" << nbRequetes / dureeSecondes
+         << " par seconde)" << endl;
+
+    return 0;
+}
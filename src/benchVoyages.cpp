@@ -0,0 +1,129 @@
+//
+// Banc d'essai du routage par voyages (ReseauGTFS::preparerRoutageParVoyages()).
+// Le réseau est construit avec instrumentation, ce qui donne le nombre d'arcs de transfert, de trajet à pieds et
+// d'attente du graphe; les transferts entre voyages sont ensuite précalculés et comptés à chaque étape (initiaux,
+// demi-tours écartés, dominés écartés, gardés). Un corpus de requêtes entre stations, tiré d'une graine donnée, est
+// calculé à la fois par RoutageParVoyages::calculerItineraire() et par ReseauGTFS::calculerItineraireEntreStations()
+// afin de comparer leurs latences et leurs heures d'arrivée. Les résultats sont écrits en JSON sur la sortie standard.
+//
+// Usage: benchVoyages [dossier_gtfs] [date_AAAAMMJJ] [rayon_trajets_a_pied_km] [nombre_de_requetes] [graine]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    const unsigned int debutDesDeparts = 6 * 3600;    // les heures de départ sont tirées dans [06:00, 18:00)
+    const unsigned int plageDesDeparts = 12 * 3600;
+    const unsigned int finDeLaFenetre = 23 * 3600 + 59 * 60 + 59;
+
+    //! \brief nombre d'éléments de la phase p_nom (0 si elle n'a pas été mesurée)
+    size_t elementsDeLaPhase(const Instrumentation &p_instrumentation, const string &p_nom) {
+        for (const Instrumentation::Phase &phase : p_instrumentation.getPhases())
+            if (phase.nom == p_nom) return phase.nbElements;
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const Date date = argc > 2 ? dateDepuisArgument(argv[2], "benchVoyages") : Date(2020, 9, 25);
+    const double rayonTrajetsAPied = argc > 3 ? stod(argv[3]) : 0.0;
+    const size_t nbRequetes = argc > 4 ? stoul(argv[4]) : 2000;
+    const uint32_t graine = argc > 5 ? (uint32_t) stoul(argv[5]) : 2021;
+
+    DonneesGTFS donnees(date, Heure(0, 0, 0).add_secondes(debutDesDeparts),
+                        Heure(0, 0, 0).add_secondes(finDeLaFenetre));
+    donnees.chargerDossier(chemin_dossier);
+    if (rayonTrajetsAPied > 0) donnees.calculerTrajetsAPied(rayonTrajetsAPied);
+
+    // le réseau reprend l'instrumentation des données: elle compte les arcs de chaque famille
+    Instrumentation instrumentation;
+    donnees.setInstrumentation(&instrumentation);
+    ReseauGTFS reseau(donnees);
+    donnees.setInstrumentation(nullptr);
+    reseau.setInstrumentation(nullptr);
+    const size_t arcsTransferts = elementsDeLaPhase(instrumentation, "ajouterArcsTransferts");
+    const size_t arcsTrajetsAPied = elementsDeLaPhase(instrumentation, "ajouterArcsTrajetsAPied");
+    const size_t arcsAttente = elementsDeLaPhase(instrumentation, "ajouterArcsAttente");
+
+    auto debut = chrono::steady_clock::now();
+    const RoutageParVoyages routage = reseau.preparerRoutageParVoyages(donnees);
+    const double preparationMs = chrono::duration<double, milli>(chrono::steady_clock::now() - debut).count();
+
+    vector<unsigned int> station_ids;
+    for (const auto &station : donnees.getStations()) station_ids.push_back(station.first);
+    if (station_ids.size() < 2) throw logic_error("benchVoyages: il faut au moins deux stations");
+    std::mt19937 generateur(graine);
+    vector<double> latencesVoyages, latencesGraphe, segments;
+    size_t nbAtteignables = 0, nbEgales = 0, nbPlusTot = 0, nbPlusTard = 0;
+    for (size_t i = 0; i < nbRequetes; ++i)
+    {
+        const unsigned int origine = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+        const unsigned int destination = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+        const Heure depart = Heure(0, 0, 0).add_secondes(debutDesDeparts + tirer(generateur, plageDesDeparts));
+        if (destination == origine) continue;
+        Itineraire parVoyages, parGraphe;
+        StatistiquesRecherche statistiquesVoyages, statistiquesGraphe;
+        auto t0 = chrono::steady_clock::now();
+        const unsigned int dureeVoyages =
+                routage.calculerItineraire(origine, destination, depart, parVoyages, statistiquesVoyages);
+        auto t1 = chrono::steady_clock::now();
+        const unsigned int dureeGraphe = reseau.calculerItineraireEntreStations(donnees, origine, destination, depart,
+                                                                                parGraphe, statistiquesGraphe);
+        auto t2 = chrono::steady_clock::now();
+        latencesVoyages.push_back(chrono::duration<double, micro>(t1 - t0).count());
+        latencesGraphe.push_back(chrono::duration<double, micro>(t2 - t1).count());
+        segments.push_back((double) statistiquesVoyages.sommetsSolutionnes);
+        if (parGraphe.estAtteignable() || parVoyages.estAtteignable()) ++nbAtteignables;
+        if (dureeVoyages == dureeGraphe) ++nbEgales;
+        else if (dureeVoyages < dureeGraphe) ++nbPlusTot;
+        else ++nbPlusTard;
+    }
+    double sommeVoyages = 0, sommeGraphe = 0;
+    for (double latence : latencesVoyages) sommeVoyages += latence;
+    for (double latence : latencesGraphe) sommeGraphe += latence;
+
+    cout << fixed << setprecision(3) << "{\n";
+    cout << "  \"dossier\": \"" << chemin_dossier << "\",\n";
+    cout << "  \"rayon_trajets_a_pied_km\": " << rayonTrajetsAPied << ",\n";
+    cout << "  \"stations\": " << donnees.getNbStations() << ",\n";
+    cout << "  \"arrets\": " << donnees.getNbArrets() << ",\n";
+    cout << "  \"voyages\": " << routage.getNbVoyages() << ",\n";
+    cout << "  \"arcs_transferts\": " << arcsTransferts << ",\n";
+    cout << "  \"arcs_trajets_a_pied\": " << arcsTrajetsAPied << ",\n";
+    cout << "  \"arcs_attente\": " << arcsAttente << ",\n";
+    cout << "  \"arcs_hors_voyage\": " << arcsTransferts + arcsTrajetsAPied + arcsAttente << ",\n";
+    cout << "  \"preparation_ms\": " << preparationMs << ",\n";
+    cout << "  \"regles_de_transfert\": " << routage.getNbReglesDeTransfert() << ",\n";
+    cout << "  \"transferts_initiaux\": " << routage.getNbTransfertsInitiaux() << ",\n";
+    cout << "  \"demi_tours\": " << routage.getNbDemiTours() << ",\n";
+    cout << "  \"transferts_domines\": "
+         << routage.getNbTransfertsInitiaux() - routage.getNbDemiTours() - routage.getNbTransferts() << ",\n";
+    cout << "  \"transferts_gardes\": " << routage.getNbTransferts() << ",\n";
+    cout << "  \"octets_memoire\": " << routage.getTailleEnOctets() << ",\n";
+    cout << "  \"requetes\": " << latencesVoyages.size() << ",\n";
+    cout << "  \"atteignables\": " << nbAtteignables << ",\n";
+    cout << "  \"arrivees_egales\": " << nbEgales << ",\n";
+    cout << "  \"arrivees_plus_tot\": " << nbPlusTot << ",\n";
+    cout << "  \"arrivees_plus_tard\": " << nbPlusTard << ",\n";
+    afficherDistribution(cout, "segments_parcourus", segments);
+    afficherDistribution(cout, "voyages_latence_us", latencesVoyages);
+    afficherDistribution(cout, "graphe_latence_us", latencesGraphe);
+    cout << "  \"acceleration\": " << (sommeVoyages > 0 ? sommeGraphe / sommeVoyages : 0.0) << "\n";
+    cout << "}\n";
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+//
+// Cache des résultats de calcul d'itinéraires.
+//
+
+#include "cacheItineraires.h"
+#include <cmath>
+
+using namespace std;
+
+const unsigned int CacheItineraires::aucuneStation = numeric_limits<unsigned int>::max();
+
+size_t CacheItineraires::HachageCle::operator()(const Cle &p_cle) const
+{
+    unsigned long long h = ((unsigned long long) p_cle.stationOrigine << 32) ^ p_cle.stationDestination;
+    h ^= (unsigned long long) p_cle.tranche * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29;
+    return (size_t) (h * 0xBF58476D1CE4E5B9ULL);
+}
+
+//! \brief construit un cache vide
+//! \param[in] p_capacite: le nombre maximal d'itinéraires mémorisés
+//! \param[in] p_tailleTranche: la durée, en secondes, des tranches d'heures de départ
+//! \param[in] p_rayonAccrochage: la distance maximale, en km, entre un point et la station qui le représente
+//! \throws logic_error si un paramètre est nul
+CacheItineraires::CacheItineraires(size_t p_capacite, unsigned int p_tailleTranche, double p_rayonAccrochage)
+        : m_capacite(p_capacite), m_tailleTranche(p_tailleTranche), m_rayonAccrochage(p_rayonAccrochage),
+          m_version(0)
+{
+    if (p_capacite == 0 || p_tailleTranche == 0 || !(p_rayonAccrochage > 0))
+        throw logic_error("CacheItineraires: la capacité, la taille des tranches et le rayon doivent être positifs");
+    m_statistiques = Statistiques{0, 0, 0, 0, 0};
+}
+
+//! \brief Calcule l'itinéraire le plus rapide entre deux points, en le prenant dans le cache s'il y est
+//! \brief Mêmes paramètres, exceptions et conditions d'utilisation que ReseauGTFS::calculerItineraire(); voir la
+//! description de la classe pour l'approximation faite. Les statistiques de recherche sont nulles si l'itinéraire vient
+//! du cache.
+unsigned int CacheItineraires::calculerItineraire(const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau,
+                                                  const Coordonnees &p_pointOrigine,
+                                                  const Coordonnees &p_pointDestination, const Heure &p_heureDepart,
+                                                  Itineraire &p_itineraire, StatistiquesRecherche &p_statistiques)
+{
+    if (p_heureDepart < p_gtfs.getTempsDebut() || !(p_heureDepart < p_gtfs.getTempsFin()))
+        throw logic_error("CacheItineraires::calculerItineraire(): heure de départ hors de l'intervalle du GTFS");
+
+    Cle cle;
+    unsigned long version;
+    shared_ptr<const Itineraire> memorise;
+    {
+        lock_guard<mutex> garde(m_verrou);
+        verifierVersion(p_gtfs, p_reseau);
+        version = m_version;
+        cle.stationOrigine = stationLaPlusProche(p_pointOrigine);
+        cle.stationDestination = stationLaPlusProche(p_pointDestination);
+        cle.tranche = (unsigned int) (p_heureDepart - Heure(0, 0, 0)) / m_tailleTranche;
+        if (cle.stationOrigine == aucuneStation || cle.stationDestination == aucuneStation)
+        {
+            ++m_statistiques.horsCache;
+        }
+        else
+        {
+            auto itIndex = m_index.find(cle);
+            if (itIndex != m_index.end() && itIndex->second->itineraire->heureDepart <= p_heureDepart &&
+                p_heureDepart <= itIndex->second->departLimite)
+            {
+                m_entrees.splice(m_entrees.begin(), m_entrees, itIndex->second);
+                memorise = itIndex->second->itineraire;
+                ++m_statistiques.succes;
+            }
+            else ++m_statistiques.echecs;
+        }
+    }
+
+    if (cle.stationOrigine == aucuneStation || cle.stationDestination == aucuneStation)
+        return p_reseau.calculerItineraire(p_gtfs, p_pointOrigine, p_pointDestination, p_heureDepart, p_itineraire,
+                                           p_statistiques);
+
+    if (!memorise)
+    {
+        shared_ptr<Itineraire> calcule = make_shared<Itineraire>();
+        const Coordonnees &origine = p_gtfs.getStations().at(cle.stationOrigine).getCoords();
+        p_reseau.calculerItineraire(p_gtfs, origine, p_gtfs.getStations().at(cle.stationDestination).getCoords(),
+                                    p_heureDepart, *calcule, p_statistiques);
+        p_itineraire = *calcule;
+
+        // fin de la tranche, ou plus tôt si l'un des arrêts d'entrée de la recherche est manqué
+        const Heure departLimite = min(Heure(0, 0, 0).add_secondes((cle.tranche + 1) * m_tailleTranche - 1),
+                                       p_reseau.departLimiteMemesEntrees(p_gtfs, origine, p_heureDepart));
+
+        lock_guard<mutex> garde(m_verrou);
+        // un itinéraire calculé pendant qu'une nouvelle version du réseau est apparue n'est pas mémorisé
+        if (version != m_version) return p_itineraire.duree;
+        auto itIndex = m_index.find(cle);
+        if (itIndex != m_index.end())
+        {
+            itIndex->second->itineraire = calcule;
+            itIndex->second->departLimite = departLimite;
+            m_entrees.splice(m_entrees.begin(), m_entrees, itIndex->second);
+            return p_itineraire.duree;
+        }
+        m_entrees.push_front(Entree{cle, calcule, departLimite});
+        m_index[cle] = m_entrees.begin();
+        if (m_entrees.size() > m_capacite)
+        {
+            m_index.erase(m_entrees.back().cle);
+            m_entrees.pop_back();
+            ++m_statistiques.evictions;
+        }
+        return p_itineraire.duree;
+    }
+
+    // copie décalée à l'heure de départ de la requête: la marche initiale part plus tard, l'attente est plus courte
+    p_statistiques = StatistiquesRecherche();
+    p_itineraire = *memorise;
+    p_itineraire.heureDepart = p_heureDepart;
+    if (!p_itineraire.estAtteignable()) return p_itineraire.duree;
+    p_itineraire.duree = (unsigned int) (memorise->getHeureArrivee() - p_heureDepart);
+    Etape &marche = p_itineraire.etapes.front();
+    marche.heureArrivee = p_heureDepart.add_secondes((unsigned int) (marche.heureArrivee - marche.heureDepart));
+    marche.heureDepart = p_heureDepart;
+    return p_itineraire.duree;
+}
+
+//! \brief retire tous les itinéraires mémorisés
+void CacheItineraires::vider()
+{
+    lock_guard<mutex> garde(m_verrou);
+    m_entrees.clear();
+    m_index.clear();
+}
+
+size_t CacheItineraires::getTaille() const
+{
+    lock_guard<mutex> garde(m_verrou);
+    return m_entrees.size();
+}
+
+size_t CacheItineraires::getCapacite() const
+{
+    return m_capacite;
+}
+
+CacheItineraires::Statistiques CacheItineraires::getStatistiques() const
+{
+    lock_guard<mutex> garde(m_verrou);
+    return m_statistiques;
+}
+
+//! \pre m_verrou est détenu
+void CacheItineraires::verifierVersion(const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau)
+{
+    if (p_reseau.getVersion() == m_version) return;
+    if (m_version != 0) ++m_statistiques.invalidations;
+    m_entrees.clear();
+    m_index.clear();
+    indexerStations(p_gtfs);
+    m_version = p_reseau.getVersion();
+}
+
+void CacheItineraires::indexerStations(const DonneesGTFS &p_gtfs)
+{
+    m_stations.clear();
+    double latitudeMax = 0;
+    for (const auto &station : p_gtfs.getStations())
+        latitudeMax = max(latitudeMax, fabs(station.second.getCoords().getLatitude()));
+    m_grille.reset(new GrilleSpatiale(m_rayonAccrochage, latitudeMax));
+    for (const auto &station : p_gtfs.getStations())
+    {
+        m_grille->ajouter(m_stations.size(), station.second.getCoords());
+        m_stations.emplace_back(station.first, station.second.getCoords());
+    }
+}
+
+//! \pre m_verrou est détenu
+unsigned int CacheItineraires::stationLaPlusProche(const Coordonnees &p_point) const
+{
+    unsigned int meilleure = aucuneStation;
+    double distanceMeilleure = m_rayonAccrochage;
+    m_grille->pourChaqueVoisinPossible(p_point, [&](size_t p_indice) {
+        double distance = p_point - m_stations[p_indice].second;
+        if (distance != distance) distance = 0; // acos() d'un arrondi au-delà de 1: points confondus
+        if (distance <= distanceMeilleure)
+        {
+            distanceMeilleure = distance;
+            meilleure = m_stations[p_indice].first;
+        }
+    });
+    return meilleure;
+}
@@ -0,0 +1,103 @@
+//
+// Cache des résultats de calcul d'itinéraires, pour les paires origine-destination demandées à répétition.
+//
+
+#ifndef RTC_CACHEITINERAIRES_H
+#define RTC_CACHEITINERAIRES_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "grilleSpatiale.h"
+#include "ReseauGTFS.h"
+
+/*!
+ * \class CacheItineraires
+ * \brief Mémorise les itinéraires calculés par ReseauGTFS::calculerItineraire(), avec éviction du moins récemment
+ * utilisé lorsque la capacité (en nombre d'itinéraires) est atteinte.
+ * \brief La clé d'une requête est formée des stations les plus proches de l'origine et de la destination et de la
+ * tranche de l'heure de départ (ex: 08:00:00 à 08:04:59 pour des tranches de 300 secondes). L'itinéraire d'une clé est
+ * calculé entre les coordonnées des deux stations, à l'heure de départ de la requête qui l'a manqué. Une station
+ * confondue avec l'origine ou la destination y est à la distance 0 (voir TableCoordonnees::indicesAMoinsDe()). Il sert
+ * ensuite les requêtes de la même tranche qui partent au plus tard à son heure limite: la dernière heure de départ à
+ * laquelle la recherche a les mêmes arrêts d'entrée (voir ReseauGTFS::departLimiteMemesEntrees()). Partir dans cet
+ * intervalle ne fait que décaler le coût de ces entrées: le même itinéraire, copié avec l'heure de départ de la
+ * requête, est donc encore le plus rapide. Une requête hors de l'intervalle est calculée et remplace l'itinéraire de sa
+ * clé.
+ * \brief La seule approximation est l'accrochage: l'origine et la destination sont remplacées par leur station la plus
+ * proche, à au plus rayonAccrochage km. Une requête dont l'origine ou la destination est plus loin de toute station est
+ * calculée sans passer par le cache.
+ * \brief Le cache se vide de lui-même lorsque la version du réseau change (construction d'un autre réseau, retards,
+ * avancement de la fenêtre: voir ReseauGTFS::getVersion()).
+ * \note Les méthodes sont synchronisées: plusieurs fils d'exécution peuvent calculer des itinéraires en même temps,
+ * aux mêmes conditions que ReseauGTFS::calculerItineraire(). Le calcul d'un itinéraire absent du cache se fait hors du
+ * verrou.
+ */
+class CacheItineraires {
+
+public:
+
+    //! \brief compteurs du cache depuis sa création
+    struct Statistiques {
+        size_t succes;         // requêtes servies par le cache
+        size_t echecs;         // requêtes calculées puis mémorisées (clé absente, ou départ hors de l'intervalle servi)
+        size_t horsCache;      // requêtes trop loin d'une station pour être mémorisées
+        size_t evictions;      // itinéraires évincés pour respecter la capacité
+        size_t invalidations;  // vidages dus à un changement de version du réseau
+    };
+
+    explicit CacheItineraires(size_t p_capacite, unsigned int p_tailleTranche = 300, double p_rayonAccrochage = 0.15);
+
+    unsigned int calculerItineraire(const DonneesGTFS &, const ReseauGTFS &, const Coordonnees &, const Coordonnees &,
+                                    const Heure &, Itineraire &, StatistiquesRecherche &);
+    void vider();
+    size_t getTaille() const;
+    size_t getCapacite() const;
+    Statistiques getStatistiques() const;
+
+private:
+
+    struct Cle {
+        unsigned int stationOrigine;
+        unsigned int stationDestination;
+        unsigned int tranche;
+        bool operator==(const Cle &p_autre) const {
+            return stationOrigine == p_autre.stationOrigine && stationDestination == p_autre.stationDestination &&
+                   tranche == p_autre.tranche;
+        }
+    };
+
+    struct HachageCle {
+        size_t operator()(const Cle &p_cle) const;
+    };
+
+    struct Entree {
+        Cle cle;
+        std::shared_ptr<const Itineraire> itineraire; //calculé pour les stations de la clé
+        Heure departLimite; //l'itinéraire sert les départs de itineraire->heureDepart à departLimite
+    };
+
+    static const unsigned int aucuneStation;
+
+    void indexerStations(const DonneesGTFS &); //construit la grille des stations
+    unsigned int stationLaPlusProche(const Coordonnees &) const; //aucuneStation si aucune n'est à moins de rayonAccrochage
+    void verifierVersion(const DonneesGTFS &, const ReseauGTFS &); //vide le cache si la version du réseau a changé
+
+    const size_t m_capacite;
+    const unsigned int m_tailleTranche; //en secondes
+    const double m_rayonAccrochage; //en km
+
+    mutable std::mutex m_verrou;
+    std::list<Entree> m_entrees; //de la plus récemment utilisée à la moins récemment utilisée
+    std::unordered_map<Cle, std::list<Entree>::iterator, HachageCle> m_index;
+    unsigned long m_version; //version du réseau des itinéraires mémorisés (0: aucune)
+    Statistiques m_statistiques;
+
+    std::vector<std::pair<unsigned int, Coordonnees> > m_stations;
+    std::unique_ptr<GrilleSpatiale> m_grille; //indices dans m_stations, pour l'accrochage à m_rayonAccrochage
+};
+
+#endif //RTC_CACHEITINERAIRES_H
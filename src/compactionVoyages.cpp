@@ -0,0 +1,396 @@
+//
+// Compaction des arrêts de passage: les suites d'arrêts sans correspondance deviennent des raccourcis, et le graphe
+// est renuméroté sans eux.
+//
+
+#include "ReseauGTFS.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+    const size_t aucunSommet = numeric_limits<size_t>::max();
+    const unsigned int infini = numeric_limits<unsigned int>::max();
+
+    //! \brief ajoute l'arc (p_de, p_vers) à p_graphe, désactivé si p_poids vaut infini (Graphe::ajouterArc() le refuse)
+    void ajouterArcPondere(Graphe &p_graphe, size_t p_de, size_t p_vers, unsigned int p_poids) {
+        p_graphe.ajouterArc(p_de, p_vers, p_poids == infini ? 0 : p_poids);
+        if (p_poids == infini) p_graphe.modifierPoids(p_de, p_vers, infini);
+    }
+}
+
+//! \brief contracte les arrêts de passage: un arrêt dont le seul arc entrant vient de l'arrêt précédent de son voyage
+//! et dont le seul arc sortant va à l'arrêt suivant n'offre ni attente ni transfert. Chaque suite maximale de tels
+//! arrêts u -> v1 -> ... -> vk -> w est remplacée par un seul arc u -> w (un raccourci), de poids l'écart des heures
+//! d'arrivée de u et de w (désactivé si l'un des arcs remplacés l'était), et le graphe est renuméroté sans v1, ..., vk.
+//! \brief Les sommets conservés reçoivent les numéros 0 à K - 1 dans leur ordre d'origine; K et K + 1 sont réservés aux
+//! points origine et destination (ajouterArcsOrigineDestination()) et l'arrêt contracté i reçoit le numéro
+//! m_premierContracte + i = K + 2 + i, qui n'est pas un sommet du graphe. m_sommetDeArret donne ces numéros;
+//! m_arretsContractes, m_debutChaine et m_franchisDesChaines permettent aux recherches de partir d'un arrêt contracté
+//! ou d'y descendre (voir reporterExtremites() et completerChemin()). Les durées des itinéraires sont inchangées.
+//! \brief appliquerRetards() met les raccourcis à jour; avancerFenetre() développe le réseau, l'avance, puis le
+//! compacte de nouveau. Les sommets libres (arrêts expirés) sont écartés. Rien n'est fait si le réseau est déjà
+//! compacté.
+//! \throws logic_error si les points origine et destination sont présents dans le graphe
+//! \throws logic_error si une incohérence est détectée lors de la compaction
+void ReseauGTFS::compacterVoyages()
+{
+    if (m_origine_dest_ajoute)
+        throw logic_error("ReseauGTFS::compacterVoyages(): il faut enlever les points origine et destination avant");
+    if (estCompacte()) return;
+
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ReseauGTFS::compacterVoyages");
+    try
+    {
+        const size_t nbSommets = m_leGraphe.getNbSommets();
+        vector<unsigned int> nbEntrants(nbSommets, 0), nbSortants(nbSommets, 0), poidsSortant(nbSommets, infini);
+        vector<size_t> predecesseur(nbSommets, aucunSommet), successeur(nbSommets, aucunSommet);
+        for (size_t i = 0; i < nbSommets; ++i)
+            m_leGraphe.pourChaqueArcSortant(i, [&](size_t p_destination, unsigned int p_poids) {
+                ++nbSortants[i];
+                successeur[i] = p_destination;
+                poidsSortant[i] = p_poids;
+                ++nbEntrants[p_destination];
+                predecesseur[p_destination] = i;
+            });
+
+        vector<char> dePassage(nbSommets, 0);
+        for (size_t i = 0; i < nbSommets; ++i)
+        {
+            const Arret::Ptr &arret = m_arretDuSommet[i];
+            if (!arret || nbEntrants[i] != 1 || nbSortants[i] != 1) continue;
+            const Arret::Ptr &precedent = m_arretDuSommet[predecesseur[i]];
+            const Arret::Ptr &suivant = m_arretDuSommet[successeur[i]];
+            dePassage[i] = precedent && suivant && precedent->getVoyageId() == arret->getVoyageId() &&
+                           suivant->getVoyageId() == arret->getVoyageId();
+        }
+
+        vector<size_t> numero(nbSommets, aucunSommet);
+        size_t nbConserves = 0;
+        for (size_t i = 0; i < nbSommets; ++i)
+            if (m_arretDuSommet[i] && !dePassage[i]) numero[i] = nbConserves++;
+        const size_t premierContracte = nbConserves + 2;
+
+        // les arcs sont recopiés dans leur ordre; celui qui mène à un arrêt de passage devient le raccourci de la suite
+        Graphe graphe(nbConserves);
+        vector<ArretContracte> contractes;
+        vector<SommetPondere> franchis;
+        vector<size_t> debutChaine(nbConserves + 1, 0);
+        for (size_t i = 0; i < nbSommets; ++i)
+        {
+            if (numero[i] == aucunSommet || dePassage[i]) continue;
+            const size_t amont = numero[i];
+            debutChaine[amont] = contractes.size();
+            m_leGraphe.pourChaqueArcSortant(i, [&](size_t p_destination, unsigned int p_poids) {
+                const size_t debut = contractes.size();
+                size_t vers = p_destination;
+                unsigned int poids = p_poids;
+                for (; dePassage[vers]; vers = successeur[vers])
+                {
+                    numero[vers] = premierContracte + contractes.size();
+                    contractes.push_back({m_arretDuSommet[vers], amont, aucunSommet, m_stationDuSommet[vers]});
+                    franchis.emplace_back(m_stationDuSommet[vers], poids);
+                    poids = poids == infini || poidsSortant[vers] == infini ? infini : poids + poidsSortant[vers];
+                }
+                for (size_t k = debut; k < contractes.size(); ++k) contractes[k].aval = numero[vers];
+                ajouterArcPondere(graphe, amont, numero[vers], poids);
+            });
+        }
+        debutChaine[nbConserves] = contractes.size();
+
+        vector<Arret::Ptr> arretDuSommet(nbConserves);
+        vector<unsigned int> stationDuSommet(nbConserves), ligneDuSommet(nbConserves);
+        for (size_t i = 0; i < nbSommets; ++i)
+        {
+            if (numero[i] >= nbConserves) continue;
+            arretDuSommet[numero[i]] = m_arretDuSommet[i];
+            stationDuSommet[numero[i]] = m_stationDuSommet[i];
+            ligneDuSommet[numero[i]] = m_ligneDuSommet[i];
+        }
+        for (auto &entree : m_sommetDeArret) entree.second = numero[entree.second];
+
+        m_sourcesArcsDesactives.clear();
+        for (size_t i = 0; i < nbConserves; ++i)
+            graphe.pourChaqueArcSortant(i, [&](size_t p_destination, unsigned int p_poids) {
+                if (p_poids == infini) m_sourcesArcsDesactives[p_destination].push_back(i);
+            });
+
+        m_leGraphe = std::move(graphe);
+        m_arretDuSommet = std::move(arretDuSommet);
+        m_stationDuSommet = std::move(stationDuSommet);
+        m_ligneDuSommet = std::move(ligneDuSommet);
+        m_arretsContractes = std::move(contractes);
+        m_debutChaine = std::move(debutChaine);
+        m_franchisDesChaines = std::move(franchis);
+        m_sommetsLibres.clear();
+        m_premierContracte = premierContracte;
+    }
+    catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+    mesure.terminer(m_arretsContractes.size());
+}
+
+//! \brief rétablit dans le graphe les arrêts contractés par compacterVoyages(): l'arrêt contracté i devient le sommet
+//! m_premierContracte + i et chaque raccourci redevient la suite des arcs de voyage qu'il remplaçait, pondérés selon
+//! les heures courantes. Les sommets conservés gardent leur numéro; les deux numéros réservés aux points origine et
+//! destination deviennent des sommets libres.
+//! \pre les points origine et destination ne sont pas présents et le réseau est compacté
+void ReseauGTFS::developperVoyages()
+{
+    const size_t nbConserves = m_premierContracte - 2;
+    m_leGraphe.resize(m_premierContracte + m_arretsContractes.size());
+    m_arretDuSommet.resize(m_premierContracte);
+    m_stationDuSommet.resize(m_premierContracte, 0);
+    m_ligneDuSommet.resize(m_premierContracte, 0);
+    m_sommetsLibres.push_back(nbConserves + 1);
+    m_sommetsLibres.push_back(nbConserves);
+    for (const ArretContracte &contracte : m_arretsContractes)
+    {
+        m_arretDuSommet.push_back(contracte.arret);
+        m_stationDuSommet.push_back(contracte.station);
+        m_ligneDuSommet.push_back(m_ligneDuSommet[contracte.amont]);
+    }
+
+    auto relier = [&](size_t p_de, size_t p_vers) {
+        const unsigned int poids = poidsArc(p_de, p_vers);
+        ajouterArcPondere(m_leGraphe, p_de, p_vers, poids);
+        if (poids == infini) noterArcDesactive(p_de, p_vers);
+    };
+    for (size_t amont = 0; amont < nbConserves; ++amont)
+    {
+        const pair<size_t, size_t> chaine = chaineDe(amont);
+        if (chaine.first == chaine.second) continue;
+        m_leGraphe.enleverArc(amont, m_arretsContractes[chaine.first].aval);
+        size_t de = amont;
+        for (size_t k = chaine.first; k < chaine.second; ++k)
+        {
+            relier(de, m_premierContracte + k);
+            de = m_premierContracte + k;
+        }
+        relier(de, m_arretsContractes[chaine.first].aval);
+    }
+
+    m_arretsContractes.clear();
+    m_debutChaine.clear();
+    m_franchisDesChaines.clear();
+    m_premierContracte = aucunSommet;
+}
+
+//! \brief adapte les extrémités d'une recherche sur un réseau compacté (rien n'est fait sinon)
+//! \brief Une source à un arrêt contracté vi est reportée sur le sommet aval w de son raccourci, au coût du trajet
+//! jusqu'à w, sauf si w est déjà une source au plus au même coût. La recherche sort aussi par les arrêts contractés
+//! que saute le raccourci d'un sommet, selon m_franchisDesChaines (p_destination.franchis): seuls les sommets qu'elle
+//! atteint les examinent. Le meilleur chemin qui descend sur le raccourci même où il est monté, sans passer par un
+//! sommet, est retenu à part (p_extremites.direct).
+//! \param[in,out] p_sources: les sources de la recherche; celles des arrêts contractés sont retirées ou reportées
+//! \param[in,out] p_destination: les sorties et bornes par station de la recherche
+//! \param[out] p_extremites: de quoi compléter le chemin trouvé (voir completerChemin())
+void ReseauGTFS::reporterExtremites(vector<SommetPondere> &p_sources, DestinationParGroupes &p_destination,
+                                   ExtremitesContractees &p_extremites) const
+{
+    p_extremites.montees.clear();
+    p_extremites.direct.clear();
+    p_extremites.coutDirect = infini;
+    p_destination.debutFranchis = nullptr;
+    p_destination.franchis = nullptr;
+    if (!estCompacte()) return;
+    p_destination.debutFranchis = &m_debutChaine;
+    p_destination.franchis = &m_franchisDesChaines;
+
+    auto sortieDe = [&](size_t p_numero) { return p_destination.sortie[stationDe(p_numero)]; };
+    auto retenirDirect = [&](unsigned int p_cout, size_t p_montee, size_t p_descente) {
+        if (p_cout >= p_extremites.coutDirect) return;
+        p_extremites.coutDirect = p_cout;
+        p_extremites.direct.assign(1, p_montee);
+        if (p_descente != p_montee) p_extremites.direct.push_back(p_descente);
+    };
+
+    vector<tuple<size_t, unsigned int, size_t>> reports; // <sommet aval, coût, arrêt contracté de la source>
+    size_t nbConservees = 0;
+    for (const SommetPondere &source : p_sources)
+    {
+        if (!estContracte(source.first))
+        {
+            p_sources[nbConservees++] = source;
+            continue;
+        }
+        const ArretContracte &contracte = m_arretsContractes[source.first - m_premierContracte];
+        if (sortieDe(source.first) != infini) retenirDirect(source.second + sortieDe(source.first), source.first,
+                                                            source.first);
+        size_t precedent = source.first;
+        bool franchissable = true;
+        for (size_t k = source.first - m_premierContracte + 1; k < chaineDe(contracte.amont).second; ++k)
+        {
+            const size_t descente = m_premierContracte + k;
+            if (secondesEntre(precedent, descente) < 0)
+            {
+                franchissable = false;
+                break;
+            }
+            precedent = descente;
+            if (sortieDe(descente) != infini)
+                retenirDirect(source.second + secondesEntre(source.first, descente) + sortieDe(descente),
+                              source.first, descente);
+        }
+        if (franchissable && secondesEntre(precedent, contracte.aval) >= 0)
+            reports.emplace_back(contracte.aval, source.second + secondesEntre(source.first, contracte.aval),
+                                 source.first);
+    }
+    p_sources.resize(nbConservees);
+
+    sort(reports.begin(), reports.end());
+    reports.erase(unique(reports.begin(), reports.end(), [](const tuple<size_t, unsigned int, size_t> &a,
+                                                            const tuple<size_t, unsigned int, size_t> &b) {
+        return get<0>(a) == get<0>(b);
+    }), reports.end());
+    for (const SommetPondere &source : p_sources)
+    {
+        auto it = lower_bound(reports.begin(), reports.end(), make_tuple(source.first, 0u, (size_t) 0));
+        if (it != reports.end() && get<0>(*it) == source.first && get<1>(*it) >= source.second)
+            get<2>(*it) = aucunSommet;
+    }
+    for (const auto &report : reports)
+    {
+        if (get<2>(report) == aucunSommet) continue;
+        p_sources.emplace_back(get<0>(report), get<1>(report));
+        p_extremites.montees.emplace_back(get<0>(report), get<2>(report));
+    }
+
+}
+
+//! \brief meilleure sortie du sommet p_sommet par un arrêt contracté de son raccourci, selon m_franchisDesChaines
+//! \param[in] p_sortie: les sorties de la recherche, par indice de station
+//! \param[out] p_descente: l'arrêt contracté de cette sortie (inchangé s'il n'y en a pas)
+//! \return son coût depuis p_sommet, ou numeric_limits<unsigned int>::max() s'il n'y en a pas
+unsigned int ReseauGTFS::sortieFranchie(size_t p_sommet, const vector<unsigned int> &p_sortie, size_t &p_descente) const
+{
+    unsigned int meilleure = infini;
+    const pair<size_t, size_t> chaine = chaineDe(p_sommet);
+    for (size_t k = chaine.first; k < chaine.second; ++k)
+    {
+        const SommetPondere &point = m_franchisDesChaines[k];
+        if (point.second == infini || p_sortie[point.first] == infini) continue;
+        if (point.second + p_sortie[point.first] < meilleure)
+        {
+            meilleure = point.second + p_sortie[point.first];
+            p_descente = m_premierContracte + k;
+        }
+    }
+    return meilleure;
+}
+
+//! \brief complète le chemin d'une recherche dont les extrémités ont été adaptées par reporterExtremites(): l'arrêt
+//! contracté où l'on est monté précède le premier sommet s'il en est le report, et celui où l'on descend suit le
+//! dernier sommet s'il sort par elle (voir sortieFranchie()). Le chemin direct le remplace s'il est moins coûteux.
+//! \brief Les arrêts contractés que l'on franchit sans descendre ne sont pas ajoutés: extraireEtapes() n'a besoin que
+//! des arrêts où l'on monte et descend de chaque voyage.
+//! \param[in,out] p_chemin: les sommets du chemin trouvé (vide s'il n'y en a pas)
+//! \param[in,out] p_cout: le coût du chemin trouvé (numeric_limits<unsigned int>::max() s'il n'y en a pas)
+//! \param[in] p_sortie: les sorties de la recherche, par indice de station
+void ReseauGTFS::completerChemin(vector<size_t> &p_chemin, unsigned int &p_cout,
+                                 const ExtremitesContractees &p_extremites, const vector<unsigned int> &p_sortie) const
+{
+    if (p_extremites.coutDirect < p_cout)
+    {
+        p_chemin = p_extremites.direct;
+        p_cout = p_extremites.coutDirect;
+        return;
+    }
+    if (p_chemin.empty()) return;
+
+    const vector<pair<size_t, size_t>> &montees = p_extremites.montees;
+    auto itMontee = lower_bound(montees.begin(), montees.end(), make_pair(p_chemin.front(), (size_t) 0));
+    if (itMontee != montees.end() && itMontee->first == p_chemin.front()) p_chemin.insert(p_chemin.begin(),
+                                                                                          itMontee->second);
+    size_t descente;
+    if (sortieFranchie(p_chemin.back(), p_sortie, descente) < p_sortie[m_stationDuSommet[p_chemin.back()]])
+        p_chemin.push_back(descente);
+}
+
+//! \brief vrai si compacterVoyages() a contracté les arrêts de passage du réseau
+bool ReseauGTFS::estCompacte() const
+{
+    return m_premierContracte != aucunSommet;
+}
+
+size_t ReseauGTFS::getNbSommets() const
+{
+    return m_leGraphe.getNbSommets();
+}
+
+size_t ReseauGTFS::getNbArretsContractes() const
+{
+    return m_arretsContractes.size();
+}
+
+//! \brief nombre de sommets dont l'arc de voyage saute des arrêts contractés
+size_t ReseauGTFS::getNbRaccourcis() const
+{
+    size_t nbRaccourcis = 0;
+    for (size_t u = 0; u + 1 < m_debutChaine.size(); ++u) nbRaccourcis += m_debutChaine[u] != m_debutChaine[u + 1];
+    return nbRaccourcis;
+}
+
+bool ReseauGTFS::estContracte(size_t p_numero) const
+{
+    return p_numero >= m_premierContracte;
+}
+
+const Arret::Ptr &ReseauGTFS::arretDe(size_t p_numero) const
+{
+    return estContracte(p_numero) ? m_arretsContractes[p_numero - m_premierContracte].arret : m_arretDuSommet[p_numero];
+}
+
+//! \brief numeric_limits<unsigned int>::max() pour les points origine et destination et les sommets libres ajoutés
+//! par developperVoyages()
+unsigned int ReseauGTFS::stationDe(size_t p_numero) const
+{
+    if (p_numero < m_stationDuSommet.size()) return m_stationDuSommet[p_numero];
+    if (estContracte(p_numero)) return m_arretsContractes[p_numero - m_premierContracte].station;
+    return numeric_limits<unsigned int>::max();
+}
+
+int ReseauGTFS::secondesEntre(size_t p_de, size_t p_vers) const
+{
+    return arretDe(p_vers)->getHeureArrivee() - arretDe(p_de)->getHeureArrivee();
+}
+
+//! \brief <premier, fin> des indices dans m_arretsContractes des arrêts que saute le raccourci du sommet p_sommet (un
+//! intervalle vide s'il n'en a pas ou si le réseau n'est pas compacté)
+pair<size_t, size_t> ReseauGTFS::chaineDe(size_t p_sommet) const
+{
+    if (p_sommet + 1 < m_debutChaine.size()) return {m_debutChaine[p_sommet], m_debutChaine[p_sommet + 1]};
+    return {0, 0};
+}
+
+bool ReseauGTFS::estRaccourci(size_t p_de, size_t p_vers) const
+{
+    const pair<size_t, size_t> chaine = chaineDe(p_de);
+    return chaine.first != chaine.second && m_arretsContractes[chaine.first].aval == p_vers;
+}
+
+//! \brief poids à jour du raccourci du sommet p_amont: l'écart des heures d'arrivée de ses extrémités, ou
+//! numeric_limits<unsigned int>::max() si l'un des arcs de voyage qu'il remplace serait désactivé (voir poidsArc()).
+//! Chacun de ces arcs abaisse m_tempsMinimauxVersStation, comme dans un réseau développé, et le coût de chaque arrêt
+//! sauté est mis à jour dans m_franchisDesChaines.
+unsigned int ReseauGTFS::poidsRaccourci(size_t p_amont)
+{
+    const pair<size_t, size_t> chaine = chaineDe(p_amont);
+    const size_t aval = m_arretsContractes[chaine.first].aval;
+    bool franchissable = true;
+    size_t de = p_amont;
+    for (size_t k = chaine.first; k <= chaine.second; ++k)
+    {
+        const size_t vers = k < chaine.second ? m_premierContracte + k : aval;
+        const int ecart = secondesEntre(de, vers);
+        if (ecart < 0) franchissable = false;
+        else abaisserTempsMinimal(de, vers, (unsigned int) ecart);
+        if (k < chaine.second)
+            m_franchisDesChaines[k].second = franchissable ? (unsigned int) secondesEntre(p_amont, vers) : infini;
+        de = vers;
+    }
+    return franchissable ? (unsigned int) secondesEntre(p_amont, aval) : infini;
+}
@@ -18,35 +18,6 @@ Coordonnees::Coordonnees(double latitude, double longitude) : m_latitude(latitud
 
 };
 
-/*!
- * \brief Constructeur de copie de la classe, permet de construire une coordonnéees à partir d'une autre coordonnée.
- * \exception logic_error si La latitude et/ou la longitude de cette coordonnée est invalide
- */
-Coordonnees::Coordonnees(const Coordonnees & rhs)
-{
-    if (this != &rhs)
-    {
-        double longitude = rhs.getLongitude();
-        double latitude = rhs.getLatitude();
-        if (!Coordonnees::is_valide_coord(latitude, longitude))
-        {
-            throw std::logic_error("Coordonnees::Coordonnees(): rhs est une coordonnée invalide");
-        }
-        m_longitude = rhs.getLongitude();
-        m_latitude = rhs.getLatitude();
-    }
-}
-
-double Coordonnees::getLatitude() const
-{
-    return m_latitude;
-};
-
-double Coordonnees::getLongitude() const
-{
-    return m_longitude;
-};
-
 /*!
  * \brief : Cette fonction vérifie si les longitude et latitude en argument représentent
  * une coordonnée gps valide. Voir https://en.wikipedia.org/wiki/Geographic_coordinate_system
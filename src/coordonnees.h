@@ -12,19 +12,21 @@
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 
 /*!
  * \class Coordonnees
  * \brief Cette classe permet de représenter les coordonnées GPS d'un endroit
+ * \brief Les coordonnées sont validées une seule fois, à leur construction (lors de la lecture de stops.txt ou d'une
+ * requête): la copie est celle du compilateur, triviale, et ne peut pas lever d'exception.
  */
 class Coordonnees {
 
 public:
 
     Coordonnees(double latitude, double longitude);
-    Coordonnees(const Coordonnees & rhs);
-    double getLatitude() const ;
-    double getLongitude() const ;
+    double getLatitude() const { return m_latitude; }
+    double getLongitude() const { return m_longitude; }
     static bool is_valide_coord(double p_latitude, double p_longitude) ;
     double operator- (const Coordonnees & other) const;
     friend std::ostream & operator<<(std::ostream & flux, const Coordonnees & p_coord);
@@ -34,5 +36,7 @@ private:
     double m_longitude;
 };
 
+static_assert(std::is_trivially_copyable<Coordonnees>::value, "Coordonnees doit rester trivialement copiable");
+
 
 #endif //RTC_COORDONNEES_H
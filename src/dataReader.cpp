@@ -4,14 +4,20 @@
 //
 
 #include "DonneesGTFS.h"
+#include "lecteurCSV.h"
+#include "grilleSpatiale.h"
+#include <cmath>
 #include <fstream>
 #include <algorithm>
+#include <tuple>
+#include <utility>
 
 using namespace std;
 
-void supprimerStationsSansArrets(map<unsigned int, Station> &stations) {
+void supprimerStationsSansArrets(map<unsigned int, Station> &stations,
+                                 const unordered_set<unsigned int> &stationsAConserver) {
     for (auto it = stations.cbegin(); it != stations.cend();) {
-        if (it->second.getArrets().empty()) {
+        if (it->second.getArrets().empty() && stationsAConserver.count(it->first) == 0) {
             it = stations.erase(it);
         } else {
             it++;
@@ -19,108 +25,124 @@ void supprimerStationsSansArrets(map<unsigned int, Station> &stations) {
     }
 }
 
-void supprimerVoyageSansArrets(map<string, Voyage> &voyages) {
-    for (auto it = voyages.cbegin(); it != voyages.cend();) {
-        if (it->second.getArrets().empty()) {
-            it = voyages.erase(it);
-        } else {
-            it++;
-        }
-    }
+//! \brief convertit une date AAAAMMJJ en Date
+//! \throws logic_error si le champ n'est pas une date AAAAMMJJ
+Date dateDepuisChamp(const LecteurCSV::Champ &p_champ) {
+    const char *texte = p_champ.getDebut();
+    if (p_champ.getTaille() != 8 || !all_of(texte, texte + 8, [](char c) { return c >= '0' && c <= '9'; }))
+        throw logic_error("date invalide: '" + p_champ.versString() + "'");
+    auto nombre = [texte](size_t debut, size_t taille) {
+        unsigned int valeur = 0;
+        for (size_t i = debut; i < debut + taille; ++i) valeur = valeur * 10 + (texte[i] - '0');
+        return valeur;
+    };
+    return Date(nombre(0, 4), nombre(4, 2), nombre(6, 2));
 }
 
-void supprimerGuillemetsDansString(string &string) {
-    const char unwanted_char = '"';
-    string.erase(remove(string.begin(), string.end(), unwanted_char), string.end());
-}
-
-Date *construireDateDepuisString(const string &str_date) {
-    int an = stoi(str_date.substr(0, 4));
-    int mois = stoi(str_date.substr(4, 2));
-    int jour = stoi(str_date.substr(6, 2));
-
-    return new Date(an, mois, jour);
+//! \brief convertit une heure HH:MM:SS (HH pouvant dépasser 24) en nombre de secondes depuis 00:00:00
+//! \throws logic_error si le champ n'est pas une heure H:MM:SS ou HH:MM:SS
+unsigned int secondesDepuisChamp(const LecteurCSV::Champ &p_champ) {
+    unsigned int valeurs[3] = {0, 0, 0};
+    unsigned int index = 0;
+    bool chiffre = false;
+    for (const char *c = p_champ.getDebut(); *c != '\0'; ++c) {
+        if (*c == ':' && chiffre && index < 2) {
+            ++index;
+            chiffre = false;
+        } else if (*c >= '0' && *c <= '9') {
+            valeurs[index] = valeurs[index] * 10 + (*c - '0');
+            chiffre = true;
+        } else if (*c != ' ') {
+            chiffre = false;
+            break;
+        }
+    }
+    if (index != 2 || !chiffre)
+        throw logic_error("heure invalide: '" + p_champ.versString() + "'");
+    return (valeurs[0] * 60 + valeurs[1]) * 60 + valeurs[2];
 }
 
-Heure *construireHeureDepuisString(const string &str_heure) {
-
-    const char delimiter = ':';
-    size_t curr_pos = 0;
-    size_t next_pos = 0;
-    vector<unsigned int> values(3);
-    int index = 0;
-
-    while (next_pos != string::npos && index < values.size()) {
-        next_pos = str_heure.find(delimiter, curr_pos);
-
-        string curr_value = str_heure.substr(curr_pos, next_pos);
-
-        values[index] = stoi(curr_value);
-
-        curr_pos = next_pos + 1;
-        index++;
+//! \brief charge tous les fichiers GTFS d'un dossier, dans l'ordre requis par les méthodes ajouter...()
+//! \brief Les modes activerFenetreGlissante() et activerMultiJours() doivent être choisis avant l'appel
+//! \param[in] p_dossier: le dossier contenant routes.txt, stops.txt, calendar.txt et/ou calendar_dates.txt,
+//! trips.txt, stop_times.txt et transfers.txt
+//! \throws logic_error si un problème survient avec la lecture d'un fichier
+//! \throws logic_error si aucun service n'est offert à la date du GTFS (hors du mode multi-jours)
+void DonneesGTFS::chargerDossier(const std::string &p_dossier) {
+    ajouterLignes(p_dossier + "/routes.txt");
+    ajouterStations(p_dossier + "/stops.txt");
+    ajouterCalendrier(p_dossier + "/calendar.txt");
+    ajouterServices(p_dossier + "/calendar_dates.txt");
+    if (m_services.empty() && !m_multiJours) {
+        ostringstream message;
+        message << "DonneesGTFS::chargerDossier(): aucun service n'est offert à la date " << m_date;
+        throw logic_error(message.str());
     }
-
-    return new Heure(values[0], values[1], values[2]);
+    ajouterVoyagesDeLaDate(p_dossier + "/trips.txt");
+    ajouterArretsDesVoyagesDeLaDate(p_dossier + "/stop_times.txt");
+    ajouterTransferts(p_dossier + "/transfers.txt");
 }
 
-
 //! \brief ajoute les lignes dans l'objet GTFS
+//! \brief Chaque ligne est construite en place dans m_lignes; m_lignes_par_numero n'en retient que le route_id
 //! \param[in] p_nomFichier: le nom du fichier contenant les lignes
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterLignes(const std::string &p_nomFichier) {
-    ifstream fichier(p_nomFichier);
-    string ligne;
-
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ajouterLignes");
     try {
-        getline(fichier, ligne);
-
-        while (getline(fichier, ligne)) {
-            supprimerGuillemetsDansString(ligne);
-            vector<string> vector = string_to_vector(ligne, ',');
-
-            unsigned int route_id = stoi(vector[0]);
-            const string route_short_name = vector[2];
-            const string description = vector[4];
-
-            CategorieBus categorie = Ligne::couleurToCategorie(vector[7]);
-            Ligne l(route_id, route_short_name, description, categorie);
-
-            m_lignes.insert(make_pair(route_id, l));
-            m_lignes_par_numero.insert(make_pair(route_short_name, l));
-        }
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colRouteId = lecteur.getColonne("route_id");
+        const size_t colShortName = lecteur.getColonne("route_short_name");
+        const size_t colDesc = lecteur.getColonneOptionnelle("route_desc");
+        const size_t colCouleur = lecteur.getColonneOptionnelle("route_color");
+        string couleur;
+
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            unsigned int route_id = rangee[colRouteId].versEntier();
+            rangee[colCouleur].copierDans(couleur);
+            CategorieBus categorie = Ligne::couleurToCategorie(couleur);
+
+            auto insertion = m_lignes.emplace(
+                    piecewise_construct, forward_as_tuple(route_id),
+                    forward_as_tuple(route_id, rangee[colShortName].versString(), rangee[colDesc].versString(),
+                                     categorie));
+            if (insertion.second) {
+                m_lignes_par_numero.emplace(insertion.first->second.getNumero(), route_id);
+            }
+        });
     } catch (exception &ex) {
         throw logic_error(ex.what());
     }
+    mesure.terminer(m_lignes.size());
 }
 
 //! \brief ajoute les stations dans l'objet GTFS
 //! \param[in] p_nomFichier: le nom du fichier contenant les station
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterStations(const std::string &p_nomFichier) {
-
-    ifstream fichier(p_nomFichier);
-    string ligne;
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ajouterStations");
 
     try {
-        getline(fichier, ligne);
-
-        while (getline(fichier, ligne)) {
-            supprimerGuillemetsDansString(ligne);
-            vector<string> vector = string_to_vector(ligne, ',');
-
-            unsigned int stop_id = stoi(vector[0]);
-            const string station_nom = vector[1];
-            const string station_description = vector[2];
-
-            Coordonnees coordonnees(stod(vector[3]), stod(vector[4]));
-            Station station(stop_id, station_nom, station_description, coordonnees);
-
-            m_stations.insert(make_pair(stop_id, station));
-        }
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colStopId = lecteur.getColonne("stop_id");
+        const size_t colNom = lecteur.getColonne("stop_name");
+        const size_t colDesc = lecteur.getColonneOptionnelle("stop_desc");
+        const size_t colLatitude = lecteur.getColonne("stop_lat");
+        const size_t colLongitude = lecteur.getColonne("stop_lon");
+
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            unsigned int stop_id = rangee[colStopId].versEntier();
+            Coordonnees coordonnees(rangee[colLatitude].versReel(), rangee[colLongitude].versReel());
+
+            m_stations.emplace(piecewise_construct, forward_as_tuple(stop_id),
+                               forward_as_tuple(stop_id, rangee[colNom].versString(),
+                                                rangee[colDesc].versString(),
+                                                coordonnees, m_arena.get()));
+        });
     } catch (exception &ex) {
         throw logic_error(ex.what());
     }
+    mesure.terminer(m_stations.size());
 }
 
 //! \brief ajoute les transferts dans l'objet GTFS
@@ -132,150 +154,447 @@ void DonneesGTFS::ajouterStations(const std::string &p_nomFichier) {
 //! \throws logic_error si un problème survient avec la lecture du fichier
 //! \throws logic_error si tous les arrets de la date et de l'intervalle n'ont pas été ajoutés
 void DonneesGTFS::ajouterTransferts(const std::string &p_nomFichier) {
-
-    ifstream fichier(p_nomFichier);
-    string ligne;
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ajouterTransferts");
 
     try {
-        getline(fichier, ligne);
-
-        while (getline(fichier, ligne)) {
-            vector<string> vector = string_to_vector(ligne, ',');
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colFrom = lecteur.getColonne("from_stop_id");
+        const size_t colTo = lecteur.getColonne("to_stop_id");
+        const size_t colTemps = lecteur.getColonneOptionnelle("min_transfer_time");
 
-            unsigned int from_station_id = stoi(vector[0]);
-            unsigned int to_station_id = stoi(vector[1]);
-            unsigned int min_transfer_time = stoi(vector[3]);
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            unsigned int from_station_id = rangee[colFrom].versEntier();
+            unsigned int to_station_id = rangee[colTo].versEntier();
+            unsigned int min_transfer_time = rangee[colTemps].estVide() ? 0 : rangee[colTemps].versEntier();
 
             if (min_transfer_time == 0) {
                 min_transfer_time = 1;
             }
 
-            if (m_stations.find(from_station_id) != m_stations.end() &&
-                m_stations.find(to_station_id) != m_stations.end()) {
-                m_transferts.emplace_back(from_station_id, to_station_id, min_transfer_time);
-                m_stationsDeTransfert.insert(from_station_id);
-            }
+            m_tousLesTransferts.emplace_back(from_station_id, to_station_id, min_transfer_time);
+        });
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+    filtrerTransferts();
+    mesure.terminer(m_transferts.size());
+}
+
+//! \brief retient dans m_transferts les transferts dont les deux stations sont présentes dans l'objet GTFS
+//! \post m_transferts et m_stationsDeTransfert sont reconstruits à partir de m_tousLesTransferts
+//! \post m_trajetsAPied est recalculé, pour les stations présentes, si calculerTrajetsAPied() a été appelée
+//! \post getVersionTransferts() change: un réseau construit avant l'appel doit actualiser ses transferts
+void DonneesGTFS::filtrerTransferts() {
+    m_versionTransferts++;
+    m_transferts.clear();
+    m_stationsDeTransfert.clear();
+    for (const auto &transfert : m_tousLesTransferts) {
+        unsigned int from_station_id = get<0>(transfert);
+        unsigned int to_station_id = get<1>(transfert);
+        if (m_stations.find(from_station_id) != m_stations.end() &&
+            m_stations.find(to_station_id) != m_stations.end()) {
+            m_transferts.push_back(transfert);
+            m_stationsDeTransfert.insert(from_station_id);
         }
+    }
+    if (m_rayonTrajetsAPied > 0) joindreStationsVoisines();
+}
+
+//! \brief calcule les trajets à pieds entre toutes les paires de stations distantes d'au plus p_rayon km
+//! \brief Ces trajets complètent ceux de transfers.txt: ReseauGTFS en fait des arcs de transfert, sauf pour les paires
+//! de stations déjà reliées par un transfert. Ils sont recalculés lorsque les stations présentes changent (voir
+//! filtrerTransferts()).
+//! \param[in] p_rayon: la distance maximale, en km, d'un trajet à pieds (0: aucun trajet à pieds)
+//! \pre les stations ont été ajoutées
+//! \throws logic_error si p_rayon est négatif
+void DonneesGTFS::calculerTrajetsAPied(double p_rayon) {
+    if (!(p_rayon >= 0)) throw logic_error("calculerTrajetsAPied(): le rayon ne peut être négatif");
+    Instrumentation::MesurePhase mesure(m_instrumentation, "calculerTrajetsAPied");
+    m_rayonTrajetsAPied = p_rayon;
+    m_versionTransferts++;
+    m_trajetsAPied.clear();
+    if (p_rayon > 0) joindreStationsVoisines();
+    mesure.terminer(m_trajetsAPied.size());
+}
+
+//! \brief jointure par distance des stations à l'aide d'une GrilleSpatiale: chaque station n'est comparée qu'aux
+//! stations des cellules voisines de la sienne
+//! \post m_trajetsAPied contient les deux sens de chaque paire de stations distinctes à au plus m_rayonTrajetsAPied km
+void DonneesGTFS::joindreStationsVoisines() {
+    m_trajetsAPied.clear();
+    double latitudeMax = 0;
+    for (const auto &station : m_stations)
+        latitudeMax = max(latitudeMax, fabs(station.second.getCoords().getLatitude()));
+
+    vector<const pair<const unsigned int, Station> *> stations;
+    stations.reserve(m_stations.size());
+    GrilleSpatiale grille(m_rayonTrajetsAPied, latitudeMax);
+    for (const auto &station : m_stations) {
+        grille.ajouter(stations.size(), station.second.getCoords());
+        stations.push_back(&station);
+    }
+
+    for (const auto station : stations) {
+        const Coordonnees &coords = station->second.getCoords();
+        grille.pourChaqueVoisinPossible(coords, [&](size_t p_indice) {
+            const auto voisine = stations[p_indice];
+            if (voisine->first == station->first) return;
+            double distance = coords - voisine->second.getCoords();
+            if (distance != distance) distance = 0; // acos() d'un arrondi au-delà de 1: points confondus
+            if (distance <= m_rayonTrajetsAPied)
+                m_trajetsAPied.push_back(TrajetAPied{station->first, voisine->first, distance});
+        });
+    }
+    // m_stations est ordonnée par identifiant: il reste à ordonner les voisines de chaque station
+    sort(m_trajetsAPied.begin(), m_trajetsAPied.end(), [](const TrajetAPied &a, const TrajetAPied &b) {
+        return a.from_station_id < b.from_station_id ||
+               (a.from_station_id == b.from_station_id && a.to_station_id < b.to_station_id);
+    });
+}
+
+//! \brief ajoute les services hebdomadaires du GTFS (calendar.txt)
+//! \brief Chaque service est offert, entre start_date et end_date inclusivement, les jours de la semaine dont la
+//! colonne vaut 1. Les exceptions de calendar_dates.txt s'appliquent ensuite par ajouterServices().
+//! \brief m_services contient les services offerts à la date du GTFS (m_date)
+//! \param[in] p_nomFichier: le nom du fichier contenant le calendrier
+//! \pre doit être appelée avant ajouterServices()
+//! \throws logic_error si un problème survient avec la lecture du fichier
+//! \throws logic_error si des services ont déjà été ajoutés
+void DonneesGTFS::ajouterCalendrier(const std::string &p_nomFichier) {
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ajouterCalendrier");
+    if (!m_joursDeService.empty())
+        throw logic_error("DonneesGTFS::ajouterCalendrier(): des services ont déjà été ajoutés");
+    if (!LecteurCSV::fichierExiste(p_nomFichier)) return;
+
+    vector<tuple<string, unsigned int, Date, Date>> semaines; // <service_id, bit i = jour i (lundi = 0), début, fin>
+
+    try {
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colService = lecteur.getColonne("service_id");
+        const char *nomsDesJours[7] = {"monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"};
+        size_t colJours[7];
+        for (unsigned int jour = 0; jour < 7; ++jour) colJours[jour] = lecteur.getColonne(nomsDesJours[jour]);
+        const size_t colDebut = lecteur.getColonne("start_date");
+        const size_t colFin = lecteur.getColonne("end_date");
+
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            unsigned int joursDeLaSemaine = 0;
+            for (unsigned int jour = 0; jour < 7; ++jour) {
+                if (rangee[colJours[jour]].versEntier() == 1) joursDeLaSemaine |= 1u << jour;
+            }
+            semaines.emplace_back(rangee[colService].versString(), joursDeLaSemaine, dateDepuisChamp(rangee[colDebut]),
+                                  dateDepuisChamp(rangee[colFin]));
+        });
     } catch (exception &ex) {
         throw logic_error(ex.what());
     }
+
+    if (!semaines.empty()) {
+        Date debut = get<2>(semaines.front());
+        Date fin = get<3>(semaines.front());
+        for (const auto &semaine : semaines) {
+            if (get<2>(semaine) < debut) debut = get<2>(semaine);
+            if (get<3>(semaine) > fin) fin = get<3>(semaine);
+        }
+        etendrePlageDeDates(debut, fin);
+    }
+    for (const auto &semaine : semaines) {
+        vector<bool> &jours = m_joursDeService[indexerService(get<0>(semaine))];
+        for (Date date = get<2>(semaine); !(date > get<3>(semaine)); date = date.add_jours(1)) {
+            if (get<1>(semaine) & (1u << date.getJourDeLaSemaine())) {
+                jours[date - m_premiereDate] = true;
+            }
+        }
+    }
+
+    mettreAJourServicesDeLaDate();
+    mesure.terminer(m_indexServices.size());
 }
 
-//! \brief ajoute les services de la date du GTFS (m_date)
+//! \brief ajoute les services du GTFS (calendar_dates.txt)
+//! \brief Les jours de service de chaque service_id sont conservés sur toute la plage de dates du GTFS: une
+//! exception_type 1 ajoute la date au service et une exception_type 2 l'en retire
+//! \brief m_services contient les services offerts à la date du GTFS (m_date)
 //! \param[in] p_nomFichier: le nom du fichier contenant les services
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterServices(const std::string &p_nomFichier) {
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ajouterServices");
+    if (!LecteurCSV::fichierExiste(p_nomFichier)) return;
 
-    ifstream fichier(p_nomFichier);
-    string ligne;
+    vector<tuple<string, Date, bool>> exceptions; // <service_id, date, ajout>
 
     try {
-        getline(fichier, ligne);
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colService = lecteur.getColonne("service_id");
+        const size_t colDate = lecteur.getColonne("date");
+        const size_t colType = lecteur.getColonne("exception_type");
+
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            exceptions.emplace_back(rangee[colService].versString(), dateDepuisChamp(rangee[colDate]),
+                                    rangee[colType].versEntier() == 1);
+        });
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
 
-        while (getline(fichier, ligne)) {
-            vector<string> vector = string_to_vector(ligne, ',');
+    if (!exceptions.empty()) {
+        Date debut = get<1>(exceptions.front());
+        Date fin = debut;
+        for (const auto &exception : exceptions) {
+            if (get<1>(exception) < debut) debut = get<1>(exception);
+            if (get<1>(exception) > fin) fin = get<1>(exception);
+        }
+        etendrePlageDeDates(debut, fin);
+    }
+    for (const auto &exception : exceptions) {
+        m_joursDeService[indexerService(get<0>(exception))][get<1>(exception) - m_premiereDate] = get<2>(exception);
+    }
 
-            const string service_id = vector[0];
-            const string str_date = vector[1];
-            const string exception_type = vector[2];
+    mettreAJourServicesDeLaDate();
+    mesure.terminer(m_indexServices.size());
+}
 
-            if (exception_type == "1") {
-                Date *date = construireDateDepuisString(str_date);
+//! \brief étend la plage de dates couverte par les jours de service pour qu'elle inclue [p_debut, p_fin]
+//! \brief Tant qu'aucun service n'est indexé, la plage devient simplement [p_debut, p_fin]
+//! \param[in] p_debut: la première date à couvrir
+//! \param[in] p_fin: la dernière date à couvrir
+void DonneesGTFS::etendrePlageDeDates(const Date &p_debut, const Date &p_fin) {
+    if (m_joursDeService.empty()) {
+        m_premiereDate = p_debut;
+        m_derniereDate = p_fin;
+        return;
+    }
 
-                if (m_date == *date) {
-                    m_services.insert(service_id);
-                }
-                delete date;
-            }
+    const Date debut = p_debut < m_premiereDate ? p_debut : m_premiereDate;
+    const Date fin = p_fin > m_derniereDate ? p_fin : m_derniereDate;
+    const size_t decalage = (size_t) (m_premiereDate - debut);
+    const size_t nbJours = (size_t) (fin - debut + 1);
+    for (auto &jours : m_joursDeService) {
+        jours.insert(jours.begin(), decalage, false);
+        jours.resize(nbJours, false);
+    }
+    m_premiereDate = debut;
+    m_derniereDate = fin;
+}
+
+//! \brief donne l'indice d'un service dans m_joursDeService, en l'ajoutant (sans jours de service) s'il est inconnu
+//! \param[in] p_service_id: l'identifiant du service
+//! \return l'indice du service
+unsigned int DonneesGTFS::indexerService(const std::string &p_service_id) {
+    auto itService = m_indexServices.find(p_service_id);
+    if (itService != m_indexServices.end()) return itService->second;
+
+    const unsigned int index = (unsigned int) m_joursDeService.size();
+    m_indexServices.insert(make_pair(p_service_id, index));
+    m_joursDeService.emplace_back((size_t) (m_derniereDate - m_premiereDate + 1), false);
+    return index;
+}
+
+//! \brief reconstruit m_services avec les services offerts à la date du GTFS (m_date)
+void DonneesGTFS::mettreAJourServicesDeLaDate() {
+    m_services.clear();
+    for (const auto &service : m_indexServices) {
+        if (isServiceActif(service.second, m_date)) {
+            m_services.insert(service.first);
         }
-    } catch (exception &ex) {
-        throw logic_error(ex.what());
     }
 }
 
+//! \brief indique si un service est offert à une date donnée
+//! \param[in] p_service_id: l'identifiant du service
+//! \param[in] p_date: la date
+//! \return false si le service est inconnu ou si la date est hors de la plage de dates du GTFS
+bool DonneesGTFS::isServiceActif(const std::string &p_service_id, const Date &p_date) const {
+    auto itService = m_indexServices.find(p_service_id);
+    return itService != m_indexServices.end() && isServiceActif(itService->second, p_date);
+}
+
+//! \brief indique si un service est offert à une date donnée
+//! \param[in] p_service: l'indice du service (voir m_indexServices)
+//! \param[in] p_date: la date
+//! \return false si la date est hors de la plage de dates du GTFS
+bool DonneesGTFS::isServiceActif(unsigned int p_service, const Date &p_date) const {
+    const int jour = p_date - m_premiereDate;
+    const vector<bool> &jours = m_joursDeService[p_service];
+    return jour >= 0 && (size_t) jour < jours.size() && jours[jour];
+}
+
 //! \brief ajoute les voyages de la date
 //! \brief seuls les voyages dont le service est présent dans l'objet GTFS sont ajoutés
+//! \brief les voyages dont le service est offert la veille sont aussi conservés dans l'horaire, car leurs arrêts
+//! après minuit (heures >= 24:00:00) appartiennent à la date; en mode multi-jours, tous les voyages sont conservés
 //! \param[in] p_nomFichier: le nom du fichier contenant les voyages
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterVoyagesDeLaDate(const std::string &p_nomFichier) {
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ajouterVoyagesDeLaDate");
 
-    ifstream fichier(p_nomFichier);
-    string ligne;
+    const Date veille = m_date.add_jours(-1);
 
     try {
-        getline(fichier, ligne);
-
-        while (getline(fichier, ligne)) {
-            supprimerGuillemetsDansString(ligne);
-            vector<string> vector = string_to_vector(ligne, ',');
-
-            const string service_id = vector[1];
-
-            if (m_services.find(service_id) != m_services.end()) {
-                unsigned int route_id = stoi(vector[0]);
-                const string trip_id = vector[2];
-                const string trip_headsign = vector[3];
-
-                Voyage voyage(trip_id, route_id, service_id, trip_headsign);
-                m_voyages.insert(make_pair(trip_id, voyage));
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colRouteId = lecteur.getColonne("route_id");
+        const size_t colService = lecteur.getColonne("service_id");
+        const size_t colTripId = lecteur.getColonne("trip_id");
+        const size_t colDestination = lecteur.getColonneOptionnelle("trip_headsign");
+        string service_id, trip_id;
+
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            rangee[colService].copierDans(service_id);
+            auto itService = m_indexServices.find(service_id);
+            if (itService == m_indexServices.end()) return;
+            const bool actif = isServiceActif(itService->second, m_date);
+
+            if (actif || isServiceActif(itService->second, veille) || m_multiJours) {
+                unsigned int route_id = rangee[colRouteId].versEntier();
+                rangee[colTripId].copierDans(trip_id);
+
+                VoyageHoraire &horaire = m_horaire[trip_id];
+                horaire.voyage = Voyage(trip_id, route_id, service_id,
+                                        rangee[colDestination].versString(), m_arena.get());
+                horaire.service = itService->second;
+                if (actif) {
+                    m_voyages.emplace(trip_id, horaire.voyage);
+                }
             }
-
-        }
+        });
     } catch (exception &ex) {
         throw logic_error(ex.what());
     }
-
+    mesure.terminer(m_voyages.size());
 }
 
 //! \brief ajoute les arrets aux voyages présents dans le GTFS si l'heure du voyage appartient à l'intervalle de temps du GTFS
 //! \brief Un arrêt est ajouté SSI son heure de départ est >= now1 et que son heure d'arrivée est < now2
 //! \brief De plus, on enlève les voyages qui n'ont pas d'arrêts dans l'intervalle de temps du GTFS
 //! \brief De plus, on enlève les stations qui n'ont pas d'arrets dans l'intervalle de temps du GTFS
+//! \brief Les arrêts sont d'abord lus dans l'horaire compact m_horaire, puis les arrêts de la fenêtre sont créés par
+//! materialiserFenetre(); hors du mode multi-jours, l'horaire est ensuite libéré
 //! \param[in] p_nomFichier: le nom du fichier contenant les arrets
 //! \post assigne m_tousLesArretsPresents à true
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterArretsDesVoyagesDeLaDate(const std::string &p_nomFichier) {
-    ifstream fichier(p_nomFichier);
-    string ligne;
-
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ajouterArretsDesVoyagesDeLaDate");
     try {
-        getline(fichier, ligne);
-
-        while (getline(fichier, ligne)) {
-            vector<string> vector = string_to_vector(ligne, ',');
-
-            Heure *heure_arrivee = construireHeureDepuisString(vector[1]);
-            Heure *heure_depart = construireHeureDepuisString(vector[2]);
-
-            if (*heure_depart >= m_now1 && *heure_arrivee < m_now2) {
-
-                const string voyage_id = vector[0];
-                if (m_voyages.find(voyage_id) != m_voyages.end()) {
-
-                    unsigned int station_id = stoi(vector[3]);
-                    unsigned int numero_sequence = stoi(vector[4]);
-
-                    Arret::Ptr arret = make_shared<Arret>(station_id, *heure_arrivee, *heure_depart, numero_sequence,
-                                                          voyage_id);
-
-                    m_voyages.at(voyage_id).ajouterArret(arret);
-                    m_stations.at(station_id).addArret(arret);
-                    m_nbArrets++;
-                }
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colTripId = lecteur.getColonne("trip_id");
+        const size_t colArrivee = lecteur.getColonne("arrival_time");
+        const size_t colDepart = lecteur.getColonne("departure_time");
+        const size_t colStopId = lecteur.getColonne("stop_id");
+        const size_t colSequence = lecteur.getColonne("stop_sequence");
+        string trip_id;
+        auto itHoraire = m_horaire.end();
+
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            // les arrêts d'un même voyage sont habituellement consécutifs: on évite alors de chercher à nouveau
+            const LecteurCSV::Champ &champVoyage = rangee[colTripId];
+            if (!(champVoyage == trip_id.c_str())) {
+                champVoyage.copierDans(trip_id);
+                itHoraire = m_horaire.find(trip_id);
             }
-
-            delete heure_arrivee;
-            delete heure_depart;
+            if (itHoraire != m_horaire.end()) {
+                ArretHoraire arret = {rangee[colStopId].versEntier(), rangee[colSequence].versEntier(),
+                                      secondesDepuisChamp(rangee[colArrivee]), secondesDepuisChamp(rangee[colDepart])};
+                itHoraire->second.arrets.push_back(arret);
+            }
+        });
+
+        for (auto &itHoraire : m_horaire) {
+            vector<ArretHoraire> &arrets = itHoraire.second.arrets;
+            sort(arrets.begin(), arrets.end(), [](const ArretHoraire &a, const ArretHoraire &b) {
+                return a.numero_sequence < b.numero_sequence;
+            });
+            arrets.shrink_to_fit();
         }
 
-        supprimerVoyageSansArrets(m_voyages);
-        supprimerStationsSansArrets(m_stations);
+        materialiserFenetre();
+        if (!m_multiJours) {
+            m_horaire.clear();
+        }
 
         m_tousLesArretsPresents = true;
     } catch (exception &ex) {
         throw logic_error(ex.what());
     }
+    mesure.terminer(m_nbArrets);
 }
 
+//! \brief crée les arrêts de la fenêtre [m_now1, m_now2) de la date m_date à partir de l'horaire compact
+//! \brief Sont considérés les voyages dont le service est offert à m_date, ainsi que ceux dont le service est offert
+//! la veille pour leurs arrêts de 24:00:00 et plus (ramenés à la date sous l'identifiant trip_id + "@veille")
+//! \brief En fenêtre glissante, les arrêts dont l'heure d'arrivée est >= now2 sont conservés dans m_arretsAVenir, et
+//! les voyages et stations qui en possèdent ne sont pas enlevés
+//! \post m_voyages, m_stations, m_services et m_nbArrets correspondent à la date m_date et à la fenêtre
+void DonneesGTFS::materialiserFenetre() {
+    Instrumentation::MesurePhase mesure(m_instrumentation, "materialiserFenetre");
+    const unsigned int unJour = 24 * 3600;
+    const unsigned int now1 = m_now1 - Heure(0, 0, 0);
+    const unsigned int now2 = m_now2 - Heure(0, 0, 0);
+    const Date veille = m_date.add_jours(-1);
+
+    if (m_multiJours) {
+        if (m_toutesLesStations.empty()) {
+            m_toutesLesStations = m_stations;
+        } else {
+            m_stations = m_toutesLesStations;
+        }
+    }
+    m_voyages.clear();
+    m_nbArrets = 0;
+    m_arretsAVenir.clear();
+    m_prochainArretAVenir = 0;
+    m_retardsAVenir.clear();
+    mettreAJourServicesDeLaDate();
+
+    for (const auto &itHoraire : m_horaire) {
+        const Voyage &voyage = itHoraire.second.voyage;
+        for (unsigned int decalage = 0; decalage <= unJour; decalage += unJour) {
+            if (!isServiceActif(itHoraire.second.service, decalage == 0 ? m_date : veille)) continue;
+
+            auto itVoyage = m_voyages.end();
+            for (const ArretHoraire &arretHoraire : itHoraire.second.arrets) {
+                if (arretHoraire.arrivee < decalage) continue;
+                ArretHoraire arret = arretHoraire;
+                arret.arrivee -= decalage;
+                arret.depart -= decalage;
+
+                const bool dansLaFenetre = arret.depart >= now1 && arret.arrivee < now2;
+                if (!dansLaFenetre && !(m_fenetreGlissante && arret.arrivee >= now2)) continue;
+
+                if (itVoyage == m_voyages.end()) {
+                    const string voyage_id = decalage == 0 ? itHoraire.first : itHoraire.first + "@veille";
+                    itVoyage = m_voyages.emplace(piecewise_construct, forward_as_tuple(voyage_id),
+                                                 forward_as_tuple(voyage_id, voyage.getLigne(), voyage.getServiceId(),
+                                                                  voyage.getDestination(), m_arena.get())).first;
+                }
 
+                if (dansLaFenetre) {
+                    Arret::Ptr ptr = allocate_shared<Arret>(AllocateurArena<Arret>(m_arena.get()), arret.station_id,
+                                                            Heure(0, 0, 0).add_secondes(arret.arrivee),
+                                                            Heure(0, 0, 0).add_secondes(arret.depart),
+                                                            arret.numero_sequence, itVoyage->first);
+                    itVoyage->second.ajouterArret(ptr);
+                    m_stations.at(arret.station_id).addArret(ptr);
+                    m_nbArrets++;
+                } else {
+                    ArretAVenir aVenir = {arret, itVoyage, false};
+                    m_arretsAVenir.push_back(aVenir);
+                }
+            }
+        }
+    }
 
+    unordered_set<unsigned int> stationsAVenir;
+    stable_sort(m_arretsAVenir.begin(), m_arretsAVenir.end(), [](const ArretAVenir &a, const ArretAVenir &b) {
+        return a.horaire.arrivee < b.horaire.arrivee;
+    });
+    // chaque voyage ayant des arrêts à venir reçoit une entrée (vide) de retards à venir, libérée par son dernier arrêt
+    for (auto itArret = m_arretsAVenir.rbegin(); itArret != m_arretsAVenir.rend(); ++itArret) {
+        itArret->dernier = m_retardsAVenir.emplace(itArret->voyage->first, vector<pair<unsigned int, int>>()).second;
+    }
+    for (const auto &arret : m_arretsAVenir) {
+        stationsAVenir.insert(arret.horaire.station_id);
+    }
+    supprimerStationsSansArrets(m_stations, stationsAVenir);
+    filtrerTransferts();
+    mesure.terminer(m_nbArrets);
+}
@@ -0,0 +1,210 @@
+//
+// Générateur de charge pour serveurItineraires.
+// Des paires de stations assez éloignées (lues dans stops.txt) et des heures de départ sont tirées d'une graine fixe.
+// Chaque connexion garde <profondeur> requêtes en vol et en envoie une nouvelle dès qu'une réponse arrive, jusqu'à
+// épuisement de sa part des requêtes. Le débit soutenu et la distribution des latences (de l'envoi à la réception de
+// la réponse) sont écrits en JSON sur la sortie standard.
+//
+// Usage: generateurCharge [chemin_socket] [dossier_gtfs] [nb_requetes] [nb_connexions] [profondeur] [graine]
+//
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "coordonnees.h"
+#include "lecteurCSV.h"
+#include "outilsMesure.h"
+
+using namespace std;
+
+namespace {
+
+    const unsigned int debutDesDeparts = 6 * 3600; // les heures de départ sont tirées dans [06:00, 18:00)
+    const unsigned int plageDesDeparts = 12 * 3600;
+    const double distanceMin = 2.1 * 1.5;          // km: en deçà, la marche seule suffit
+
+    typedef chrono::steady_clock Horloge;
+
+    //! \brief tire un entier dans [0, p_n) avec une réduction par multiplication, identique sur toutes les plateformes
+    uint32_t tirer(mt19937 &p_generateur, uint32_t p_n) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(p_generateur()) * p_n) >> 32);
+    }
+
+    vector<Coordonnees> lireStations(const string &p_dossier) {
+        vector<Coordonnees> stations;
+        LecteurCSV lecteur(p_dossier + "/stops.txt");
+        const size_t colLatitude = lecteur.getColonne("stop_lat");
+        const size_t colLongitude = lecteur.getColonne("stop_lon");
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            stations.emplace_back(rangee[colLatitude].versReel(), rangee[colLongitude].versReel());
+        });
+        if (stations.size() < 2) throw logic_error("generateurCharge: il faut au moins deux stations");
+        return stations;
+    }
+
+    //! \brief construit les lignes de requête (sans identifiant ni fin de ligne)
+    vector<string> construireCorpus(const vector<Coordonnees> &p_stations, size_t p_nbRequetes, uint32_t p_graine) {
+        mt19937 generateur(p_graine);
+        vector<string> corpus;
+        corpus.reserve(p_nbRequetes);
+        for (size_t essai = 0; corpus.size() < p_nbRequetes; ++essai) {
+            if (essai == 1000 * p_nbRequetes)
+                throw logic_error("generateurCharge: impossible de trouver des paires de stations assez éloignées");
+            const Coordonnees &origine = p_stations[tirer(generateur, (uint32_t) p_stations.size())];
+            const Coordonnees &destination = p_stations[tirer(generateur, (uint32_t) p_stations.size())];
+            const unsigned int depart = debutDesDeparts + 60 * tirer(generateur, plageDesDeparts / 60);
+            if (origine - destination <= distanceMin) continue;
+            ostringstream ligne;
+            ligne << setprecision(9) << origine.getLatitude() << " " << origine.getLongitude() << " "
+                  << destination.getLatitude() << " " << destination.getLongitude() << " " << setfill('0') << setw(2)
+                  << depart / 3600 << ":" << setw(2) << depart / 60 % 60 << ":00";
+            corpus.push_back(ligne.str());
+        }
+        return corpus;
+    }
+
+    int connecter(const string &p_chemin) {
+        sockaddr_un adresse;
+        memset(&adresse, 0, sizeof(adresse));
+        adresse.sun_family = AF_UNIX;
+        strncpy(adresse.sun_path, p_chemin.c_str(), sizeof(adresse.sun_path) - 1);
+        const int client = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (client < 0 || connect(client, (sockaddr *) &adresse, sizeof(adresse)) != 0)
+            throw logic_error("generateurCharge: impossible de se connecter à " + p_chemin + ": " + strerror(errno));
+        return client;
+    }
+
+    void envoyer(int p_socket, const string &p_texte) {
+        size_t envoye = 0;
+        while (envoye < p_texte.size()) {
+            ssize_t n = send(p_socket, p_texte.data() + envoye, p_texte.size() - envoye, MSG_NOSIGNAL);
+            if (n <= 0) throw logic_error("generateurCharge: connexion perdue");
+            envoye += (size_t) n;
+        }
+    }
+
+    struct Resultats {
+        vector<double> latencesUs;
+        size_t nbAtteignables = 0;
+        size_t nbErreurs = 0;
+    };
+
+    //! \brief joue les requêtes [p_debut, p_fin) du corpus sur une connexion
+    void jouer(const string &p_chemin, const vector<string> &p_corpus, size_t p_debut, size_t p_fin,
+               size_t p_profondeur, Resultats &p_resultats) {
+        const int client = connecter(p_chemin);
+        unordered_map<size_t, Horloge::time_point> envois; // id -> heure d'envoi
+        size_t prochaine = p_debut, recues = 0;
+        auto envoyerSuivante = [&]() {
+            envois[prochaine] = Horloge::now();
+            envoyer(client, to_string(prochaine) + " " + p_corpus[prochaine] + "\n");
+            ++prochaine;
+        };
+        while (prochaine < p_fin && prochaine - p_debut < p_profondeur) envoyerSuivante();
+
+        string tampon;
+        char bloc[65536];
+        while (recues < p_fin - p_debut) {
+            const ssize_t n = recv(client, bloc, sizeof(bloc), 0);
+            if (n <= 0) throw logic_error("generateurCharge: le serveur a fermé la connexion");
+            tampon.append(bloc, (size_t) n);
+            size_t debutLigne = 0, finLigne;
+            while ((finLigne = tampon.find('\n', debutLigne)) != string::npos) {
+                const auto reception = Horloge::now();
+                const string reponse = tampon.substr(debutLigne, finLigne - debutLigne);
+                debutLigne = finLigne + 1;
+                // {"id": "<id>", ...
+                const size_t debutId = reponse.find("\"id\": \"");
+                if (debutId == string::npos) throw logic_error("generateurCharge: réponse sans identifiant");
+                const size_t id = stoul(reponse.substr(debutId + 7));
+                auto itEnvoi = envois.find(id);
+                if (itEnvoi == envois.end()) throw logic_error("generateurCharge: identifiant de réponse inconnu");
+                p_resultats.latencesUs.push_back(chrono::duration<double, micro>(reception - itEnvoi->second).count());
+                envois.erase(itEnvoi);
+                if (reponse.find("\"erreur\"") != string::npos) ++p_resultats.nbErreurs;
+                else if (reponse.find("\"atteignable\": true") != string::npos) ++p_resultats.nbAtteignables;
+                ++recues;
+                if (prochaine < p_fin) envoyerSuivante();
+            }
+            tampon.erase(0, debutLigne);
+        }
+        close(client);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const string chemin_socket = argc > 1 ? argv[1] : "/tmp/rtc.sock";
+    const string chemin_dossier = argc > 2 ? argv[2] : "data";
+    const size_t nbRequetes = argc > 3 ? stoul(argv[3]) : 20000;
+    const size_t nbConnexions = max<size_t>(1, argc > 4 ? stoul(argv[4]) : 8);
+    const size_t profondeur = max<size_t>(1, argc > 5 ? stoul(argv[5]) : 4);
+    const uint32_t graine = argc > 6 ? (uint32_t) stoul(argv[6]) : 2021;
+
+    try {
+        const vector<string> corpus = construireCorpus(lireStations(chemin_dossier), nbRequetes, graine);
+
+        vector<Resultats> resultats(nbConnexions);
+        vector<thread> connexions;
+        mutex verrouErreur;
+        string erreur;
+        const auto debut = Horloge::now();
+        for (size_t i = 0; i < nbConnexions; ++i) {
+            const size_t premiere = nbRequetes * i / nbConnexions, fin = nbRequetes * (i + 1) / nbConnexions;
+            connexions.emplace_back([&, i, premiere, fin]() {
+                try {
+                    jouer(chemin_socket, corpus, premiere, fin, profondeur, resultats[i]);
+                } catch (exception &ex) {
+                    lock_guard<mutex> garde(verrouErreur);
+                    erreur = ex.what();
+                }
+            });
+        }
+        for (auto &connexion : connexions) connexion.join();
+        const double duree = chrono::duration<double>(Horloge::now() - debut).count();
+        if (!erreur.empty()) throw logic_error(erreur);
+
+        vector<double> latences;
+        size_t nbAtteignables = 0, nbErreurs = 0;
+        for (const auto &resultat : resultats) {
+            latences.insert(latences.end(), resultat.latencesUs.begin(), resultat.latencesUs.end());
+            nbAtteignables += resultat.nbAtteignables;
+            nbErreurs += resultat.nbErreurs;
+        }
+        sort(latences.begin(), latences.end());
+        double somme = 0.0;
+        for (double latence : latences) somme += latence;
+
+        cout << fixed << setprecision(3) << "{\n";
+        cout << "  \"requetes\": " << latences.size() << ",\n";
+        cout << "  \"connexions\": " << nbConnexions << ",\n";
+        cout << "  \"profondeur\": " << profondeur << ",\n";
+        cout << "  \"atteignables\": " << nbAtteignables << ",\n";
+        cout << "  \"erreurs\": " << nbErreurs << ",\n";
+        cout << "  \"duree_s\": " << duree << ",\n";
+        cout << "  \"requetes_par_seconde\": " << (duree > 0 ? latences.size() / duree : 0.0) << ",\n";
+        cout << "  \"latence_us\": {\"p50\": " << centile(latences, 50) << ", \"p90\": " << centile(latences, 90)
+             << ", \"p99\": " << centile(latences, 99) << ", \"p999\": " << centile(latences, 99.9) << ", \"max\": "
+             << (latences.empty() ? 0.0 : latences.back()) << ", \"moyenne\": "
+             << (latences.empty() ? 0.0 : somme / latences.size()) << "}\n";
+        cout << "}\n";
+    } catch (exception &ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    return 0;
+}
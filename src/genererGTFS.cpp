@@ -0,0 +1,312 @@
+//
+// Générateur de flux GTFS synthétiques pour les essais de mise à l'échelle.
+// Les fichiers produits ont les mêmes colonnes que ceux du RTC: routes.txt, stops.txt, calendar_dates.txt, trips.txt,
+// stop_times.txt et transfers.txt.
+//
+// Usage: genererGTFS dossier [--lignes N] [--stations N] [--voyages N] [--arrets N] [--jours N] [--debut AAAAMMJJ]
+//                            [--densite D] [--graine N]
+//   --lignes   nombre de lignes d'autobus (défaut 150)
+//   --stations nombre de stations (défaut 4500)
+//   --voyages  nombre de voyages par ligne et par jour de semaine, les deux directions confondues (défaut 60)
+//   --arrets   nombre d'arrêts visés par ligne (défaut 30)
+//   --jours    nombre de jours de service à partir de la date de début (défaut 14)
+//   --debut    première date de service (défaut 20200920)
+//   --densite  nombre de stations par km², qui détermine la superficie couverte (défaut 8)
+//   --graine   graine du générateur aléatoire (défaut 1)
+//
+
+#include <sys/stat.h>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "auxiliaires.h"
+
+using namespace std;
+
+namespace {
+
+    struct Parametres {
+        unsigned int nbLignes = 150;
+        unsigned int nbStations = 4500;
+        unsigned int nbVoyagesParLigne = 60;
+        unsigned int nbArretsParLigne = 30;
+        unsigned int nbJours = 14;
+        Date debut = Date(2020, 9, 20);
+        double densite = 8.0;
+        unsigned int graine = 1;
+    };
+
+    const double latitudeCentre = 46.81;
+    const double longitudeCentre = -71.22;
+    const double kmParDegreLatitude = 111.2;
+    const double vitesseAutobus = 22.0;         // km/h, arrêts compris
+    const unsigned int arretAuxStations = 20;  // secondes à chaque arrêt
+    const unsigned int debutDuService = 5 * 3600;
+    const unsigned int finDuService = 24 * 3600 + 30 * 60; // des voyages se poursuivent après minuit
+    const double distanceMaxTransfert = 0.3;   // km
+    const char *const couleurs[] = {"97BF0D", "013888", "E04503", "1A171B"};
+
+    //! \brief stations disposées dans un carré de côté m_cote km, indexées par une grille pour les recherches de voisins
+    class Territoire {
+    public:
+        Territoire(unsigned int p_nbStations, double p_densite, mt19937 &p_generateur)
+                : m_cote(sqrt(p_nbStations / p_densite)), m_tailleCellule(1.0 / sqrt(p_densite)),
+                  m_nbCellules(max(1, (int) ceil(m_cote / m_tailleCellule))),
+                  m_cellules((size_t) m_nbCellules * m_nbCellules) {
+            uniform_real_distribution<double> position(0.0, m_cote);
+            for (unsigned int i = 0; i < p_nbStations; ++i) {
+                m_x.push_back(position(p_generateur));
+                m_y.push_back(position(p_generateur));
+                m_cellules[cellule(m_x.back(), m_y.back())].push_back(i);
+            }
+        }
+
+        size_t getNbStations() const { return m_x.size(); }
+        double x(size_t i) const { return m_x[i]; }
+        double y(size_t i) const { return m_y[i]; }
+        double latitude(size_t i) const { return latitudeCentre + (m_y[i] - m_cote / 2) / kmParDegreLatitude; }
+        double longitude(size_t i) const {
+            return longitudeCentre +
+                   (m_x[i] - m_cote / 2) / (kmParDegreLatitude * cos(latitudeCentre * M_PI / 180.0));
+        }
+        double distance(size_t i, size_t j) const { return hypot(m_x[i] - m_x[j], m_y[i] - m_y[j]); }
+
+        //! \brief la station la plus proche de i qui satisfait p_accepter, en cherchant dans des anneaux de cellules de
+        //! plus en plus grands, jusqu'à p_rayonMax km; retourne getNbStations() si aucune ne convient
+        template<typename Predicat>
+        size_t plusProche(size_t i, double p_rayonMax, Predicat p_accepter) const {
+            const int cx = coordonneeCellule(m_x[i]);
+            const int cy = coordonneeCellule(m_y[i]);
+            const int anneauMax = (int) ceil(p_rayonMax / m_tailleCellule);
+            size_t meilleure = getNbStations();
+            double meilleureDistance = p_rayonMax;
+            for (int anneau = 0; anneau <= anneauMax; ++anneau) {
+                // une station d'un anneau plus éloigné est à au moins (anneau - 1) cellules
+                if (meilleure != getNbStations() && (anneau - 1) * m_tailleCellule > meilleureDistance) break;
+                for (int dx = -anneau; dx <= anneau; ++dx) {
+                    for (int dy = -anneau; dy <= anneau; ++dy) {
+                        if (max(abs(dx), abs(dy)) != anneau) continue;
+                        const int gx = cx + dx, gy = cy + dy;
+                        if (gx < 0 || gy < 0 || gx >= m_nbCellules || gy >= m_nbCellules) continue;
+                        for (size_t j : m_cellules[(size_t) gy * m_nbCellules + gx]) {
+                            if (j == i) continue;
+                            const double d = distance(i, j);
+                            if (d <= meilleureDistance && p_accepter(j)) {
+                                meilleure = j;
+                                meilleureDistance = d;
+                            }
+                        }
+                    }
+                }
+            }
+            return meilleure;
+        }
+
+        //! \brief les stations à au plus p_rayon km de i
+        vector<size_t> voisines(size_t i, double p_rayon) const {
+            vector<size_t> resultat;
+            const int cx = coordonneeCellule(m_x[i]);
+            const int cy = coordonneeCellule(m_y[i]);
+            const int portee = (int) ceil(p_rayon / m_tailleCellule);
+            for (int gx = max(0, cx - portee); gx <= min(m_nbCellules - 1, cx + portee); ++gx) {
+                for (int gy = max(0, cy - portee); gy <= min(m_nbCellules - 1, cy + portee); ++gy) {
+                    for (size_t j : m_cellules[(size_t) gy * m_nbCellules + gx]) {
+                        if (j != i && distance(i, j) <= p_rayon) resultat.push_back(j);
+                    }
+                }
+            }
+            return resultat;
+        }
+
+    private:
+        int coordonneeCellule(double v) const {
+            return min(m_nbCellules - 1, max(0, (int) (v / m_tailleCellule)));
+        }
+        size_t cellule(double x, double y) const {
+            return (size_t) coordonneeCellule(y) * m_nbCellules + coordonneeCellule(x);
+        }
+
+        double m_cote;
+        double m_tailleCellule;
+        int m_nbCellules;
+        vector<vector<size_t>> m_cellules;
+        vector<double> m_x;
+        vector<double> m_y;
+    };
+
+    string formaterHeure(unsigned int p_secondes) {
+        ostringstream flux;
+        flux << setfill('0') << setw(2) << p_secondes / 3600 << ':' << setw(2) << (p_secondes % 3600) / 60 << ':'
+             << setw(2) << p_secondes % 60;
+        return flux.str();
+    }
+
+    string formaterDate(const Date &p_date) {
+        ostringstream flux;
+        flux << p_date;
+        string texte = flux.str(); // AAAA-MM-JJ
+        return texte.substr(0, 4) + texte.substr(5, 2) + texte.substr(8, 2);
+    }
+
+    //! \brief trace une ligne: à partir d'une station au hasard, on avance vers la station la plus proche située à moins
+    //! de 60 degrés de la direction courante, qui dévie légèrement à chaque arrêt
+    vector<size_t> tracerLigne(const Territoire &p_territoire, unsigned int p_nbArrets, mt19937 &p_generateur) {
+        uniform_int_distribution<size_t> depart(0, p_territoire.getNbStations() - 1);
+        uniform_real_distribution<double> angle(0.0, 2 * M_PI);
+        normal_distribution<double> deviation(0.0, 0.25);
+
+        vector<size_t> arrets(1, depart(p_generateur));
+        unordered_set<size_t> dejaDesservies(arrets.begin(), arrets.end());
+        double direction = angle(p_generateur);
+        const double rayonMax = 3.0;
+
+        while (arrets.size() < p_nbArrets) {
+            const size_t courante = arrets.back();
+            size_t prochaine = p_territoire.getNbStations();
+            for (int essai = 0; essai < 3 && prochaine == p_territoire.getNbStations(); ++essai) {
+                const double dx = cos(direction), dy = sin(direction);
+                prochaine = p_territoire.plusProche(courante, rayonMax, [&](size_t j) {
+                    if (dejaDesservies.count(j)) return false;
+                    const double vx = p_territoire.x(j) - p_territoire.x(courante);
+                    const double vy = p_territoire.y(j) - p_territoire.y(courante);
+                    return vx * dx + vy * dy >= 0.5 * hypot(vx, vy);
+                });
+                if (prochaine == p_territoire.getNbStations()) direction += M_PI / 2; // bord du territoire: on tourne
+            }
+            if (prochaine == p_territoire.getNbStations()) break;
+            arrets.push_back(prochaine);
+            dejaDesservies.insert(prochaine);
+            direction += deviation(p_generateur);
+        }
+        return arrets;
+    }
+
+    void ecrireFichiers(const string &p_dossier, const Parametres &p) {
+        mt19937 generateur(p.graine);
+        Territoire territoire(p.nbStations, p.densite, generateur);
+
+        ofstream stops(p_dossier + "/stops.txt");
+        stops << "stop_id,stop_name,stop_desc,stop_lat,stop_lon,stop_url,location_type,wheelchair_boarding\n"
+              << fixed << setprecision(6);
+        for (size_t i = 0; i < territoire.getNbStations(); ++i) {
+            stops << 1000 + i << ",\"Station " << i << "\",\"\"," << territoire.latitude(i) << ','
+                  << territoire.longitude(i) << ",\"\",,0\n";
+        }
+
+        // TOUSLESJOURS roule chaque jour, SEMAINE du lundi au vendredi seulement
+        ofstream calendar(p_dossier + "/calendar_dates.txt");
+        calendar << "service_id,date,exception_type\n";
+        for (unsigned int jour = 0; jour < p.nbJours; ++jour) {
+            const Date date = p.debut.add_jours((int) jour);
+            calendar << "TOUSLESJOURS," << formaterDate(date) << ",1\n";
+            if (date.getJourDeLaSemaine() < 5) calendar << "SEMAINE," << formaterDate(date) << ",1\n";
+        }
+
+        ofstream routes(p_dossier + "/routes.txt");
+        routes << "route_id,agency_id,route_short_name,route_long_name,route_desc,route_type,route_url,route_color,"
+                  "route_text_color\n";
+        ofstream trips(p_dossier + "/trips.txt");
+        trips << "route_id,service_id,trip_id,trip_headsign,direction_id,shape_id,wheelchair_accessible\n";
+        ofstream stopTimes(p_dossier + "/stop_times.txt");
+        stopTimes << "trip_id,arrival_time,departure_time,stop_id,stop_sequence,pickup_type,drop_off_type\n";
+
+        vector<unsigned int> nbLignesDeLaStation(territoire.getNbStations(), 0);
+        uniform_int_distribution<unsigned int> decalage(0, 120);
+        for (unsigned int l = 0; l < p.nbLignes; ++l) {
+            const unsigned int route_id = 1 + l;
+            const vector<size_t> arrets = tracerLigne(territoire, p.nbArretsParLigne, generateur);
+            for (size_t station : arrets) nbLignesDeLaStation[station]++;
+
+            routes << route_id << ",\"RTC\",\"" << route_id << "\",\"\",\"Ligne " << route_id << "\",3,\"\","
+                   << couleurs[l % 4] << ",FFFFFF\n";
+
+            vector<unsigned int> tempsDeParcours(arrets.size(), 0); // depuis le premier arrêt
+            for (size_t i = 1; i < arrets.size(); ++i) {
+                const double km = territoire.distance(arrets[i - 1], arrets[i]);
+                tempsDeParcours[i] = tempsDeParcours[i - 1] + arretAuxStations +
+                                     max(30u, (unsigned int) (km / vitesseAutobus * 3600));
+            }
+
+            const unsigned int intervalle = max(1u, (finDuService - debutDuService) / max(1u, p.nbVoyagesParLigne));
+            for (unsigned int v = 0; v < p.nbVoyagesParLigne; ++v) {
+                const bool retour = v % 2 == 1;
+                const string trip_id = "L" + to_string(route_id) + "_V" + to_string(v);
+                const char *service = (v / 2) % 2 == 0 ? "TOUSLESJOURS" : "SEMAINE";
+                const size_t terminus = retour ? arrets.front() : arrets.back();
+                trips << route_id << ',' << service << ",\"" << trip_id << "\",\"Direction " << 1000 + terminus
+                      << "\"," << (retour ? 1 : 0) << ",x,1\n";
+
+                const unsigned int depart = debutDuService + v * intervalle + decalage(generateur);
+                const unsigned int duree = tempsDeParcours.back();
+                for (size_t i = 0; i < arrets.size(); ++i) {
+                    const size_t indice = retour ? arrets.size() - 1 - i : i;
+                    const unsigned int heure = depart + (retour ? duree - tempsDeParcours[indice]
+                                                                : tempsDeParcours[indice]);
+                    const string texte = formaterHeure(heure);
+                    stopTimes << trip_id << ',' << texte << ',' << texte << ',' << 1000 + arrets[indice] << ','
+                              << i + 1 << ",0,0\n";
+                }
+            }
+        }
+
+        // transferts: correspondance sur place aux stations desservies par plusieurs lignes, et à pied vers les
+        // stations voisines
+        ofstream transfers(p_dossier + "/transfers.txt");
+        transfers << "from_stop_id,to_stop_id,transfer_type,min_transfer_time\n";
+        for (size_t i = 0; i < territoire.getNbStations(); ++i) {
+            if (nbLignesDeLaStation[i] == 0) continue;
+            if (nbLignesDeLaStation[i] > 1) transfers << 1000 + i << ',' << 1000 + i << ",2,0\n";
+            for (size_t j : territoire.voisines(i, distanceMaxTransfert)) {
+                if (nbLignesDeLaStation[j] == 0) continue;
+                const unsigned int marche = 60 + (unsigned int) (territoire.distance(i, j) / 5.0 * 3600);
+                transfers << 1000 + i << ',' << 1000 + j << ",2," << marche << '\n';
+            }
+        }
+    }
+
+    unsigned int lireEntier(int &i, int argc, char *argv[]) {
+        if (i + 1 >= argc) throw logic_error(string("genererGTFS: valeur manquante pour ") + argv[i]);
+        return (unsigned int) stoul(argv[++i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        cerr << "Usage: genererGTFS dossier [--lignes N] [--stations N] [--voyages N] [--arrets N] [--jours N] "
+                "[--debut AAAAMMJJ] [--densite D] [--graine N]" << endl;
+        return 1;
+    }
+    const string dossier = argv[1];
+    Parametres parametres;
+    for (int i = 2; i < argc; ++i) {
+        const string option = argv[i];
+        if (option == "--lignes") parametres.nbLignes = lireEntier(i, argc, argv);
+        else if (option == "--stations") parametres.nbStations = lireEntier(i, argc, argv);
+        else if (option == "--voyages") parametres.nbVoyagesParLigne = lireEntier(i, argc, argv);
+        else if (option == "--arrets") parametres.nbArretsParLigne = lireEntier(i, argc, argv);
+        else if (option == "--jours") parametres.nbJours = lireEntier(i, argc, argv);
+        else if (option == "--graine") parametres.graine = lireEntier(i, argc, argv);
+        else if (option == "--densite" && i + 1 < argc) parametres.densite = stod(argv[++i]);
+        else if (option == "--debut" && i + 1 < argc) {
+            const string texte = argv[++i];
+            if (texte.size() != 8) throw logic_error("genererGTFS: la date doit être au format AAAAMMJJ");
+            parametres.debut = Date(stoi(texte.substr(0, 4)), stoi(texte.substr(4, 2)), stoi(texte.substr(6, 2)));
+        } else throw logic_error("genererGTFS: option inconnue " + option);
+    }
+    if (parametres.nbStations < 2 || parametres.nbArretsParLigne < 2 || parametres.densite <= 0)
+        throw logic_error("genererGTFS: il faut au moins 2 stations, 2 arrêts par ligne et une densité positive");
+
+    mkdir(dossier.c_str(), 0755);
+    ecrireFichiers(dossier, parametres);
+    cout << "Flux GTFS écrit dans " << dossier << ": " << parametres.nbLignes << " lignes, " << parametres.nbStations
+         << " stations, " << parametres.nbVoyagesParLigne << " voyages par ligne, " << parametres.nbJours << " jours"
+         << endl;
+    return 0;
+}
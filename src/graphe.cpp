@@ -14,10 +14,65 @@
 
 using namespace std;
 
+namespace {
+
+    //! \brief observateur de Graphe::rechercherDepuisSources() qui ne fait rien: l'appel disparaît à la compilation
+    struct SansTrace {
+        void operator()(size_t, unsigned int) const {
+        }
+    };
+
+    //! \brief observateur de Graphe::rechercherDepuisSources() qui note les sommets solutionnés
+    struct AvecTrace {
+        explicit AvecTrace(TraceSommets &p_trace) : trace(p_trace) {
+        }
+        void operator()(size_t p_sommet, unsigned int p_cle) {
+            trace.emplace_back(p_sommet, p_cle);
+        }
+        TraceSommets &trace;
+    };
+}
+
 //! \brief Constructeur avec paramètre du nombre de sommets désiré
 //! \param[in] p_nbSommets indique le nombre de sommets désiré
 //! \post crée le vecteur de p_nbSommets de listes d'adjacence vides avec nbArcs=0
-Graphe::Graphe(size_t p_nbSommets) : m_listesAdj(p_nbSommets), m_nbArcs(0) {}
+//! \post les noeuds des listes d'adjacence proviennent d'une arène propre à ce graphe
+Graphe::Graphe(size_t p_nbSommets)
+        : m_arena(new ArenaMemoire), m_listesAdj(p_nbSommets, ListeArcs(AllocateurArena<Arc>(m_arena.get()))),
+          m_nbArcs(0) {}
+
+//! \brief constructeur de copie
+//! \post les listes d'adjacence sont recopiées dans une nouvelle arène, indépendante de celle de p_source
+Graphe::Graphe(const Graphe &p_source) : m_arena(new ArenaMemoire), m_nbArcs(p_source.m_nbArcs) {
+    m_listesAdj.reserve(p_source.m_listesAdj.size());
+    for (const auto &liste : p_source.m_listesAdj) {
+        m_listesAdj.emplace_back(liste.begin(), liste.end(), AllocateurArena<Arc>(m_arena.get()));
+    }
+}
+
+//! \brief constructeur de déplacement: les listes d'adjacence et leur arène sont transférées
+Graphe::Graphe(Graphe &&p_source) noexcept
+        : m_arena(std::move(p_source.m_arena)), m_listesAdj(std::move(p_source.m_listesAdj)),
+          m_nbArcs(p_source.m_nbArcs) {
+    p_source.m_nbArcs = 0;
+}
+
+Graphe &Graphe::operator=(const Graphe &p_source) {
+    if (this != &p_source) {
+        Graphe copie(p_source);
+        *this = std::move(copie);
+    }
+    return *this;
+}
+
+//! \brief affectation par déplacement
+//! \post les anciennes listes de cet objet sont détruites avec p_source, avant leur arène
+Graphe &Graphe::operator=(Graphe &&p_source) noexcept {
+    m_listesAdj.swap(p_source.m_listesAdj);
+    m_arena.swap(p_source.m_arena);
+    std::swap(m_nbArcs, p_source.m_nbArcs);
+    return *this;
+}
 
 //! \brief change le nombre de sommets du graphe
 //! \param[in] p_nouvelleTaille indique le nouveau nombre de sommet
@@ -34,13 +89,26 @@ void Graphe::resize(size_t p_nouvelleTaille) {
             m_nbArcs -= m_listesAdj[i].size();
         }
     }
-    m_listesAdj.resize(p_nouvelleTaille);
+    m_listesAdj.resize(p_nouvelleTaille, ListeArcs(AllocateurArena<Arc>(m_arena.get())));
 }
 
 size_t Graphe::getNbSommets() const { return m_listesAdj.size(); }
 
 size_t Graphe::getNbArcs() const { return m_nbArcs; }
 
+//! \brief ajoute au bilan la mémoire du vecteur des listes d'adjacence et de tous les noeuds de ces listes
+//! \param[in,out] p_bilan: le bilan à compléter
+//! \param[in] p_composante: le nom de la composante du bilan qui reçoit cette mémoire
+void Graphe::comptabiliserMemoire(BilanMemoire &p_bilan, const std::string &p_composante) const {
+    BilanMemoire::Composante &composante = p_bilan.composante(p_composante);
+    composante.nbElements += m_nbArcs;
+    composante.ajouterTableau(m_listesAdj.size(), m_listesAdj.capacity(), sizeof(ListeArcs));
+    size_t nbNoeuds = 0;
+    for (const auto &liste : m_listesAdj) nbNoeuds += liste.size();
+    composante.ajouterNoeudsListe(nbNoeuds, sizeof(Arc), m_arena != nullptr);
+    if (m_arena) p_bilan.ajouterArena(p_composante, *m_arena);
+}
+
 //! \brief ajoute un arc d'un poids donné dans le graphe
 //! \param[in] i: le sommet origine de l'arc
 //! \param[in] j: le sommet destination de l'arc
@@ -88,6 +156,17 @@ void Graphe::enleverArc(size_t i, size_t j) {
     --m_nbArcs;
 }
 
+//! \brief enlève tous les arcs sortant d'un sommet
+//! \param[in] i: le sommet dont les arcs sortants sont enlevés
+//! \post le sommet i existe toujours mais sa liste d'adjacence est vide; nbArcs est diminué en conséquence
+//! \throws logic_error lorsque le sommet i n'existe pas
+void Graphe::enleverArcsSortants(size_t i) {
+    if (i >= m_listesAdj.size())
+        throw logic_error("Graphe::enleverArcsSortants(): le sommet i n'existe pas");
+    m_nbArcs -= m_listesAdj[i].size();
+    m_listesAdj[i].clear();
+}
+
 unsigned int Graphe::getPoids(size_t i, size_t j) const {
     if (i >= m_listesAdj.size())
         throw logic_error("Graphe::getPoids(): l'incice i n,est pas un sommet existant");
@@ -98,12 +177,88 @@ unsigned int Graphe::getPoids(size_t i, size_t j) const {
     throw logic_error("Graphe::getPoids(): l'arc(i,j) est inexistant");
 }
 
+//! \brief indique si l'arc (i,j) est présent dans le graphe
+//! \throws logic_error lorsque le sommet i n'existe pas
+bool Graphe::arcExiste(size_t i, size_t j) const {
+    if (i >= m_listesAdj.size())
+        throw logic_error("Graphe::arcExiste(): l'incice i n,est pas un sommet existant");
+    for (const auto &arc : m_listesAdj[i]) {
+        if (arc.destination == j)
+            return true;
+    }
+    return false;
+}
+
+//! \brief modifie sur place le poids de l'arc (i,j), sans toucher à la structure du graphe
+//! \param[in] i: le sommet origine de l'arc
+//! \param[in] j: le sommet destination de l'arc
+//! \param[in] poids: le nouveau poids de l'arc; numeric_limits<unsigned int>::max() désactive l'arc, qui est alors
+//! ignoré par plusCourtChemin() jusqu'à ce qu'un poids valide lui soit redonné
+//! \post tous les arcs (i,j) présents ont le poids donné
+//! \throws logic_error lorsque le sommet i ou le sommet j n'existe pas
+//! \throws logic_error lorsque l'arc n'existe pas
+void Graphe::modifierPoids(size_t i, size_t j, unsigned int poids) {
+    if (i >= m_listesAdj.size())
+        throw logic_error("Graphe::modifierPoids(): tentative de modifier l'arc(i,j) avec un sommet i inexistant");
+    if (j >= m_listesAdj.size())
+        throw logic_error("Graphe::modifierPoids(): tentative de modifier l'arc(i,j) avec un sommet j inexistant");
+    bool arc_modifie = false;
+    for (auto &arc : m_listesAdj[i]) {
+        if (arc.destination == j) {
+            arc.poids = poids;
+            arc_modifie = true;
+        }
+    }
+    if (!arc_modifie)
+        throw logic_error("Graphe::modifierPoids(): cet arc n'existe pas; donc impossible de le modifier");
+}
+
+//! \brief retourne les sommets vers lesquels le sommet i possède un arc, dans l'ordre de la liste d'adjacence
+//! \throws logic_error lorsque le sommet i n'existe pas
+vector<size_t> Graphe::getSuccesseurs(size_t i) const {
+    if (i >= m_listesAdj.size())
+        throw logic_error("Graphe::getSuccesseurs(): le sommet i n'existe pas");
+    vector<size_t> successeurs;
+    successeurs.reserve(m_listesAdj[i].size());
+    for (const auto &arc : m_listesAdj[i]) {
+        successeurs.push_back(arc.destination);
+    }
+    return successeurs;
+}
+
 //! \brief Permet de trouver le plus court chemin entre le sommet p_origine et le sommet p_destination
 //! \param[in] p_origine: le sommet de départ \param[in] p_destination: le sommet de destination \param[out]
 //! p_chemin: le plus court chemin trouvé entre p_origine et p_destination \return Le poids du chemin le plus court
 //! entre p_origine et p_destination \throws logic_error lorsque p_origine ou p_destination n'existe pas
 unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, vector<size_t> &p_chemin) const {
+    StatistiquesRecherche statistiques;
+    return plusCourtChemin(p_origine, p_destination, p_chemin, statistiques);
+}
+
+//! \brief Comme plusCourtChemin(p_origine, p_destination, p_chemin), en comptabilisant le travail de la recherche
+//! \param[out] p_statistiques: les compteurs de la recherche (remis à zéro au début)
+unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, vector<size_t> &p_chemin,
+                                     StatistiquesRecherche &p_statistiques) const {
+    return plusCourtChemin(p_origine, p_destination, p_chemin, p_statistiques, vector<unsigned int>(),
+                           vector<unsigned int>());
+}
+
+//! \brief Comme plusCourtChemin(p_origine, p_destination, p_chemin, p_statistiques), guidé par une borne inférieure du
+//! coût restant jusqu'à p_destination
+//! \brief La file est ordonnée par distance plus borne (A*): les sommets dont cette somme dépasse la longueur du plus
+//! court chemin ne sont jamais solutionnés. Un sommet autre que p_destination dont la distance plus la borne atteint le
+//! poids provisoire de p_destination n'est pas empilé, un sommet dont la borne est infinie non plus, et la recherche
+//! s'arrête lorsque la clé en tête de file atteint ce poids. La durée retournée est celle de la recherche sans borne;
+//! à égalité, le chemin peut différer.
+//! \param[in] p_groupeDuSommet, p_borneDuGroupe: les bornes inférieures du coût restant jusqu'à p_destination, par
+//! groupe de sommets (voir DestinationParGroupes); un sommet sans groupe a la borne 0
+//! \pre les bornes sont cohérentes: pour tout arc (u, v), borne(u) <= poids de l'arc + borne(v)
+unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, vector<size_t> &p_chemin,
+                                     StatistiquesRecherche &p_statistiques,
+                                     const vector<unsigned int> &p_groupeDuSommet,
+                                     const vector<unsigned int> &p_borneDuGroupe) const {
     p_chemin.clear();
+    p_statistiques = StatistiquesRecherche();
 
     if (p_origine >= m_listesAdj.size() || p_destination >= m_listesAdj.size()) {
         throw logic_error("Graphe::dijkstra(): p_origine ou p_destination n'existe pas");
@@ -118,14 +273,19 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, vec
     vector<bool> sommetsSolutionnes(tailleGraphe, false);
     vector<size_t> predecesseur(tailleGraphe, numeric_limits<size_t>::max());
 
-    typedef size_t DistanceSommet;
+    typedef size_t CleSommet; // distance depuis p_origine plus borne
     typedef size_t NumeroSommet;
-    typedef pair<DistanceSommet, NumeroSommet> sommet;
+    typedef pair<CleSommet, NumeroSommet> sommet;
     // Contient les sommets solutionnés en bordures des sommets non solutionnés
     priority_queue<sommet, vector<sommet>, greater<sommet>> q;
 
+    auto borneDe = [&](size_t p_sommet) -> unsigned int {
+        return p_sommet < p_groupeDuSommet.size() ? p_borneDuGroupe[p_groupeDuSommet[p_sommet]] : 0;
+    };
+
     poids[p_origine] = 0;
-    q.push({0, p_origine});
+    q.push({borneDe(p_origine), p_origine});
+    p_statistiques.sommetsEmpiles++;
 
     while (!q.empty()) {
         size_t numeroSommetCourant = q.top().second;
@@ -133,15 +293,26 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, vec
             // Le sommet est le sommet destination, on a trouvé le chemin le plus court
             break;
         }
+        if (q.top().first >= poids[p_destination]) {
+            // Aucun sommet restant ne peut mener à la destination plus tôt que son poids provisoire
+            break;
+        }
 
         // À la prochaine itération, le sommet courant n'aura plus de sommet adjacent non solutionnés, on l'enlève donc
         // de q ici
         q.pop();
+        if (sommetsSolutionnes[numeroSommetCourant]) continue; // entrée périmée: le sommet a déjà été solutionné
+        p_statistiques.sommetsSolutionnes++;
         sommetsSolutionnes[numeroSommetCourant] = true;
 
         // On boucle sur tous les arc (sommets adjacent) du sommet courant
         auto arc = m_listesAdj[numeroSommetCourant].begin();
         for (; arc != m_listesAdj[numeroSommetCourant].end(); ++arc) {
+            // Les arcs désactivés (ex: correspondance rendue impossible par un retard) sont ignorés
+            if (arc->poids == numeric_limits<unsigned int>::max()) {
+                continue;
+            }
+            p_statistiques.arcsRelaches++;
             // Si le sommet de l'arc n'est pas solutionné
             if (!sommetsSolutionnes[arc->destination]) {
                 // On récupère la distance entre le sommet courrant et le sommet de l'arc
@@ -151,11 +322,19 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, vec
                 // Si la distance entre le sommet courant et le sommet de l'arc est plus petit que le poids enregistré
                 // au numéro correspondant au sommet de l'arc
                 if (distanceSommetAdjacent < poids[numeroSommetAdjacent]) {
+                    const unsigned int borne = borneDe(numeroSommetAdjacent);
+                    if (numeroSommetAdjacent != p_destination &&
+                        (borne == numeric_limits<unsigned int>::max() ||
+                         (size_t) distanceSommetAdjacent + borne >= poids[p_destination])) {
+                        p_statistiques.etiquettesElaguees++;
+                        continue;
+                    }
                     // On remplace le poids enregistré à ce numero de sommet
                     poids[arc->destination] = distanceSommetAdjacent;
 
                     // On ajoute à la sommet adjacent à "q" afin de solutionner ses sommets adjacent s'il y en a
-                    q.push({poids[numeroSommetAdjacent], numeroSommetAdjacent});
+                    q.push({poids[numeroSommetAdjacent] + borne, numeroSommetAdjacent});
+                    p_statistiques.sommetsEmpiles++;
                     predecesseur[arc->destination] = numeroSommetCourant;
                 }
             }
@@ -186,3 +365,139 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, vec
 
     return poids[p_destination];
 }
+
+//! \brief Plus court chemin d'une source virtuelle, reliée aux sommets de p_sources, à une destination virtuelle, reliée
+//! aux sommets des groupes de p_destination, sans ajouter ces deux sommets ni leurs arcs au graphe
+//! \brief Le graphe n'est pas modifié: plusieurs recherches peuvent se faire simultanément sur un même graphe.
+//! \param[in] p_sources: les sommets d'entrée et le coût pour les atteindre depuis la source virtuelle
+//! \param[in] p_groupeDuSommet: le groupe de chaque sommet (voir DestinationParGroupes)
+//! \param[in] p_destination: le coût de sortie et la borne inférieure du coût restant de chaque groupe
+//! \param[out] p_chemin: les sommets du plus court chemin, du sommet d'entrée au sommet de sortie (vide si la
+//! destination n'est pas atteignable)
+//! \param[out] p_statistiques: les compteurs de la recherche (remis à zéro au début)
+//! \brief La file est ordonnée par distance plus borne du groupe (A*), la borne de la destination virtuelle étant 0:
+//! une étiquette dont la distance plus la borne atteint la meilleure arrivée connue n'est pas empilée, et la recherche
+//! s'arrête dès que la clé en tête de file atteint cette arrivée. À égalité, le chemin peut différer de celui d'une
+//! recherche sans borne, mais pas son poids.
+//! \return le poids du plus court chemin, coûts d'entrée et de sortie compris (numeric_limits<unsigned int>::max() si la
+//! destination n'est pas atteignable)
+//! \throws logic_error lorsqu'un sommet de p_sources n'existe pas
+//! \pre p_destination a une sortie et une borne pour chaque groupe de p_groupeDuSommet, et les bornes sont cohérentes:
+//! borne(u) <= poids de l'arc + borne(v) pour tout arc (u, v), et borne(u) <= sortie(u)
+unsigned int Graphe::plusCourtChemin(const vector<SommetPondere> &p_sources,
+                                     const vector<unsigned int> &p_groupeDuSommet,
+                                     const DestinationParGroupes &p_destination, vector<size_t> &p_chemin,
+                                     StatistiquesRecherche &p_statistiques) const {
+    SansTrace sansTrace;
+    return rechercherDepuisSources(p_sources, p_groupeDuSommet, p_destination, p_chemin, p_statistiques, sansTrace);
+}
+
+//! \brief Comme plusCourtChemin(p_sources, p_groupeDuSommet, p_destination, p_chemin, p_statistiques), en notant dans
+//! p_trace chaque sommet solutionné et sa clé, dans l'ordre (la destination virtuelle n'y figure pas)
+//! \brief La recherche sans trace est compilée séparément: elle ne paie rien pour cette option.
+//! \param[out] p_trace: les sommets solutionnés (vidée au début)
+unsigned int Graphe::plusCourtChemin(const vector<SommetPondere> &p_sources,
+                                     const vector<unsigned int> &p_groupeDuSommet,
+                                     const DestinationParGroupes &p_destination, vector<size_t> &p_chemin,
+                                     StatistiquesRecherche &p_statistiques, TraceSommets &p_trace) const {
+    p_trace.clear();
+    AvecTrace avecTrace(p_trace);
+    return rechercherDepuisSources(p_sources, p_groupeDuSommet, p_destination, p_chemin, p_statistiques, avecTrace);
+}
+
+template<typename Observateur>
+unsigned int Graphe::rechercherDepuisSources(const vector<SommetPondere> &p_sources,
+                                             const vector<unsigned int> &p_groupeDuSommet,
+                                             const DestinationParGroupes &p_destination, vector<size_t> &p_chemin,
+                                             StatistiquesRecherche &p_statistiques,
+                                             Observateur &p_observateur) const {
+    p_chemin.clear();
+    p_statistiques = StatistiquesRecherche();
+
+    const size_t tailleGraphe = m_listesAdj.size();
+    const size_t destinationVirtuelle = tailleGraphe;
+    const size_t aucun = numeric_limits<size_t>::max();
+    const unsigned int infini = numeric_limits<unsigned int>::max();
+    vector<unsigned int> poids(tailleGraphe + 1, infini);
+    vector<bool> sommetsSolutionnes(tailleGraphe + 1, false);
+    vector<size_t> predecesseur(tailleGraphe + 1, aucun);
+
+    typedef pair<unsigned long long, size_t> sommet; // <distance plus borne, numéro>
+    priority_queue<sommet, vector<sommet>, greater<sommet>> q;
+
+    auto sortieDe = [&](size_t p_sommet) -> unsigned int {
+        unsigned int sortie = p_sommet < p_groupeDuSommet.size() ? p_destination.sortie[p_groupeDuSommet[p_sommet]]
+                                                                 : infini;
+        if (p_destination.franchis && p_sommet + 1 < p_destination.debutFranchis->size()) {
+            for (size_t k = (*p_destination.debutFranchis)[p_sommet];
+                 k < (*p_destination.debutFranchis)[p_sommet + 1]; ++k) {
+                const SommetPondere &point = (*p_destination.franchis)[k];
+                const unsigned int sortiePoint = p_destination.sortie[point.first];
+                if (point.second != infini && sortiePoint != infini) sortie = min(sortie, point.second + sortiePoint);
+            }
+        }
+        return sortie;
+    };
+    auto borneDe = [&](size_t p_sommet) -> unsigned int {
+        return p_sommet < p_groupeDuSommet.size() ? p_destination.borne[p_groupeDuSommet[p_sommet]] : 0;
+    };
+    for (const auto &source : p_sources) {
+        if (source.first >= tailleGraphe)
+            throw logic_error("Graphe::plusCourtChemin(): un sommet d'entrée n'existe pas");
+        if (source.second < poids[source.first] && borneDe(source.first) != infini) {
+            poids[source.first] = source.second;
+            q.push({(unsigned long long) source.second + borneDe(source.first), source.first});
+            p_statistiques.sommetsEmpiles++;
+        }
+    }
+
+    while (!q.empty()) {
+        const size_t courant = q.top().second;
+        if (courant == destinationVirtuelle) break;
+        // aucune étiquette restante ne peut améliorer la meilleure arrivée connue
+        if (q.top().first >= poids[destinationVirtuelle]) break;
+        q.pop();
+        if (sommetsSolutionnes[courant]) continue; // entrée périmée
+        const unsigned int distance = poids[courant];
+        sommetsSolutionnes[courant] = true;
+        p_statistiques.sommetsSolutionnes++;
+        p_observateur(courant, distance + borneDe(courant));
+
+        // l'arc implicite vers la destination virtuelle
+        const unsigned int sortie = sortieDe(courant);
+        if (sortie != infini && distance + sortie < poids[destinationVirtuelle]) {
+            poids[destinationVirtuelle] = distance + sortie;
+            predecesseur[destinationVirtuelle] = courant;
+            q.push({poids[destinationVirtuelle], destinationVirtuelle}); // sa borne est 0
+            p_statistiques.sommetsEmpiles++;
+        }
+        for (const auto &arc : m_listesAdj[courant]) {
+            // Les arcs désactivés (ex: correspondance rendue impossible par un retard) sont ignorés
+            if (arc.poids == infini) continue;
+            p_statistiques.arcsRelaches++;
+            if (sommetsSolutionnes[arc.destination]) continue;
+            const unsigned int distanceAdjacent = distance + arc.poids;
+            if (distanceAdjacent < poids[arc.destination]) {
+                // une borne infinie écarte le sommet même avant la première arrivée: la destination n'en est pas
+                // atteignable
+                const unsigned long long cle = (unsigned long long) distanceAdjacent + borneDe(arc.destination);
+                if (cle >= poids[destinationVirtuelle]) {
+                    p_statistiques.etiquettesElaguees++;
+                    continue;
+                }
+                poids[arc.destination] = distanceAdjacent;
+                predecesseur[arc.destination] = courant;
+                q.push({cle, arc.destination});
+                p_statistiques.sommetsEmpiles++;
+            }
+        }
+    }
+
+    if (predecesseur[destinationVirtuelle] == aucun) return infini;
+
+    for (size_t numero = predecesseur[destinationVirtuelle]; numero != aucun; numero = predecesseur[numero]) {
+        p_chemin.push_back(numero);
+    }
+    reverse(p_chemin.begin(), p_chemin.end());
+    return poids[destinationVirtuelle];
+}
@@ -10,12 +10,56 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include <set>
 #include <stack>
 #include <queue>
 #include <limits>
 #include <iostream>
 #include <algorithm>
+#include <string>
+
+#include "arena.h"
+#include "memoire.h"
+
+//! \brief compteurs d'une recherche de plus court chemin
+struct StatistiquesRecherche
+{
+	StatistiquesRecherche() :
+			sommetsSolutionnes(0), arcsRelaches(0), sommetsEmpiles(0), etiquettesElaguees(0)
+	{
+	}
+	size_t sommetsSolutionnes; /*!< sommets retirés de la file de priorité pour la première fois */
+	size_t arcsRelaches;       /*!< arcs (actifs) examinés depuis un sommet solutionné */
+	size_t sommetsEmpiles;     /*!< insertions dans la file de priorité */
+	size_t etiquettesElaguees; /*!< améliorations écartées parce qu'elles ne peuvent plus battre la meilleure arrivée */
+};
+
+//! \brief sommet d'entrée (ou de sortie) d'une recherche multi-sources, avec le coût pour l'atteindre depuis la source
+//! virtuelle (ou pour atteindre la destination virtuelle à partir de lui)
+typedef std::pair<size_t, unsigned int> SommetPondere;
+
+//! \brief destination virtuelle d'une recherche, décrite par groupes de sommets (ex: les arrêts d'une même station)
+//! \brief Le sommet i appartient au groupe p_groupeDuSommet[i], donné à la recherche (les sommets d'indice supérieur
+//! n'appartiennent à aucun groupe). La destination virtuelle est atteinte depuis tout sommet du groupe g au coût
+//! sortie[g], et borne[g] est une borne inférieure du coût restant depuis un sommet du groupe g; la valeur
+//! numeric_limits<unsigned int>::max() indique que la destination n'est pas atteinte directement depuis le groupe
+//! (sortie) ou qu'elle n'en est pas atteignable du tout (borne). Un sommet sans groupe n'a ni sortie ni borne (0).
+//! \brief Si franchis n'est pas nul, le sommet i passe en outre, sans pouvoir y changer de chemin, par les points
+//! (*franchis)[k], (*debutFranchis)[i] <= k < (*debutFranchis)[i + 1], donnés par <groupe, coût pour y arriver depuis
+//! i> (numeric_limits<unsigned int>::max() s'il n'y arrive pas): il sort aussi par chacun d'eux, à ce coût plus la
+//! sortie de leur groupe, et le plus petit coût de sortie est retenu (la borne du groupe de i ne doit pas le dépasser).
+struct DestinationParGroupes
+{
+	std::vector<unsigned int> sortie;
+	std::vector<unsigned int> borne;
+	const std::vector<size_t> *debutFranchis = nullptr;
+	const std::vector<SommetPondere> *franchis = nullptr;
+};
+
+//! \brief trace d'une recherche: les sommets solutionnés dans l'ordre où ils sortent de la file de priorité, chacun avec
+//! sa clé (sa distance depuis la source virtuelle plus sa borne inférieure du coût restant)
+typedef std::vector<SommetPondere> TraceSommets;
 
 //! \brief  Classe pour graphes orientés pondérés (non négativement) avec listes d'adjacence
 class Graphe
@@ -23,15 +67,49 @@ class Graphe
 public:
 
 	explicit Graphe(size_t = 0);
+	Graphe(const Graphe &);
+	Graphe(Graphe &&) noexcept;
+	Graphe & operator=(const Graphe &);
+	Graphe & operator=(Graphe &&) noexcept;
     void resize(size_t);
 	void ajouterArc(size_t i, size_t j, unsigned int poids);
 	void enleverArc(size_t i, size_t j);
+	void enleverArcsSortants(size_t i);
 	unsigned int getPoids(size_t i, size_t j) const;
+	bool arcExiste(size_t i, size_t j) const;
+	void modifierPoids(size_t i, size_t j, unsigned int poids);
+	std::vector<size_t> getSuccesseurs(size_t i) const;
+
+	//! \brief appelle p_visiteur(destination, poids) pour chaque arc sortant du sommet i, dans l'ordre de la liste
+	//! d'adjacence, sans copier les successeurs (arcs désactivés compris: poids == numeric_limits<unsigned int>::max())
+	//! \pre le sommet i existe
+	template<typename Visiteur>
+	void pourChaqueArcSortant(size_t i, Visiteur p_visiteur) const
+	{
+		for (const Arc &arc : m_listesAdj[i]) p_visiteur(arc.destination, arc.poids);
+	}
+
 	size_t getNbSommets() const;
     size_t getNbArcs() const;
+    void comptabiliserMemoire(BilanMemoire & p_bilan, const std::string & p_composante) const;
 
     unsigned int plusCourtChemin(size_t p_origine, size_t p_destination,
                              std::vector<size_t> & p_chemin) const;
+    unsigned int plusCourtChemin(size_t p_origine, size_t p_destination,
+                             std::vector<size_t> & p_chemin, StatistiquesRecherche & p_statistiques) const;
+    unsigned int plusCourtChemin(size_t p_origine, size_t p_destination,
+                             std::vector<size_t> & p_chemin, StatistiquesRecherche & p_statistiques,
+                             const std::vector<unsigned int> & p_groupeDuSommet,
+                             const std::vector<unsigned int> & p_borneDuGroupe) const;
+    unsigned int plusCourtChemin(const std::vector<SommetPondere> & p_sources,
+                             const std::vector<unsigned int> & p_groupeDuSommet,
+                             const DestinationParGroupes & p_destination,
+                             std::vector<size_t> & p_chemin, StatistiquesRecherche & p_statistiques) const;
+    unsigned int plusCourtChemin(const std::vector<SommetPondere> & p_sources,
+                             const std::vector<unsigned int> & p_groupeDuSommet,
+                             const DestinationParGroupes & p_destination,
+                             std::vector<size_t> & p_chemin, StatistiquesRecherche & p_statistiques,
+                             TraceSommets & p_trace) const;
 
 private:
 
@@ -45,9 +123,20 @@ private:
 		unsigned int poids;
 	};
 
-	std::vector<std::list<Arc> > m_listesAdj; /*!< les listes d'adjacence */
+	typedef std::list<Arc, AllocateurArena<Arc> > ListeArcs;
+
+	std::unique_ptr<ArenaMemoire> m_arena; /*!< fournit les noeuds des listes; déclarée avant celles-ci pour être détruite après */
+	std::vector<ListeArcs> m_listesAdj; /*!< les listes d'adjacence */
     unsigned long m_nbArcs;
 
+	//! \brief corps de la recherche multi-sources; p_observateur(sommet, clé) est appelé à chaque sommet solutionné
+	template<typename Observateur>
+	unsigned int rechercherDepuisSources(const std::vector<SommetPondere> & p_sources,
+	                                     const std::vector<unsigned int> & p_groupeDuSommet,
+	                                     const DestinationParGroupes & p_destination,
+	                                     std::vector<size_t> & p_chemin, StatistiquesRecherche & p_statistiques,
+	                                     Observateur & p_observateur) const;
+
 };
 
 #endif  //GRAPH_H
@@ -8,10 +8,19 @@
 
 using namespace std;
 
-unsigned int getPoidsEntre2Coord(const double &vitesseDeMarche, const double &distanceMaxMarche,
+// conteneurs temporaires des étapes de construction du graphe: leurs noeuds sont pris dans une arène propre à l'étape,
+// recyclés d'une station à l'autre et rendus au système d'un coup à la fin de l'étape
+template<typename Cle, typename Valeur>
+using MapTemporaire = map<Cle, Valeur, less<Cle>, AllocateurArena<pair<const Cle, Valeur>>>;
+template<typename Cle, typename Valeur>
+using MultimapTemporaire = multimap<Cle, Valeur, less<Cle>, AllocateurArena<pair<const Cle, Valeur>>>;
+
+unsigned int getPoidsEntre2Coord(const double &vitesseDeMarche,
                                  const Coordonnees &coordDepart,
                                  const Coordonnees &coordArrivee) {
-    return (unsigned int) (((coordDepart - coordArrivee) / vitesseDeMarche) * 3600);
+    double distance = coordDepart - coordArrivee;
+    if (distance != distance) distance = 0; // acos() d'un arrondi au-delà de 1: points confondus
+    return (unsigned int) ((distance / vitesseDeMarche) * 3600);
 }
 
 //! \brief Permet de valider qu'une station est présente dans les transferts
@@ -29,8 +38,7 @@ bool isStationPresenteDansTransfert(const Station &station,
 //! \brief Permet de construire deux arrêt servant de noeud d'origine et de
 //! destination
 tuple<Arret::Ptr, Arret::Ptr> creerArretsOrigineDestination(const unsigned int stationIdOrigine,
-                                                            const unsigned int stationIdDestination,
-                                                            unsigned int nombreArcs) {
+                                                            const unsigned int stationIdDestination) {
     Arret::Ptr arretOrigine = make_shared<Arret>(
             stationIdOrigine,
             Heure(1, 1, 1),
@@ -51,62 +59,61 @@ tuple<Arret::Ptr, Arret::Ptr> creerArretsOrigineDestination(const unsigned int s
 }
 
 //! \brief Permet la récupération des arrêts des stations atteignable depuis le
-//! noeud d'origine (au départ du graphe) \brief et dont le poids est plus petit
-//! ou égale à distanceMaxMarche
-multimap<Arret::Ptr, Coordonnees> getArretsAtteingnableAPiedDepuisOrigine(const Arret::Ptr &arretOrigine,
-                                                                          const Coordonnees &coordArretOrigine,
-                                                                          const double distanceMaxMarche,
-                                                                          const map<unsigned int, Station> &stations,
-                                                                          const map<string, Voyage> &voyages) {
-    multimap<Arret::Ptr, Coordonnees> arretsAtteignable;
-
-    // On filtre les stations par celles qui sont atteignable à pied
-    for (const auto &itStations : stations) {
-        const Station &station = itStations.second;
-
-        if ((coordArretOrigine - station.getCoords()) <= distanceMaxMarche) {
-            const multimap<Heure, Arret::Ptr> &arrets = station.getArrets();
-            map<unsigned int, Arret::Ptr> arretsAvecLigneDifferente;
-
-            for (const auto &itArrets : arrets) {
-                Arret::Ptr arret = itArrets.second;
-
-                unsigned int numLigne = voyages.at(arret->getVoyageId()).getLigne();
-                auto it = arretsAvecLigneDifferente.find(numLigne);
-                if (it != arretsAvecLigneDifferente.end()) {
-                    if (it->second->getHeureArrivee() > arret->getHeureArrivee()) {
-                        it->second = arret;
-                    }
-                } else {
-                    arretsAvecLigneDifferente.insert({numLigne, arret});
-                }
-
-            }
+//! noeud d'origine (au départ du graphe)
+//! \brief Pour chaque station et chaque ligne, seul le premier arrêt qu'il est possible d'attraper en partant à pieds
+//! à p_heureDepart est retenu
+//! \param[in] stations: les stations à au plus distanceMaxMarche du point origine et le temps de marche pour s'y rendre
+//! (voir ReseauGTFS::stationsAMoinsDe())
+//! \return les arrêts retenus, chacun avec le temps de marche depuis le point origine
+vector<pair<Arret::Ptr, unsigned int>> getArretsAtteingnableAPiedDepuisOrigine(
+        const Heure &p_heureDepart, const vector<pair<const Station *, unsigned int>> &stations,
+        const map<string, Voyage> &voyages) {
+    vector<pair<Arret::Ptr, unsigned int>> arretsAtteignable;
+
+    for (const auto &stationAPied : stations) {
+        const Station::Arrets &arrets = stationAPied.first->getArrets();
+        map<unsigned int, Arret::Ptr> arretsAvecLigneDifferente;
+
+        auto itArrets = arrets.lower_bound(p_heureDepart.add_secondes(stationAPied.second));
+        for (; itArrets != arrets.end(); ++itArrets) {
+            Arret::Ptr arret = itArrets->second;
+
+            unsigned int numLigne = voyages.at(arret->getVoyageId()).getLigne();
+            // les arrêts sont parcourus en ordre d'heure d'arrivée: le premier de chaque ligne est conservé
+            arretsAvecLigneDifferente.insert({numLigne, arret});
+        }
 
-            for (const auto &arret : arretsAvecLigneDifferente) {
-                arretsAtteignable.insert({arret.second, station.getCoords()});
-            }
+        for (const auto &arret : arretsAvecLigneDifferente) {
+            arretsAtteignable.emplace_back(arret.second, stationAPied.second);
         }
     }
     return arretsAtteignable;
 }
 
 //! \brief Permet la récupération des arrêts qui sont entre les stations et
-//! l'arrêt destination (à la fin du graphe) \brief et dont le poids est plus
-//! petit ou égale à distanceMaxMarche
-multimap<Arret::Ptr, Coordonnees> getArretsEntreStationsEtDestination(const Arret::Ptr &arretDestination,
-                                                                      const Coordonnees &coordArretDestination,
-                                                                      const double distanceMaxMarche,
-                                                                      const map<unsigned int, Station> &stations) {
-    multimap<Arret::Ptr, Coordonnees> arretsAtteignable;
-
-    for (const auto &itStations : stations) {
-        const Station &station = itStations.second;
-        if ((coordArretDestination - station.getCoords()) <= distanceMaxMarche) {
-            const multimap<Heure, Arret::Ptr> &arrets = itStations.second.getArrets();
-            for (const auto &itArrets : arrets) {
-                arretsAtteignable.insert({itArrets.second, itStations.second.getCoords()});
-            }
+//! l'arrêt destination (à la fin du graphe)
+//! \brief Seuls les arrêts où il peut être utile de descendre sont retenus: les arcs ne remontant jamais le temps, aucun
+//! arrêt qui arrive avant le plus tôt des arrêts d'entrée n'est atteignable. Chaque station ne garde donc que ses arrêts
+//! à partir de cette heure.
+//! \param[in] stations: les stations à au plus distanceMaxMarche du point destination et le temps de marche pour s'y
+//! rendre (voir ReseauGTFS::stationsAMoinsDe())
+//! \param[in] arretsEntree: les arrêts d'entrée de la recherche (voir getArretsAtteingnableAPiedDepuisOrigine())
+//! \return les arrêts retenus, chacun avec le temps de marche vers le point destination
+vector<pair<Arret::Ptr, unsigned int>> getArretsEntreStationsEtDestination(
+        const vector<pair<const Station *, unsigned int>> &stations,
+        const vector<pair<Arret::Ptr, unsigned int>> &arretsEntree) {
+    vector<pair<Arret::Ptr, unsigned int>> arretsAtteignable;
+    if (arretsEntree.empty()) return arretsAtteignable;
+
+    Heure arriveeAuPlusTot = arretsEntree.front().first->getHeureArrivee();
+    for (const auto &entree : arretsEntree) {
+        if (entree.first->getHeureArrivee() < arriveeAuPlusTot) arriveeAuPlusTot = entree.first->getHeureArrivee();
+    }
+
+    for (const auto &stationAPied : stations) {
+        const Station::Arrets &arrets = stationAPied.first->getArrets();
+        for (auto itArrets = arrets.lower_bound(arriveeAuPlusTot); itArrets != arrets.end(); ++itArrets) {
+            arretsAtteignable.emplace_back(itArrets->second, stationAPied.second);
         }
     }
 
@@ -114,18 +121,20 @@ multimap<Arret::Ptr, Coordonnees> getArretsEntreStationsEtDestination(const Arre
 }
 
 //! \brief Permet de récupérer les arcs attente
-multimap<Arret::Ptr, Arret::Ptr> getArcsAttente(const unsigned int delaisMinArcAttente,
-                                                const Station &station,
-                                                const multimap<Heure, Arret::Ptr> &arretsDeLaStation,
-                                                const map<string, Voyage> &voyages) {
-    multimap<Arret::Ptr, Arret::Ptr> arcsAttente;
+//! \param[in] p_arena: l'arène des conteneurs temporaires, dont vient aussi le conteneur retourné
+MultimapTemporaire<Arret::Ptr, Arret::Ptr> getArcsAttente(const unsigned int delaisMinArcAttente,
+                                                          const Station::Arrets &arretsDeLaStation,
+                                                          const map<string, Voyage> &voyages,
+                                                          ArenaMemoire &p_arena) {
+    const AllocateurArena<char> allocateur(&p_arena);
+    MultimapTemporaire<Arret::Ptr, Arret::Ptr> arcsAttente(allocateur);
 
     // On boucle sur tous les arrêts
     for (const auto &itArretFrom: arretsDeLaStation) {
         Arret::Ptr arretFrom = itArretFrom.second;
         unsigned int arretFromNumeroLigne = voyages.find(arretFrom->getVoyageId())->second.getLigne();
 
-        map<unsigned int, Arret::Ptr> arcsPossiblesVersArretTo;
+        MapTemporaire<unsigned int, Arret::Ptr> arcsPossiblesVersArretTo(allocateur);
 
         auto itArretTo = arretsDeLaStation.lower_bound(itArretFrom.first.add_secondes(delaisMinArcAttente));
         for (; itArretTo != arretsDeLaStation.end(); itArretTo++) {
@@ -153,42 +162,40 @@ multimap<Arret::Ptr, Arret::Ptr> getArcsAttente(const unsigned int delaisMinArcA
 }
 
 //! \brief Permet de récupérer les arcs de transfert qui sont valide
-map<Arret::Ptr, map<string, Arret::Ptr>> getArcsDeTransferts(const multimap<Heure, Arret::Ptr> &arretsStationFrom,
-                                                             const multimap<Heure, Arret::Ptr> &arretsStationTo,
-                                                             unsigned int minTransferTime,
-                                                             const map<string, Voyage> &voyages,
-                                                             const unordered_map<unsigned int, Ligne> &lignes) {
-    map<Arret::Ptr, map<string, Arret::Ptr>> arcsPossibles;
-
-    //On boucle sur tous les arrêts de la station from_station_id
-    for (const auto &itArretsFrom : arretsStationFrom) {
-        map<string, Arret::Ptr> arretsToPossibles;
-
-        Arret::Ptr arretFrom = itArretsFrom.second;
-        auto itArretsTo = arretsStationTo.lower_bound(
-                arretFrom->getHeureArrivee().add_secondes(minTransferTime));
-
-        // On boucl sur tous les arrês de la station to_station_id
-        for (; itArretsTo != arretsStationTo.end(); itArretsTo++) {
-            Arret::Ptr arretTo = itArretsTo->second;
-
-            const string &fromLigneNumero = lignes.find(
-                    voyages.at(arretFrom->getVoyageId()).getLigne())->second.getNumero();
-            const string &toLigneNumero = lignes.find(
-                    voyages.at(arretTo->getVoyageId()).getLigne())->second.getNumero();
-
-            if (fromLigneNumero != toLigneNumero) {
-                auto it = arretsToPossibles.find(toLigneNumero);
-                if (it != arretsToPossibles.end()) {
-                    if (it->second->getHeureArrivee() > arretTo->getHeureArrivee()) {
-                        it->second = arretFrom;
-                    }
-                } else {
-                    arretsToPossibles.insert({toLigneNumero, arretFrom});
-                }
-            }
+//! Pour chaque arrêt de la station de départ, on retient, pour chaque autre ligne, le premier arrêt de la station
+//! d'arrivée au moins minTransferTime secondes plus tard. Les arrêts de départ sont parcourus du dernier au premier:
+//! leur seuil ne fait que reculer, de sorte que chaque arrêt d'arrivée n'est ajouté qu'une fois aux premiers arrêts
+//! par ligne, au lieu d'un parcours de toute la station d'arrivée pour chaque arrêt de départ.
+//! \param[in] p_arena: l'arène des conteneurs temporaires, dont vient aussi le conteneur retourné
+MapTemporaire<Arret::Ptr, MapTemporaire<string, Arret::Ptr>> getArcsDeTransferts(
+        const Station::Arrets &arretsStationFrom,
+        const Station::Arrets &arretsStationTo,
+        unsigned int minTransferTime,
+        const map<string, Voyage> &voyages,
+        const unordered_map<unsigned int, Ligne> &lignes,
+        ArenaMemoire &p_arena) {
+    const AllocateurArena<char> allocateur(&p_arena);
+    MapTemporaire<Arret::Ptr, MapTemporaire<string, Arret::Ptr>> arcsPossibles(allocateur);
+    auto numeroDeLigne = [&](const Arret::Ptr &p_arret) {
+        return lignes.find(voyages.at(p_arret->getVoyageId()).getLigne())->second.getNumero();
+    };
+
+    // premiers arrêts par ligne de la station to_station_id parmi ceux de [itArretsTo, fin)
+    MapTemporaire<string, Arret::Ptr> premiersParLigne(allocateur);
+    auto itArretsTo = arretsStationTo.end();
+
+    //On boucle sur tous les arrêts de la station from_station_id, du dernier au premier
+    for (auto itArretsFrom = arretsStationFrom.rbegin(); itArretsFrom != arretsStationFrom.rend(); ++itArretsFrom) {
+        const Arret::Ptr &arretFrom = itArretsFrom->second;
+        const auto seuil = arretsStationTo.lower_bound(arretFrom->getHeureArrivee().add_secondes(minTransferTime));
+        while (itArretsTo != seuil) {
+            --itArretsTo;
+            premiersParLigne[numeroDeLigne(itArretsTo->second)] = itArretsTo->second;
         }
-        arcsPossibles.insert({arretFrom, arretsToPossibles});
+
+        MapTemporaire<string, Arret::Ptr> arretsToPossibles(premiersParLigne);
+        arretsToPossibles.erase(numeroDeLigne(arretFrom));
+        arcsPossibles.emplace(arretFrom, std::move(arretsToPossibles));
     }
     return arcsPossibles;
 }
@@ -207,11 +214,14 @@ void ReseauGTFS::ajouterArcsVoyages(const DonneesGTFS &p_gtfs) {
 
             for (const auto &arret : arrets) {
                 m_arretDuSommet.push_back(arret);
+                m_stationDuSommet.push_back(indiceDeStation(arret->getStationId()));
+                associerLigne(idArret, itVoyages.second.getLigne());
                 m_sommetDeArret.insert({arret, idArret});
 
                 if (arret != *arrets.begin()) {
                     unsigned int poids = arret->getHeureArrivee() - m_arretDuSommet[idArret - 1]->getHeureArrivee();
                     m_leGraphe.ajouterArc(idArret - 1, idArret, poids);
+                    abaisserTempsMinimal(idArret - 1, idArret, poids);
                 }
 
                 idArret++;
@@ -227,37 +237,204 @@ void ReseauGTFS::ajouterArcsVoyages(const DonneesGTFS &p_gtfs) {
 
 
 //! \brief ajouts des arcs dus aux transferts entre stations
+//! \brief Les tables m_transfertsVersStation et m_transfertsDepuisStation sont vidées, puis remplies avec les
+//! transferts de p_gtfs.getTransferts(); ajouterArcsTrajetsAPied() les complète ensuite avec les trajets à pieds.
+//! \post m_versionTransferts vaut p_gtfs.getVersionTransferts()
 //! \throws logic_error si une incohérence est détecté lors de cette étape de
 //! construction du graphe
 void ReseauGTFS::ajouterArcsTransferts(const DonneesGTFS &p_gtfs) {
     try {
-        const vector<tuple<unsigned int, unsigned int, unsigned int>> &transferts = p_gtfs.getTransferts();
-        const map<unsigned int, Station> &stations = p_gtfs.getStations();
-        const map<string, Voyage> &voyages = p_gtfs.getVoyages();
-        const unordered_map<unsigned int, Ligne> &lignes = p_gtfs.getLignes();
+        m_transfertsVersStation.clear();
+        m_transfertsDepuisStation.clear();
+        m_versionTransferts = p_gtfs.getVersionTransferts();
+        ArenaMemoire arenaTemporaire;
 
         // On boucle sur tous les transferts
-        for (const auto &transfert : transferts) {
+        for (const auto &transfert : p_gtfs.getTransferts()) {
             const unsigned int fromStationId = get<0>(transfert);
             const unsigned int toStationId = get<1>(transfert);
             unsigned int minTransferTime = get<2>(transfert);
+            m_transfertsVersStation[toStationId].emplace_back(fromStationId, minTransferTime);
+            m_transfertsDepuisStation[fromStationId].emplace_back(toStationId, minTransferTime);
+            ajouterArcsEntreStations(p_gtfs, fromStationId, toStationId, minTransferTime, arenaTemporaire);
+        }
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+}
 
-            const multimap<Heure, Arret::Ptr> &arretsStationFrom = stations.at(fromStationId).getArrets();
-            const multimap<Heure, Arret::Ptr> &arretsStationTo = stations.at(toStationId).getArrets();
+//! \brief ajoute les arcs de transfert d'une station à une autre (voir getArcsDeTransferts())
+//! \param[in] p_arenaTemporaire: l'arène des conteneurs temporaires du calcul
+void ReseauGTFS::ajouterArcsEntreStations(const DonneesGTFS &p_gtfs, unsigned int p_fromStationId,
+                                          unsigned int p_toStationId, unsigned int p_minTransferTime,
+                                          ArenaMemoire &p_arenaTemporaire) {
+    const map<unsigned int, Station> &stations = p_gtfs.getStations();
+    const MapTemporaire<Arret::Ptr, MapTemporaire<string, Arret::Ptr>> arcs = getArcsDeTransferts(
+            stations.at(p_fromStationId).getArrets(), stations.at(p_toStationId).getArrets(), p_minTransferTime,
+            p_gtfs.getVoyages(), p_gtfs.getLignes(), p_arenaTemporaire
+    );
 
-            const map<Arret::Ptr, map<string, Arret::Ptr>> arcs = getArcsDeTransferts(
-                    arretsStationFrom, arretsStationTo, minTransferTime, voyages, lignes
-            );
+    for (const auto &arretFrom: arcs) {
+        for (const auto &arretTo : arretFrom.second) {
+            unsigned int poids = arretTo.second->getHeureArrivee() - arretFrom.first->getHeureArrivee();
+            size_t idArretFrom = m_sommetDeArret[arretFrom.first];
+            size_t idArretTo = m_sommetDeArret[arretTo.second];
 
-            for (const auto &arretFrom: arcs) {
-                for (const auto &arretTo : arretFrom.second) {
-                    unsigned int poids = arretTo.second->getHeureArrivee() - arretFrom.first->getHeureArrivee();
-                    size_t idArretFrom = m_sommetDeArret[arretFrom.first];
-                    size_t idArretTo = m_sommetDeArret[arretTo.second];
+            m_leGraphe.ajouterArc(idArretFrom, idArretTo, poids);
+            abaisserTempsMinimal(idArretFrom, idArretTo, poids);
+        }
+    }
+}
+
+//! \brief range les coordonnées des stations dans m_coordonneesStations, dans l'ordre de p_gtfs.getStations()
+//! \brief La table est construite une seule fois, avec le réseau: les stations de p_gtfs et leurs coordonnées ne
+//! changent pas ensuite. DonneesGTFS::avancerFenetre() et appliquerRetard() ne retirent aucune station (une station
+//! dont les arrêts ont tous expiré reste présente, sans arrêts), et DonneesGTFS::changerDate(), qui peut changer les
+//! stations présentes, exige de reconstruire le réseau.
+//! \post m_tempsMinimauxVersStation a une liste vide par station
+void ReseauGTFS::indexerStations(const DonneesGTFS &p_gtfs) {
+    const map<unsigned int, Station> &stations = p_gtfs.getStations();
+    m_coordonneesStations.reserver(stations.size());
+    m_idStations.reserve(stations.size());
+    for (const auto &station : stations) {
+        m_coordonneesStations.ajouter(station.second.getCoords());
+        m_idStations.push_back(station.first);
+    }
+    m_tempsMinimauxVersStation.assign(stations.size(), vector<pair<unsigned int, unsigned int>>());
+    m_lignesDeStation.assign(stations.size(), vector<unsigned int>());
+}
+
+//! \brief retourne l'indice de la station p_stationId dans m_idStations (et m_coordonneesStations)
+//! \throws logic_error si la station n'a pas été indexée
+unsigned int ReseauGTFS::indiceDeStation(unsigned int p_stationId) const {
+    auto it = lower_bound(m_idStations.begin(), m_idStations.end(), p_stationId);
+    if (it == m_idStations.end() || *it != p_stationId)
+        throw logic_error("ReseauGTFS::indiceDeStation(): station inconnue");
+    return (unsigned int) (it - m_idStations.begin());
+}
+
+//! \brief note dans m_ligneDuSommet l'indice de la ligne p_ligneId du voyage du sommet p_sommet, et la desserte de la
+//! station du sommet par cette ligne dans m_stationsDeLigne et m_lignesDeStation
+//! \brief Comme les temps minimaux, les dessertes ne font que s'ajouter: une ligne qui ne passe plus par une station
+//! (fenêtre glissante) ne fait que rendre plus faible le nombre minimal de montées (voir calculerMonteesMinimales()).
+//! \pre m_stationDuSommet[p_sommet] est à jour; p_sommet est au plus m_ligneDuSommet.size() (sommet ajouté)
+void ReseauGTFS::associerLigne(size_t p_sommet, unsigned int p_ligneId) {
+    auto itLigne = m_indiceDeLigne.find(p_ligneId);
+    if (itLigne == m_indiceDeLigne.end()) {
+        itLigne = m_indiceDeLigne.insert({p_ligneId, (unsigned int) m_stationsDeLigne.size()}).first;
+        m_stationsDeLigne.emplace_back();
+    }
+    const unsigned int ligne = itLigne->second;
+    if (p_sommet == m_ligneDuSommet.size()) m_ligneDuSommet.push_back(ligne);
+    else m_ligneDuSommet[p_sommet] = ligne;
+
+    const unsigned int station = m_stationDuSommet[p_sommet];
+    vector<unsigned int> &lignes = m_lignesDeStation[station];
+    if (find(lignes.begin(), lignes.end(), ligne) == lignes.end()) {
+        lignes.push_back(ligne);
+        m_stationsDeLigne[ligne].push_back(station);
+    }
+}
+
+//! \brief tient compte de l'arc (p_de, p_vers) de poids p_poids dans m_tempsMinimauxVersStation
+//! \brief Le temps minimal d'une station à une autre ne fait que baisser: un arc retiré ou alourdi (fenêtre glissante,
+//! retards) laisse une borne plus faible, mais toujours valide. Les arcs d'une station vers elle-même, ceux des points
+//! origine et destination et les arcs infranchissables sont ignorés. Les extrémités peuvent être des arrêts contractés
+//! (voir poidsRaccourci()).
+void ReseauGTFS::abaisserTempsMinimal(size_t p_de, size_t p_vers, unsigned int p_poids) {
+    const unsigned int aucune = numeric_limits<unsigned int>::max();
+    const unsigned int stationDe = this->stationDe(p_de);
+    const unsigned int stationVers = this->stationDe(p_vers);
+    if (p_poids == numeric_limits<unsigned int>::max() || stationDe == aucune || stationVers == aucune ||
+        stationDe == stationVers)
+        return;
+    for (auto &entrant : m_tempsMinimauxVersStation[stationVers]) {
+        if (entrant.first == stationDe) {
+            entrant.second = min(entrant.second, p_poids);
+            return;
+        }
+    }
+    m_tempsMinimauxVersStation[stationVers].emplace_back(stationDe, p_poids);
+}
+
+//! \brief calcule p_destination.borne à partir de p_destination.sortie, par un algorithme de Dijkstra à rebours sur le
+//! graphe des stations dont chaque arc a pour poids le plus petit poids des arcs d'une station à l'autre
+//! (m_tempsMinimauxVersStation)
+//! \brief La borne d'une station ne dépasse donc jamais le coût restant depuis un de ses arrêts: un trajet d'un arrêt à
+//! la destination emprunte une suite de stations dont chaque passage coûte au moins ce plus petit poids, et les arcs à
+//! l'intérieur d'une station coûtent au moins 0. Le temps de marche de la station à la destination seul ne serait pas
+//! une borne: un autobus va plus vite qu'un piéton.
+//! \param[in,out] p_destination: la sortie de chaque station (numeric_limits<unsigned int>::max() si aucune)
+//! \post p_destination.borne[i] est la borne de la station d'indice i (numeric_limits<unsigned int>::max() si la
+//! destination n'en est pas atteignable)
+void ReseauGTFS::calculerBornes(DestinationParGroupes &p_destination) const {
+    const unsigned int infini = numeric_limits<unsigned int>::max();
+    typedef pair<unsigned int, unsigned int> StationPonderee; // <borne, indice de station>
+    priority_queue<StationPonderee, vector<StationPonderee>, greater<StationPonderee>> file;
+    p_destination.borne.assign(m_idStations.size(), infini);
+    for (unsigned int station = 0; station < p_destination.sortie.size(); ++station) {
+        if (p_destination.sortie[station] == infini) continue;
+        p_destination.borne[station] = p_destination.sortie[station];
+        file.push({p_destination.sortie[station], station});
+    }
+    while (!file.empty()) {
+        const StationPonderee courante = file.top();
+        file.pop();
+        if (courante.first > p_destination.borne[courante.second]) continue;
+        for (const auto &entrant : m_tempsMinimauxVersStation[courante.second]) {
+            const unsigned int borne = courante.first + entrant.second;
+            if (borne < p_destination.borne[entrant.first]) {
+                p_destination.borne[entrant.first] = borne;
+                file.push({borne, entrant.first});
+            }
+        }
+    }
+}
+
+//! \brief retourne, dans l'ordre des identifiants, les stations à au plus p_distance km de p_point, chacune avec le
+//! temps de marche (en secondes, à vitesseDeMarche) depuis p_point
+//! \brief Le résultat est celui d'une comparaison de Coordonnees::operator-() avec chaque station, mais seules les
+//! stations retenues par le filtre en lot de TableCoordonnees::indicesAMoinsDe() y sont soumises. Les coordonnées
+//! viennent du tableau compact m_coordonneesStations: aucune n'est copiée.
+vector<pair<const Station *, unsigned int>> ReseauGTFS::stationsAMoinsDe(const DonneesGTFS &p_gtfs,
+                                                                        const Coordonnees &p_point,
+                                                                        double p_distance) const {
+    vector<size_t> indices;
+    m_coordonneesStations.indicesAMoinsDe(p_point, p_distance, indices);
+    vector<pair<const Station *, unsigned int>> stations;
+    stations.reserve(indices.size());
+    for (size_t indice : indices)
+        stations.emplace_back(&p_gtfs.getStations().at(m_idStations[indice]),
+                              tempsDeMarche(p_point, m_coordonneesStations.getCoordonnees(indice)));
+    return stations;
+}
 
-                    m_leGraphe.ajouterArc(idArretFrom, idArretTo, poids);
+//! \brief ajouts des arcs dus aux trajets à pieds entre stations voisines (DonneesGTFS::getTrajetsAPied())
+//! \brief Un trajet à pieds est un transfert dont le temps minimal est le temps de marche à vitesseDeMarche; les paires
+//! de stations déjà reliées par un transfert de transfers.txt gardent ce transfert. Les stations reliées uniquement par
+//! des trajets à pieds conservent leurs arcs d'attente (voir ajouterArcsAttente()).
+//! \pre ajouterArcsTransferts() a été appelée
+//! \throws logic_error si une incohérence est détecté lors de cette étape de construction du graphe
+void ReseauGTFS::ajouterArcsTrajetsAPied(const DonneesGTFS &p_gtfs) {
+    try {
+        ArenaMemoire arenaTemporaire;
+
+        for (const auto &trajet : p_gtfs.getTrajetsAPied()) {
+            auto &transfertsDepuis = m_transfertsDepuisStation[trajet.from_station_id];
+            bool dejaRelies = false;
+            for (const auto &transfert : transfertsDepuis) {
+                if (transfert.first == trajet.to_station_id) {
+                    dejaRelies = true;
+                    break;
                 }
             }
+            if (dejaRelies) continue;
+
+            const unsigned int tempsDeMarche = max(1u, (unsigned int) (trajet.distance / vitesseDeMarche * 3600));
+            m_transfertsVersStation[trajet.to_station_id].emplace_back(trajet.from_station_id, tempsDeMarche);
+            transfertsDepuis.emplace_back(trajet.to_station_id, tempsDeMarche);
+            ajouterArcsEntreStations(p_gtfs, trajet.from_station_id, trajet.to_station_id, tempsDeMarche,
+                                     arenaTemporaire);
         }
     } catch (exception &ex) {
         throw logic_error(ex.what());
@@ -272,15 +449,16 @@ void ReseauGTFS::ajouterArcsAttente(const DonneesGTFS &p_gtfs) {
         const map<unsigned int, Station> &stations = p_gtfs.getStations();
         const vector<tuple<unsigned int, unsigned int, unsigned int>> &transferts = p_gtfs.getTransferts();
         const map<string, Voyage> &voyages = p_gtfs.getVoyages();
+        ArenaMemoire arenaTemporaire;
 
         for (const auto &itStations : stations) {
             const Station &station = itStations.second;
 
             if (!isStationPresenteDansTransfert(station, transferts)) {
-                const multimap<Heure, Arret::Ptr> &arretsDeLaStation = station.getArrets();
+                const Station::Arrets &arretsDeLaStation = station.getArrets();
 
-                const multimap<Arret::Ptr, Arret::Ptr> arcsAttentes =
-                        getArcsAttente(delaisMinArcsAttente, station, arretsDeLaStation, voyages);
+                const MultimapTemporaire<Arret::Ptr, Arret::Ptr> arcsAttentes =
+                        getArcsAttente(delaisMinArcsAttente, arretsDeLaStation, voyages, arenaTemporaire);
 
                 for (const auto &pair: arcsAttentes) {
                     unsigned int poids = pair.second->getHeureArrivee() - pair.first->getHeureArrivee();
@@ -310,55 +488,106 @@ void ReseauGTFS::ajouterArcsAttente(const DonneesGTFS &p_gtfs) {
 //! destination
 void ReseauGTFS::ajouterArcsOrigineDestination(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
                                                const Coordonnees &p_pointDestination) {
-    try {
-        tuple<Arret::Ptr, Arret::Ptr> arretsOrigineDestination =
-                creerArretsOrigineDestination(stationIdOrigine, stationIdDestination, getNbArcs());
-        Arret::Ptr arretOrigine = get<0>(arretsOrigineDestination);
-        Arret::Ptr arretDestination = get<1>(arretsOrigineDestination);
-
-        m_sommetOrigine = m_sommetDeArret.size(); // Prochain numéro de sommet disponible
-        m_sommetDeArret.insert({arretOrigine, m_sommetOrigine});
-        m_arretDuSommet.push_back(arretOrigine);
-
-        m_sommetDestination = m_sommetDeArret.size();
-        m_sommetDeArret.insert({arretDestination, m_sommetDestination});
-        m_arretDuSommet.push_back(arretDestination);
-
-        m_leGraphe.resize(m_leGraphe.getNbSommets() + 2);
-
-
-        multimap<Arret::Ptr, Coordonnees> arretsAtteignablesDepuisOrigine = getArretsAtteingnableAPiedDepuisOrigine(
-                arretOrigine, p_pointOrigine, distanceMaxMarche, p_gtfs.getStations(), p_gtfs.getVoyages());
-        m_nbArcsOrigineVersStations = 0;
-        for (const auto &pair: arretsAtteignablesDepuisOrigine) {
-            size_t idArcOrigine = m_sommetOrigine;
-            size_t idArcDestination = m_sommetDeArret[pair.first];
-            Coordonnees coordonneesArret = pair.second;
-            unsigned int poids = getPoidsEntre2Coord(vitesseDeMarche, distanceMaxMarche, p_pointOrigine,
-                                                     coordonneesArret);
-
-            m_leGraphe.ajouterArc(idArcOrigine, idArcDestination, poids);
-            m_nbArcsOrigineVersStations++;
-        }
-
-        multimap<Arret::Ptr, Coordonnees> arretsAtteignableDepuisDestination = getArretsEntreStationsEtDestination(
-                arretDestination, p_pointDestination, distanceMaxMarche, p_gtfs.getStations());
-        for (const auto &pair : arretsAtteignableDepuisDestination) {
-            size_t idArcOrigine = m_sommetDeArret[pair.first];
-            size_t idArcDestination = m_sommetDestination;
-            Coordonnees coordonneesArret = pair.second;
-            unsigned int poids = getPoidsEntre2Coord(vitesseDeMarche, distanceMaxMarche, p_pointDestination,
-                                                     coordonneesArret);
-
-            m_leGraphe.ajouterArc(idArcOrigine, idArcDestination, poids);
-            m_sommetsVersDestination.push_back(idArcOrigine);
-        }
-        m_nbArcsStationsVersDestination = m_sommetsVersDestination.size();
+    ajouterArcsOrigineDestination(p_gtfs, p_pointOrigine, p_pointDestination, p_gtfs.getTempsDebut());
+}
 
-        m_origine_dest_ajoute = true;
+//! \brief Comme ajouterArcsOrigineDestination(p_gtfs, p_pointOrigine, p_pointDestination), en partant du point
+//! d'origine à l'heure donnée plutôt qu'au début de l'intervalle de temps du GTFS
+//! \param[in] p_heureDepart: l'heure de départ du point d'origine
+//! \throws logic_error si p_heureDepart n'appartient pas à l'intervalle de temps du GTFS
+void ReseauGTFS::ajouterArcsOrigineDestination(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                               const Coordonnees &p_pointDestination, const Heure &p_heureDepart) {
+    if (p_heureDepart < p_gtfs.getTempsDebut() || !(p_heureDepart < p_gtfs.getTempsFin()))
+        throw logic_error("ReseauGTFS::ajouterArcsOrigineDestination(): heure de départ hors de l'intervalle du GTFS");
+    const auto debut = Instrumentation::Horloge::now();
+    try {
+        construireOrigineDestination(p_gtfs, p_pointOrigine, p_pointDestination, p_heureDepart);
     } catch (exception &ex) {
         throw logic_error(ex.what());
     }
+    if (m_instrumentation) m_instrumentation->nouvelleRequete().superpositionUs = Instrumentation::microsecondesDepuis(debut);
+}
+
+//! \brief corps de ajouterArcsOrigineDestination(), sans sa mesure: appliquerRetards() s'en sert pour replacer les
+//! points origine et destination sur un réseau compacté
+void ReseauGTFS::construireOrigineDestination(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                              const Coordonnees &p_pointDestination, const Heure &p_heureDepart) {
+    tuple<Arret::Ptr, Arret::Ptr> arretsOrigineDestination =
+            creerArretsOrigineDestination(stationIdOrigine, stationIdDestination);
+    Arret::Ptr arretOrigine = get<0>(arretsOrigineDestination);
+    Arret::Ptr arretDestination = get<1>(arretsOrigineDestination);
+
+    m_heureDepart = p_heureDepart;
+    m_pointOrigine = p_pointOrigine;
+    m_pointDestination = p_pointDestination;
+    m_sommetOrigine = m_arretDuSommet.size(); // Prochain numéro de sommet disponible
+    m_sommetDeArret.insert({arretOrigine, m_sommetOrigine});
+    m_arretDuSommet.push_back(arretOrigine);
+
+    m_sommetDestination = m_arretDuSommet.size();
+    m_sommetDeArret.insert({arretDestination, m_sommetDestination});
+    m_arretDuSommet.push_back(arretDestination);
+
+    m_leGraphe.resize(m_leGraphe.getNbSommets() + 2);
+
+
+    const vector<pair<Arret::Ptr, unsigned int>> arretsAtteignablesDepuisOrigine =
+            getArretsAtteingnableAPiedDepuisOrigine(
+                    m_heureDepart, stationsAMoinsDe(p_gtfs, p_pointOrigine, distanceMaxMarche), p_gtfs.getVoyages());
+    m_tempsMarcheDepuisOrigine.clear();
+    vector<SommetPondere> sources, destinations;
+    for (const auto &pair: arretsAtteignablesDepuisOrigine) {
+        m_tempsMarcheDepuisOrigine[pair.first->getStationId()] = pair.second;
+        // le poids inclut la marche et l'attente à la station: la distance d'un sommet est ainsi le temps écoulé
+        // depuis l'heure de départ
+        sources.emplace_back(m_sommetDeArret[pair.first], pair.first->getHeureArrivee() - m_heureDepart);
+    }
+
+    const vector<pair<const Station *, unsigned int>> stationsDestination =
+            stationsAMoinsDe(p_gtfs, p_pointDestination, distanceMaxMarche);
+    DestinationParGroupes destination;
+    destination.sortie.assign(m_idStations.size(), numeric_limits<unsigned int>::max());
+    for (const auto &station : stationsDestination)
+        destination.sortie[indiceDeStation(station.first->getId())] = station.second;
+    // la sortie d'un arrêt contracté passe au sommet amont de son raccourci s'il y sort mieux que par sa station (la
+    // plus petite de ses sorties franchies, voir sortieFranchie())
+    vector<SommetPondere> sortiesFranchies;
+    for (const auto &pair : getArretsEntreStationsEtDestination(stationsDestination,
+                                                                arretsAtteignablesDepuisOrigine)) {
+        const size_t sommet = m_sommetDeArret[pair.first];
+        if (!estContracte(sommet)) {
+            destinations.emplace_back(sommet, pair.second);
+            continue;
+        }
+        const size_t indice = sommet - m_premierContracte;
+        if (m_franchisDesChaines[indice].second != numeric_limits<unsigned int>::max())
+            sortiesFranchies.emplace_back(m_arretsContractes[indice].amont,
+                                          m_franchisDesChaines[indice].second + pair.second);
+    }
+    sort(sortiesFranchies.begin(), sortiesFranchies.end());
+    for (size_t i = 0; i < sortiesFranchies.size(); ++i) {
+        const SommetPondere &sortie = sortiesFranchies[i];
+        if ((i == 0 || sortiesFranchies[i - 1].first != sortie.first) &&
+            sortie.second < destination.sortie[m_stationDuSommet[sortie.first]])
+            destinations.push_back(sortie);
+    }
+    calculerBornes(destination);
+    reporterExtremites(sources, destination, m_extremitesOrigineDestination);
+    m_borneVersDestination = std::move(destination.borne);
+    m_sortieVersDestination = std::move(destination.sortie);
+
+    m_nbArcsOrigineVersStations = 0;
+    for (const auto &source : sources) {
+        m_leGraphe.ajouterArc(m_sommetOrigine, source.first, source.second);
+        m_nbArcsOrigineVersStations++;
+    }
+    for (const auto &destination : destinations) {
+        m_leGraphe.ajouterArc(destination.first, m_sommetDestination, destination.second);
+        m_sommetsVersDestination.push_back(destination.first);
+    }
+    m_nbArcsStationsVersDestination = m_sommetsVersDestination.size();
+
+    m_origine_dest_ajoute = true;
 }
 
 //! \brief Remet ReseauGTFS dans l'était qu'il était avant l'exécution de
@@ -370,24 +599,230 @@ void ReseauGTFS::ajouterArcsOrigineDestination(const DonneesGTFS &p_gtfs, const
 //! (les points orignine et destination sont enlevés du graphe) \post enlève les
 //! données de m_sommetsVersDestination
 void ReseauGTFS::enleverArcsOrigineDestination() {
+    const auto debut = Instrumentation::Horloge::now();
     try {
-        for (size_t i : m_sommetsVersDestination) {
-            m_leGraphe.enleverArc(i, m_sommetDestination);
-        }
+        retirerOrigineDestination();
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+    if (m_instrumentation) m_instrumentation->requeteCourante().retraitUs = Instrumentation::microsecondesDepuis(debut);
+}
 
-        m_leGraphe.resize(m_leGraphe.getNbSommets() - 2);
+//! \brief corps de enleverArcsOrigineDestination(), sans sa mesure
+void ReseauGTFS::retirerOrigineDestination() {
+    for (size_t i : m_sommetsVersDestination) {
+        m_leGraphe.enleverArc(i, m_sommetDestination);
+    }
+
+    m_leGraphe.resize(m_leGraphe.getNbSommets() - 2);
+
+    Arret::Ptr arretOrigine = m_arretDuSommet[m_sommetOrigine];
+    Arret::Ptr arretDestination = m_arretDuSommet[m_sommetDestination];
+    m_sommetDeArret.erase(arretOrigine);
+    m_sommetDeArret.erase(arretDestination);
+    m_arretDuSommet.resize(m_arretDuSommet.size() - 2);
+
+    m_sommetsVersDestination.clear();
+    m_tempsMarcheDepuisOrigine.clear();
+    m_borneVersDestination.clear();
+    m_sortieVersDestination.clear();
+    m_extremitesOrigineDestination.montees.clear();
+    m_extremitesOrigineDestination.direct.clear();
+    m_extremitesOrigineDestination.coutDirect = numeric_limits<unsigned int>::max();
+    m_nbArcsStationsVersDestination = 0;
+    m_nbArcsOrigineVersStations = 0;
+    m_origine_dest_ajoute = false;
+}
 
-        Arret::Ptr arretOrigine = m_arretDuSommet[m_sommetOrigine];
-        Arret::Ptr arretDestination = m_arretDuSommet[m_sommetDestination];
-        m_sommetDeArret.erase(arretOrigine);
-        m_sommetDeArret.erase(arretDestination);
-        m_arretDuSommet.resize(m_arretDuSommet.size() - 2);
+//! \brief Calcule l'itinéraire le plus rapide entre deux points sans modifier le réseau
+//! \brief Les arcs du point origine et vers le point destination sont les mêmes qu'avec
+//! ajouterArcsOrigineDestination(), mais ils ne sont pas ajoutés au graphe: la recherche part directement des arrêts
+//! atteignables à pieds depuis l'origine. Plusieurs fils d'exécution peuvent donc calculer des itinéraires en même
+//! temps, tant que le réseau et p_gtfs ne sont pas modifiés. Ces requêtes ne sont pas instrumentées.
+//! \param[in] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point d'origine
+//! \param[out] p_itineraire: l'itinéraire trouvé (sans étapes si la destination n'est pas atteignable)
+//! \param[out] p_statistiques: les compteurs de la recherche de plus court chemin
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si p_heureDepart n'appartient pas à l'intervalle de temps du GTFS
+//! \throws logic_error si les points origine et destination de ajouterArcsOrigineDestination() sont présents
+unsigned int ReseauGTFS::calculerItineraire(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                            const Coordonnees &p_pointDestination, const Heure &p_heureDepart,
+                                            Itineraire &p_itineraire, StatistiquesRecherche &p_statistiques) const {
+    return rechercherItineraire(p_gtfs, p_pointOrigine, p_pointDestination, p_heureDepart, p_itineraire,
+                                p_statistiques, nullptr);
+}
+
+//! \brief Comme calculerItineraire(p_gtfs, p_pointOrigine, p_pointDestination, p_heureDepart, p_itineraire,
+//! p_statistiques), en notant dans p_trace chaque sommet solutionné avec sa clé, son ordre, ainsi que la station, la
+//! ligne et l'heure d'arrivée de son arrêt (voir ecrireTraceCSV() et ecrireTraceGeoJSON())
+//! \brief Seule cette surcharge paie l'enregistrement: la recherche sans trace n'en contient aucune instruction.
+//! \param[out] p_trace: les sommets solutionnés, dans l'ordre (vidée au début)
+unsigned int ReseauGTFS::calculerItineraire(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                            const Coordonnees &p_pointDestination, const Heure &p_heureDepart,
+                                            Itineraire &p_itineraire, StatistiquesRecherche &p_statistiques,
+                                            TraceRecherche &p_trace) const {
+    TraceSommets sommets;
+    const unsigned int tempsDuTrajet = rechercherItineraire(p_gtfs, p_pointOrigine, p_pointDestination,
+                                                            p_heureDepart, p_itineraire, p_statistiques, &sommets);
+    try {
+        p_trace.heureDepart = p_heureDepart;
+        p_trace.points.clear();
+        p_trace.points.reserve(sommets.size());
+        for (size_t ordre = 0; ordre < sommets.size(); ++ordre) {
+            const Arret::Ptr &arret = m_arretDuSommet[sommets[ordre].first];
+            const Coordonnees &coordonnees = p_gtfs.getStations().at(arret->getStationId()).getCoords();
+            PointDeTrace point;
+            point.ordre = ordre;
+            point.cle = sommets[ordre].second;
+            point.sommet = sommets[ordre].first;
+            point.station = arret->getStationId();
+            point.ligne = p_gtfs.getVoyages().at(arret->getVoyageId()).getLigne();
+            point.heureArrivee = arret->getHeureArrivee();
+            point.latitude = coordonnees.getLatitude();
+            point.longitude = coordonnees.getLongitude();
+            p_trace.points.push_back(point);
+        }
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+    return tempsDuTrajet;
+}
 
-        m_nbArcsStationsVersDestination = 0;
-        m_nbArcsOrigineVersStations = 0;
-        m_origine_dest_ajoute = false;
+//! \brief corps de calculerItineraire(): p_trace, s'il n'est pas nullptr, reçoit les sommets solutionnés et leur clé
+unsigned int ReseauGTFS::rechercherItineraire(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                              const Coordonnees &p_pointDestination, const Heure &p_heureDepart,
+                                              Itineraire &p_itineraire, StatistiquesRecherche &p_statistiques,
+                                              TraceSommets *p_trace) const {
+    if (p_heureDepart < p_gtfs.getTempsDebut() || !(p_heureDepart < p_gtfs.getTempsFin()))
+        throw logic_error("ReseauGTFS::calculerItineraire(): heure de départ hors de l'intervalle du GTFS");
+    if (m_origine_dest_ajoute)
+        throw logic_error("ReseauGTFS::calculerItineraire(): il faut enlever les points origine et destination avant");
+    try {
+        vector<SommetPondere> sources;
+        DestinationParGroupes destination;
+        sommetsEntreeSortie(p_gtfs, p_pointOrigine, p_pointDestination, p_heureDepart, sources, destination);
+        ExtremitesContractees extremites;
+        reporterExtremites(sources, destination, extremites);
+
+        vector<size_t> chemin;
+        unsigned int tempsDuTrajet =
+                p_trace ? m_leGraphe.plusCourtChemin(sources, m_stationDuSommet, destination, chemin, p_statistiques,
+                                                     *p_trace)
+                        : m_leGraphe.plusCourtChemin(sources, m_stationDuSommet, destination, chemin, p_statistiques);
+        completerChemin(chemin, tempsDuTrajet, extremites, destination.sortie);
+        p_itineraire.heureDepart = p_heureDepart;
+        p_itineraire.duree = tempsDuTrajet;
+        p_itineraire.etapes.clear();
+        if (tempsDuTrajet == numeric_limits<unsigned int>::max()) return tempsDuTrajet;
+
+        const Station &premiereStation = p_gtfs.getStations().at(arretDe(chemin.front())->getStationId());
+        extraireEtapes(p_gtfs, chemin, 0, chemin.size(), tempsDeMarche(p_pointOrigine, premiereStation.getCoords()),
+                       p_itineraire);
+        return tempsDuTrajet;
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+}
 
+//! \brief Calcule l'itinéraire le plus rapide entre deux stations sans modifier le réseau
+//! \brief La recherche part des arrêts de la station d'origine qui arrivent à partir de p_heureDepart et s'arrête au
+//! premier arrêt de la station de destination, sans marche aux extrémités. C'est la référence des motifs de transfert
+//! (voir precalculerMotifsDeTransfert()). Les conditions d'appel sont celles de calculerItineraire().
+//! \param[in] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \param[in] p_stationOrigine, p_stationDestination: les identifiants des stations
+//! \param[in] p_heureDepart: l'heure de départ de la station d'origine
+//! \param[out] p_itineraire: l'itinéraire trouvé (sans étapes si la destination n'est pas atteignable)
+//! \param[out] p_statistiques: les compteurs de la recherche de plus court chemin
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si p_heureDepart n'appartient pas à l'intervalle de temps du GTFS
+//! \throws logic_error si l'une des stations est inconnue
+//! \throws logic_error si les points origine et destination de ajouterArcsOrigineDestination() sont présents
+unsigned int ReseauGTFS::calculerItineraireEntreStations(const DonneesGTFS &p_gtfs, unsigned int p_stationOrigine,
+                                                         unsigned int p_stationDestination, const Heure &p_heureDepart,
+                                                         Itineraire &p_itineraire,
+                                                         StatistiquesRecherche &p_statistiques) const {
+    if (p_heureDepart < p_gtfs.getTempsDebut() || !(p_heureDepart < p_gtfs.getTempsFin()))
+        throw logic_error("ReseauGTFS::calculerItineraireEntreStations(): heure de départ hors de l'intervalle du GTFS");
+    if (m_origine_dest_ajoute)
+        throw logic_error(
+                "ReseauGTFS::calculerItineraireEntreStations(): il faut enlever les points origine et destination avant");
+    try {
+        const Station::Arrets &arretsOrigine = p_gtfs.getStations().at(p_stationOrigine).getArrets();
+        vector<SommetPondere> sources;
+        for (auto it = arretsOrigine.lower_bound(p_heureDepart); it != arretsOrigine.end(); ++it)
+            sources.emplace_back(m_sommetDeArret.at(it->second), it->second->getHeureArrivee() - p_heureDepart);
+        // la sortie se fait sans marche par tout arrêt de la station de destination
+        DestinationParGroupes destination;
+        destination.sortie.assign(m_idStations.size(), numeric_limits<unsigned int>::max());
+        destination.sortie[indiceDeStation(p_stationDestination)] = 0;
+        calculerBornes(destination);
+        ExtremitesContractees extremites;
+        reporterExtremites(sources, destination, extremites);
+
+        vector<size_t> chemin;
+        unsigned int tempsDuTrajet = m_leGraphe.plusCourtChemin(sources, m_stationDuSommet, destination, chemin,
+                                                                p_statistiques);
+        completerChemin(chemin, tempsDuTrajet, extremites, destination.sortie);
+        p_itineraire.heureDepart = p_heureDepart;
+        p_itineraire.duree = tempsDuTrajet;
+        p_itineraire.etapes.clear();
+        if (tempsDuTrajet == numeric_limits<unsigned int>::max()) return tempsDuTrajet;
+        extraireEtapes(p_gtfs, chemin, 0, chemin.size(), 0, p_itineraire);
+        return tempsDuTrajet;
     } catch (exception &ex) {
         throw logic_error(ex.what());
     }
 }
+
+//! \brief calcule les sommets d'entrée et de sortie d'une recherche partant de p_pointOrigine à p_heureDepart vers
+//! p_pointDestination, sans modifier le graphe: ce sont les extrémités des arcs qu'ajouterait
+//! ajouterArcsOrigineDestination()
+//! \param[out] p_sources: les arrêts atteignables à pieds depuis l'origine; le coût inclut la marche et l'attente à la
+//! station, comme pour les arcs du point origine
+//! \param[out] p_destination: par station (les groupes de m_stationDuSommet), le temps de marche vers la destination
+//! pour les stations à distance de marche de celle-ci, et la borne inférieure du reste du trajet (calculerBornes())
+//! \brief Une sortie par station remplace la liste des arrêts de getArretsEntreStationsEtDestination(): la distance
+//! d'un sommet étant le temps écoulé depuis p_heureDepart, les arrêts que cette fonction écarte ne sont pas atteints.
+void ReseauGTFS::sommetsEntreeSortie(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                     const Coordonnees &p_pointDestination, const Heure &p_heureDepart,
+                                     vector<SommetPondere> &p_sources, DestinationParGroupes &p_destination) const {
+    p_sources.clear();
+    const vector<pair<Arret::Ptr, unsigned int>> arretsEntree = getArretsAtteingnableAPiedDepuisOrigine(
+            p_heureDepart, stationsAMoinsDe(p_gtfs, p_pointOrigine, distanceMaxMarche), p_gtfs.getVoyages());
+    for (const auto &pair : arretsEntree) {
+        p_sources.emplace_back(m_sommetDeArret.at(pair.first), pair.first->getHeureArrivee() - p_heureDepart);
+    }
+    p_destination.sortie.assign(m_idStations.size(), numeric_limits<unsigned int>::max());
+    for (const auto &station : stationsAMoinsDe(p_gtfs, p_pointDestination, distanceMaxMarche))
+        p_destination.sortie[indiceDeStation(station.first->getId())] = station.second;
+    calculerBornes(p_destination);
+}
+
+//! \brief Donne la dernière heure de départ à laquelle une recherche partant de p_pointOrigine a les mêmes arrêts
+//! d'entrée qu'en partant à p_heureDepart
+//! \brief Les arrêts d'entrée sont, à chaque station à distance de marche, le premier arrêt de chaque ligne que l'on
+//! peut attraper (voir sommetsEntreeSortie()). Tant qu'aucun d'eux n'est manqué, un départ plus tardif ne fait que
+//! réduire d'autant le coût de chaque entrée: la recherche suit le même chemin et arrive à la même heure. Passé cette
+//! heure, le premier arrêt d'une ligne peut être remplacé par un voyage plus tardif, par exemple dans l'autre sens,
+//! et mener à une arrivée plus hâtive.
+//! \param[in] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \return p_heureDepart plus la plus petite attente à une station d'entrée, ou getTempsFin() de p_gtfs s'il n'y a
+//! aucun arrêt d'entrée (aucun ne peut alors apparaître plus tard)
+Heure ReseauGTFS::departLimiteMemesEntrees(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                           const Heure &p_heureDepart) const {
+    const vector<pair<Arret::Ptr, unsigned int>> arretsEntree = getArretsAtteingnableAPiedDepuisOrigine(
+            p_heureDepart, stationsAMoinsDe(p_gtfs, p_pointOrigine, distanceMaxMarche), p_gtfs.getVoyages());
+    if (arretsEntree.empty()) return p_gtfs.getTempsFin();
+    unsigned int attenteMin = numeric_limits<unsigned int>::max();
+    for (const auto &entree : arretsEntree)
+        attenteMin = min(attenteMin, (entree.first->getHeureArrivee() - p_heureDepart) - entree.second);
+    return p_heureDepart.add_secondes(attenteMin);
+}
+
+//! \brief temps de marche, en secondes, entre deux points à la vitesse vitesseDeMarche
+unsigned int ReseauGTFS::tempsDeMarche(const Coordonnees &p_depart, const Coordonnees &p_arrivee) const {
+    return getPoidsEntre2Coord(vitesseDeMarche, p_depart, p_arrivee);
+}
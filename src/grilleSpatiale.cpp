@@ -0,0 +1,46 @@
+//
+// Grille régulière de points géographiques.
+//
+
+#include "grilleSpatiale.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    // un degré de latitude mesure 111,19 km sur la sphère de Coordonnees::operator-(); on arrondit vers le bas pour que
+    // les cellules soient un peu plus grandes que le rayon
+    const double kmParDegre = 111.0;
+}
+
+//! \param[in] p_rayon: la distance maximale, en km, des voisins recherchés
+//! \param[in] p_latitudeMax: la plus grande latitude (en valeur absolue) des points qui seront ajoutés
+//! \throws logic_error si p_rayon n'est pas positif
+GrilleSpatiale::GrilleSpatiale(double p_rayon, double p_latitudeMax) : m_rayon(p_rayon)
+{
+    if (!(p_rayon > 0)) throw logic_error("GrilleSpatiale: le rayon doit être positif");
+    m_hauteurCellule = p_rayon / kmParDegre;
+    m_largeurCellule = p_rayon / (kmParDegre * max(0.01, cos(fabs(p_latitudeMax) * M_PI / 180.0)));
+}
+
+void GrilleSpatiale::ajouter(size_t p_indice, const Coordonnees &p_point)
+{
+    m_cellules[cle(ligneDe(p_point.getLatitude()), colonneDe(p_point.getLongitude()))].push_back(p_indice);
+}
+
+long long GrilleSpatiale::ligneDe(double p_latitude) const
+{
+    return (long long) floor(p_latitude / m_hauteurCellule);
+}
+
+long long GrilleSpatiale::colonneDe(double p_longitude) const
+{
+    return (long long) floor(p_longitude / m_largeurCellule);
+}
+
+long long GrilleSpatiale::cle(long long p_ligne, long long p_colonne)
+{
+    return (long long) (((unsigned long long) p_ligne << 32) ^ ((unsigned long long) p_colonne & 0xFFFFFFFFULL));
+}
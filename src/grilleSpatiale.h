@@ -0,0 +1,60 @@
+//
+// Grille régulière de points géographiques pour les recherches de voisins à distance bornée.
+//
+
+#ifndef RTC_GRILLESPATIALE_H
+#define RTC_GRILLESPATIALE_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "coordonnees.h"
+
+/*!
+ * \class GrilleSpatiale
+ * \brief Répartit des points (désignés par un indice choisi par l'appelant) dans des cellules d'au moins
+ * getRayon() km de côté, de sorte que tout point à moins de getRayon() km d'un autre se trouve dans la cellule de
+ * celui-ci ou dans l'une des 8 cellules voisines. Une jointure par distance ne compare ainsi que des points proches
+ * au lieu de toutes les paires.
+ * \brief Les cellules sont des intervalles de latitude et de longitude. Pour que leur largeur soit d'au moins
+ * getRayon() km partout, la largeur en degrés est calculée à la plus grande latitude (en valeur absolue) des points.
+ */
+class GrilleSpatiale {
+
+public:
+
+    GrilleSpatiale(double p_rayon, double p_latitudeMax);
+
+    void ajouter(size_t p_indice, const Coordonnees &p_point);
+
+    //! \brief appelle p_visiteur(indice) pour chaque point de la cellule de p_point et des 8 cellules voisines, parmi
+    //! lesquels se trouvent tous les points à moins de getRayon() km de p_point
+    template<typename Visiteur>
+    void pourChaqueVoisinPossible(const Coordonnees &p_point, Visiteur p_visiteur) const {
+        const long long ligne = ligneDe(p_point.getLatitude());
+        const long long colonne = colonneDe(p_point.getLongitude());
+        for (long long l = ligne - 1; l <= ligne + 1; ++l)
+            for (long long c = colonne - 1; c <= colonne + 1; ++c) {
+                auto itCellule = m_cellules.find(cle(l, c));
+                if (itCellule == m_cellules.end()) continue;
+                for (size_t indice : itCellule->second) p_visiteur(indice);
+            }
+    }
+
+    double getRayon() const { return m_rayon; }
+    size_t getNbCellules() const { return m_cellules.size(); }
+
+private:
+
+    long long ligneDe(double p_latitude) const;
+    long long colonneDe(double p_longitude) const;
+    static long long cle(long long p_ligne, long long p_colonne);
+
+    double m_rayon;          // en km
+    double m_hauteurCellule; // en degrés de latitude
+    double m_largeurCellule; // en degrés de longitude
+    std::unordered_map<long long, std::vector<size_t>> m_cellules;
+};
+
+#endif //RTC_GRILLESPATIALE_H
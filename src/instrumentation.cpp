@@ -0,0 +1,195 @@
+//
+// Mesures de performance des phases de chargement, de construction du graphe et des requêtes d'itinéraire.
+//
+
+#include "instrumentation.h"
+#include <sys/resource.h>
+#include <algorithm>
+#include <iomanip>
+
+using namespace std;
+
+namespace {
+    const Instrumentation::Requete requeteNulle = {0.0, 0.0, 0.0, 0.0, 0, 0, 0};
+
+    //! \brief ajoute les mesures de p_requete au total et au maximum de p_resume
+    void cumuler(Instrumentation::ResumeRequetes &p_resume, const Instrumentation::Requete &p_requete) {
+        Instrumentation::Requete &total = p_resume.total;
+        Instrumentation::Requete &maximum = p_resume.maximum;
+        ++p_resume.nombre;
+        total.superpositionUs += p_requete.superpositionUs;
+        total.rechercheUs += p_requete.rechercheUs;
+        total.reconstructionUs += p_requete.reconstructionUs;
+        total.retraitUs += p_requete.retraitUs;
+        total.sommetsSolutionnes += p_requete.sommetsSolutionnes;
+        total.sommetsEmpiles += p_requete.sommetsEmpiles;
+        total.arcsRelaches += p_requete.arcsRelaches;
+        maximum.superpositionUs = max(maximum.superpositionUs, p_requete.superpositionUs);
+        maximum.rechercheUs = max(maximum.rechercheUs, p_requete.rechercheUs);
+        maximum.reconstructionUs = max(maximum.reconstructionUs, p_requete.reconstructionUs);
+        maximum.retraitUs = max(maximum.retraitUs, p_requete.retraitUs);
+        maximum.sommetsSolutionnes = max(maximum.sommetsSolutionnes, p_requete.sommetsSolutionnes);
+        maximum.sommetsEmpiles = max(maximum.sommetsEmpiles, p_requete.sommetsEmpiles);
+        maximum.arcsRelaches = max(maximum.arcsRelaches, p_requete.arcsRelaches);
+    }
+}
+
+//! \brief construit une instrumentation vide
+//! \param[in] p_capaciteDetail: le nombre de requêtes les plus récentes conservées en détail (0: aucune)
+Instrumentation::Instrumentation(size_t p_capaciteDetail)
+        : m_capaciteDetail(p_capaciteDetail), m_resume{0, requeteNulle, requeteNulle}, m_plusAncienne(0),
+          m_requeteCourante(requeteNulle), m_requeteEnCours(false) {
+}
+
+//! \brief démarre la mesure d'une phase
+//! \param[in] p_instrumentation: l'instrumentation qui recevra la mesure (nullptr: aucune mesure)
+//! \param[in] p_nom: le nom de la phase (chaîne littérale)
+Instrumentation::MesurePhase::MesurePhase(Instrumentation *p_instrumentation, const char *p_nom)
+        : m_instrumentation(p_instrumentation), m_nom(p_nom), m_rssMaxKo(0) {
+    if (m_instrumentation) {
+        m_rssMaxKo = getRssMaxKo();
+        m_debut = Horloge::now();
+    }
+}
+
+//! \brief termine la phase et l'enregistre
+//! \param[in] p_nbElements: le nombre d'éléments produits par la phase
+void Instrumentation::MesurePhase::terminer(size_t p_nbElements) {
+    if (!m_instrumentation) return;
+    const double dureeMs = microsecondesDepuis(m_debut) / 1000.0;
+    m_instrumentation->enregistrerPhase(m_nom, dureeMs, getRssMaxKo() - m_rssMaxKo, p_nbElements);
+    m_instrumentation = nullptr;
+}
+
+void Instrumentation::enregistrerPhase(const std::string &p_nom, double p_dureeMs, long p_deltaRssMaxKo,
+                                       size_t p_nbElements) {
+    Phase phase = {p_nom, p_dureeMs, p_deltaRssMaxKo, p_nbElements};
+    m_phases.push_back(phase);
+}
+
+//! \brief clôture la requête courante et en commence une dont toutes les mesures sont nulles
+//! \return la nouvelle requête, valide jusqu'au prochain appel de nouvelleRequete() ou de reinitialiser()
+Instrumentation::Requete &Instrumentation::nouvelleRequete() {
+    cloturerRequete();
+    m_requeteCourante = requeteNulle;
+    m_requeteEnCours = true;
+    return m_requeteCourante;
+}
+
+//! \brief retourne la dernière requête commencée, en en commençant une au besoin
+Instrumentation::Requete &Instrumentation::requeteCourante() {
+    return m_requeteEnCours ? m_requeteCourante : nouvelleRequete();
+}
+
+void Instrumentation::cloturerRequete() {
+    if (!m_requeteEnCours) return;
+    m_requeteEnCours = false;
+    cumuler(m_resume, m_requeteCourante);
+    if (m_capaciteDetail == 0) return;
+    if (m_dernieresRequetes.size() < m_capaciteDetail) {
+        m_dernieresRequetes.push_back(m_requeteCourante);
+    } else {
+        m_dernieresRequetes[m_plusAncienne] = m_requeteCourante;
+        m_plusAncienne = (m_plusAncienne + 1) % m_capaciteDetail;
+    }
+}
+
+const std::vector<Instrumentation::Phase> &Instrumentation::getPhases() const {
+    return m_phases;
+}
+
+//! \brief retourne le résumé de toutes les requêtes depuis la dernière réinitialisation, requête courante comprise
+Instrumentation::ResumeRequetes Instrumentation::getResumeRequetes() const {
+    ResumeRequetes resume = m_resume;
+    if (m_requeteEnCours) cumuler(resume, m_requeteCourante);
+    return resume;
+}
+
+//! \brief retourne, de la plus ancienne à la plus récente, les capaciteDetail dernières requêtes au plus, requête
+//! courante comprise
+std::vector<Instrumentation::Requete> Instrumentation::getDernieresRequetes() const {
+    vector<Requete> requetes(m_dernieresRequetes.begin() + m_plusAncienne, m_dernieresRequetes.end());
+    requetes.insert(requetes.end(), m_dernieresRequetes.begin(), m_dernieresRequetes.begin() + m_plusAncienne);
+    if (m_requeteEnCours && m_capaciteDetail > 0) {
+        if (requetes.size() == m_capaciteDetail) requetes.erase(requetes.begin());
+        requetes.push_back(m_requeteCourante);
+    }
+    return requetes;
+}
+
+//! \brief efface toutes les mesures: les phases, le résumé et le détail des requêtes
+void Instrumentation::reinitialiser() {
+    m_phases.clear();
+    m_resume = ResumeRequetes{0, requeteNulle, requeteNulle};
+    m_dernieresRequetes.clear();
+    m_plusAncienne = 0;
+    m_requeteEnCours = false;
+}
+
+//! \brief mémoire résidente maximale du processus jusqu'ici, en Ko (unité de getrusage() sous Linux)
+long Instrumentation::getRssMaxKo() {
+    rusage ressources;
+    if (getrusage(RUSAGE_SELF, &ressources) != 0) return 0;
+    return ressources.ru_maxrss;
+}
+
+double Instrumentation::microsecondesDepuis(const Horloge::time_point &p_debut) {
+    return chrono::duration<double, micro>(Horloge::now() - p_debut).count();
+}
+
+namespace {
+    //! \brief écrit le total, la moyenne et le maximum d'une mesure des requêtes
+    template<typename Mesure>
+    void ecrireResume(ostream &p_flux, const char *p_nom, const Instrumentation::ResumeRequetes &p_resume,
+                      Mesure p_mesure, bool p_dernier) {
+        const double total = (double) p_mesure(p_resume.total);
+        p_flux << "    \"" << p_nom << "\": {\"total\": " << total << ", \"moyenne\": "
+               << (p_resume.nombre == 0 ? 0.0 : total / p_resume.nombre) << ", \"max\": "
+               << (double) p_mesure(p_resume.maximum) << "}" << (p_dernier ? "\n" : ",\n");
+    }
+}
+
+/*!
+ * \brief Écrit les mesures en JSON: la liste des phases, puis un résumé (total, moyenne, maximum) des requêtes
+ * \param[in,out] p_flux: le flux de sortie
+ * \param[in] p_detailDesRequetes: si vrai, les mesures des requêtes conservées en détail (les plus récentes) sont
+ * aussi écrites
+ */
+void Instrumentation::ecrireJSON(std::ostream &p_flux, bool p_detailDesRequetes) const {
+    const auto precision = p_flux.precision();
+    const auto format = p_flux.flags();
+    p_flux << fixed << setprecision(3) << "{\n  \"phases\": [\n";
+    for (size_t i = 0; i < m_phases.size(); ++i) {
+        const Phase &phase = m_phases[i];
+        p_flux << "    {\"nom\": \"" << phase.nom << "\", \"duree_ms\": " << phase.dureeMs
+               << ", \"delta_rss_max_ko\": " << phase.deltaRssMaxKo << ", \"elements\": " << phase.nbElements << "}"
+               << (i + 1 < m_phases.size() ? ",\n" : "\n");
+    }
+    const ResumeRequetes resume = getResumeRequetes();
+    p_flux << "  ],\n  \"requetes\": {\n    \"nombre\": " << resume.nombre << ",\n";
+    ecrireResume(p_flux, "superposition_us", resume, [](const Requete &r) { return r.superpositionUs; }, false);
+    ecrireResume(p_flux, "recherche_us", resume, [](const Requete &r) { return r.rechercheUs; }, false);
+    ecrireResume(p_flux, "reconstruction_us", resume, [](const Requete &r) { return r.reconstructionUs; }, false);
+    ecrireResume(p_flux, "retrait_us", resume, [](const Requete &r) { return r.retraitUs; }, false);
+    ecrireResume(p_flux, "sommets_solutionnes", resume, [](const Requete &r) { return r.sommetsSolutionnes; },
+                 false);
+    ecrireResume(p_flux, "sommets_empiles", resume, [](const Requete &r) { return r.sommetsEmpiles; }, false);
+    ecrireResume(p_flux, "arcs_relaches", resume, [](const Requete &r) { return r.arcsRelaches; },
+                 !p_detailDesRequetes);
+    if (p_detailDesRequetes) {
+        const vector<Requete> requetes = getDernieresRequetes();
+        p_flux << "    \"detail\": [\n";
+        for (size_t i = 0; i < requetes.size(); ++i) {
+            const Requete &r = requetes[i];
+            p_flux << "      {\"superposition_us\": " << r.superpositionUs << ", \"recherche_us\": " << r.rechercheUs
+                   << ", \"reconstruction_us\": " << r.reconstructionUs << ", \"retrait_us\": " << r.retraitUs
+                   << ", \"sommets_solutionnes\": " << r.sommetsSolutionnes << ", \"sommets_empiles\": "
+                   << r.sommetsEmpiles << ", \"arcs_relaches\": " << r.arcsRelaches << "}"
+                   << (i + 1 < requetes.size() ? ",\n" : "\n");
+        }
+        p_flux << "    ]\n";
+    }
+    p_flux << "  }\n}\n";
+    p_flux.precision(precision);
+    p_flux.flags(format);
+}
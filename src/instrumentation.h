@@ -0,0 +1,104 @@
+//
+// Mesures de performance des phases de chargement, de construction du graphe et des requêtes d'itinéraire.
+//
+
+#ifndef RTC_INSTRUMENTATION_H
+#define RTC_INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*!
+ * \class Instrumentation
+ * \brief Accumule les mesures des phases (chargement d'un fichier, ajout d'une famille d'arcs, ...) et des requêtes
+ * d'itinéraire, consultables en cours d'exécution ou écrites en JSON.
+ * \brief Un objet DonneesGTFS ou ReseauGTFS n'est instrumenté que si on lui a donné un objet Instrumentation (voir
+ * setInstrumentation()); sinon, chaque point de mesure se limite à tester un pointeur nul.
+ * \brief Les requêtes sont cumulées dans un résumé (nombre, total et maximum de chaque mesure) et seules les
+ * capaciteDetail dernières sont conservées en détail, dans un tampon circulaire: la mémoire reste bornée dans un
+ * processus de longue durée. reinitialiser() remet le tout à zéro.
+ * \note Les méthodes ne sont pas synchronisées: un même objet ne doit pas être utilisé par plusieurs fils d'exécution
+ * à la fois.
+ */
+class Instrumentation {
+
+public:
+
+    //! \brief mesure d'une phase
+    struct Phase {
+        std::string nom;
+        double dureeMs;      // temps écoulé (horloge monotone)
+        long deltaRssMaxKo;  // augmentation de la mémoire résidente maximale du processus pendant la phase
+        size_t nbElements;   // nombre d'éléments produits par la phase (lignes, arrêts, arcs, ...)
+    };
+
+    //! \brief mesures d'une requête d'itinéraire
+    struct Requete {
+        double superpositionUs;   // ajout du point origine, du point destination et de leurs arcs
+        double rechercheUs;       // recherche du plus court chemin, remontée des prédécesseurs comprise
+        double reconstructionUs;  // découpage du chemin en étapes (Itineraire)
+        double retraitUs;         // retrait du point origine, du point destination et de leurs arcs
+        size_t sommetsSolutionnes;
+        size_t sommetsEmpiles;
+        size_t arcsRelaches;
+    };
+
+    /*!
+     * \class MesurePhase
+     * \brief Chronomètre une phase du début de sa portée jusqu'à l'appel de terminer(); ne fait rien si
+     * l'instrumentation est nulle. Une phase interrompue par une exception n'est pas enregistrée.
+     */
+    class MesurePhase {
+    public:
+        MesurePhase(Instrumentation *p_instrumentation, const char *p_nom);
+        void terminer(size_t p_nbElements);
+
+    private:
+        Instrumentation *m_instrumentation;
+        const char *m_nom;
+        std::chrono::steady_clock::time_point m_debut;
+        long m_rssMaxKo;
+    };
+
+    //! \brief cumul des mesures de toutes les requêtes depuis la dernière réinitialisation
+    struct ResumeRequetes {
+        size_t nombre;
+        Requete total;
+        Requete maximum;
+    };
+
+    typedef std::chrono::steady_clock Horloge;
+
+    explicit Instrumentation(size_t p_capaciteDetail = 1024);
+
+    void enregistrerPhase(const std::string &p_nom, double p_dureeMs, long p_deltaRssMaxKo, size_t p_nbElements);
+    Requete &nouvelleRequete();
+    Requete &requeteCourante();
+
+    const std::vector<Phase> &getPhases() const;
+    ResumeRequetes getResumeRequetes() const;
+    std::vector<Requete> getDernieresRequetes() const;
+    void reinitialiser();
+
+    void ecrireJSON(std::ostream &p_flux, bool p_detailDesRequetes = false) const;
+
+    static long getRssMaxKo();
+    static double microsecondesDepuis(const Horloge::time_point &p_debut);
+
+private:
+
+    void cloturerRequete(); //cumule la requête courante et la range dans m_dernieresRequetes
+
+    std::vector<Phase> m_phases;
+    const size_t m_capaciteDetail;            // nombre de requêtes conservées en détail
+    ResumeRequetes m_resume;                  // requêtes clôturées
+    std::vector<Requete> m_dernieresRequetes; // tampon circulaire d'au plus m_capaciteDetail requêtes clôturées
+    size_t m_plusAncienne;                    // indice de la plus ancienne dans m_dernieresRequetes, une fois plein
+    Requete m_requeteCourante;                // modifiable jusqu'à la prochaine requête (voir requeteCourante())
+    bool m_requeteEnCours;
+};
+
+#endif //RTC_INSTRUMENTATION_H
@@ -0,0 +1,70 @@
+//
+// Mise en forme d'un itinéraire.
+//
+
+#include "itineraire.h"
+#include "DonneesGTFS.h"
+
+using namespace std;
+
+const unsigned int Etape::pointOrigineDestination;
+
+//! \brief écrit un itinéraire sous forme de directives à suivre, station par station
+//! \param[in] p_flux: le flux de sortie
+//! \param[in] p_gtfs: les données GTFS dont proviennent les stations, les voyages et les lignes de l'itinéraire
+//! \param[in] p_itineraire: l'itinéraire à écrire
+//! \throws logic_error si une station, un voyage ou une ligne de l'itinéraire est absent de p_gtfs
+void afficherItineraire(ostream &p_flux, const DonneesGTFS &p_gtfs, const Itineraire &p_itineraire)
+{
+    if (!p_itineraire.estAtteignable())
+    {
+        p_flux << "La destination n'est pas atteignable de l'orignine avec cette distance maximale de marche" << endl;
+        return;
+    }
+    if (p_itineraire.duree == 0)
+    {
+        p_flux << "Vous êtes déjà situé à la destination demandée" << endl;
+        return;
+    }
+
+    try
+    {
+        const auto &stations = p_gtfs.getStations();
+        p_flux << "\n=====================\n     ITINÉRAIRE      \n=====================\n\n";
+        p_flux << "Heure de départ du point d'origine: " << p_itineraire.heureDepart << "\n";
+        for (const Etape &etape : p_itineraire.etapes)
+        {
+            switch (etape.type)
+            {
+                case Etape::MARCHE:
+                    if (etape.stationDepart == Etape::pointOrigineDestination)
+                        p_flux << "Rendez vous à la station " << stations.at(etape.stationArrivee) << "\n";
+                    else
+                        p_flux << "Déplacez-vous à pieds de cette station au point destination\n";
+                    break;
+                case Etape::TRAJET:
+                {
+                    const Voyage &voyage = p_gtfs.getVoyages().at(etape.embarquement->getVoyageId());
+                    p_flux << "De cette station, prenez l'autobus numéro "
+                           << p_gtfs.getLignes().at(etape.ligne).getNumero() << " à l'heure " << etape.heureDepart << " " << voyage << "\n";
+                    p_flux << "et arrêtez-vous à la station " << stations.at(etape.stationArrivee) << " à l'heure "
+                           << etape.heureArrivee << "\n";
+                    break;
+                }
+                case Etape::TRANSFERT:
+                    // une correspondance à la même station se lit dans l'heure de départ du trajet suivant
+                    if (etape.stationDepart != etape.stationArrivee)
+                        p_flux << "De cette station, rendez-vous à pieds à la station "
+                               << stations.at(etape.stationArrivee) << "\n";
+                    break;
+            }
+        }
+        p_flux << "Heure d'arrivée à la destination: " << p_itineraire.getHeureArrivee() << "\n";
+        p_flux << "Durée du trajet: " << p_itineraire.duree / 3600 << " heures, " << p_itineraire.duree % 3600 / 60
+               << " minutes, " << p_itineraire.duree % 60 << " secondes" << endl;
+    }
+    catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
@@ -0,0 +1,84 @@
+//
+// Résultat structuré d'une recherche d'itinéraire: la liste des étapes du trajet, indépendante de son affichage.
+//
+
+#ifndef RTC_ITINERAIRE_H
+#define RTC_ITINERAIRE_H
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "arret.h"
+#include "auxiliaires.h"
+
+class DonneesGTFS;
+
+/*!
+ * \struct Etape
+ * \brief Une étape d'un itinéraire:
+ *  - MARCHE: du point origine à la première station, ou de la dernière station au point destination;
+ *  - TRAJET: à bord d'un voyage, de l'arrêt d'embarquement à l'arrêt de débarquement;
+ *  - TRANSFERT: d'un arrêt à un autre arrêt, à pieds vers une autre station ou, entre deux trajets, en attendant à la
+ *    même station.
+ * \brief L'attente à la première station avant le premier embarquement n'est pas une étape: elle se lit dans l'heure de
+ * départ du premier trajet.
+ */
+struct Etape {
+
+    enum Type { MARCHE, TRAJET, TRANSFERT };
+
+    //! \brief numéro de station des extrémités d'une étape MARCHE qui sont le point origine ou le point destination
+    static const unsigned int pointOrigineDestination = std::numeric_limits<unsigned int>::max();
+
+    Etape(Type p_type, unsigned int p_stationDepart, unsigned int p_stationArrivee, const Heure &p_heureDepart,
+          const Heure &p_heureArrivee)
+            : type(p_type), stationDepart(p_stationDepart), stationArrivee(p_stationArrivee),
+              heureDepart(p_heureDepart), heureArrivee(p_heureArrivee), ligne(0) {
+    }
+
+    Type type;
+    unsigned int stationDepart;
+    unsigned int stationArrivee;
+    Heure heureDepart;
+    Heure heureArrivee;
+    unsigned int ligne;        // TRAJET: le numéro (route_id) de la ligne du voyage
+    Arret::Ptr embarquement;   // TRAJET: l'arrêt où l'on monte (son voyage est celui de l'étape)
+    Arret::Ptr debarquement;   // TRAJET: l'arrêt où l'on descend
+};
+
+/*!
+ * \struct Itineraire
+ * \brief Le trajet le plus rapide d'un point origine à un point destination, tel que retourné par
+ * ReseauGTFS::itineraire() et ReseauGTFS::calculerItineraire(). La mise en forme est une étape distincte et
+ * facultative (voir afficherItineraire()).
+ */
+struct Itineraire {
+
+    Itineraire() : heureDepart(0, 0, 0), duree(std::numeric_limits<unsigned int>::max()) {
+    }
+
+    bool estAtteignable() const { return duree != std::numeric_limits<unsigned int>::max(); }
+
+    Heure getHeureArrivee() const { return heureDepart.add_secondes(duree); }
+
+    Heure heureDepart;         // l'heure de départ du point origine (00:00:00 avant la recherche)
+    unsigned int duree;        // en secondes (numeric_limits<unsigned int>::max() si la destination est inatteignable)
+    std::vector<Etape> etapes; // vide si la destination n'est pas atteignable
+};
+
+/*!
+ * \struct ItinerairePareto
+ * \brief Un itinéraire de l'ensemble de Pareto retourné par ReseauGTFS::calculerItinerairesPareto(), avec ses critères:
+ * aucun autre itinéraire n'arrive au plus tard à la même heure avec au plus autant de changements et de marche.
+ */
+struct ItinerairePareto {
+    Itineraire itineraire;
+    unsigned int nbChangements;    // changements de véhicule: le nombre d'étapes TRAJET moins 1 (0 sans trajet)
+    unsigned int secondesDeMarche; // marche depuis l'origine et vers la destination, plus le temps minimal des
+                                   // transferts entre stations distinctes
+};
+
+void afficherItineraire(std::ostream &, const DonneesGTFS &, const Itineraire &);
+
+#endif //RTC_ITINERAIRE_H
@@ -0,0 +1,320 @@
+//
+// Itinéraires alternatifs: les k itinéraires les plus rapides qui empruntent des lignes différentes.
+//
+
+#include "ReseauGTFS.h"
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+    const uint32_t aucuneEtiquette = numeric_limits<uint32_t>::max();
+    const uint32_t bitArrivee = 0x80000000u; // marque, dans la file, les entrées qui sont des arrivées
+
+    //! \brief chemin partiel de la recherche d'alternatives (24 octets), chaîné aux autres chemins de son sommet
+    struct Etiquette {
+        uint32_t sommet;
+        uint32_t parent;   // étiquette du sommet précédent (aucuneEtiquette pour un sommet d'entrée)
+        uint32_t suivante; // étiquette suivante du même sommet (aucuneEtiquette pour la dernière)
+        uint32_t temps;    // secondes écoulées depuis l'heure de départ
+        uint32_t lignes;   // dernière ligne ajoutée à l'ensemble des lignes empruntées (aucuneEtiquette s'il est vide)
+        uint8_t aBord;     // 1 si le dernier arc est un arc de voyage: le poursuivre n'ajoute pas de ligne
+        uint8_t active;    // 0 si l'étiquette a été écartée après sa création
+    };
+    static_assert(sizeof(Etiquette) == 24, "Etiquette doit rester compacte");
+
+    //! \brief maillon d'un ensemble de lignes empruntées: les ensembles des chemins partiels partagent leurs débuts
+    struct LigneEmpruntee {
+        uint64_t masque;     // un bit par indice de ligne modulo 64, pour l'ensemble jusqu'à ce maillon inclus
+        uint32_t ligne;      // indice de la ligne (voir ReseauGTFS::m_stationsDeLigne)
+        uint32_t precedente; // maillon précédent (aucuneEtiquette pour le premier)
+    };
+
+    uint64_t masqueDe(const vector<LigneEmpruntee> &p_lignes, uint32_t p_maillon) {
+        return p_maillon == aucuneEtiquette ? 0 : p_lignes[p_maillon].masque;
+    }
+
+    bool contient(const vector<LigneEmpruntee> &p_lignes, uint32_t p_maillon, uint32_t p_ligne) {
+        if (!(masqueDe(p_lignes, p_maillon) & (1ULL << (p_ligne & 63)))) return false;
+        for (uint32_t i = p_maillon; i != aucuneEtiquette; i = p_lignes[i].precedente)
+            if (p_lignes[i].ligne == p_ligne) return true;
+        return false;
+    }
+
+    //! \brief vrai si les lignes empruntées par p_a sont un sous-ensemble de celles de p_b: aucun prolongement de p_b
+    //! n'emprunte alors moins de lignes que le même prolongement de p_a. Un ensemble vide (marche seulement) n'est
+    //! comparé qu'à un ensemble vide, comme les itinéraires retenus.
+    bool sousEnsemble(const vector<LigneEmpruntee> &p_lignes, uint32_t p_a, uint32_t p_b) {
+        if (p_a == aucuneEtiquette) return p_b == aucuneEtiquette;
+        if (masqueDe(p_lignes, p_a) & ~masqueDe(p_lignes, p_b)) return false;
+        for (uint32_t i = p_a; i != aucuneEtiquette; i = p_lignes[i].precedente)
+            if (!contient(p_lignes, p_b, p_lignes[i].ligne)) return false;
+        return true;
+    }
+
+    //! \brief nombre de lignes de l'ensemble qui se termine au maillon p_maillon, saturé à 255
+    uint32_t nbLignes(const vector<LigneEmpruntee> &p_lignes, uint32_t p_maillon) {
+        uint32_t nb = 0;
+        for (uint32_t i = p_maillon; i != aucuneEtiquette && nb < 0xFF; i = p_lignes[i].precedente) ++nb;
+        return nb;
+    }
+
+    //! \brief vrai si le chemin partiel p_a vient après p_b parmi ceux d'un même sommet: il arrive plus tard ou, à
+    //! temps égal, emprunte plus de lignes ou, à nombre égal, un ensemble de lignes qui vient après celui de p_b. Cet
+    //! ordre ne dépend pas de celui où les chemins ont été créés.
+    bool vientApres(const vector<LigneEmpruntee> &p_lignes, const Etiquette &p_a, const Etiquette &p_b) {
+        if (p_a.temps != p_b.temps) return p_a.temps > p_b.temps;
+        const uint32_t nbA = nbLignes(p_lignes, p_a.lignes), nbB = nbLignes(p_lignes, p_b.lignes);
+        if (nbA != nbB) return nbA > nbB;
+        auto triees = [&](uint32_t p_maillon) {
+            vector<uint32_t> lignes;
+            for (uint32_t i = p_maillon; i != aucuneEtiquette; i = p_lignes[i].precedente)
+                lignes.push_back(p_lignes[i].ligne);
+            sort(lignes.begin(), lignes.end());
+            return lignes;
+        };
+        return triees(p_b.lignes) < triees(p_a.lignes);
+    }
+
+    //! \brief lignes (route_id) des étapes TRAJET d'un itinéraire, triées et sans doublons
+    vector<unsigned int> lignesDe(const Itineraire &p_itineraire) {
+        vector<unsigned int> lignes;
+        for (const Etape &etape : p_itineraire.etapes)
+            if (etape.type == Etape::TRAJET) lignes.push_back(etape.ligne);
+        sort(lignes.begin(), lignes.end());
+        lignes.erase(unique(lignes.begin(), lignes.end()), lignes.end());
+        return lignes;
+    }
+}
+
+//! \brief Calcule jusqu'à p_nbAlternatives itinéraires entre deux points qui diffèrent par les lignes empruntées, et non
+//! seulement par l'heure de départ, par heure d'arrivée croissante
+//! \brief Une seule recherche fournit tous les candidats: c'est un Dijkstra où chaque sommet garde jusqu'à
+//! p_nbAlternatives chemins partiels (au lieu d'un seul), et où les arrivées à destination passent par la même file
+//! que les sommets. Les arrivées sont donc examinées par heure croissante; la première est l'itinéraire de
+//! calculerItineraire(). Une arrivée est retenue sauf si un itinéraire déjà retenu, donc plus rapide, emprunte un
+//! sous-ensemble de ses lignes: elle n'offrirait alors que des changements de plus. À heure égale, les arrivées sont
+//! examinées par nombre de lignes croissant, de sorte que le résultat ne dépende pas de l'ordre où leurs chemins
+//! partiels ont été créés; de même, un sommet plein garde ses premiers chemins selon un ordre total (temps, nombre
+//! puis ensemble de lignes), et non les premiers créés. Un sommet ne garde pas un chemin qui n'y arrive pas plus tôt
+//! qu'un autre n'ayant emprunté qu'une partie de ses lignes: ses places vont aux chemins qui peuvent encore donner des
+//! itinéraires distincts. Le graphe n'est pas modifié et aucune recherche n'est refaite d'une alternative à l'autre.
+//! \param[in] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point d'origine
+//! \param[in] p_nbAlternatives: le nombre maximal d'itinéraires retournés
+//! \param[in] p_retardMaximal: les alternatives arrivent au plus p_retardMaximal secondes après le plus rapide
+//! \param[out] p_itineraires: les itinéraires retenus (vide si la destination n'est pas atteignable)
+//! \param[out] p_statistiques: sommetsSolutionnes compte les chemins partiels traités et sommetsEmpiles les entrées de
+//! la file
+//! \throws logic_error si p_heureDepart n'appartient pas à l'intervalle de temps du GTFS
+//! \throws logic_error si les points origine et destination de ajouterArcsOrigineDestination() sont présents
+void ReseauGTFS::calculerAlternatives(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                      const Coordonnees &p_pointDestination, const Heure &p_heureDepart,
+                                      unsigned int p_nbAlternatives, unsigned int p_retardMaximal,
+                                      vector<Itineraire> &p_itineraires, StatistiquesRecherche &p_statistiques) const
+{
+    if (p_heureDepart < p_gtfs.getTempsDebut() || !(p_heureDepart < p_gtfs.getTempsFin()))
+        throw logic_error("ReseauGTFS::calculerAlternatives(): heure de départ hors de l'intervalle du GTFS");
+    if (m_origine_dest_ajoute)
+        throw logic_error("ReseauGTFS::calculerAlternatives(): il faut enlever les points origine et destination avant");
+    try
+    {
+        p_itineraires.clear();
+        p_statistiques = StatistiquesRecherche();
+        if (p_nbAlternatives == 0) return;
+        vector<SommetPondere> sources;
+        DestinationParGroupes destination;
+        sommetsEntreeSortie(p_gtfs, p_pointOrigine, p_pointDestination, p_heureDepart, sources, destination);
+
+        const unsigned int infini = numeric_limits<unsigned int>::max();
+        const size_t tailleGraphe = m_leGraphe.getNbSommets();
+
+        vector<uint32_t> premiere(tailleGraphe, aucuneEtiquette);
+        vector<Etiquette> etiquettes;
+        etiquettes.reserve(1024);
+        vector<LigneEmpruntee> lignesEmpruntees;
+        // <(temps << 8) | lignes empruntées par une arrivée, indice de l'étiquette (| bitArrivee pour une arrivée)>: à
+        // temps égal, les chemins partiels passent avant les arrivées, et celles-ci par nombre de lignes croissant
+        typedef pair<uint64_t, uint32_t> Entree;
+        priority_queue<Entree, vector<Entree>, greater<Entree>> file;
+        auto arriver = [&](uint32_t p_temps, uint32_t p_etiquette) {
+            file.push({((uint64_t) p_temps << 8) | nbLignes(lignesEmpruntees, etiquettes[p_etiquette].lignes),
+                       p_etiquette | bitArrivee});
+            p_statistiques.sommetsEmpiles++;
+        };
+
+        // un sommet garde au plus p_nbAlternatives chemins, les plus hâtifs; un chemin qui n'arrive pas plus tard qu'un
+        // autre, par une partie de ses lignes, écarte ce dernier (à lignes et temps égaux, le premier reste)
+        auto ajouter = [&](Etiquette p_etiquette) {
+            uint32_t *lien = &premiere[p_etiquette.sommet];
+            unsigned int nb = 0;
+            while (*lien != aucuneEtiquette)
+            {
+                Etiquette &existante = etiquettes[*lien];
+                if (existante.temps <= p_etiquette.temps &&
+                    sousEnsemble(lignesEmpruntees, existante.lignes, p_etiquette.lignes))
+                    return;
+                if (p_etiquette.temps <= existante.temps &&
+                    sousEnsemble(lignesEmpruntees, p_etiquette.lignes, existante.lignes))
+                {
+                    existante.active = 0;
+                    *lien = existante.suivante;
+                }
+                else
+                {
+                    lien = &existante.suivante;
+                    ++nb;
+                }
+            }
+            if (nb >= p_nbAlternatives)
+            {
+                // sommet plein: le dernier chemin selon vientApres() cède sa place s'il vient après le nouveau; il n'a
+                // alors pas encore été traité, la file étant ordonnée par temps
+                uint32_t *pire = &premiere[p_etiquette.sommet];
+                for (lien = pire; *lien != aucuneEtiquette; lien = &etiquettes[*lien].suivante)
+                    if (vientApres(lignesEmpruntees, etiquettes[*lien], etiquettes[*pire])) pire = lien;
+                if (!vientApres(lignesEmpruntees, etiquettes[*pire], p_etiquette)) return;
+                etiquettes[*pire].active = 0;
+                *pire = etiquettes[*pire].suivante;
+            }
+            if (etiquettes.size() >= bitArrivee) throw logic_error("trop de chemins partiels");
+            p_etiquette.suivante = premiere[p_etiquette.sommet];
+            p_etiquette.active = 1;
+            etiquettes.push_back(p_etiquette);
+            premiere[p_etiquette.sommet] = (uint32_t) etiquettes.size() - 1;
+            file.push({(uint64_t) p_etiquette.temps << 8, premiere[p_etiquette.sommet]});
+            p_statistiques.sommetsEmpiles++;
+        };
+
+        // les lignes empruntées après un arc de voyage de la ligne p_ligne depuis l'étiquette p_etiquette
+        auto lignesApres = [&](const Etiquette &p_etiquette, uint32_t p_ligne) -> uint32_t {
+            if (p_etiquette.aBord || contient(lignesEmpruntees, p_etiquette.lignes, p_ligne)) return p_etiquette.lignes;
+            const uint64_t masque = masqueDe(lignesEmpruntees, p_etiquette.lignes) | (1ULL << (p_ligne & 63));
+            lignesEmpruntees.push_back(LigneEmpruntee{masque, p_ligne, p_etiquette.lignes});
+            return (uint32_t) lignesEmpruntees.size() - 1;
+        };
+        // une arrivée par chacun des arrêts contractés m_arretsContractes[p_debut], ... jusqu'à p_fin, qui suivent le
+        // sommet de p_depart sur son voyage (réseau compacté, voir compacterVoyages()): leur étiquette n'entre que dans
+        // le tableau, pour reconstruire le chemin. Retourne le dernier arrêt franchi (numeric_limits<size_t>::max() si
+        // un arc de voyage désactivé coupe la suite).
+        auto descendre = [&](uint32_t p_parent, Etiquette p_depart, size_t p_debut, size_t p_fin,
+                             uint32_t p_lignes) -> size_t {
+            size_t precedent = p_depart.sommet;
+            for (size_t k = p_debut; k < p_fin; ++k)
+            {
+                const size_t descente = m_premierContracte + k;
+                if (secondesEntre(precedent, descente) < 0) return numeric_limits<size_t>::max();
+                precedent = descente;
+                const unsigned int sortie = destination.sortie[stationDe(descente)];
+                if (sortie == infini) continue;
+                if (etiquettes.size() >= bitArrivee) throw logic_error("trop de chemins partiels");
+                const uint32_t temps = p_depart.temps + secondesEntre(p_depart.sommet, descente);
+                etiquettes.push_back(Etiquette{(uint32_t) descente, p_parent, aucuneEtiquette, temps, p_lignes, 1, 0});
+                arriver(temps + sortie, (uint32_t) etiquettes.size() - 1);
+            }
+            return precedent;
+        };
+
+        for (const auto &source : sources)
+        {
+            const Etiquette depart{(uint32_t) source.first, aucuneEtiquette, aucuneEtiquette, source.second,
+                                   aucuneEtiquette, 0, 1};
+            if (!estContracte(source.first))
+            {
+                ajouter(depart);
+                continue;
+            }
+            // entrée à un arrêt contracté: sortie à sa station, descente plus loin sur son raccourci, ou poursuite
+            // jusqu'au sommet aval
+            if (etiquettes.size() >= bitArrivee) throw logic_error("trop de chemins partiels");
+            const uint32_t indiceDepart = (uint32_t) etiquettes.size();
+            etiquettes.push_back(depart);
+            etiquettes.back().active = 0;
+            const unsigned int sortie = destination.sortie[stationDe(source.first)];
+            if (sortie != infini) arriver(depart.temps + sortie, indiceDepart);
+            const ArretContracte &contracte = m_arretsContractes[source.first - m_premierContracte];
+            const uint32_t lignes = lignesApres(depart, m_ligneDuSommet[contracte.amont]);
+            const size_t precedent = descendre(indiceDepart, depart, source.first - m_premierContracte + 1,
+                                               chaineDe(contracte.amont).second, lignes);
+            if (precedent != numeric_limits<size_t>::max() && secondesEntre(precedent, contracte.aval) >= 0)
+                ajouter(Etiquette{(uint32_t) contracte.aval, indiceDepart, aucuneEtiquette,
+                                  depart.temps + secondesEntre(source.first, contracte.aval), lignes, 1, 1});
+        }
+
+        vector<vector<unsigned int>> lignesRetenues;
+        vector<size_t> chemin;
+        unsigned int limite = infini;
+        while (!file.empty() && p_itineraires.size() < p_nbAlternatives && (file.top().first >> 8) <= limite)
+        {
+            const uint32_t temps = (uint32_t) (file.top().first >> 8);
+            const uint32_t code = file.top().second;
+            file.pop();
+
+            if (code & bitArrivee)
+            {
+                chemin.clear();
+                for (uint32_t i = code & ~bitArrivee; i != aucuneEtiquette; i = etiquettes[i].parent)
+                    chemin.push_back(etiquettes[i].sommet);
+                reverse(chemin.begin(), chemin.end());
+                Itineraire candidat;
+                candidat.heureDepart = p_heureDepart;
+                candidat.duree = temps;
+                const Station &premiereStation =
+                        p_gtfs.getStations().at(arretDe(chemin.front())->getStationId());
+                extraireEtapes(p_gtfs, chemin, 0, chemin.size(),
+                               tempsDeMarche(p_pointOrigine, premiereStation.getCoords()), candidat);
+
+                // un chemin à pieds seulement n'écarte que les autres chemins à pieds
+                vector<unsigned int> lignes = lignesDe(candidat);
+                bool redondant = false;
+                for (const auto &retenues : lignesRetenues)
+                    if ((!retenues.empty() || lignes.empty()) &&
+                        includes(lignes.begin(), lignes.end(), retenues.begin(), retenues.end()))
+                    {
+                        redondant = true;
+                        break;
+                    }
+                if (redondant) continue;
+                if (p_itineraires.empty() && p_retardMaximal < infini - temps) limite = temps + p_retardMaximal;
+                lignesRetenues.push_back(std::move(lignes));
+                p_itineraires.push_back(std::move(candidat));
+                continue;
+            }
+
+            const Etiquette courante = etiquettes[code]; // copie: ajouter() peut déplacer le tableau
+            if (!courante.active) continue;
+            p_statistiques.sommetsSolutionnes++;
+            const unsigned int sortie = destination.sortie[m_stationDuSommet[courante.sommet]];
+            if (sortie != infini) arriver(courante.temps + sortie, code);
+            const pair<size_t, size_t> chaine = chaineDe(courante.sommet);
+            if (chaine.first != chaine.second)
+                descendre(code, courante, chaine.first, chaine.second,
+                          lignesApres(courante, m_ligneDuSommet[courante.sommet]));
+
+            const Arret::Ptr &arretFrom = m_arretDuSommet[courante.sommet];
+            m_leGraphe.pourChaqueArcSortant(courante.sommet, [&](size_t p_destination, unsigned int p_poids) {
+                // Les arcs désactivés (ex: correspondance rendue impossible par un retard) sont ignorés
+                if (p_poids == infini) return;
+                p_statistiques.arcsRelaches++;
+                const Arret::Ptr &arretTo = m_arretDuSommet[p_destination];
+                Etiquette suivante = courante;
+                suivante.sommet = (uint32_t) p_destination;
+                suivante.parent = code;
+                suivante.temps += p_poids;
+                if (arretFrom->getVoyageId() == arretTo->getVoyageId())
+                {
+                    suivante.lignes = lignesApres(courante, m_ligneDuSommet[courante.sommet]);
+                    suivante.aBord = 1;
+                }
+                else suivante.aBord = 0;
+                ajouter(suivante);
+            });
+        }
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
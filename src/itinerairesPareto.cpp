@@ -0,0 +1,361 @@
+//
+// Recherche multicritère: l'ensemble de Pareto des itinéraires selon l'heure d'arrivée, le nombre de changements de
+// véhicule et le temps de marche.
+//
+
+#include "ReseauGTFS.h"
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+    const uint32_t aucuneEtiquette = numeric_limits<uint32_t>::max();
+
+    //! \brief chemin partiel de la recherche multicritère, de taille fixe (24 octets): les étiquettes d'une requête
+    //! sont rangées dans un seul tableau et celles d'un même sommet sont chaînées par indice
+    struct Etiquette {
+        uint32_t sommet;
+        uint32_t parent;   // étiquette du sommet précédent sur le chemin (aucuneEtiquette pour un sommet d'entrée)
+        uint32_t suivante; // étiquette suivante du même sommet (aucuneEtiquette pour la dernière)
+        uint32_t temps;    // secondes écoulées depuis l'heure de départ
+        uint32_t marche;   // secondes de marche
+        uint16_t trajets;  // voyages empruntés
+        uint8_t aBord;     // 1 si le dernier arc est un arc de voyage: le poursuivre n'est pas un nouveau trajet
+        uint8_t active;    // 0 si l'étiquette a été dominée après sa création
+    };
+    static_assert(sizeof(Etiquette) == 24, "Etiquette doit rester compacte");
+
+    //! \brief vrai si aucun prolongement de p_b ne peut faire mieux, sur un critère, que le même prolongement de p_a
+    //! \brief Une étiquette hors voyage qui se compare à une étiquette à bord compte un trajet de plus: si le chemin
+    //! continue sur le voyage du sommet, elle doit y monter.
+    bool domine(const Etiquette &p_a, const Etiquette &p_b) {
+        const unsigned int montee = !p_a.aBord && p_b.aBord ? 1 : 0;
+        return p_a.temps <= p_b.temps && p_a.marche <= p_b.marche && p_a.trajets + montee <= p_b.trajets;
+    }
+
+    //! \brief un itinéraire complet: l'étiquette de son dernier arrêt et ses critères, marche finale comprise
+    struct Arrivee {
+        uint32_t etiquette;
+        uint32_t temps;
+        uint32_t marche;
+        uint32_t changements;
+    };
+
+    //! \brief changements de véhicule d'un chemin de p_trajets trajets: un chemin sans trajet (à pieds) n'en a aucun,
+    //! comme un chemin d'un seul trajet
+    uint32_t changementsDe(uint32_t p_trajets) {
+        return p_trajets > 0 ? p_trajets - 1 : 0;
+    }
+
+    //! \brief ordre de la file: heure plus p_borne (la borne inférieure du reste du trajet), puis trajets, puis marche
+    //! (les deux derniers saturés à 8 et 24 bits)
+    uint64_t cleDe(const Etiquette &p_etiquette, uint32_t p_borne) {
+        return ((uint64_t) (p_etiquette.temps + p_borne) << 32) |
+               ((uint64_t) min<uint32_t>(p_etiquette.trajets, 0xFF) << 24) |
+               min<uint32_t>(p_etiquette.marche, 0xFFFFFF);
+    }
+}
+
+//! \brief Calcule l'ensemble de Pareto des itinéraires entre deux points selon trois critères à minimiser: l'heure
+//! d'arrivée, le nombre de changements de véhicule et le temps de marche
+//! \brief Les sommets d'entrée et de sortie sont ceux de calculerItineraire(), qui donne le premier itinéraire de
+//! l'ensemble (le plus rapide). La recherche est un Dijkstra multi-étiquettes: chaque sommet garde les étiquettes
+//! (temps, trajets, marche) qu'aucune autre ne domine, et une étiquette est abandonnée dès qu'un itinéraire déjà trouvé
+//! la domine, ce qui borne la recherche lorsque la destination est atteinte. La comparaison se fait sur ce que
+//! l'étiquette peut au mieux devenir: son temps plus la borne de sa station (voir calculerBornes()), ses trajets plus
+//! les montées qui lui restent au minimum (voir calculerMonteesMinimales()), sa marche plus la plus petite marche
+//! finale. Sans la borne des montées, les étiquettes à peu de changements ne seraient jamais dominées par les
+//! itinéraires trouvés, plus rapides mais à plus de changements, et rempliraient le réseau. Le nombre d'étiquettes
+//! d'un sommet n'est pas borné: l'ensemble retourné est complet. La file est ordonnée par temps plus borne, comme
+//! calculerItineraire(), de sorte que les itinéraires rapides, qui élaguent le plus, sont trouvés tôt. Comme
+//! calculerItineraire(), la méthode ne modifie pas le réseau et peut être appelée par plusieurs fils d'exécution à la
+//! fois.
+//! \param[in] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point d'origine
+//! \param[out] p_itineraires: l'ensemble de Pareto, par heure d'arrivée croissante (vide si la destination n'est pas
+//! atteignable)
+//! \param[out] p_statistiques: sommetsSolutionnes compte les étiquettes traitées et sommetsEmpiles les étiquettes
+//! créées
+//! \throws logic_error si p_heureDepart n'appartient pas à l'intervalle de temps du GTFS
+//! \throws logic_error si les points origine et destination de ajouterArcsOrigineDestination() sont présents
+void ReseauGTFS::calculerItinerairesPareto(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                           const Coordonnees &p_pointDestination, const Heure &p_heureDepart,
+                                           vector<ItinerairePareto> &p_itineraires,
+                                           StatistiquesRecherche &p_statistiques) const
+{
+    if (p_heureDepart < p_gtfs.getTempsDebut() || !(p_heureDepart < p_gtfs.getTempsFin()))
+        throw logic_error("ReseauGTFS::calculerItinerairesPareto(): heure de départ hors de l'intervalle du GTFS");
+    if (m_origine_dest_ajoute)
+        throw logic_error(
+                "ReseauGTFS::calculerItinerairesPareto(): il faut enlever les points origine et destination avant");
+    try
+    {
+        p_itineraires.clear();
+        p_statistiques = StatistiquesRecherche();
+        vector<SommetPondere> sources;
+        DestinationParGroupes destination;
+        sommetsEntreeSortie(p_gtfs, p_pointOrigine, p_pointDestination, p_heureDepart, sources, destination);
+
+        const unsigned int infini = numeric_limits<unsigned int>::max();
+        const size_t tailleGraphe = m_leGraphe.getNbSommets();
+        unsigned int sortieMinimale = infini; // borne inférieure de la marche restante
+        for (unsigned int sortie : destination.sortie) sortieMinimale = min(sortieMinimale, sortie);
+        vector<unsigned int> monteesDeStation, monteesDeLigne;
+        calculerMonteesMinimales(destination, monteesDeStation, monteesDeLigne);
+
+        vector<uint32_t> premiere(tailleGraphe, aucuneEtiquette);
+        vector<Etiquette> etiquettes;
+        etiquettes.reserve(1024);
+        vector<Arrivee> arrivees;
+        typedef pair<uint64_t, uint32_t> Entree; // <cleDe(étiquette), indice de l'étiquette>
+        priority_queue<Entree, vector<Entree>, greater<Entree>> file;
+
+        // une étiquette qu'un itinéraire trouvé domine ne peut mener qu'à des itinéraires dominés
+        auto estElaguee = [&](uint64_t p_temps, uint32_t p_changements, uint64_t p_marche) {
+            for (const Arrivee &arrivee : arrivees)
+                if (arrivee.temps <= p_temps && arrivee.changements <= p_changements && arrivee.marche <= p_marche)
+                    return true;
+            return false;
+        };
+        // ... même en lui ajoutant le moins qu'il lui reste à parcourir: le temps, la marche et les montées (à bord, le
+        // voyage peut mener sans changement à toute station de sa ligne); une borne infinie l'écarte toujours
+        auto borneDe = [&](const Etiquette &p_etiquette) {
+            return destination.borne[m_stationDuSommet[p_etiquette.sommet]];
+        };
+        auto estElagueeAvecBorne = [&](const Etiquette &p_etiquette) {
+            const unsigned int borne = borneDe(p_etiquette);
+            const unsigned int montees = p_etiquette.aBord ? monteesDeLigne[m_ligneDuSommet[p_etiquette.sommet]]
+                                                           : monteesDeStation[m_stationDuSommet[p_etiquette.sommet]];
+            return borne == infini || montees == infini ||
+                   estElaguee((uint64_t) p_etiquette.temps + borne, changementsDe(p_etiquette.trajets + montees),
+                              (uint64_t) p_etiquette.marche + sortieMinimale);
+        };
+
+        // insère l'étiquette si aucune étiquette de son sommet ne la domine, et retire du sommet celles qu'elle domine
+        // (la dominance étant transitive, ces deux cas s'excluent: un seul passage suffit)
+        auto ajouter = [&](Etiquette p_etiquette) {
+            if (estElagueeAvecBorne(p_etiquette)) return;
+            uint32_t *lien = &premiere[p_etiquette.sommet];
+            while (*lien != aucuneEtiquette)
+            {
+                Etiquette &existante = etiquettes[*lien];
+                if (domine(existante, p_etiquette)) return;
+                if (domine(p_etiquette, existante))
+                {
+                    existante.active = 0;
+                    *lien = existante.suivante;
+                }
+                else
+                    lien = &existante.suivante;
+            }
+            p_etiquette.suivante = premiere[p_etiquette.sommet];
+            p_etiquette.active = 1;
+            premiere[p_etiquette.sommet] = (uint32_t) etiquettes.size();
+            etiquettes.push_back(p_etiquette);
+            file.push({cleDe(p_etiquette, borneDe(p_etiquette)), premiere[p_etiquette.sommet]});
+            p_statistiques.sommetsEmpiles++;
+        };
+
+        // retient un itinéraire qu'aucun autre ne domine, et retire ceux qu'il domine
+        auto retenir = [&](const Arrivee &p_arrivee) {
+            if (estElaguee(p_arrivee.temps, p_arrivee.changements, p_arrivee.marche)) return;
+            arrivees.erase(remove_if(arrivees.begin(), arrivees.end(), [&](const Arrivee &p_autre) {
+                return p_arrivee.temps <= p_autre.temps && p_arrivee.changements <= p_autre.changements &&
+                       p_arrivee.marche <= p_autre.marche;
+            }), arrivees.end());
+            arrivees.push_back(p_arrivee);
+        };
+
+        // Sur un réseau compacté (voir compacterVoyages()), les arrêts contractés m_arretsContractes[p_debut], ...,
+        // jusqu'à p_fin, qui suivent le sommet de p_depart sur son voyage, ne sont pas des sommets: la sortie par chacun
+        // d'eux est examinée depuis p_depart, à travers une étiquette qui n'entre ni dans premiere ni dans la file et ne
+        // sert qu'à reconstruire le chemin. Retourne le dernier arrêt franchi (numeric_limits<size_t>::max() si un arc
+        // de voyage désactivé coupe la suite).
+        auto descendre = [&](uint32_t p_parent, Etiquette p_depart, size_t p_debut, size_t p_fin) -> size_t {
+            size_t precedent = p_depart.sommet;
+            for (size_t k = p_debut; k < p_fin; ++k)
+            {
+                const size_t descente = m_premierContracte + k;
+                if (secondesEntre(precedent, descente) < 0) return numeric_limits<size_t>::max();
+                precedent = descente;
+                const unsigned int sortie = destination.sortie[stationDe(descente)];
+                if (sortie == infini) continue;
+                const Etiquette etiquette{(uint32_t) descente, p_parent, aucuneEtiquette,
+                                          p_depart.temps + secondesEntre(p_depart.sommet, descente), p_depart.marche,
+                                          (uint16_t) (p_depart.trajets + (p_depart.aBord ? 0 : 1)), 1, 0};
+                const Arrivee arrivee{(uint32_t) etiquettes.size(), etiquette.temps + sortie, etiquette.marche + sortie,
+                                      changementsDe(etiquette.trajets)};
+                if (estElaguee(arrivee.temps, arrivee.changements, arrivee.marche)) continue;
+                etiquettes.push_back(etiquette);
+                retenir(arrivee);
+            }
+            return precedent;
+        };
+
+        for (const auto &source : sources)
+        {
+            const Arret::Ptr &arret = arretDe(source.first);
+            const unsigned int marche =
+                    tempsDeMarche(p_pointOrigine, p_gtfs.getStations().at(arret->getStationId()).getCoords());
+            const Etiquette depart{(uint32_t) source.first, aucuneEtiquette, aucuneEtiquette, source.second, marche, 0,
+                                   0, 1};
+            if (!estContracte(source.first))
+            {
+                ajouter(depart);
+                continue;
+            }
+            // entrée à un arrêt contracté: sortie à sa station, descente plus loin sur son raccourci, ou poursuite
+            // jusqu'au sommet aval
+            const uint32_t indiceDepart = (uint32_t) etiquettes.size();
+            etiquettes.push_back(depart);
+            etiquettes.back().active = 0;
+            const unsigned int sortie = destination.sortie[stationDe(source.first)];
+            if (sortie != infini) retenir(Arrivee{indiceDepart, depart.temps + sortie, depart.marche + sortie, 0});
+            const ArretContracte &contracte = m_arretsContractes[source.first - m_premierContracte];
+            const size_t precedent = descendre(indiceDepart, depart, source.first - m_premierContracte + 1,
+                                               chaineDe(contracte.amont).second);
+            if (precedent != numeric_limits<size_t>::max() && secondesEntre(precedent, contracte.aval) >= 0)
+                ajouter(Etiquette{(uint32_t) contracte.aval, indiceDepart, aucuneEtiquette,
+                                  depart.temps + secondesEntre(source.first, contracte.aval), marche, 1, 1, 1});
+        }
+
+        while (!file.empty())
+        {
+            const uint32_t indice = file.top().second;
+            file.pop();
+            const Etiquette courante = etiquettes[indice]; // copie: ajouter() peut déplacer le tableau
+            if (!courante.active || estElagueeAvecBorne(courante)) continue;
+            p_statistiques.sommetsSolutionnes++;
+
+            // l'arc implicite vers la destination
+            const unsigned int sortie = destination.sortie[m_stationDuSommet[courante.sommet]];
+            if (sortie != infini)
+                retenir(Arrivee{indice, courante.temps + sortie, courante.marche + sortie,
+                                changementsDe(courante.trajets)});
+            const pair<size_t, size_t> chaine = chaineDe(courante.sommet);
+            if (chaine.first != chaine.second) descendre(indice, courante, chaine.first, chaine.second);
+
+            const Arret::Ptr &arretFrom = m_arretDuSommet[courante.sommet];
+            m_leGraphe.pourChaqueArcSortant(courante.sommet, [&](size_t p_destination, unsigned int p_poids) {
+                // Les arcs désactivés (ex: correspondance rendue impossible par un retard) sont ignorés
+                if (p_poids == infini) return;
+                p_statistiques.arcsRelaches++;
+                const Arret::Ptr &arretTo = m_arretDuSommet[p_destination];
+                Etiquette suivante = courante;
+                suivante.sommet = (uint32_t) p_destination;
+                suivante.parent = indice;
+                suivante.temps += p_poids;
+                if (arretFrom->getVoyageId() == arretTo->getVoyageId())
+                {
+                    if (!suivante.aBord) suivante.trajets++;
+                    suivante.aBord = 1;
+                }
+                else
+                {
+                    suivante.aBord = 0;
+                    if (arretFrom->getStationId() != arretTo->getStationId())
+                        suivante.marche += tempsDeTransfert(arretFrom->getStationId(), arretTo->getStationId());
+                }
+                ajouter(suivante);
+            });
+        }
+
+        sort(arrivees.begin(), arrivees.end(), [](const Arrivee &a, const Arrivee &b) {
+            return a.temps != b.temps ? a.temps < b.temps
+                                      : a.changements != b.changements ? a.changements < b.changements
+                                                                       : a.marche < b.marche;
+        });
+        vector<size_t> chemin;
+        for (const Arrivee &arrivee : arrivees)
+        {
+            chemin.clear();
+            for (uint32_t i = arrivee.etiquette; i != aucuneEtiquette; i = etiquettes[i].parent)
+                chemin.push_back(etiquettes[i].sommet);
+            reverse(chemin.begin(), chemin.end());
+
+            p_itineraires.emplace_back();
+            ItinerairePareto &resultat = p_itineraires.back();
+            resultat.itineraire.heureDepart = p_heureDepart;
+            resultat.itineraire.duree = arrivee.temps;
+            resultat.nbChangements = arrivee.changements;
+            resultat.secondesDeMarche = arrivee.marche;
+            const Station &premiereStation = p_gtfs.getStations().at(arretDe(chemin.front())->getStationId());
+            extraireEtapes(p_gtfs, chemin, 0, chemin.size(), tempsDeMarche(p_pointOrigine, premiereStation.getCoords()),
+                           resultat.itineraire);
+        }
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
+
+//! \brief calcule, pour chaque station et chaque ligne, le nombre minimal de montées dans un voyage pour atteindre une
+//! station de sortie de p_destination, par un parcours en largeur sur les dessertes des lignes
+//! \brief Le parcours se fait à rebours depuis les stations de sortie (0 montée). Un transfert (de transfers.txt ou à
+//! pieds) ne coûte aucune montée; une ligne qui passe par une station à k montées en coûte au plus k depuis un de ses
+//! voyages, et k + 1 depuis toute autre de ses stations. Le sens des voyages et les heures sont ignorés: le résultat
+//! est une borne inférieure.
+//! \param[out] p_monteesDeStation: pour chaque indice de station, les montées minimales depuis un arrêt où l'on n'est
+//! pas à bord (numeric_limits<unsigned int>::max() si la destination n'en est pas atteignable)
+//! \param[out] p_monteesDeLigne: pour chaque indice de ligne, les montées minimales depuis un de ses voyages
+void ReseauGTFS::calculerMonteesMinimales(const DestinationParGroupes &p_destination,
+                                          vector<unsigned int> &p_monteesDeStation,
+                                          vector<unsigned int> &p_monteesDeLigne) const
+{
+    const unsigned int infini = numeric_limits<unsigned int>::max();
+    p_monteesDeStation.assign(m_idStations.size(), infini);
+    p_monteesDeLigne.assign(m_stationsDeLigne.size(), infini);
+    vector<unsigned int> niveau, suivant;
+    for (unsigned int station = 0; station < p_destination.sortie.size(); ++station)
+    {
+        if (p_destination.sortie[station] == infini) continue;
+        p_monteesDeStation[station] = 0;
+        niveau.push_back(station);
+    }
+    for (unsigned int montees = 0; !niveau.empty(); ++montees)
+    {
+        // les transferts vers une station du niveau ne coûtent aucune montée: leurs stations s'ajoutent au niveau
+        for (size_t i = 0; i < niveau.size(); ++i)
+        {
+            auto itTransferts = m_transfertsVersStation.find(m_idStations[niveau[i]]);
+            if (itTransferts == m_transfertsVersStation.end()) continue;
+            for (const auto &transfert : itTransferts->second)
+            {
+                const unsigned int station = indiceDeStation(transfert.first);
+                if (p_monteesDeStation[station] != infini) continue;
+                p_monteesDeStation[station] = montees;
+                niveau.push_back(station);
+            }
+        }
+        suivant.clear();
+        for (unsigned int station : niveau)
+        {
+            for (unsigned int ligne : m_lignesDeStation[station])
+            {
+                if (p_monteesDeLigne[ligne] != infini) continue;
+                p_monteesDeLigne[ligne] = montees;
+                for (unsigned int autre : m_stationsDeLigne[ligne])
+                {
+                    if (p_monteesDeStation[autre] != infini) continue;
+                    p_monteesDeStation[autre] = montees + 1;
+                    suivant.push_back(autre);
+                }
+            }
+        }
+        niveau.swap(suivant);
+    }
+}
+
+//! \brief retourne le temps minimal du transfert (de transfers.txt, ou le temps de marche d'un trajet à pieds) de la
+//! station p_stationFrom à la station p_stationTo, ou 0 s'il n'y a pas de tel transfert
+unsigned int ReseauGTFS::tempsDeTransfert(unsigned int p_stationFrom, unsigned int p_stationTo) const
+{
+    auto itTransferts = m_transfertsVersStation.find(p_stationTo);
+    if (itTransferts == m_transfertsVersStation.end()) return 0;
+    for (const auto &transfert : itTransferts->second)
+        if (transfert.first == p_stationFrom) return transfert.second;
+    return 0;
+}
@@ -0,0 +1,271 @@
+//
+// Lecteur de fichiers CSV (RFC 4180) utilisé pour charger les fichiers GTFS.
+//
+
+#include "lecteurCSV.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+const size_t LecteurCSV::colonneAbsente = static_cast<size_t>(-1);
+
+namespace {
+    const char *const champVide = "";
+    const size_t tailleBloc = 1 << 16; // octets lus du fichier à la fois
+
+    bool estEspace(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    //! \brief vérifie qu'il ne reste que des espaces après une valeur numérique
+    void verifierFinDuNombre(const char *p_fin, const char *p_debut, const LecteurCSV::Champ &p_champ) {
+        while (estEspace(*p_fin)) ++p_fin;
+        if (p_fin == p_debut || *p_fin != '\0' || errno == ERANGE)
+            throw logic_error("valeur numérique invalide: '" + p_champ.versString() + "'");
+    }
+}
+
+LecteurCSV::Champ::Champ() : m_debut(champVide), m_taille(0) {
+}
+
+const LecteurCSV::Champ LecteurCSV::Rangee::champAbsent;
+
+LecteurCSV::Champ::Champ(const char *p_debut, size_t p_taille) : m_debut(p_debut), m_taille(p_taille) {
+}
+
+const char *LecteurCSV::Champ::getDebut() const {
+    return m_debut;
+}
+
+size_t LecteurCSV::Champ::getTaille() const {
+    return m_taille;
+}
+
+bool LecteurCSV::Champ::estVide() const {
+    return m_taille == 0;
+}
+
+bool LecteurCSV::Champ::operator==(const char *p_texte) const {
+    return strlen(p_texte) == m_taille && memcmp(m_debut, p_texte, m_taille) == 0;
+}
+
+std::string LecteurCSV::Champ::versString() const {
+    return string(m_debut, m_taille);
+}
+
+//! \brief copie le champ dans une chaîne existante, ce qui réutilise sa capacité
+void LecteurCSV::Champ::copierDans(std::string &p_destination) const {
+    p_destination.assign(m_debut, m_taille);
+}
+
+//! \throws logic_error si le champ n'est pas un entier non négatif
+unsigned int LecteurCSV::Champ::versEntier() const {
+    const char *debut = m_debut;
+    while (estEspace(*debut)) ++debut;
+    if (*debut == '-') throw logic_error("valeur numérique invalide: '" + versString() + "'");
+    char *fin;
+    errno = 0;
+    unsigned long valeur = strtoul(debut, &fin, 10);
+    verifierFinDuNombre(fin, debut, *this);
+    return static_cast<unsigned int>(valeur);
+}
+
+//! \throws logic_error si le champ n'est pas un entier
+int LecteurCSV::Champ::versEntierSigne() const {
+    char *fin;
+    errno = 0;
+    long valeur = strtol(m_debut, &fin, 10);
+    verifierFinDuNombre(fin, m_debut, *this);
+    return static_cast<int>(valeur);
+}
+
+//! \throws logic_error si le champ n'est pas un nombre réel
+double LecteurCSV::Champ::versReel() const {
+    char *fin;
+    errno = 0;
+    double valeur = strtod(m_debut, &fin);
+    verifierFinDuNombre(fin, m_debut, *this);
+    return valeur;
+}
+
+/*!
+ * \brief Ouvre le fichier et repère les colonnes de son en-tête
+ * \param[in] p_nomFichier: le nom du fichier CSV
+ * \throws logic_error si le fichier ne peut être ouvert ou lu
+ */
+LecteurCSV::LecteurCSV(const std::string &p_nomFichier)
+        : m_nomFichier(p_nomFichier), m_fichier(p_nomFichier, ios::binary), m_tampon(tailleBloc + 1, '\0'),
+          m_position(0), m_taille(0), m_ligneCourante(1), m_numeroDeLigne(0) {
+    if (!m_fichier)
+        throw logic_error("LecteurCSV: impossible d'ouvrir le fichier " + p_nomFichier);
+
+    if (assurerOctet(2) && memcmp(m_tampon.data(), "\xEF\xBB\xBF", 3) == 0) {
+        m_position = 3; // marque d'ordre des octets UTF-8
+    }
+
+    if (lireRangee(true)) {
+        for (size_t colonne = 0; colonne < m_rangee.size(); ++colonne) {
+            const char *debut = m_rangee[colonne].getDebut();
+            const char *fin = debut + m_rangee[colonne].getTaille();
+            while (debut < fin && estEspace(*debut)) ++debut;
+            while (fin > debut && estEspace(*(fin - 1))) --fin;
+            m_colonnes.insert(make_pair(string(debut, fin), colonne));
+        }
+    }
+}
+
+//! \brief indique si un fichier existe et peut être ouvert en lecture
+bool LecteurCSV::fichierExiste(const std::string &p_nomFichier) {
+    return ifstream(p_nomFichier).good();
+}
+
+/*!
+ * \brief Donne le numéro d'une colonne obligatoire
+ * \param[in] p_nom: le nom de la colonne dans l'en-tête
+ * \throws logic_error si la colonne est absente de l'en-tête
+ */
+size_t LecteurCSV::getColonne(const std::string &p_nom) const {
+    size_t colonne = getColonneOptionnelle(p_nom);
+    if (colonne == colonneAbsente)
+        throw logic_error("LecteurCSV: colonne " + p_nom + " absente du fichier " + m_nomFichier);
+    return colonne;
+}
+
+/*!
+ * \brief Donne le numéro d'une colonne facultative
+ * \param[in] p_nom: le nom de la colonne dans l'en-tête
+ * \return colonneAbsente si la colonne est absente de l'en-tête; le champ rangee[colonneAbsente] est toujours vide
+ */
+size_t LecteurCSV::getColonneOptionnelle(const std::string &p_nom) const {
+    auto itColonne = m_colonnes.find(p_nom);
+    return itColonne == m_colonnes.end() ? colonneAbsente : itColonne->second;
+}
+
+//! \brief donne le numéro (à partir de 1) de la ligne du fichier où commence la rangée courante
+size_t LecteurCSV::getNumeroDeLigne() const {
+    return m_numeroDeLigne;
+}
+
+/*!
+ * \brief Garantit que l'octet à p_decalage de la position de lecture est dans le tampon, en lisant un bloc de plus
+ * \brief Les octets déjà consommés sont d'abord retirés du tampon, qui n'est agrandi que s'il est rempli par la seule
+ * rangée courante. Les positions dans le tampon, et les champs de la rangée précédente, sont alors invalidés.
+ * \param[in] p_decalage: la distance de l'octet voulu à m_position
+ * \return false si le fichier se termine avant cet octet
+ * \throws logic_error si la lecture du fichier échoue
+ */
+bool LecteurCSV::assurerOctet(size_t p_decalage) {
+    while (m_position + p_decalage >= m_taille) {
+        if (m_position > 0) {
+            memmove(m_tampon.data(), m_tampon.data() + m_position, m_taille - m_position);
+            m_taille -= m_position;
+            m_position = 0;
+        }
+        if (m_taille + 1 == m_tampon.size()) m_tampon.resize(2 * m_tampon.size() - 1);
+        m_fichier.read(m_tampon.data() + m_taille, static_cast<streamsize>(m_tampon.size() - 1 - m_taille));
+        if (m_fichier.bad())
+            throw logic_error("LecteurCSV: impossible de lire le fichier " + m_nomFichier);
+        const size_t nbLus = static_cast<size_t>(m_fichier.gcount());
+        m_taille += nbLus;
+        m_tampon[m_taille] = '\0';
+        if (nbLus == 0) return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Lit la prochaine rangée non vide et la découpe en champs
+ * \brief La rangée est d'abord délimitée (sa fin est la première fin de ligne hors guillemets), ce qui amène tous ses
+ * octets dans le tampon. Les champs sont ensuite terminés en place par un caractère nul (en écrasant le séparateur) et
+ * les guillemets doublés des champs entre guillemets sont ramenés à un seul guillemet, aussi en place.
+ * \param[in] p_enTete: si vrai, m_rangee prend le nombre de champs de la rangée (lecture de l'en-tête); sinon, sa
+ * taille est fixe et les champs en trop sont ignorés
+ * \return false s'il ne reste aucune rangée
+ * \throws logic_error si un champ entre guillemets n'est pas terminé
+ */
+bool LecteurCSV::lireRangee(bool p_enTete) {
+    while (assurerOctet(0) && (m_tampon[m_position] == '\n' || m_tampon[m_position] == '\r')) {
+        if (m_tampon[m_position] == '\n' || !assurerOctet(1) || m_tampon[m_position + 1] != '\n') ++m_ligneCourante;
+        ++m_position;
+    }
+    if (!assurerOctet(0)) return false;
+
+    size_t longueur = 0;
+    bool entreGuillemets = false, debutDeChamp = true;
+    while (assurerOctet(longueur)) {
+        const char c = m_tampon[m_position + longueur];
+        if (entreGuillemets) {
+            if (c == '"') {
+                if (assurerOctet(longueur + 1) && m_tampon[m_position + longueur + 1] == '"') ++longueur;
+                else entreGuillemets = false;
+            }
+        } else if (c == '"' && debutDeChamp) {
+            entreGuillemets = true;
+        } else if (c == '\n' || c == '\r') {
+            if (c == '\r') assurerOctet(longueur + 1); // pour reconnaître une fin de ligne \r\n
+            break;
+        }
+        debutDeChamp = !entreGuillemets && c == ',';
+        ++longueur;
+    }
+
+    const size_t fin = m_position + longueur; // position de la fin de ligne, ou de la fin du fichier
+    char *const tampon = m_tampon.data();
+    m_numeroDeLigne = m_ligneCourante;
+    for (Champ &champ : m_rangee.m_champs) champ = Champ();
+
+    size_t numeroChamp = 0;
+    while (true) {
+        size_t i = m_position;
+        char *const debut = tampon + i;
+        char *ecriture;
+        if (tampon[i] == '"') {
+            ecriture = debut;
+            ++i;
+            while (true) {
+                if (i >= fin)
+                    throw logic_error(m_nomFichier + ", ligne " + to_string(m_numeroDeLigne) +
+                                      ": guillemet non terminé");
+                if (tampon[i] == '"') {
+                    if (tampon[i + 1] != '"') {
+                        ++i;
+                        break;
+                    }
+                    ++i;
+                } else if (tampon[i] == '\n') {
+                    ++m_ligneCourante;
+                }
+                *ecriture++ = tampon[i++];
+            }
+            // tolère des caractères entre le guillemet fermant et le séparateur
+            while (i < fin && tampon[i] != ',') {
+                *ecriture++ = tampon[i++];
+            }
+        } else {
+            while (i < fin && tampon[i] != ',') ++i;
+            ecriture = tampon + i;
+        }
+
+        const char separateur = tampon[i];
+        *ecriture = '\0';
+        if (p_enTete && numeroChamp >= m_rangee.m_champs.size()) m_rangee.m_champs.resize(numeroChamp + 1);
+        if (numeroChamp < m_rangee.m_champs.size())
+            m_rangee.m_champs[numeroChamp] = Champ(debut, static_cast<size_t>(ecriture - debut));
+        ++numeroChamp;
+
+        if (separateur == ',') {
+            m_position = i + 1;
+            continue;
+        }
+        if (i < m_taille) {
+            if (separateur == '\r' && tampon[i + 1] == '\n') ++i;
+            ++i;
+        }
+        m_position = i;
+        ++m_ligneCourante;
+        return true;
+    }
+}
@@ -0,0 +1,118 @@
+//
+// Lecteur de fichiers CSV (RFC 4180) utilisé pour charger les fichiers GTFS.
+//
+
+#ifndef RTC_LECTEURCSV_H
+#define RTC_LECTEURCSV_H
+
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * \class LecteurCSV
+ * \brief Lit un fichier CSV par blocs et le parcourt rangée par rangée
+ * \brief Les colonnes sont repérées par leur nom dans l'en-tête (première rangée du fichier), ce qui rend le
+ * chargement indépendant de l'ordre des colonnes. Les champs entre guillemets peuvent contenir des virgules, des fins
+ * de ligne et des guillemets doublés ("").
+ * \brief Les champs d'une rangée sont des vues sur le tampon du lecteur: aucune allocation n'est faite par rangée.
+ * Une vue n'est valide que pendant l'appel du visiteur qui la reçoit. Le tampon ne garde que les octets de la rangée
+ * courante et la suite du dernier bloc lu; il ne grandit que pour une rangée plus longue qu'un bloc.
+ */
+class LecteurCSV {
+
+public:
+
+    /*!
+     * \class Champ
+     * \brief Vue (non possédante) sur un champ d'une rangée, terminée par un caractère nul
+     */
+    class Champ {
+    public:
+        Champ();
+        Champ(const char *p_debut, size_t p_taille);
+        const char *getDebut() const;
+        size_t getTaille() const;
+        bool estVide() const;
+        bool operator==(const char *p_texte) const;
+        std::string versString() const;
+        void copierDans(std::string &p_destination) const;
+        unsigned int versEntier() const;
+        int versEntierSigne() const;
+        double versReel() const;
+
+    private:
+        const char *m_debut;
+        size_t m_taille;
+    };
+
+    static const size_t colonneAbsente;
+
+    /*!
+     * \class Rangee
+     * \brief Champs d'une rangée, indexés par les numéros de colonne donnés par getColonne() et
+     * getColonneOptionnelle(); le champ de colonneAbsente est toujours vide
+     */
+    class Rangee {
+    public:
+        const Champ &operator[](size_t p_colonne) const {
+            return p_colonne < m_champs.size() ? m_champs[p_colonne] : champAbsent;
+        }
+        size_t size() const {
+            return m_champs.size();
+        }
+
+    private:
+        friend class LecteurCSV;
+        static const Champ champAbsent;
+        std::vector<Champ> m_champs;
+    };
+
+    explicit LecteurCSV(const std::string &p_nomFichier);
+    static bool fichierExiste(const std::string &p_nomFichier);
+
+    size_t getColonne(const std::string &p_nom) const;
+    size_t getColonneOptionnelle(const std::string &p_nom) const;
+    size_t getNumeroDeLigne() const;
+
+    template<typename Visiteur>
+    void pourChaqueRangee(Visiteur p_visiteur);
+
+private:
+
+    bool lireRangee(bool p_enTete = false);
+    bool assurerOctet(size_t p_decalage);
+
+    std::string m_nomFichier;
+    std::ifstream m_fichier;
+    std::vector<char> m_tampon;  // les octets lus et pas encore consommés, suivis d'un caractère nul
+    size_t m_position;           // position de lecture dans m_tampon
+    size_t m_taille;             // nombre d'octets lus dans m_tampon (m_tampon[m_taille] est le caractère nul)
+    size_t m_ligneCourante;      // numéro de la ligne du fichier à la position m_position
+    size_t m_numeroDeLigne;      // numéro de la ligne du fichier où commence la rangée courante
+    std::unordered_map<std::string, size_t> m_colonnes; // nom de colonne -> numéro de colonne
+    Rangee m_rangee;             // champs de la rangée courante (réutilisé d'une rangée à l'autre)
+};
+
+/*!
+ * \brief Appelle p_visiteur(const Rangee &) pour chaque rangée du fichier suivant l'en-tête
+ * \brief Les rangées vides sont ignorées. Les champs manquants d'une rangée trop courte sont vides.
+ * \param[in] p_visiteur: la fonction appelée pour chaque rangée
+ * \throws logic_error si p_visiteur lance une exception; le message indique le fichier et la ligne fautive
+ */
+template<typename Visiteur>
+void LecteurCSV::pourChaqueRangee(Visiteur p_visiteur) {
+    while (lireRangee()) {
+        try {
+            p_visiteur(const_cast<const Rangee &>(m_rangee));
+        } catch (std::exception &ex) {
+            throw std::logic_error(m_nomFichier + ", ligne " + std::to_string(m_numeroDeLigne) + ": " + ex.what());
+        }
+    }
+}
+
+#endif //RTC_LECTEURCSV_H
@@ -4,6 +4,7 @@
 // Update by Mathieu Boisver on 2021-12-07
 
 #include "ligne.h"
+#include <utility>
 
 /*!
  * \brief Constructeur de la classe ligne
@@ -13,10 +14,10 @@
  * \param[in] p_categorie: CategorieBus (venant de couleur) permettant d’identifier visuellement la ligne
  * Nous n'utilisons que route_id (m_id), route_short_name (m_numero), route_desc(m_description), route_color(m_categorie) du fichier routes.txt
  *  L'attribut m_voyages n'est pas initialisé
+ *  Les chaînes sont reçues par valeur: un temporaire (p. ex. un champ lu du fichier) y est déplacé sans copie
  */
-Ligne::Ligne(unsigned int p_id, const std::string &p_numero, const std::string &p_description,
-             const CategorieBus &p_categorie) :
-        m_id(p_id), m_numero(p_numero), m_description(p_description), m_categorie(p_categorie)
+Ligne::Ligne(unsigned int p_id, std::string p_numero, std::string p_description, const CategorieBus &p_categorie) :
+        m_id(p_id), m_numero(std::move(p_numero)), m_description(std::move(p_description)), m_categorie(p_categorie)
 {
 }
 
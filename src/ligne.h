@@ -35,7 +35,7 @@ enum class CategorieBus {METRO_BUS, LEBUS, EXPRESS, COUCHE_TARD};
 class Ligne {
 
 public:
-    Ligne(unsigned int p_id, const std::string & p_numero, const std::string & p_description, const CategorieBus& p_categorie);
+    Ligne(unsigned int p_id, std::string p_numero, std::string p_description, const CategorieBus& p_categorie);
 	Ligne();
     static CategorieBus couleurToCategorie(const std::string & couleur);
     static std::string categorieToString(const CategorieBus & c);
@@ -25,6 +25,7 @@ int main()
     cout << "Nombre de lignes = " << donnees_rtc.getNbLignes() << endl;
     donnees_rtc.ajouterStations(chemin_dossier + "/stops.txt");
     cout << "Nombre de stations initiales = " << donnees_rtc.getNbStations() << endl;
+    donnees_rtc.ajouterCalendrier(chemin_dossier + "/calendar.txt");
     donnees_rtc.ajouterServices(chemin_dossier + "/calendar_dates.txt");
     size_t nb_services = donnees_rtc.getNbServices();
     cout << "Nombre de services = " << nb_services << endl;
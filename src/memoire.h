@@ -0,0 +1,127 @@
+//
+// Comptabilité de l'empreinte mémoire des données GTFS et du graphe.
+//
+
+#ifndef RTC_MEMOIRE_H
+#define RTC_MEMOIRE_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+#include "arena.h"
+
+/*!
+ * \class BilanMemoire
+ * \brief Répartition estimée de la mémoire occupée par composante (voyages, stations, arrêts, graphe, ...)
+ * \brief Pour chaque composante, on distingue:
+ *  - les octets utiles: les objets eux-mêmes (clés, valeurs, caractères des chaînes);
+ *  - les octets de structure: ce que le conteneur ajoute (liens des noeuds, alvéoles des tables de hachage, blocs de
+ *    contrôle des shared_ptr, capacité non utilisée des vecteurs);
+ *  - les octets de l'allocateur: en-têtes et arrondis des blocs alloués. Les blocs pris dans une ArenaMemoire n'ont
+ *    pas d'en-tête; la partie inutilisée des grands blocs d'une arène est comptée à part (voir ajouterArena()).
+ * \brief Les tailles de noeuds et d'allocation suivent libstdc++ et l'allocateur de la glibc sur une plateforme 64 bits:
+ * il s'agit d'estimations, et non de mesures. Les objets intégrés par valeur dans leur parent (ex: un std::string
+ * dont le texte tient dans le tampon interne) ne sont comptés qu'une fois, dans le noeud du parent.
+ */
+class BilanMemoire {
+
+public:
+
+    //! \brief empreinte d'une composante
+    struct Composante {
+        std::string nom;
+        size_t nbElements;
+        size_t octetsUtiles;
+        size_t octetsStructure;
+        size_t octetsAllocateur;
+
+        size_t getTotal() const { return octetsUtiles + octetsStructure + octetsAllocateur; }
+
+        //! \brief ajoute p_nbBlocs allocations de p_octetsUtiles + p_octetsStructure octets chacune, prises dans une
+        //! ArenaMemoire si p_arena est vrai
+        void ajouterBlocs(size_t p_nbBlocs, size_t p_octetsUtiles, size_t p_octetsStructure, bool p_arena = false) {
+            if (p_nbBlocs == 0) return;
+            const size_t demande = p_octetsUtiles + p_octetsStructure;
+            octetsUtiles += p_nbBlocs * p_octetsUtiles;
+            octetsStructure += p_nbBlocs * p_octetsStructure;
+            octetsAllocateur += p_nbBlocs * ((p_arena ? tailleBlocArena(demande) : tailleBlocAlloue(demande)) - demande);
+        }
+
+        //! \brief ajoute les noeuds d'un arbre (std::map, std::set, std::multimap): couleur et trois liens par noeud
+        void ajouterNoeudsArbre(size_t p_nbNoeuds, size_t p_tailleValeur, bool p_arena = false) {
+            ajouterBlocs(p_nbNoeuds, p_tailleValeur, surcoutNoeudArbre, p_arena);
+        }
+
+        //! \brief ajoute les noeuds d'une std::list: deux liens par noeud
+        void ajouterNoeudsListe(size_t p_nbNoeuds, size_t p_tailleValeur, bool p_arena = false) {
+            ajouterBlocs(p_nbNoeuds, p_tailleValeur, 2 * sizeof(void *), p_arena);
+        }
+
+        //! \brief ajoute une table de hachage: un lien par noeud (plus le hachage conservé pour les clés std::string)
+        //! et le tableau des alvéoles
+        void ajouterTableHachage(size_t p_nbNoeuds, size_t p_tailleValeur, size_t p_nbAlveoles,
+                                 bool p_hachageConserve) {
+            ajouterBlocs(p_nbNoeuds, p_tailleValeur, sizeof(void *) + (p_hachageConserve ? sizeof(size_t) : 0));
+            if (p_nbAlveoles > 1) ajouterBlocs(1, 0, p_nbAlveoles * sizeof(void *)); // une seule alvéole est intégrée
+        }
+
+        //! \brief ajoute le tampon d'un std::vector de p_taille éléments et de capacité p_capacite
+        void ajouterTableau(size_t p_taille, size_t p_capacite, size_t p_tailleElement) {
+            if (p_capacite == 0) return;
+            ajouterBlocs(1, p_taille * p_tailleElement, (p_capacite - p_taille) * p_tailleElement);
+        }
+
+        //! \brief ajoute le texte d'un std::string s'il ne tient pas dans le tampon interne de l'objet
+        void ajouterChaine(size_t p_capacite) {
+            if (p_capacite > capaciteChaineInterne) ajouterBlocs(1, p_capacite + 1, 0);
+        }
+    };
+
+    //! \brief taille réellement réservée par malloc() pour une demande de p_octets: en-tête de 8 octets, arrondi au
+    //! multiple de 16 et bloc minimal de 32 octets
+    static size_t tailleBlocAlloue(size_t p_octets) {
+        const size_t taille = (p_octets + sizeof(size_t) + 15) & ~static_cast<size_t>(15);
+        return taille < 32 ? 32 : taille;
+    }
+
+    //! \brief taille réellement réservée par ArenaMemoire::allouer() pour une demande de p_octets
+    static size_t tailleBlocArena(size_t p_octets) {
+        if (p_octets > ArenaMemoire::tailleMaxPetitBloc) return tailleBlocAlloue(p_octets);
+        return (p_octets + ArenaMemoire::granularite - 1) / ArenaMemoire::granularite * ArenaMemoire::granularite;
+    }
+
+    static const size_t surcoutNoeudArbre = 4 * sizeof(void *); // couleur (alignée) + parent + gauche + droite
+    static const size_t blocControlePartage = 2 * sizeof(void *); // vtable + compteurs d'un bloc de make_shared()
+    static const size_t blocControlePartageArena = 3 * sizeof(void *); // + l'allocateur conservé par allocate_shared()
+    static const size_t capaciteChaineInterne = 15;
+
+    //! \brief retourne la composante de ce nom, en la créant (vide) au besoin
+    Composante &composante(const std::string &p_nom) {
+        for (auto &composante : m_composantes)
+            if (composante.nom == p_nom) return composante;
+        Composante nouvelle = {p_nom, 0, 0, 0, 0};
+        m_composantes.push_back(nouvelle);
+        return m_composantes.back();
+    }
+
+    //! \brief ajoute à la composante p_nom la partie des grands blocs de p_arena qui n'est occupée par aucun petit bloc
+    //! (fin du grand bloc courant et blocs libérés en attente de réutilisation)
+    void ajouterArena(const std::string &p_nom, const ArenaMemoire &p_arena) {
+        composante(p_nom).octetsAllocateur += p_arena.getOctetsReserves() - p_arena.getOctetsAlloues();
+    }
+
+    const std::deque<Composante> &getComposantes() const { return m_composantes; }
+
+    size_t getTotal() const {
+        size_t total = 0;
+        for (const auto &composante : m_composantes) total += composante.getTotal();
+        return total;
+    }
+
+private:
+
+    std::deque<Composante> m_composantes; // dans l'ordre de leur première apparition (références stables)
+};
+
+#endif //RTC_MEMOIRE_H
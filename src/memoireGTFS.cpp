@@ -0,0 +1,97 @@
+//
+// Affiche la répartition estimée de la mémoire occupée par les données d'un flux GTFS et par le graphe construit à
+// partir de ces données, afin de mesurer l'effet d'un changement de disposition des données.
+//
+// Usage: memoireGTFS [dossier_gtfs] [date_AAAAMMJJ] [--json]
+//
+
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+
+#include "DonneesGTFS.h"
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+#include "instrumentation.h"
+#include "memoire.h"
+
+using namespace std;
+
+namespace {
+
+    void afficherTableau(ostream &p_flux, const BilanMemoire &p_bilan) {
+        const double total = (double) p_bilan.getTotal();
+        p_flux << left << setw(26) << "composante" << right << setw(12) << "elements" << setw(14) << "utiles"
+               << setw(14) << "structure" << setw(14) << "allocateur" << setw(14) << "total" << setw(8) << "%"
+               << "\n";
+        size_t utiles = 0, structure = 0, allocateur = 0;
+        for (const auto &composante : p_bilan.getComposantes()) {
+            p_flux << left << setw(26) << composante.nom << right << setw(12) << composante.nbElements << setw(14)
+                   << composante.octetsUtiles << setw(14) << composante.octetsStructure << setw(14)
+                   << composante.octetsAllocateur << setw(14) << composante.getTotal() << setw(8) << fixed
+                   << setprecision(1) << (total > 0 ? 100.0 * composante.getTotal() / total : 0.0) << "\n";
+            utiles += composante.octetsUtiles;
+            structure += composante.octetsStructure;
+            allocateur += composante.octetsAllocateur;
+        }
+        p_flux << left << setw(26) << "TOTAL" << right << setw(12) << "" << setw(14) << utiles << setw(14)
+               << structure << setw(14) << allocateur << setw(14) << p_bilan.getTotal() << setw(8) << "100.0"
+               << "\n";
+    }
+
+    void afficherJSON(ostream &p_flux, const BilanMemoire &p_bilan) {
+        p_flux << "{\n  \"composantes\": [\n";
+        const auto &composantes = p_bilan.getComposantes();
+        for (size_t i = 0; i < composantes.size(); ++i) {
+            const auto &composante = composantes[i];
+            p_flux << "    {\"nom\": \"" << composante.nom << "\", \"elements\": " << composante.nbElements
+                   << ", \"octets_utiles\": " << composante.octetsUtiles << ", \"octets_structure\": "
+                   << composante.octetsStructure << ", \"octets_allocateur\": " << composante.octetsAllocateur
+                   << ", \"octets_total\": " << composante.getTotal() << "}"
+                   << (i + 1 < composantes.size() ? ",\n" : "\n");
+        }
+        p_flux << "  ],\n  \"octets_total\": " << p_bilan.getTotal() << ",\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bool json = false;
+    vector<string> arguments;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--json") json = true;
+        else arguments.push_back(argv[i]);
+    }
+    const string chemin_dossier = arguments.size() > 0 ? arguments[0] : "data";
+    const Date date = arguments.size() > 1 ? dateDepuisArgument(arguments[1], "memoireGTFS") : Date(2020, 9, 25);
+
+    try {
+        const long rssAvant = Instrumentation::getRssMaxKo();
+        DonneesGTFS donnees(date, Heure(0, 0, 0), Heure(23, 59, 59));
+        donnees.chargerDossier(chemin_dossier);
+        ReseauGTFS reseau(donnees);
+        const long rssApres = Instrumentation::getRssMaxKo();
+
+        BilanMemoire bilan;
+        donnees.comptabiliserMemoire(bilan);
+        reseau.comptabiliserMemoire(bilan);
+
+        if (json) {
+            afficherJSON(cout, bilan);
+            cout << "  \"rss_max_ko\": " << rssApres << ",\n";
+            cout << "  \"delta_rss_max_ko\": " << rssApres - rssAvant << "\n}\n";
+        } else {
+            cout << "Flux " << chemin_dossier << ", date " << date << ": " << donnees.getNbArrets() << " arrêts, "
+                 << reseau.getNbArcs() << " arcs (octets estimés)\n";
+            afficherTableau(cout, bilan);
+            // le pic de mémoire résidente comprend les tampons temporaires du chargement et l'exécutable
+            cout << "Mémoire résidente maximale: " << rssApres << " Ko (" << rssApres - rssAvant
+                 << " Ko pendant le chargement et la construction)\n";
+        }
+    } catch (exception &ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    return 0;
+}
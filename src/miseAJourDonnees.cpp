@@ -0,0 +1,241 @@
+//
+// Mise à jour en temps réel des données GTFS déjà chargées
+//
+
+#include "DonneesGTFS.h"
+#include "lecteurCSV.h"
+#include <algorithm>
+
+using namespace std;
+
+//! \brief lit un fichier de retards de voyages
+//! \brief Le fichier possède une ligne d'en-tête avec les colonnes trip_id, stop_sequence et delay, puis une ligne par
+//! retard, où delay est un décalage en secondes (négatif pour une avance) par rapport aux heures courantes des arrêts
+//! \param[in] p_nomFichier: le nom du fichier contenant les retards
+//! \return les retards, dans l'ordre du fichier
+//! \throws logic_error si un problème survient avec la lecture du fichier
+vector<RetardVoyage> DonneesGTFS::lireRetards(const std::string &p_nomFichier) {
+    vector<RetardVoyage> retards;
+
+    try {
+        LecteurCSV lecteur(p_nomFichier);
+        const size_t colTripId = lecteur.getColonne("trip_id");
+        const size_t colSequence = lecteur.getColonne("stop_sequence");
+        const size_t colDelai = lecteur.getColonne("delay");
+
+        lecteur.pourChaqueRangee([&](const LecteurCSV::Rangee &rangee) {
+            RetardVoyage retard;
+            retard.voyage_id = rangee[colTripId].versString();
+            retard.numero_sequence = rangee[colSequence].versEntier();
+            retard.delai = rangee[colDelai].versEntierSigne();
+            retards.push_back(retard);
+        });
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+    return retards;
+}
+
+//! \brief décale les heures des arrêts d'un voyage à partir du numéro de séquence donné
+//! \brief Les arrêts déplacés sont repositionnés dans Station::m_arrets selon leur nouvelle heure d'arrivée.
+//! \brief Une avance est tronquée au besoin pour que le premier arrêt touché n'arrive pas avant le départ de l'arrêt qui
+//! le précède dans le voyage (l'ordre des arrêts du voyage est ainsi toujours respecté)
+//! \brief En fenêtre glissante, le décalage est aussi mémorisé pour les arrêts à venir du voyage, s'il en a encore
+//! (les décalages d'un même numéro de séquence sont cumulés)
+//! \param[in] p_retard: le retard à appliquer
+//! \return les arrêts dont les heures ont été modifiées (vide si le voyage n'est pas présent dans l'objet GTFS)
+//! \throws logic_error si une incohérence est détectée lors de la mise à jour
+vector<Arret::Ptr> DonneesGTFS::appliquerRetard(const RetardVoyage &p_retard) {
+    vector<Arret::Ptr> arretsModifies;
+
+    auto itVoyage = m_voyages.find(p_retard.voyage_id);
+    if (itVoyage == m_voyages.end() || p_retard.delai == 0) {
+        return arretsModifies;
+    }
+
+    Arret::Ptr precedent;
+    for (const auto &arret : itVoyage->second.getArrets()) {
+        if (arret->getNumeroSequence() < p_retard.numero_sequence) {
+            precedent = arret;
+        } else {
+            arretsModifies.push_back(arret);
+        }
+    }
+
+    int delai = p_retard.delai;
+    if (delai < 0 && !arretsModifies.empty()) {
+        const Arret::Ptr &premier = arretsModifies.front();
+        int avanceMax = precedent ? premier->getHeureArrivee() - precedent->getHeureDepart()
+                                  : premier->getHeureArrivee() - Heure(0, 0, 0);
+        delai = max(delai, -avanceMax);
+    }
+    if (m_fenetreGlissante && delai != 0) {
+        auto itRetards = m_retardsAVenir.find(p_retard.voyage_id);
+        if (itRetards != m_retardsAVenir.end()) {
+            vector<pair<unsigned int, int>> &retards = itRetards->second;
+            auto itRetard = find_if(retards.begin(), retards.end(), [&](const pair<unsigned int, int> &p_r) {
+                return p_r.first == p_retard.numero_sequence;
+            });
+            if (itRetard != retards.end()) {
+                itRetard->second += delai;
+            } else {
+                retards.emplace_back(p_retard.numero_sequence, delai);
+            }
+        }
+    }
+    if (delai == 0) {
+        arretsModifies.clear();
+        return arretsModifies;
+    }
+
+    try {
+        for (const auto &arret : arretsModifies) {
+            Station &station = m_stations.at(arret->getStationId());
+            station.retirerArret(arret);
+            arret->decaler(delai);
+            station.addArret(arret);
+        }
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+    return arretsModifies;
+}
+
+//! \brief active le mode fenêtre glissante: les arrêts de la journée postérieurs à la fenêtre [m_now1, m_now2) sont
+//! conservés en mémoire afin d'être admis au fur et à mesure que la fenêtre avance (voir avancerFenetre())
+//! \pre doit être appelée avant ajouterArretsDesVoyagesDeLaDate()
+//! \throws logic_error si les arrêts ont déjà été ajoutés
+void DonneesGTFS::activerFenetreGlissante() {
+    if (m_tousLesArretsPresents)
+        throw logic_error("DonneesGTFS::activerFenetreGlissante(): les arrêts ont déjà été ajoutés");
+    m_fenetreGlissante = true;
+}
+
+//! \brief active le mode multi-jours: l'horaire complet de toutes les dates du GTFS est conservé en mémoire afin de
+//! pouvoir changer de date (voir changerDate()) sans relire les fichiers
+//! \throws logic_error si des voyages ont déjà été ajoutés
+void DonneesGTFS::activerMultiJours() {
+    if (!m_horaire.empty() || m_tousLesArretsPresents)
+        throw logic_error("DonneesGTFS::activerMultiJours(): les voyages ont déjà été ajoutés");
+    m_multiJours = true;
+}
+
+//! \brief change la date d'intérêt et l'intervalle [now1, now2) à partir de l'horaire conservé en mémoire
+//! \brief Les voyages de la veille qui se poursuivent après minuit sont inclus sous l'identifiant trip_id + "@veille".
+//! Les retards reçus et les arrêts créés pour l'ancienne date sont abandonnés: un ReseauGTFS construit avec cet objet
+//! doit être reconstruit après l'appel.
+//! \param[in] p_date: la nouvelle date d'intérêt
+//! \param[in] p_now1: l'heure de début d'intérêt
+//! \param[in] p_now2: l'heure de fin d'intérêt
+//! \throws logic_error si le mode multi-jours n'est pas actif ou si les arrêts n'ont pas encore été ajoutés
+//! \throws logic_error si p_date est hors de la plage de dates du GTFS (en comptant le lendemain de la dernière date)
+//! \throws logic_error si p_now1 > p_now2
+void DonneesGTFS::changerDate(const Date &p_date, const Heure &p_now1, const Heure &p_now2) {
+    if (!m_multiJours)
+        throw logic_error("DonneesGTFS::changerDate(): le mode multi-jours n'est pas actif");
+    if (!m_tousLesArretsPresents)
+        throw logic_error("DonneesGTFS::changerDate(): les arrêts n'ont pas encore été ajoutés");
+    if (p_date < m_premiereDate || p_date - m_derniereDate > 1)
+        throw logic_error("DonneesGTFS::changerDate(): date hors de la plage de dates du GTFS");
+    if (p_now2 < p_now1)
+        throw logic_error("DonneesGTFS::changerDate(): now1 doit précéder now2");
+
+    m_date = p_date;
+    m_now1 = p_now1;
+    m_now2 = p_now2;
+    try {
+        materialiserFenetre();
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+}
+
+//! \brief retourne le nombre d'arrêts de la journée qui ne sont pas encore entrés dans la fenêtre
+size_t DonneesGTFS::getNbArretsAVenir() const {
+    return m_arretsAVenir.size() - m_prochainArretAVenir;
+}
+
+//! \brief retourne le nombre de retards mémorisés pour les arrêts à venir (voir appliquerRetard()); il retombe à 0 une
+//! fois tous les arrêts de la journée admis dans la fenêtre ou expirés
+size_t DonneesGTFS::getNbRetardsAVenir() const {
+    size_t nbRetards = 0;
+    for (const auto &retards : m_retardsAVenir) nbRetards += retards.second.size();
+    return nbRetards;
+}
+
+//! \brief avance la fenêtre de temps [m_now1, m_now2) sans recharger les données
+//! \brief Les arrêts dont l'heure de départ précède p_now1 sont retirés de leur voyage et de leur station. Les arrêts à
+//! venir dont l'heure d'arrivée précède p_now2 sont créés et ajoutés à leur voyage et à leur station. La mémoire
+//! occupée par les arrêts retirés et par les arrêts à venir déjà admis est libérée au fur et à mesure.
+//! \param[in] p_now1: la nouvelle heure de début de la fenêtre (>= m_now1)
+//! \param[in] p_now2: la nouvelle heure de fin de la fenêtre (>= m_now2)
+//! \param[out] p_arretsExpires: les arrêts retirés y sont ajoutés
+//! \param[out] p_arretsAdmis: les arrêts ajoutés y sont ajoutés, en ordre d'heure d'arrivée
+//! \note les retards (appliquerRetard()) ne touchent que les arrêts déjà admis dans la fenêtre
+//! \throws logic_error si le mode fenêtre glissante n'est pas actif ou si la fenêtre recule
+void DonneesGTFS::avancerFenetre(const Heure &p_now1, const Heure &p_now2, vector<Arret::Ptr> &p_arretsExpires,
+                                 vector<Arret::Ptr> &p_arretsAdmis) {
+    Instrumentation::MesurePhase mesure(m_instrumentation, "DonneesGTFS::avancerFenetre");
+    if (!m_fenetreGlissante || !m_tousLesArretsPresents)
+        throw logic_error("DonneesGTFS::avancerFenetre(): la fenêtre glissante n'est pas active");
+    if (p_now1 < m_now1 || p_now2 < m_now2 || p_now2 < p_now1)
+        throw logic_error("DonneesGTFS::avancerFenetre(): la fenêtre ne peut qu'avancer");
+
+    try {
+        const size_t debutExpires = p_arretsExpires.size();
+        for (auto &itStations : m_stations) {
+            itStations.second.retirerArretsPartisAvant(p_now1, p_arretsExpires);
+        }
+        for (size_t i = debutExpires; i < p_arretsExpires.size(); ++i) {
+            m_voyages.at(p_arretsExpires[i]->getVoyageId()).retirerArret(p_arretsExpires[i]);
+            m_nbArrets--;
+        }
+
+        const unsigned int now1 = p_now1 - Heure(0, 0, 0);
+        const unsigned int now2 = p_now2 - Heure(0, 0, 0);
+        while (m_prochainArretAVenir < m_arretsAVenir.size() &&
+               m_arretsAVenir[m_prochainArretAVenir].horaire.arrivee < now2) {
+            const ArretAVenir &aVenir = m_arretsAVenir[m_prochainArretAVenir++];
+            const ArretHoraire &horaire = aVenir.horaire;
+            auto itRetards = m_retardsAVenir.find(aVenir.voyage->first);
+            if (horaire.depart < now1) { // déjà reparti
+                if (aVenir.dernier && itRetards != m_retardsAVenir.end()) m_retardsAVenir.erase(itRetards);
+                continue;
+            }
+
+            const Heure heureArrivee = Heure(0, 0, 0).add_secondes(horaire.arrivee);
+            Arret::Ptr arret = allocate_shared<Arret>(AllocateurArena<Arret>(m_arena.get()), horaire.station_id,
+                                                      heureArrivee, Heure(0, 0, 0).add_secondes(horaire.depart),
+                                                      horaire.numero_sequence, aVenir.voyage->first);
+            if (itRetards != m_retardsAVenir.end() && !itRetards->second.empty()) {
+                int delai = 0;
+                for (const auto &retard : itRetards->second) {
+                    if (retard.first <= horaire.numero_sequence) delai += retard.second;
+                }
+                // l'arrêt ne peut arriver avant le départ de l'arrêt qui le précède dans le voyage
+                const auto &arretsDuVoyage = aVenir.voyage->second.getArrets();
+                Heure heureMin = arretsDuVoyage.empty() ? Heure(0, 0, 0) : (*arretsDuVoyage.rbegin())->getHeureDepart();
+                delai = max(delai, heureMin - heureArrivee);
+                if (delai != 0) arret->decaler(delai);
+            }
+            if (aVenir.dernier && itRetards != m_retardsAVenir.end()) m_retardsAVenir.erase(itRetards);
+            aVenir.voyage->second.ajouterArret(arret);
+            m_stations.at(horaire.station_id).addArret(arret);
+            m_nbArrets++;
+            p_arretsAdmis.push_back(arret);
+        }
+
+        // on libère les arrêts à venir déjà admis lorsqu'ils occupent plus de la moitié du vecteur
+        if (m_prochainArretAVenir > m_arretsAVenir.size() / 2) {
+            m_arretsAVenir.erase(m_arretsAVenir.begin(), m_arretsAVenir.begin() + m_prochainArretAVenir);
+            m_arretsAVenir.shrink_to_fit();
+            m_prochainArretAVenir = 0;
+        }
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+
+    m_now1 = p_now1;
+    m_now2 = p_now2;
+    mesure.terminer(p_arretsAdmis.size());
+}
@@ -0,0 +1,495 @@
+//
+// Mise à jour en temps réel du réseau GTFS sans reconstruction du graphe
+//
+
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+//! \brief applique des retards de voyages aux données GTFS et met à jour le graphe en conséquence
+//! \brief Seuls les poids des arcs touchant aux arrêts déplacés sont recalculés (arcs de voyage, d'attente, de
+//! transfert et, s'il est présent, arcs du point origine); la structure du graphe n'est pas modifiée. Un arc dont la
+//! correspondance devient impossible est désactivé et sera réactivé si un retard ultérieur la rend de nouveau possible.
+//! \param[in,out] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \param[in] p_retards: les retards à appliquer, dans l'ordre
+//! \throws logic_error si une incohérence est détectée lors de la mise à jour
+//! \post les transferts du réseau sont ceux de p_gtfs (voir actualiserTransferts())
+//! \brief Sur un réseau compacté (voir compacterVoyages()), un arrêt contracté déplacé ne change que le poids du
+//! raccourci qui le saute, et les points origine et destination, s'ils sont présents, sont retirés puis replacés: les
+//! extrémités reportées dépendent des heures des arrêts contractés. Si les transferts doivent être reconstruits, le
+//! réseau est développé, mis à jour, puis compacté de nouveau.
+void ReseauGTFS::appliquerRetards(DonneesGTFS &p_gtfs, const vector<RetardVoyage> &p_retards) {
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ReseauGTFS::appliquerRetards");
+    size_t nbSommetsMisAJour = 0;
+    m_version = nouvelleVersion();
+    try {
+        const bool compacte = estCompacte();
+        const bool origineDestination = compacte && m_origine_dest_ajoute;
+        const Coordonnees pointOrigine = m_pointOrigine, pointDestination = m_pointDestination;
+        const Heure heureDepart = m_heureDepart;
+        if (origineDestination) retirerOrigineDestination();
+        const bool developper = compacte && p_gtfs.getVersionTransferts() != m_versionTransferts;
+        if (developper) developperVoyages();
+
+        actualiserTransferts(p_gtfs);
+        for (const auto &retard : p_retards) {
+            const vector<Arret::Ptr> arretsModifies = p_gtfs.appliquerRetard(retard);
+            for (const auto &arret : arretsModifies) {
+                const size_t sommet = m_sommetDeArret.at(arret);
+                if (!estContracte(sommet)) {
+                    mettreAJourArcsDuSommet(p_gtfs, sommet);
+                    continue;
+                }
+                const ArretContracte &contracte = m_arretsContractes[sommet - m_premierContracte];
+                const unsigned int poids = poidsRaccourci(contracte.amont);
+                m_leGraphe.modifierPoids(contracte.amont, contracte.aval, poids);
+                if (poids == numeric_limits<unsigned int>::max()) noterArcDesactive(contracte.amont, contracte.aval);
+            }
+            nbSommetsMisAJour += arretsModifies.size();
+        }
+
+        if (developper) compacterVoyages();
+        if (origineDestination) construireOrigineDestination(p_gtfs, pointOrigine, pointDestination, heureDepart);
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+    mesure.terminer(nbSommetsMisAJour);
+}
+
+//! \brief reconstruit les arcs de transfert, de trajet à pieds et d'attente si les transferts de p_gtfs ont été
+//! recalculés depuis la construction du réseau (DonneesGTFS::filtrerTransferts(), calculerTrajetsAPied())
+//! \brief Les arcs entre arrêts de voyages différents sont retirés, puis m_transfertsVersStation et
+//! m_transfertsDepuisStation sont remplies de nouveau, avec leurs arcs, à partir des mêmes transferts filtrés que lors
+//! de la construction: les mises à jour suivantes (mettreAJourArcsDuSommet(), ajouterArcsArretAdmis()) consultent donc
+//! les transferts courants. Rien n'est fait si p_gtfs.getVersionTransferts() n'a pas changé.
+void ReseauGTFS::actualiserTransferts(const DonneesGTFS &p_gtfs) {
+    if (p_gtfs.getVersionTransferts() == m_versionTransferts) return;
+
+    for (size_t sommet = 0; sommet < m_arretDuSommet.size(); ++sommet) {
+        const Arret::Ptr &arret = m_arretDuSommet[sommet];
+        if (!arret || (m_origine_dest_ajoute && (sommet == m_sommetOrigine || sommet == m_sommetDestination)))
+            continue;
+        vector<size_t> aEnlever;
+        m_leGraphe.pourChaqueArcSortant(sommet, [&](size_t p_destination, unsigned int) {
+            if (p_destination == m_sommetDestination && m_origine_dest_ajoute) return;
+            const Arret::Ptr &arretTo = m_arretDuSommet[p_destination];
+            if (arretTo && arretTo->getVoyageId() != arret->getVoyageId()) aEnlever.push_back(p_destination);
+        });
+        for (size_t destination : aEnlever) m_leGraphe.enleverArc(sommet, destination);
+    }
+
+    ajouterArcsTransferts(p_gtfs);
+    ajouterArcsTrajetsAPied(p_gtfs);
+    ajouterArcsAttente(p_gtfs);
+}
+
+//! \brief calcule le poids d'un arc selon les heures courantes des arrêts de ses extrémités
+//! \brief Le poids est la différence des heures d'arrivée. Il vaut numeric_limits<unsigned int>::max() (arc désactivé)
+//! lorsque cette différence est inférieure au délai minimal de l'arc: 0 pour un arc de voyage, delaisMinArcsAttente
+//! pour un arc d'attente et min_transfer_time pour un arc de transfert
+//! \param[in] p_source: le sommet origine de l'arc (éventuellement m_sommetOrigine)
+//! \param[in] p_destination: le sommet destination de l'arc (autre que m_sommetDestination)
+unsigned int ReseauGTFS::poidsArc(size_t p_source, size_t p_destination) const {
+    const Arret::Ptr &arretTo = m_arretDuSommet[p_destination];
+    int delaiMinimal = 0;
+    int difference;
+
+    if (m_origine_dest_ajoute && p_source == m_sommetOrigine) {
+        difference = arretTo->getHeureArrivee() - m_heureDepart;
+        delaiMinimal = (int) m_tempsMarcheDepuisOrigine.at(arretTo->getStationId());
+    } else {
+        const Arret::Ptr &arretFrom = m_arretDuSommet[p_source];
+        difference = arretTo->getHeureArrivee() - arretFrom->getHeureArrivee();
+        if (arretFrom->getVoyageId() != arretTo->getVoyageId()) {
+            delaiMinimal = arretFrom->getStationId() == arretTo->getStationId() ? (int) delaisMinArcsAttente : 0;
+            auto itTransferts = m_transfertsVersStation.find(arretTo->getStationId());
+            if (itTransferts != m_transfertsVersStation.end()) {
+                for (const auto &transfert : itTransferts->second) {
+                    if (transfert.first == arretFrom->getStationId()) {
+                        delaiMinimal = (int) transfert.second;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    if (difference < delaiMinimal) return numeric_limits<unsigned int>::max();
+    return (unsigned int) difference;
+}
+
+//! \brief recalcule les poids de tous les arcs entrants et sortants d'un sommet dont l'arrêt a été déplacé
+//! \brief Les arcs entrants ne peuvent provenir que de l'arrêt précédent du même voyage, des arrêts de la même station,
+//! des arrêts des stations ayant un transfert vers cette station, ou du point origine; seuls ceux-ci sont examinés
+//! \param[in] p_gtfs: les données GTFS (déjà mises à jour)
+//! \param[in] p_sommet: le sommet de l'arrêt déplacé
+void ReseauGTFS::mettreAJourArcsDuSommet(const DonneesGTFS &p_gtfs, size_t p_sommet) {
+    for (size_t successeur : m_leGraphe.getSuccesseurs(p_sommet)) {
+        if (m_origine_dest_ajoute && successeur == m_sommetDestination) continue; // la marche finale ne change pas
+        const unsigned int poids = estRaccourci(p_sommet, successeur) ? poidsRaccourci(p_sommet)
+                                                                      : poidsArc(p_sommet, successeur);
+        m_leGraphe.modifierPoids(p_sommet, successeur, poids);
+        abaisserTempsMinimal(p_sommet, successeur, poids);
+        if (poids == numeric_limits<unsigned int>::max()) noterArcDesactive(p_sommet, successeur);
+    }
+
+    const Arret::Ptr &arret = m_arretDuSommet[p_sommet];
+    vector<size_t> sources;
+
+    Arret::Ptr precedent;
+    for (const auto &arretDuVoyage : p_gtfs.getVoyages().at(arret->getVoyageId()).getArrets()) {
+        if (arretDuVoyage == arret) break;
+        precedent = arretDuVoyage;
+    }
+    if (precedent) {
+        // sur un réseau compacté, l'arc de voyage entrant peut être le raccourci qui saute l'arrêt précédent
+        const size_t sommetPrecedent = m_sommetDeArret.at(precedent);
+        sources.push_back(estContracte(sommetPrecedent) ? m_arretsContractes[sommetPrecedent - m_premierContracte].amont
+                                                        : sommetPrecedent);
+    }
+
+    // un arrêt contracté n'a aucun arc d'attente ni de transfert
+    for (size_t source : getSommetsDesStationsSources(p_gtfs, arret))
+        if (!estContracte(source)) sources.push_back(source);
+    if (m_origine_dest_ajoute) sources.push_back(m_sommetOrigine);
+
+    for (size_t source : sources) {
+        if (m_leGraphe.arcExiste(source, p_sommet)) {
+            const unsigned int poids = estRaccourci(source, p_sommet) ? poidsRaccourci(source)
+                                                                      : poidsArc(source, p_sommet);
+            m_leGraphe.modifierPoids(source, p_sommet, poids);
+            abaisserTempsMinimal(source, p_sommet, poids);
+            if (poids == numeric_limits<unsigned int>::max()) noterArcDesactive(source, p_sommet);
+        }
+    }
+}
+
+//! \brief note la source d'un arc désactivé dans m_sourcesArcsDesactives, pour que retirerSommet() retire cet arc si sa
+//! destination expire (les arcs du point origine, retirés avec lui, sont ignorés)
+void ReseauGTFS::noterArcDesactive(size_t p_source, size_t p_destination) {
+    if (m_origine_dest_ajoute && p_source == m_sommetOrigine) return;
+    vector<size_t> &sources = m_sourcesArcsDesactives[p_destination];
+    if (find(sources.begin(), sources.end(), p_source) == sources.end()) sources.push_back(p_source);
+}
+
+//! \brief retourne les sommets des arrêts pouvant posséder un arc d'attente ou de transfert vers l'arrêt donné, soit
+//! les autres arrêts de sa station et ceux des stations ayant un transfert vers sa station
+//! \note les arrêts qui n'ont pas encore de sommet (admis dans la fenêtre mais pas encore placés) sont ignorés
+vector<size_t> ReseauGTFS::getSommetsDesStationsSources(const DonneesGTFS &p_gtfs, const Arret::Ptr &p_arret) const {
+    vector<unsigned int> stationsSources(1, p_arret->getStationId());
+    auto itTransferts = m_transfertsVersStation.find(p_arret->getStationId());
+    if (itTransferts != m_transfertsVersStation.end()) {
+        for (const auto &transfert : itTransferts->second) {
+            if (transfert.first != p_arret->getStationId()) stationsSources.push_back(transfert.first);
+        }
+    }
+
+    vector<size_t> sources;
+    for (unsigned int stationId : stationsSources) {
+        for (const auto &itArrets : p_gtfs.getStations().at(stationId).getArrets()) {
+            if (itArrets.second == p_arret) continue;
+            auto itSommet = m_sommetDeArret.find(itArrets.second);
+            if (itSommet != m_sommetDeArret.end()) sources.push_back(itSommet->second);
+        }
+    }
+    return sources;
+}
+
+//! \brief avance la fenêtre de temps du réseau sans le reconstruire
+//! \brief Le travail est proportionnel au changement de la fenêtre. Les sommets des arrêts expirés sont vidés de leurs
+//! arcs et réutilisés pour les arrêts admis. Seuls les arrêts admis et les arrêts encore à quai (arrivés avant
+//! p_now1, pas encore repartis) reçoivent de nouveaux arcs d'attente et de transfert sortants, calculés comme lors de
+//! la construction du réseau. Un autre arrêt n'acquiert d'arc que vers un arrêt admis qui devient, pour lui, le premier
+//! de sa ligne (ou de son numéro de ligne, pour un transfert) dans une station où il mène (voir
+//! ajouterArcsVersArretsAdmis()). Sans retard, le graphe obtenu a donc les mêmes arcs qu'un réseau reconstruit pour
+//! la nouvelle fenêtre.
+//! \param[in,out] p_gtfs: les données GTFS à partir desquelles le réseau a été construit, en mode fenêtre glissante
+//! \param[in] p_now1: la nouvelle heure de début de la fenêtre
+//! \param[in] p_now2: la nouvelle heure de fin de la fenêtre
+//! \throws logic_error si les points origine et destination sont présents dans le graphe
+//! \throws logic_error si une incohérence est détectée lors de la mise à jour
+void ReseauGTFS::avancerFenetre(DonneesGTFS &p_gtfs, const Heure &p_now1, const Heure &p_now2) {
+    if (m_origine_dest_ajoute)
+        throw logic_error("ReseauGTFS::avancerFenetre(): il faut enlever les points origine et destination avant");
+
+    Instrumentation::MesurePhase mesure(m_instrumentation, "ReseauGTFS::avancerFenetre");
+    size_t nbArretsAdmis = 0;
+    m_version = nouvelleVersion();
+    try {
+        // les arrêts expirés et admis peuvent changer les arrêts de passage: un réseau compacté est développé, avancé,
+        // puis compacté de nouveau
+        const bool compacte = estCompacte();
+        if (compacte) developperVoyages();
+        actualiserTransferts(p_gtfs);
+        vector<Arret::Ptr> arretsExpires;
+        vector<Arret::Ptr> arretsAdmis;
+        p_gtfs.avancerFenetre(p_now1, p_now2, arretsExpires, arretsAdmis);
+        nbArretsAdmis = arretsAdmis.size();
+
+        for (const auto &arret : arretsExpires) {
+            retirerSommet(arret);
+        }
+
+        // un arc actif vers un arrêt expiré part d'un arrêt arrivé avant lui, donc avant p_now1: s'il n'a pas expiré,
+        // cet arrêt est encore à quai. Ses arcs vers d'autres voyages sont retirés, puis recalculés avec ceux des
+        // arrêts admis.
+        vector<size_t> aRecalculer;
+        for (const auto &itStation : p_gtfs.getStations()) {
+            const Station::Arrets &arrets = itStation.second.getArrets();
+            for (auto itArret = arrets.begin(); itArret != arrets.end() && itArret->first < p_now1; ++itArret) {
+                auto itSommet = m_sommetDeArret.find(itArret->second);
+                if (itSommet == m_sommetDeArret.end()) continue; // admis à quai: il n'a pas encore de sommet
+                const size_t sommet = itSommet->second;
+                vector<size_t> aEnlever;
+                m_leGraphe.pourChaqueArcSortant(sommet, [&](size_t p_destination, unsigned int) {
+                    const Arret::Ptr &arretTo = m_arretDuSommet[p_destination];
+                    if (!arretTo || arretTo->getVoyageId() != itArret->second->getVoyageId())
+                        aEnlever.push_back(p_destination);
+                });
+                for (size_t destination : aEnlever) m_leGraphe.enleverArc(sommet, destination);
+                aRecalculer.push_back(sommet);
+            }
+        }
+
+        unordered_map<unsigned int, vector<size_t>> recalculesParStation; // arrêts à quai et arrêts admis
+        for (size_t sommet : aRecalculer)
+            recalculesParStation[m_arretDuSommet[sommet]->getStationId()].push_back(sommet);
+        for (const auto &arret : arretsAdmis) {
+            size_t sommet;
+            if (m_sommetsLibres.empty()) {
+                sommet = m_arretDuSommet.size();
+                m_arretDuSommet.push_back(arret);
+                m_stationDuSommet.push_back(indiceDeStation(arret->getStationId()));
+                m_leGraphe.resize(m_arretDuSommet.size());
+            } else {
+                sommet = m_sommetsLibres.back();
+                m_sommetsLibres.pop_back();
+                m_arretDuSommet[sommet] = arret;
+                m_stationDuSommet[sommet] = indiceDeStation(arret->getStationId());
+            }
+            associerLigne(sommet, p_gtfs.getVoyages().at(arret->getVoyageId()).getLigne());
+            m_sommetDeArret.insert({arret, sommet});
+            recalculesParStation[arret->getStationId()].push_back(sommet);
+        }
+
+        // clés des premiers arrêts: la ligne pour les arcs d'attente, le numéro de ligne pour les arcs de transfert
+        // (comme getArcsAttente() et getArcsDeTransferts())
+        vector<unsigned int> cleDeLigne(m_stationsDeLigne.size()), cleDeNumero(m_stationsDeLigne.size());
+        map<string, unsigned int> numeros;
+        for (const auto &itLigne : m_indiceDeLigne) {
+            cleDeLigne[itLigne.second] = itLigne.second;
+            const string numero = p_gtfs.getLignes().at(itLigne.first).getNumero();
+            cleDeNumero[itLigne.second] = numeros.insert({numero, (unsigned int) numeros.size()}).first->second;
+        }
+
+        vector<EtatSommet> etat(m_arretDuSommet.size(), arretInchange);
+        for (size_t sommet : aRecalculer) etat[sommet] = arretRecalcule;
+        for (const auto &arret : arretsAdmis) etat[m_sommetDeArret.at(arret)] = arretAdmis;
+
+        for (const auto &arret : arretsAdmis) {
+            ajouterArcsVoyageArretAdmis(p_gtfs, arret, etat);
+        }
+        for (const auto &station : recalculesParStation) {
+            ajouterArcsSortantsEntreVoyages(p_gtfs, station.first, station.second, cleDeLigne, cleDeNumero);
+            ajouterArcsVersArretsAdmis(p_gtfs, station.first, station.second, etat, cleDeLigne, cleDeNumero);
+        }
+        if (compacte) compacterVoyages();
+    } catch (exception &ex) {
+        throw logic_error(ex.what());
+    }
+    mesure.terminer(nbArretsAdmis);
+}
+
+//! \brief retire du graphe les arcs sortants du sommet d'un arrêt expiré, ainsi que les arcs désactivés qui y
+//! aboutissent, et libère ce sommet
+//! \brief Les arcs actifs qui y aboutissent partent d'arrêts eux aussi expirés ou encore à quai (voir
+//! avancerFenetre()).
+//! \pre l'arrêt a déjà été retiré de sa station et de son voyage dans p_gtfs
+void ReseauGTFS::retirerSommet(const Arret::Ptr &p_arret) {
+    const size_t sommet = m_sommetDeArret.at(p_arret);
+    m_leGraphe.enleverArcsSortants(sommet);
+
+    auto itDesactives = m_sourcesArcsDesactives.find(sommet);
+    if (itDesactives != m_sourcesArcsDesactives.end()) {
+        for (size_t source : itDesactives->second) {
+            while (m_leGraphe.arcExiste(source, sommet)) m_leGraphe.enleverArc(source, sommet);
+        }
+        m_sourcesArcsDesactives.erase(itDesactives);
+    }
+
+    m_sommetDeArret.erase(p_arret);
+    m_arretDuSommet[sommet].reset();
+    m_sommetsLibres.push_back(sommet);
+}
+
+//! \brief ajoute les arcs de voyage d'un arrêt admis: depuis l'arrêt précédent du voyage, et vers l'arrêt suivant s'il
+//! n'a pas été admis en même temps (il ajoutera alors lui-même cet arc)
+//! \param[in] p_etat: l'état de chaque sommet (arretInchange, arretRecalcule ou arretAdmis)
+void ReseauGTFS::ajouterArcsVoyageArretAdmis(const DonneesGTFS &p_gtfs, const Arret::Ptr &p_arret,
+                                             const vector<EtatSommet> &p_etat) {
+    const size_t sommet = m_sommetDeArret.at(p_arret);
+    auto ajouterArc = [&](size_t i, size_t j) {
+        unsigned int poids = poidsArc(i, j);
+        if (poids != numeric_limits<unsigned int>::max()) {
+            m_leGraphe.ajouterArc(i, j, poids);
+            abaisserTempsMinimal(i, j, poids);
+        }
+    };
+
+    const auto &arretsDuVoyage = p_gtfs.getVoyages().at(p_arret->getVoyageId()).getArrets();
+    auto itVoyage = arretsDuVoyage.find(p_arret);
+    if (itVoyage != arretsDuVoyage.begin()) {
+        ajouterArc(m_sommetDeArret.at(*prev(itVoyage)), sommet);
+    }
+    if (next(itVoyage) != arretsDuVoyage.end()) {
+        const size_t suivant = m_sommetDeArret.at(*next(itVoyage));
+        if (p_etat[suivant] != arretAdmis) ajouterArc(sommet, suivant);
+    }
+}
+
+//! \brief ajoute les arcs d'attente et de transfert sortant des sommets donnés d'une station, selon les règles de la
+//! construction du réseau: vers le premier arrêt de chaque autre ligne au moins delaisMinArcsAttente plus tard dans la
+//! station (station sans transfert), et vers le premier arrêt de chaque autre numéro de ligne au moins
+//! min_transfer_time plus tard dans chaque station où mène un de ses transferts
+//! \brief Comme dans getArcsDeTransferts(), les sommets sont pris par heure d'arrivée décroissante: leur seuil ne fait
+//! que reculer, et chaque station d'arrivée n'est parcourue qu'une fois, de sa fin jusqu'au plus petit seuil.
+//! \param[in] p_sommets: des sommets d'arrêts de la station, sans arc vers un autre voyage
+//! \param[in] p_cleDeLigne, p_cleDeNumero: la clé des premiers arrêts de chaque indice de ligne, pour les arcs
+//! d'attente et de transfert
+void ReseauGTFS::ajouterArcsSortantsEntreVoyages(const DonneesGTFS &p_gtfs, unsigned int p_stationId,
+                                                 const vector<size_t> &p_sommets,
+                                                 const vector<unsigned int> &p_cleDeLigne,
+                                                 const vector<unsigned int> &p_cleDeNumero) {
+    const map<unsigned int, Station> &stations = p_gtfs.getStations();
+    vector<size_t> sommets(p_sommets);
+    sort(sommets.begin(), sommets.end(), [&](size_t a, size_t b) {
+        return m_arretDuSommet[b]->getHeureArrivee() < m_arretDuSommet[a]->getHeureArrivee();
+    });
+    vector<pair<unsigned int, size_t>> premiers; // <clé, sommet du premier arrêt de cette clé à partir du seuil>
+
+    auto relierVers = [&](unsigned int p_stationTo, unsigned int p_delai, const vector<unsigned int> &p_cles) {
+        const Station::Arrets &arretsTo = stations.at(p_stationTo).getArrets();
+        auto itArretsTo = arretsTo.end();
+        premiers.clear();
+        for (size_t sommet : sommets) {
+            const Arret::Ptr &arret = m_arretDuSommet[sommet];
+            const auto seuil = arretsTo.lower_bound(arret->getHeureArrivee().add_secondes(p_delai));
+            while (itArretsTo != seuil) {
+                --itArretsTo;
+                const size_t sommetTo = m_sommetDeArret.at(itArretsTo->second);
+                const unsigned int cle = p_cles[m_ligneDuSommet[sommetTo]];
+                auto itPremier = find_if(premiers.begin(), premiers.end(),
+                                         [&](const pair<unsigned int, size_t> &p_premier) {
+                                             return p_premier.first == cle;
+                                         });
+                if (itPremier == premiers.end()) premiers.emplace_back(cle, sommetTo);
+                else itPremier->second = sommetTo;
+            }
+            const unsigned int cleDeLArret = p_cles[m_ligneDuSommet[sommet]];
+            for (const auto &premier : premiers) {
+                if (premier.first == cleDeLArret) continue;
+                const unsigned int poids = m_arretDuSommet[premier.second]->getHeureArrivee() -
+                                           arret->getHeureArrivee();
+                m_leGraphe.ajouterArc(sommet, premier.second, poids);
+                abaisserTempsMinimal(sommet, premier.second, poids);
+            }
+        }
+    };
+
+    if (p_gtfs.getStationsDeTransfert().count(p_stationId) == 0)
+        relierVers(p_stationId, delaisMinArcsAttente, p_cleDeLigne);
+    auto itTransferts = m_transfertsDepuisStation.find(p_stationId);
+    if (itTransferts != m_transfertsDepuisStation.end()) {
+        for (const auto &transfert : itTransferts->second) relierVers(transfert.first, transfert.second, p_cleDeNumero);
+    }
+}
+
+//! \brief ajoute les arcs d'attente et de transfert vers les arrêts admis d'une station depuis les arrêts ni admis ni
+//! recalculés
+//! \brief Un arrêt admis Y devient le premier de sa clé, à au moins d secondes d'un arrêt A, lorsque A arrive au plus
+//! d secondes avant Y et plus de d secondes après P, l'arrêt de même clé qui précède Y dans la station: les arrêts A
+//! concernés forment donc un intervalle d'heures d'arrivée de leur station. Chacun perd son arc vers l'arrêt qui était
+//! jusque là le premier, le prochain arrêt non admis de même clé après Y, et gagne un arc vers Y. Un parcours à rebours
+//! de la station, arrêté dès que P est connu pour chaque arrêt admis, donne P et ce prochain arrêt.
+//! \param[in] p_stationId: la station des arrêts admis
+//! \param[in] p_sommets: des sommets de la station, dont ceux de tous ses arrêts admis
+//! \param[in] p_etat: l'état de chaque sommet (arretInchange, arretRecalcule ou arretAdmis)
+//! \param[in] p_cleDeLigne, p_cleDeNumero: voir ajouterArcsSortantsEntreVoyages()
+void ReseauGTFS::ajouterArcsVersArretsAdmis(const DonneesGTFS &p_gtfs, unsigned int p_stationId,
+                                            const vector<size_t> &p_sommets, const vector<EtatSommet> &p_etat,
+                                            const vector<unsigned int> &p_cleDeLigne,
+                                            const vector<unsigned int> &p_cleDeNumero) {
+    const size_t nbAdmis = (size_t) count_if(p_sommets.begin(), p_sommets.end(),
+                                             [&](size_t p_sommet) { return p_etat[p_sommet] == arretAdmis; });
+    if (nbAdmis == 0) return;
+    const map<unsigned int, Station> &stations = p_gtfs.getStations();
+    const Station::Arrets &arrets = stations.at(p_stationId).getArrets();
+    const size_t aucunSommet = numeric_limits<size_t>::max();
+    struct Admis {
+        size_t sommet;
+        size_t precedent;  // P: sommet de l'arrêt précédent de même clé (aucunSommet s'il n'y en a pas)
+        size_t remplace;   // sommet du prochain arrêt non admis de même clé (aucunSommet s'il n'y en a pas)
+    };
+
+    auto reperer = [&](const vector<unsigned int> &p_cles, vector<Admis> &p_admis) {
+        unordered_map<unsigned int, size_t> enAttente;     // clé -> admis dont l'arrêt précédent reste à trouver
+        unordered_map<unsigned int, size_t> prochainNonAdmis;
+        size_t aTrouver = nbAdmis;
+        for (auto it = arrets.rbegin(); it != arrets.rend() && (aTrouver > 0 || !enAttente.empty()); ++it) {
+            const size_t sommet = m_sommetDeArret.at(it->second);
+            const unsigned int cle = p_cles[m_ligneDuSommet[sommet]];
+            auto itAttente = enAttente.find(cle);
+            if (itAttente != enAttente.end()) {
+                p_admis[itAttente->second].precedent = sommet;
+                enAttente.erase(itAttente);
+            }
+            if (p_etat[sommet] == arretAdmis) {
+                auto itProchain = prochainNonAdmis.find(cle);
+                p_admis.push_back({sommet, aucunSommet, itProchain == prochainNonAdmis.end() ? aucunSommet
+                                                                                             : itProchain->second});
+                enAttente[cle] = p_admis.size() - 1;
+                --aTrouver;
+            } else {
+                prochainNonAdmis[cle] = sommet;
+            }
+        }
+    };
+
+    // les arrêts de p_stationFrom arrivés dans ]P - p_delai, Y - p_delai] passent de leur premier arrêt à Y
+    auto relierDepuis = [&](unsigned int p_stationFrom, unsigned int p_delai, const vector<unsigned int> &p_cles,
+                            const Admis &p_admis) {
+        const Station::Arrets &arretsFrom = stations.at(p_stationFrom).getArrets();
+        auto borne = [&](size_t p_sommetTo) {
+            const int secondes = (m_arretDuSommet[p_sommetTo]->getHeureArrivee() - Heure(0, 0, 0)) - (int) p_delai;
+            return secondes < 0 ? arretsFrom.begin() : arretsFrom.upper_bound(Heure(0, 0, 0).add_secondes(secondes));
+        };
+        const Arret::Ptr &arretTo = m_arretDuSommet[p_admis.sommet];
+        const unsigned int cleTo = p_cles[m_ligneDuSommet[p_admis.sommet]];
+        const auto fin = borne(p_admis.sommet);
+        for (auto it = p_admis.precedent == aucunSommet ? arretsFrom.begin() : borne(p_admis.precedent); it != fin;
+             ++it) {
+            const size_t source = m_sommetDeArret.at(it->second);
+            if (p_etat[source] != arretInchange || p_cles[m_ligneDuSommet[source]] == cleTo) continue;
+            if (p_admis.remplace != aucunSommet && m_leGraphe.arcExiste(source, p_admis.remplace))
+                m_leGraphe.enleverArc(source, p_admis.remplace);
+            const unsigned int poids = arretTo->getHeureArrivee() - it->second->getHeureArrivee();
+            m_leGraphe.ajouterArc(source, p_admis.sommet, poids);
+            abaisserTempsMinimal(source, p_admis.sommet, poids);
+        }
+    };
+
+    vector<Admis> admis;
+    if (p_gtfs.getStationsDeTransfert().count(p_stationId) == 0) {
+        reperer(p_cleDeLigne, admis);
+        for (const Admis &unAdmis : admis) relierDepuis(p_stationId, delaisMinArcsAttente, p_cleDeLigne, unAdmis);
+    }
+    auto itTransferts = m_transfertsVersStation.find(p_stationId);
+    if (itTransferts != m_transfertsVersStation.end()) {
+        admis.clear();
+        reperer(p_cleDeNumero, admis);
+        for (const auto &transfert : itTransferts->second) {
+            for (const Admis &unAdmis : admis)
+                relierDepuis(transfert.first, transfert.second, p_cleDeNumero, unAdmis);
+        }
+    }
+}
@@ -0,0 +1,661 @@
+//
+// Motifs de transfert: précalcul sur le graphe du réseau, fichier compact et évaluation en ligne.
+//
+
+#include "motifsTransfert.h"
+#include "ReseauGTFS.h"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+    const char signatureFichier[8] = {'R', 'T', 'C', 'M', 'O', 'T', 'I', 'F'};
+    const uint64_t versionFichier = 2;
+    const uint32_t aucun = numeric_limits<uint32_t>::max();
+
+    uint32_t secondesDe(const Heure &p_heure) {
+        return (uint32_t) (p_heure - Heure(0, 0, 0));
+    }
+
+    Heure heureDe(uint32_t p_secondes) {
+        return Heure(0, 0, 0).add_secondes(p_secondes);
+    }
+
+    //! \brief écrit un entier non signé sur 7 bits par octet, le bit de poids fort indiquant qu'un octet suit
+    void ecrireEntier(ostream &p_flux, uint64_t p_valeur) {
+        while (p_valeur >= 0x80)
+        {
+            p_flux.put((char) ((p_valeur & 0x7F) | 0x80));
+            p_valeur >>= 7;
+        }
+        p_flux.put((char) p_valeur);
+    }
+
+    uint64_t lireEntier(istream &p_flux) {
+        uint64_t valeur = 0;
+        for (unsigned int decalage = 0; decalage < 64; decalage += 7)
+        {
+            const int octet = p_flux.get();
+            if (octet == char_traits<char>::eof()) throw logic_error("MotifsDeTransfert: fichier tronqué");
+            valeur |= (uint64_t) (octet & 0x7F) << decalage;
+            if (!(octet & 0x80)) return valeur;
+        }
+        throw logic_error("MotifsDeTransfert: entier invalide dans le fichier");
+    }
+
+    uint32_t lireEntier32(istream &p_flux) {
+        const uint64_t valeur = lireEntier(p_flux);
+        if (valeur > numeric_limits<uint32_t>::max()) throw logic_error("MotifsDeTransfert: entier invalide dans le fichier");
+        return (uint32_t) valeur;
+    }
+
+    //! \brief un trajet de l'arbre des préfixes en construction: le trajet précédent, le transfert et les stations
+    struct CleTrajet {
+        uint32_t precedent, transfert, montee, descente;
+        bool operator==(const CleTrajet &p_autre) const {
+            return precedent == p_autre.precedent && transfert == p_autre.transfert && montee == p_autre.montee &&
+                   descente == p_autre.descente;
+        }
+    };
+
+    struct HachageCleTrajet {
+        size_t operator()(const CleTrajet &p_cle) const {
+            uint64_t h = ((uint64_t) p_cle.precedent << 32 | p_cle.transfert) * 0x9E3779B97F4A7C15ULL;
+            h ^= ((uint64_t) p_cle.montee << 32 | p_cle.descente) + (h >> 29);
+            return (size_t) (h * 0xBF58476D1CE4E5B9ULL);
+        }
+    };
+
+}
+
+MotifsDeTransfert::MotifsDeTransfert() : m_nbPaires(0), m_nbMotifs(0), m_nbTrajets(0)
+{
+}
+
+//! \brief taille, en octets, des motifs en mémoire (la table des trajets directs, reconstruite au chargement, exclue)
+size_t MotifsDeTransfert::getTailleEnOctets() const
+{
+    size_t taille = sizeof(Origine) * m_origines.size();
+    for (const Origine &origine : m_origines)
+        taille += sizeof(uint32_t) * (origine.destinations.size() + origine.debutMotifs.size()) +
+                  sizeof(Motif) * origine.motifs.size() + sizeof(Trajet) * origine.trajets.size();
+    return taille;
+}
+
+//! \brief cherche le trajet direct de la station de rang p_montee à celle de rang p_descente qui arrive le plus tôt, en
+//! montant dans un voyage qui arrive à p_montee au plus tôt à l'heure p_heure (en secondes depuis 00:00:00)
+//! \returns faux s'il n'y en a aucun
+bool MotifsDeTransfert::trajetDirect(uint32_t p_montee, uint32_t p_descente, uint32_t p_heure,
+                                     TrajetDirect &p_trajet) const
+{
+    p_trajet.arrivee = aucun;
+    typedef TableParcours::Passage Passage;
+    const Passage *descente = m_horaires.debutPassages(p_descente);
+    const Passage *finDescente = m_horaires.finPassages(p_descente);
+    const Passage *finMontee = m_horaires.finPassages(p_montee);
+    for (const Passage *montee = m_horaires.debutPassages(p_montee); montee != finMontee; ++montee)
+    {
+        while (descente != finDescente && descente->parcours < montee->parcours) ++descente;
+        if (descente == finDescente) break;
+        // le premier passage par p_descente après la montée: les heures ne décroissent pas le long d'un voyage
+        const Passage *suivant = descente;
+        while (suivant != finDescente && suivant->parcours == montee->parcours && suivant->rang <= montee->rang)
+            ++suivant;
+        if (suivant == finDescente || suivant->parcours != montee->parcours) continue;
+
+        const uint32_t voyage = m_horaires.premierVoyage(montee->parcours, montee->rang, p_heure);
+        if (voyage == aucun) continue;
+        const uint32_t arrivee = m_horaires.getHeure(m_horaires.evenement(voyage, suivant->rang));
+        if (arrivee < p_trajet.arrivee) p_trajet = TrajetDirect{voyage, montee->rang, suivant->rang, arrivee};
+    }
+    return p_trajet.arrivee != aucun;
+}
+
+//! \brief heure d'arrivée (en secondes depuis 00:00:00) à la station de descente du trajet p_trajet de p_origine et
+//! de ses précédents, en partant à p_depart, ou aucun si l'un d'eux n'a plus de voyage
+//! \param[out] p_trajets: si non nul, reçoit les trajets directs empruntés, du premier au dernier
+uint32_t MotifsDeTransfert::evaluerTrajets(const Origine &p_origine, uint32_t p_trajet, uint32_t p_depart,
+                                           vector<TrajetDirect> *p_trajets) const
+{
+    if (p_trajet == aucun) return p_depart;
+    const Trajet &trajet = p_origine.trajets[p_trajet];
+    const uint32_t heure = evaluerTrajets(p_origine, trajet.precedent, p_depart, p_trajets);
+    TrajetDirect direct;
+    if (heure == aucun || !trajetDirect(trajet.montee, trajet.descente, heure + trajet.transfert, direct)) return aucun;
+    if (p_trajets) p_trajets->push_back(direct);
+    return direct.arrivee;
+}
+
+//! \brief heure d'arrivée (en secondes depuis 00:00:00) du motif p_motif de p_origine en partant à p_depart, ou
+//! aucun si l'un de ses trajets n'a plus de voyage
+//! \param[out] p_trajets: si non nul, reçoit les trajets directs empruntés
+uint32_t MotifsDeTransfert::evaluerMotif(const Origine &p_origine, const Motif &p_motif, uint32_t p_depart,
+                                         vector<TrajetDirect> *p_trajets) const
+{
+    const uint32_t heure = evaluerTrajets(p_origine, p_motif.trajet, p_depart, p_trajets);
+    return heure == aucun ? aucun : heure + p_motif.transfert;
+}
+
+//! \brief Calcule l'itinéraire le plus rapide entre deux stations en évaluant leurs motifs de transfert
+//! \brief Les étapes sont celles de ReseauGTFS::calculerItineraireEntreStations(): une étape MARCHE nulle à chaque
+//! bout, les trajets, et un transfert avant chaque trajet qui ne part pas de la station où l'on se trouve ou qui suit un
+//! autre trajet.
+//! \param[in] p_stationOrigine, p_stationDestination: les identifiants des stations
+//! \param[in] p_heureDepart: l'heure de départ de la station d'origine
+//! \param[out] p_itineraire: l'itinéraire trouvé (sans étapes si la destination n'est pas atteignable, ou si c'est
+//! l'origine)
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si aucun motif n'a été précalculé ou chargé, ou si l'une des stations est inconnue
+unsigned int MotifsDeTransfert::calculerItineraire(unsigned int p_stationOrigine, unsigned int p_stationDestination,
+                                                   const Heure &p_heureDepart, Itineraire &p_itineraire) const
+{
+    if (m_origines.empty()) throw logic_error("MotifsDeTransfert::calculerItineraire(): aucun motif");
+    try
+    {
+        const uint32_t origine = m_horaires.rangDeStation(p_stationOrigine);
+        const uint32_t destination = m_horaires.rangDeStation(p_stationDestination);
+        p_itineraire.heureDepart = p_heureDepart;
+        p_itineraire.duree = numeric_limits<unsigned int>::max();
+        p_itineraire.etapes.clear();
+        if (origine == destination) return p_itineraire.duree = 0;
+
+        const Origine &motifsOrigine = m_origines[origine];
+        const vector<uint32_t> &destinations = motifsOrigine.destinations;
+        const auto paire = lower_bound(destinations.begin(), destinations.end(), destination);
+        if (paire == destinations.end() || *paire != destination) return p_itineraire.duree;
+        const size_t indicePaire = paire - destinations.begin();
+
+        // le motif qui arrive le plus tôt; à égalité, celui qui a le moins de trajets
+        auto nbTrajets = [&](const Motif &p_motif) {
+            uint32_t nb = 0;
+            for (uint32_t t = p_motif.trajet; t != aucun; t = motifsOrigine.trajets[t].precedent) ++nb;
+            return nb;
+        };
+        const uint32_t depart = secondesDe(p_heureDepart);
+        uint32_t arrivee = aucun, nbTrajetsMeilleur = 0;
+        const Motif *meilleur = nullptr;
+        for (uint32_t m = motifsOrigine.debutMotifs[indicePaire]; m < motifsOrigine.debutMotifs[indicePaire + 1]; ++m)
+        {
+            const Motif &motif = motifsOrigine.motifs[m];
+            const uint32_t heure = evaluerMotif(motifsOrigine, motif, depart, nullptr);
+            if (heure > arrivee || heure == aucun) continue;
+            const uint32_t nb = nbTrajets(motif);
+            if (heure < arrivee || nb < nbTrajetsMeilleur)
+            {
+                arrivee = heure;
+                nbTrajetsMeilleur = nb;
+                meilleur = &motif;
+            }
+        }
+        if (!meilleur) return p_itineraire.duree;
+
+        vector<TrajetDirect> trajets;
+        evaluerMotif(motifsOrigine, *meilleur, depart, &trajets);
+        p_itineraire.duree = arrivee - depart;
+        vector<Etape> &etapes = p_itineraire.etapes;
+        etapes.emplace_back(Etape::MARCHE, Etape::pointOrigineDestination, p_stationOrigine, p_heureDepart,
+                            p_heureDepart);
+        uint32_t position = origine, heurePosition = depart;
+        for (size_t i = 0; i < trajets.size(); ++i)
+        {
+            const TrajetDirect &trajet = trajets[i];
+            const uint32_t parcours = m_horaires.getParcoursDuVoyage(trajet.voyage);
+            const uint32_t montee = m_horaires.getStation(parcours, trajet.rangMontee);
+            const uint32_t descente = m_horaires.getStation(parcours, trajet.rangDescente);
+            const uint32_t evenementMontee = m_horaires.evenement(trajet.voyage, trajet.rangMontee);
+            const uint32_t heureMontee = m_horaires.getHeure(evenementMontee);
+            if (i > 0 || montee != position)
+                etapes.emplace_back(Etape::TRANSFERT, m_horaires.getIdStation(position), m_horaires.getIdStation(montee),
+                                    heureDe(heurePosition), heureDe(heureMontee));
+            etapes.emplace_back(Etape::TRAJET, m_horaires.getIdStation(montee), m_horaires.getIdStation(descente),
+                                heureDe(heureMontee), heureDe(trajet.arrivee));
+            Etape &etape = etapes.back();
+            etape.ligne = m_horaires.getLigne(trajet.voyage);
+            etape.embarquement = m_horaires.getArret(trajet.voyage, trajet.rangMontee);
+            etape.debarquement = m_horaires.getArret(trajet.voyage, trajet.rangDescente);
+            position = descente;
+            heurePosition = trajet.arrivee;
+        }
+        if (position != destination)
+            etapes.emplace_back(Etape::TRANSFERT, m_horaires.getIdStation(position), p_stationDestination,
+                                heureDe(heurePosition), heureDe(arrivee));
+        etapes.emplace_back(Etape::MARCHE, p_stationDestination, Etape::pointOrigineDestination, heureDe(arrivee),
+                            heureDe(arrivee));
+        return p_itineraire.duree;
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
+
+//! \brief enregistre les motifs dans le fichier p_fichier
+//! \brief Format: la signature RTCMOTIF puis, en entiers de longueur variable, la version, le nombre de stations et
+//! leurs identifiants (codés par écart), puis pour chaque station d'origine le nombre de ses trajets et, pour chacun,
+//! l'écart à son trajet précédent (0 pour aucun), le temps du transfert et les stations de montée et de descente, puis
+//! le nombre de ses destinations, leurs rangs (codés par écart) et, pour chacune, le nombre de ses motifs et, pour
+//! chacun, son dernier trajet (1 + son indice, 0 pour aucun) et le temps du transfert final.
+//! \throws logic_error si le fichier ne peut être écrit
+void MotifsDeTransfert::enregistrer(const string &p_fichier) const
+{
+    ofstream fichier(p_fichier, ios::binary);
+    if (!fichier) throw logic_error("MotifsDeTransfert::enregistrer(): impossible d'ouvrir " + p_fichier);
+    fichier.write(signatureFichier, sizeof(signatureFichier));
+    ecrireEntier(fichier, versionFichier);
+    ecrireEntier(fichier, m_horaires.getNbStations());
+    unsigned int precedent = 0;
+    for (uint32_t s = 0; s < m_horaires.getNbStations(); ++s)
+    {
+        ecrireEntier(fichier, m_horaires.getIdStation(s) - precedent);
+        precedent = m_horaires.getIdStation(s);
+    }
+    for (const Origine &origine : m_origines)
+    {
+        ecrireEntier(fichier, origine.trajets.size());
+        for (uint32_t t = 0; t < origine.trajets.size(); ++t)
+        {
+            const Trajet &trajet = origine.trajets[t];
+            ecrireEntier(fichier, trajet.precedent == aucun ? 0 : t - trajet.precedent);
+            ecrireEntier(fichier, trajet.transfert);
+            ecrireEntier(fichier, trajet.montee);
+            ecrireEntier(fichier, trajet.descente);
+        }
+        ecrireEntier(fichier, origine.destinations.size());
+        uint32_t destinationPrecedente = 0;
+        for (uint32_t destination : origine.destinations)
+        {
+            ecrireEntier(fichier, destination - destinationPrecedente);
+            destinationPrecedente = destination;
+        }
+        for (size_t paire = 0; paire < origine.destinations.size(); ++paire)
+        {
+            ecrireEntier(fichier, origine.debutMotifs[paire + 1] - origine.debutMotifs[paire]);
+            for (uint32_t m = origine.debutMotifs[paire]; m < origine.debutMotifs[paire + 1]; ++m)
+            {
+                ecrireEntier(fichier, origine.motifs[m].trajet == aucun ? 0 : 1 + origine.motifs[m].trajet);
+                ecrireEntier(fichier, origine.motifs[m].transfert);
+            }
+        }
+    }
+    if (!fichier) throw logic_error("MotifsDeTransfert::enregistrer(): erreur d'écriture dans " + p_fichier);
+}
+
+//! \brief remplace les motifs par ceux du fichier p_fichier (voir enregistrer()) et reconstruit la table des trajets
+//! directs à partir de p_gtfs
+//! \param[in] p_gtfs: les données GTFS à partir desquelles les motifs ont été calculés
+//! \throws logic_error si le fichier est illisible, ou si ses stations ne sont pas celles de p_gtfs
+void MotifsDeTransfert::charger(const string &p_fichier, const DonneesGTFS &p_gtfs)
+{
+    ifstream fichier(p_fichier, ios::binary);
+    if (!fichier) throw logic_error("MotifsDeTransfert::charger(): impossible d'ouvrir " + p_fichier);
+    try
+    {
+        char signature[sizeof(signatureFichier)];
+        if (!fichier.read(signature, sizeof(signature)) || !equal(signature, signature + sizeof(signature), signatureFichier))
+            throw logic_error("MotifsDeTransfert::charger(): " + p_fichier + " n'est pas un fichier de motifs");
+        if (lireEntier(fichier) != versionFichier)
+            throw logic_error("MotifsDeTransfert::charger(): version de fichier non supportée");
+
+        MotifsDeTransfert motifs;
+        const uint32_t nbStations = lireEntier32(fichier);
+        if (nbStations != p_gtfs.getStations().size())
+            throw logic_error("MotifsDeTransfert::charger(): les stations du fichier ne sont pas celles des données GTFS");
+        unsigned int id = 0;
+        auto itStations = p_gtfs.getStations().begin();
+        for (uint32_t s = 0; s < nbStations; ++s, ++itStations)
+        {
+            id += lireEntier32(fichier);
+            if (id != itStations->first)
+                throw logic_error("MotifsDeTransfert::charger(): les stations du fichier ne sont pas celles des données GTFS");
+        }
+
+        motifs.m_origines.resize(nbStations);
+        for (Origine &origine : motifs.m_origines)
+        {
+            // validation: un trajet ne suit qu'un trajet déjà lu de la même origine, entre des stations qui existent
+            const uint32_t nbTrajets = lireEntier32(fichier);
+            if (nbTrajets == aucun) throw logic_error("MotifsDeTransfert::charger(): trop de trajets");
+            origine.trajets.resize(nbTrajets);
+            for (uint32_t t = 0; t < nbTrajets; ++t)
+            {
+                Trajet &trajet = origine.trajets[t];
+                const uint32_t ecart = lireEntier32(fichier);
+                if (ecart > t) throw logic_error("MotifsDeTransfert::charger(): trajet précédent invalide");
+                trajet.precedent = ecart == 0 ? aucun : t - ecart;
+                trajet.transfert = lireEntier32(fichier);
+                trajet.montee = lireEntier32(fichier);
+                trajet.descente = lireEntier32(fichier);
+                if (trajet.montee >= nbStations || trajet.descente >= nbStations)
+                    throw logic_error("MotifsDeTransfert::charger(): station invalide");
+            }
+
+            const uint32_t nbDestinations = lireEntier32(fichier);
+            origine.destinations.resize(nbDestinations);
+            uint32_t destination = 0;
+            for (uint32_t i = 0; i < nbDestinations; ++i)
+            {
+                destination += lireEntier32(fichier);
+                if (destination >= nbStations) throw logic_error("MotifsDeTransfert::charger(): station invalide");
+                origine.destinations[i] = destination;
+            }
+            origine.debutMotifs.assign(1, 0);
+            for (uint32_t i = 0; i < nbDestinations; ++i)
+            {
+                const uint32_t nbMotifs = lireEntier32(fichier);
+                for (uint32_t j = 0; j < nbMotifs; ++j)
+                {
+                    const uint32_t trajet = lireEntier32(fichier);
+                    if (trajet > nbTrajets) throw logic_error("MotifsDeTransfert::charger(): trajet invalide");
+                    const uint32_t transfert = lireEntier32(fichier);
+                    origine.motifs.push_back(Motif{trajet == 0 ? aucun : trajet - 1, transfert});
+                }
+                origine.debutMotifs.push_back((uint32_t) origine.motifs.size());
+            }
+            origine.motifs.shrink_to_fit();
+            motifs.m_nbPaires += nbDestinations;
+            motifs.m_nbMotifs += origine.motifs.size();
+            motifs.m_nbTrajets += nbTrajets;
+        }
+        motifs.m_horaires = TableParcours(p_gtfs);
+        *this = std::move(motifs);
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
+
+//! \brief Précalcule les motifs de transfert de toutes les paires de stations (voir MotifsDeTransfert)
+//! \brief Pour chaque station d'origine, une recherche est lancée depuis chacun de ses arrêts, du plus tardif au plus
+//! hâtif, et les arrêts qu'une recherche précédente a déjà atteints ne sont pas explorés de nouveau: y arriver en
+//! partant plus tôt ne mène à rien de mieux. Chaque sommet est ainsi exploré au plus une fois par station d'origine.
+//! Une recherche ne retient une destination que si elle y arrive plus tôt que toutes les recherches précédentes (les
+//! départs plus tardifs); le motif est alors extrait du chemin, et le temps de chaque transfert est le temps minimal de
+//! ses arcs (transfers.txt, trajet à pieds, ou delaisMinArcsAttente à la même station), qui ne dépasse jamais celui du
+//! chemin. La destination est la première station atteinte par quelque arc que ce soit, comme dans
+//! calculerItineraireEntreStations(). À égalité d'heure d'arrivée, la recherche préfère le chemin qui emprunte le moins
+//! d'arcs hors voyage. Les chemins d'une même recherche partagent leurs débuts: le motif partiel d'un sommet (le
+//! dernier trajet terminé dans l'arbre des préfixes de l'origine, et le transfert depuis) n'est calculé qu'une fois par
+//! recherche, à partir de celui de son parent.
+//! \brief Les stations d'origine sont réparties dynamiquement entre p_nbFils fils d'exécution, qui ne lisent que le
+//! réseau. La phase "precalculerMotifsDeTransfert" de l'instrumentation reçoit la durée et le nombre de motifs.
+//! \param[in] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \param[in] p_nbFils: le nombre de fils d'exécution (au moins 1)
+//! \throws logic_error si p_nbFils vaut 0 ou si les points origine et destination de ajouterArcsOrigineDestination()
+//! sont présents
+MotifsDeTransfert ReseauGTFS::precalculerMotifsDeTransfert(const DonneesGTFS &p_gtfs, unsigned int p_nbFils) const
+{
+    if (p_nbFils == 0)
+        throw logic_error("ReseauGTFS::precalculerMotifsDeTransfert(): il faut au moins un fil d'exécution");
+    if (m_origine_dest_ajoute)
+        throw logic_error(
+                "ReseauGTFS::precalculerMotifsDeTransfert(): il faut enlever les points origine et destination avant");
+    Instrumentation::MesurePhase mesure(m_instrumentation, "precalculerMotifsDeTransfert");
+    try
+    {
+        MotifsDeTransfert motifs;
+        motifs.m_horaires = TableParcours(p_gtfs);
+        const size_t nbStations = m_idStations.size();
+        // sur un réseau compacté, les arrêts contractés suivent les sommets (voir compacterVoyages())
+        const size_t nbSommets = estCompacte() ? m_premierContracte + m_arretsContractes.size()
+                                               : m_leGraphe.getNbSommets();
+
+        // rang de station et voyage de chaque sommet (aucun pour un sommet libre et les numéros réservés aux points
+        // origine et destination)
+        vector<uint32_t> stationDuSommet(nbSommets, aucun), voyageDuSommet(nbSommets, aucun);
+        unordered_map<string, uint32_t> indicesVoyages;
+        for (size_t sommet = 0; sommet < nbSommets; ++sommet)
+        {
+            if (sommet >= m_arretDuSommet.size() && !estContracte(sommet)) continue;
+            const Arret::Ptr &arret = arretDe(sommet);
+            if (!arret) continue;
+            stationDuSommet[sommet] = motifs.m_horaires.rangDeStation(arret->getStationId());
+            voyageDuSommet[sommet] =
+                    indicesVoyages.emplace(arret->getVoyageId(), (uint32_t) indicesVoyages.size()).first->second;
+        }
+
+        // temps minimal d'un arc hors voyage, selon les règles de construction du graphe
+        auto tempsMinimal = [&](size_t p_de, size_t p_vers) -> uint32_t {
+            const unsigned int stationDe = arretDe(p_de)->getStationId();
+            const unsigned int stationVers = arretDe(p_vers)->getStationId();
+            uint32_t temps = aucun;
+            auto itTransferts = m_transfertsDepuisStation.find(stationDe);
+            if (itTransferts != m_transfertsDepuisStation.end())
+                for (const auto &transfert : itTransferts->second)
+                    if (transfert.first == stationVers) temps = min<uint32_t>(temps, transfert.second);
+            if (temps != aucun) return temps;
+            return stationDe == stationVers ? delaisMinArcsAttente : 0;
+        };
+
+        motifs.m_origines.resize(nbStations);
+        atomic<size_t> prochaineOrigine(0);
+        mutex verrouErreur;
+        string erreur;
+
+        auto travailler = [&]() {
+            try
+            {
+                const unsigned int infini = numeric_limits<unsigned int>::max();
+                // atteint[s] == origine + 1: sommet déjà exploré depuis l'origine courante
+                vector<uint32_t> atteint(nbSommets, 0), recherche(nbSommets, 0), parent(nbSommets, aucun);
+                // motif partiel de chaque sommet d'un chemin extrait, calculé une fois par recherche à partir de
+                // celui de son parent: le dernier trajet terminé et le transfert depuis, et le premier sommet du
+                // voyage en cours
+                vector<uint32_t> motifCalcule(nbSommets, 0), debutDuVoyage(nbSommets);
+                vector<MotifsDeTransfert::Motif> motifPartiel(nbSommets);
+                vector<uint64_t> cle(nbSommets);       // (heure << 32) | arcs hors voyage, pour la recherche courante
+                vector<uint32_t> arriveeMin(nbStations), rechercheStation(nbStations, 0), sommetArrivee(nbStations);
+                vector<uint32_t> stationsAtteintes, chemin;
+                vector<vector<MotifsDeTransfert::Motif>> motifsVers(nbStations);
+                unordered_map<CleTrajet, uint32_t, HachageCleTrajet> indiceDuTrajet; // dans le bloc de l'origine
+                vector<uint32_t> destinationsAvecMotifs;
+                typedef pair<uint64_t, uint32_t> Entree;
+                priority_queue<Entree, vector<Entree>, greater<Entree>> file;
+                uint32_t numeroRecherche = 0;
+
+                for (size_t origine; (origine = prochaineOrigine++) < nbStations;)
+                {
+                    const uint32_t marque = (uint32_t) origine + 1;
+                    fill(arriveeMin.begin(), arriveeMin.end(), aucun);
+                    MotifsDeTransfert::Origine &bloc = motifs.m_origines[origine];
+                    indiceDuTrajet.clear();
+                    // ajoute au motif partiel p_motif le trajet du sommet p_debut au sommet p_fin d'un même voyage,
+                    // en le cherchant dans l'arbre des préfixes de l'origine ou en l'y ajoutant (aucun trajet si
+                    // p_debut est p_fin: on n'y est pas monté)
+                    auto terminerVoyage = [&](const MotifsDeTransfert::Motif &p_motif, uint32_t p_debut,
+                                              uint32_t p_fin) -> MotifsDeTransfert::Motif {
+                        if (p_debut == p_fin) return p_motif;
+                        const CleTrajet cle{p_motif.trajet, p_motif.transfert, stationDuSommet[p_debut],
+                                            stationDuSommet[p_fin]};
+                        auto itTrajet = indiceDuTrajet.find(cle);
+                        if (itTrajet == indiceDuTrajet.end())
+                        {
+                            itTrajet = indiceDuTrajet.emplace(cle, (uint32_t) bloc.trajets.size()).first;
+                            bloc.trajets.push_back(MotifsDeTransfert::Trajet{cle.precedent, cle.transfert, cle.montee,
+                                                                             cle.descente});
+                        }
+                        return MotifsDeTransfert::Motif{itTrajet->second, 0};
+                    };
+                    const Station::Arrets &arrets = p_gtfs.getStations().at(m_idStations[origine]).getArrets();
+                    for (auto itArret = arrets.rbegin(); itArret != arrets.rend(); ++itArret)
+                    {
+                        auto itSommet = m_sommetDeArret.find(itArret->second);
+                        if (itSommet == m_sommetDeArret.end() || atteint[itSommet->second] == marque) continue;
+                        const uint32_t depart = (uint32_t) itSommet->second;
+
+                        ++numeroRecherche;
+                        stationsAtteintes.clear();
+                        recherche[depart] = numeroRecherche;
+                        cle[depart] = (uint64_t) secondesDe(itArret->second->getHeureArrivee()) << 32;
+                        parent[depart] = aucun;
+                        // la station d'un sommet atteint: la clé la plus petite l'emporte (les arrêts contractés sont
+                        // atteints en même temps que le sommet amont de leur raccourci, avant leur tour dans la file)
+                        auto atteindre = [&](uint32_t p_sommet) {
+                            atteint[p_sommet] = marque;
+                            const uint32_t station = stationDuSommet[p_sommet];
+                            if (station == origine) return;
+                            if (rechercheStation[station] != numeroRecherche)
+                            {
+                                rechercheStation[station] = numeroRecherche;
+                                sommetArrivee[station] = p_sommet;
+                                stationsAtteintes.push_back(station);
+                            }
+                            else if (cle[p_sommet] < cle[sommetArrivee[station]])
+                                sommetArrivee[station] = p_sommet;
+                        };
+                        // les arrêts contractés m_arretsContractes[p_debut], ... jusqu'à p_fin, qui suivent p_sommet
+                        // sur son voyage; retourne le dernier franchi (aucun si un arc de voyage désactivé ou un arrêt
+                        // déjà atteint coupe la suite)
+                        auto parcourirRaccourci = [&](uint32_t p_sommet, size_t p_debut, size_t p_fin) -> uint32_t {
+                            uint32_t precedent = p_sommet;
+                            for (size_t k = p_debut; k < p_fin; ++k)
+                            {
+                                const uint32_t contracte = (uint32_t) (m_premierContracte + k);
+                                if (atteint[contracte] == marque || secondesEntre(precedent, contracte) < 0)
+                                    return aucun;
+                                recherche[contracte] = numeroRecherche;
+                                cle[contracte] = cle[p_sommet] +
+                                                 ((uint64_t) secondesEntre(p_sommet, contracte) << 32);
+                                parent[contracte] = p_sommet;
+                                atteindre(contracte);
+                                precedent = contracte;
+                            }
+                            return precedent;
+                        };
+                        if (estContracte(depart))
+                        {
+                            // départ d'un arrêt contracté: le voyage mène à la suite de son raccourci puis au sommet aval
+                            atteint[depart] = marque;
+                            const ArretContracte &contracte = m_arretsContractes[depart - m_premierContracte];
+                            const uint32_t precedent = parcourirRaccourci(depart, depart - m_premierContracte + 1,
+                                                                          chaineDe(contracte.amont).second);
+                            if (precedent != aucun && secondesEntre(precedent, contracte.aval) >= 0 &&
+                                atteint[contracte.aval] != marque)
+                            {
+                                recherche[contracte.aval] = numeroRecherche;
+                                cle[contracte.aval] = cle[depart] +
+                                                      ((uint64_t) secondesEntre(depart, contracte.aval) << 32);
+                                parent[contracte.aval] = depart;
+                                file.push({cle[contracte.aval], (uint32_t) contracte.aval});
+                            }
+                        }
+                        else
+                            file.push({cle[depart], depart});
+                        while (!file.empty())
+                        {
+                            const uint32_t sommet = file.top().second;
+                            const uint64_t cleSommet = file.top().first;
+                            file.pop();
+                            if (atteint[sommet] == marque) continue;
+                            atteindre(sommet);
+                            const pair<size_t, size_t> chaine = chaineDe(sommet);
+                            if (chaine.first != chaine.second) parcourirRaccourci(sommet, chaine.first, chaine.second);
+
+                            m_leGraphe.pourChaqueArcSortant(sommet, [&](size_t p_destination, unsigned int p_poids) {
+                                if (p_poids == infini || atteint[p_destination] == marque ||
+                                    stationDuSommet[p_destination] == aucun) return;
+                                const uint64_t nouvelle = cleSommet + ((uint64_t) p_poids << 32) +
+                                                          (voyageDuSommet[p_destination] != voyageDuSommet[sommet]);
+                                if (recherche[p_destination] != numeroRecherche || nouvelle < cle[p_destination])
+                                {
+                                    recherche[p_destination] = numeroRecherche;
+                                    cle[p_destination] = nouvelle;
+                                    parent[p_destination] = sommet;
+                                    file.push({nouvelle, (uint32_t) p_destination});
+                                }
+                            });
+                        }
+
+                        for (uint32_t station : stationsAtteintes)
+                        {
+                            const uint32_t arrivee = (uint32_t) (cle[sommetArrivee[station]] >> 32);
+                            if (arrivee >= arriveeMin[station]) continue;
+                            arriveeMin[station] = arrivee;
+
+                            // découpage en trajets (arrêts consécutifs d'un même voyage) et transferts, depuis le
+                            // premier sommet du chemin dont le motif partiel n'est pas encore calculé
+                            chemin.clear();
+                            for (uint32_t s = sommetArrivee[station]; s != aucun && motifCalcule[s] != numeroRecherche;
+                                 s = parent[s])
+                                chemin.push_back(s);
+                            for (auto itSommet = chemin.rbegin(); itSommet != chemin.rend(); ++itSommet)
+                            {
+                                const uint32_t sommet = *itSommet, precedent = parent[sommet];
+                                motifCalcule[sommet] = numeroRecherche;
+                                if (precedent == aucun)
+                                {
+                                    motifPartiel[sommet] = MotifsDeTransfert::Motif{aucun, 0};
+                                    debutDuVoyage[sommet] = sommet;
+                                }
+                                else if (voyageDuSommet[sommet] == voyageDuSommet[precedent])
+                                {
+                                    motifPartiel[sommet] = motifPartiel[precedent];
+                                    debutDuVoyage[sommet] = debutDuVoyage[precedent];
+                                }
+                                else
+                                {
+                                    motifPartiel[sommet] = terminerVoyage(motifPartiel[precedent],
+                                                                          debutDuVoyage[precedent], precedent);
+                                    motifPartiel[sommet].transfert += tempsMinimal(precedent, sommet);
+                                    debutDuVoyage[sommet] = sommet;
+                                }
+                            }
+                            const uint32_t fin = sommetArrivee[station];
+                            const MotifsDeTransfert::Motif motif =
+                                    terminerVoyage(motifPartiel[fin], debutDuVoyage[fin], fin);
+
+                            vector<MotifsDeTransfert::Motif> &existants = motifsVers[station];
+                            if (existants.empty()) destinationsAvecMotifs.push_back(station);
+                            bool doublon = false;
+                            for (const MotifsDeTransfert::Motif &existant : existants)
+                                doublon |= existant.trajet == motif.trajet && existant.transfert == motif.transfert;
+                            if (!doublon) existants.push_back(motif);
+                        }
+                    }
+
+                    sort(destinationsAvecMotifs.begin(), destinationsAvecMotifs.end());
+                    bloc.debutMotifs.assign(1, 0);
+                    for (uint32_t destination : destinationsAvecMotifs)
+                    {
+                        vector<MotifsDeTransfert::Motif> &existants = motifsVers[destination];
+                        bloc.destinations.push_back(destination);
+                        bloc.motifs.insert(bloc.motifs.end(), existants.begin(), existants.end());
+                        bloc.debutMotifs.push_back((uint32_t) bloc.motifs.size());
+                        existants.clear();
+                    }
+                    bloc.destinations.shrink_to_fit();
+                    bloc.debutMotifs.shrink_to_fit();
+                    bloc.motifs.shrink_to_fit();
+                    bloc.trajets.shrink_to_fit();
+                    destinationsAvecMotifs.clear();
+                }
+            } catch (exception &ex)
+            {
+                lock_guard<mutex> verrou(verrouErreur);
+                if (erreur.empty()) erreur = ex.what();
+                prochaineOrigine = nbStations;
+            }
+        };
+
+        vector<thread> fils;
+        for (unsigned int i = 1; i < p_nbFils; ++i) fils.emplace_back(travailler);
+        travailler();
+        for (thread &f : fils) f.join();
+        if (!erreur.empty()) throw logic_error(erreur);
+
+        for (const MotifsDeTransfert::Origine &origine : motifs.m_origines)
+        {
+            motifs.m_nbPaires += origine.destinations.size();
+            motifs.m_nbMotifs += origine.motifs.size();
+            motifs.m_nbTrajets += origine.trajets.size();
+        }
+        mesure.terminer(motifs.m_nbMotifs);
+        return motifs;
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
@@ -0,0 +1,100 @@
+//
+// Motifs de transfert: les suites de stations des itinéraires optimaux, précalculées pour chaque station d'origine,
+// et leur évaluation en ligne sur les horaires des trajets directs.
+//
+
+#ifndef RTC_MOTIFSTRANSFERT_H
+#define RTC_MOTIFSTRANSFERT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DonneesGTFS.h"
+#include "itineraire.h"
+#include "tableParcours.h"
+
+class ReseauGTFS;
+
+/*!
+ * \class MotifsDeTransfert
+ * \brief Pour chaque paire de stations (origine, destination), les motifs de transfert des itinéraires optimaux de la
+ * journée de service: la suite des stations où l'on monte et où l'on descend, avec le temps minimal de chaque transfert
+ * entre deux trajets. Ils sont produits hors ligne par ReseauGTFS::precalculerMotifsDeTransfert(), qui explore le graphe
+ * depuis chaque station d'origine (en parallèle sur plusieurs fils d'exécution).
+ * \brief Une requête entre deux stations n'explore plus le graphe: chaque motif de la paire est évalué trajet par
+ * trajet sur la table des trajets directs (pour deux stations, le premier voyage qui passe par l'une puis par l'autre
+ * après une heure donnée), et le motif qui arrive le plus tôt est retenu. L'itinéraire obtenu arrive au plus tard à
+ * l'heure de ReseauGTFS::calculerItineraireEntreStations() pour les mêmes données.
+ * \brief Les motifs s'enregistrent dans un fichier binaire compact (entiers de longueur variable, destinations codées
+ * par écart) et se rechargent avec les données GTFS à partir desquelles ils ont été calculés: la table des trajets
+ * directs est reconstruite à partir de ces données.
+ * \brief Les motifs d'une même origine partagent leurs débuts: leurs trajets forment un arbre de préfixes dont chaque
+ * nœud est un trajet (le temps minimal du transfert qui le précède, en secondes, la station de montée et la station de
+ * descente) et dont le parent est le trajet précédent. Un motif n'est que son dernier trajet (aucun s'il n'emprunte
+ * aucun voyage) et le temps du transfert final vers la station de destination. Les stations sont désignées par leur
+ * rang dans getStations().
+ */
+class MotifsDeTransfert {
+
+public:
+
+    MotifsDeTransfert();
+
+    void charger(const std::string &, const DonneesGTFS &);
+    void enregistrer(const std::string &) const;
+
+    unsigned int calculerItineraire(unsigned int, unsigned int, const Heure &, Itineraire &) const;
+
+    size_t getNbPaires() const { return m_nbPaires; }
+    size_t getNbMotifs() const { return m_nbMotifs; }
+    size_t getNbTrajets() const { return m_nbTrajets; }
+    size_t getTailleEnOctets() const;
+
+private:
+
+    friend class ReseauGTFS; // ReseauGTFS::precalculerMotifsDeTransfert() remplit les motifs
+
+    //! \brief le trajet direct retenu entre deux stations
+    struct TrajetDirect {
+        uint32_t voyage; // numéro du voyage dans m_horaires
+        uint32_t rangMontee;
+        uint32_t rangDescente;
+        uint32_t arrivee; // en secondes depuis 00:00:00
+    };
+
+    //! \brief un trajet d'un motif, nœud de l'arbre des préfixes des motifs de son origine
+    struct Trajet {
+        uint32_t precedent; // trajet précédent du motif (aucun pour le premier)
+        uint32_t transfert; // temps minimal du transfert qui précède le trajet, en secondes
+        uint32_t montee;    // rang de la station de montée
+        uint32_t descente;  // rang de la station de descente
+    };
+
+    //! \brief un motif: son dernier trajet et le transfert final vers la station de destination
+    struct Motif {
+        uint32_t trajet;    // aucun pour un motif sans trajet
+        uint32_t transfert; // en secondes
+    };
+
+    //! \brief les motifs d'une station d'origine, rangés à part: le précalcul les produit origine par origine
+    struct Origine {
+        std::vector<uint32_t> destinations; // rang de la station de destination, croissant
+        std::vector<uint32_t> debutMotifs;  // les motifs de la paire p: [debutMotifs[p], debutMotifs[p+1])
+        std::vector<Motif> motifs;
+        std::vector<Trajet> trajets;        // arbre des préfixes des motifs
+    };
+
+    std::vector<Origine> m_origines;           // par rang de station
+    size_t m_nbPaires;
+    size_t m_nbMotifs;
+    size_t m_nbTrajets;
+
+    TableParcours m_horaires;                  // table des trajets directs
+
+    bool trajetDirect(uint32_t, uint32_t, uint32_t, TrajetDirect &) const;
+    uint32_t evaluerTrajets(const Origine &, uint32_t, uint32_t, std::vector<TrajetDirect> *) const;
+    uint32_t evaluerMotif(const Origine &, const Motif &, uint32_t, std::vector<TrajetDirect> *) const;
+};
+
+#endif //RTC_MOTIFSTRANSFERT_H
@@ -0,0 +1,55 @@
+//
+// Fonctions communes aux outils de mesure (bancs d'essai, précalcul, serveur).
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+#include "outilsMesure.h"
+
+using namespace std;
+
+//! \brief tire un entier dans [0, p_n), identique sur toutes les plateformes
+//! \brief contrairement à std::uniform_int_distribution, dont l'algorithme dépend de la bibliothèque standard, le
+//! corpus tiré d'une graine donnée est ainsi le même partout
+//! \param[in,out] p_generateur: le générateur
+//! \param[in] p_n: la borne (exclue) du tirage
+uint32_t tirer(std::mt19937 &p_generateur, uint32_t p_n) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(p_generateur()) * p_n) >> 32);
+}
+
+//! \brief valeur au rang centile p (méthode du rang le plus proche) d'un vecteur trié
+//! \param[in] p_valeursTriees: les valeurs, en ordre croissant
+//! \param[in] p: le centile, dans [0, 100]
+//! \return la valeur au rang centile p (0 si le vecteur est vide)
+double centile(const std::vector<double> &p_valeursTriees, double p) {
+    if (p_valeursTriees.empty()) return 0.0;
+    size_t rang = (size_t) ceil(p / 100.0 * p_valeursTriees.size());
+    return p_valeursTriees[rang == 0 ? 0 : rang - 1];
+}
+
+//! \brief écrit le champ JSON p_nom: {"p50", "p90", "p99", "max", "moyenne"} des valeurs, suivi d'une virgule
+//! \param[in,out] p_flux: le flux de sortie
+//! \param[in] p_nom: le nom du champ
+//! \param[in] p_valeurs: les valeurs, dans un ordre quelconque
+void afficherDistribution(std::ostream &p_flux, const std::string &p_nom, std::vector<double> p_valeurs) {
+    sort(p_valeurs.begin(), p_valeurs.end());
+    double somme = 0.0;
+    for (double valeur : p_valeurs) somme += valeur;
+    p_flux << "  \"" << p_nom << "\": {\"p50\": " << centile(p_valeurs, 50) << ", \"p90\": "
+           << centile(p_valeurs, 90) << ", \"p99\": " << centile(p_valeurs, 99) << ", \"max\": "
+           << (p_valeurs.empty() ? 0.0 : p_valeurs.back()) << ", \"moyenne\": "
+           << (p_valeurs.empty() ? 0.0 : somme / p_valeurs.size()) << "},\n";
+}
+
+//! \brief convertit un argument AAAAMMJJ de la ligne de commande en Date
+//! \param[in] p_texte: l'argument
+//! \param[in] p_outil: le nom de l'outil, repris dans le message d'erreur
+//! \throws logic_error si l'argument n'est pas une date AAAAMMJJ
+Date dateDepuisArgument(const std::string &p_texte, const std::string &p_outil) {
+    if (p_texte.size() != 8 || !all_of(p_texte.begin(), p_texte.end(), ::isdigit))
+        throw logic_error(p_outil + ": la date doit être au format AAAAMMJJ");
+    return Date(stoi(p_texte.substr(0, 4)), stoi(p_texte.substr(4, 2)), stoi(p_texte.substr(6, 2)));
+}
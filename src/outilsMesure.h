@@ -0,0 +1,21 @@
+//
+// Fonctions communes aux outils de mesure: tirages reproductibles, distributions en JSON et lecture des arguments.
+//
+
+#ifndef RTC_OUTILSMESURE_H
+#define RTC_OUTILSMESURE_H
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "auxiliaires.h"
+
+uint32_t tirer(std::mt19937 &, uint32_t);
+double centile(const std::vector<double> &, double);
+void afficherDistribution(std::ostream &, const std::string &, std::vector<double>);
+Date dateDepuisArgument(const std::string &, const std::string &);
+
+#endif //RTC_OUTILSMESURE_H
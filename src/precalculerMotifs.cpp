@@ -0,0 +1,132 @@
+//
+// Précalcul hors ligne des motifs de transfert (ReseauGTFS::precalculerMotifsDeTransfert()).
+// Le réseau est chargé, les motifs sont calculés sur le nombre de fils d'exécution demandé puis enregistrés dans un
+// fichier, qui est relu pour vérification. Un corpus de requêtes entre stations, tiré d'une graine donnée, est ensuite
+// calculé à la fois par les motifs (MotifsDeTransfert::calculerItineraire()) et par le graphe
+// (ReseauGTFS::calculerItineraireEntreStations()) afin de comparer leurs latences et leurs heures d'arrivée. Les
+// résultats (temps et espace du précalcul, latences, écarts) sont écrits en JSON sur la sortie standard.
+//
+// Usage: precalculerMotifs [dossier_gtfs] [fichier_motifs] [nombre_de_fils] [date_AAAAMMJJ]
+//                          [rayon_trajets_a_pied_km] [nombre_de_requetes] [graine]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    const unsigned int debutDesDeparts = 6 * 3600;    // les heures de départ sont tirées dans [06:00, 18:00)
+    const unsigned int plageDesDeparts = 12 * 3600;
+    const unsigned int finDeLaFenetre = 23 * 3600 + 59 * 60 + 59;
+
+    double millisecondes(chrono::steady_clock::duration p_duree) {
+        return chrono::duration<double, milli>(p_duree).count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const std::string fichierMotifs = argc > 2 ? argv[2] : "motifs.bin";
+    const unsigned int nbFils = argc > 3 ? (unsigned int) stoul(argv[3]) : max(1u, thread::hardware_concurrency());
+    const Date date = argc > 4 ? dateDepuisArgument(argv[4], "precalculerMotifs") : Date(2020, 9, 25);
+    const double rayonTrajetsAPied = argc > 5 ? stod(argv[5]) : 0.0;
+    const size_t nbRequetes = argc > 6 ? stoul(argv[6]) : 2000;
+    const uint32_t graine = argc > 7 ? (uint32_t) stoul(argv[7]) : 2021;
+
+    DonneesGTFS donnees(date, Heure(0, 0, 0).add_secondes(debutDesDeparts),
+                        Heure(0, 0, 0).add_secondes(finDeLaFenetre));
+    donnees.chargerDossier(chemin_dossier);
+    if (rayonTrajetsAPied > 0) donnees.calculerTrajetsAPied(rayonTrajetsAPied);
+    ReseauGTFS reseau(donnees);
+
+    // les motifs calculés sont libérés avant la relecture: les deux copies ne sont jamais en mémoire à la fois
+    auto debut = chrono::steady_clock::now();
+    auto finPrecalcul = debut, finEnregistrement = debut;
+    size_t nbPaires, nbMotifs, nbTrajets, octetsMemoire;
+    {
+        const MotifsDeTransfert motifs = reseau.precalculerMotifsDeTransfert(donnees, nbFils);
+        finPrecalcul = chrono::steady_clock::now();
+        motifs.enregistrer(fichierMotifs);
+        finEnregistrement = chrono::steady_clock::now();
+        nbPaires = motifs.getNbPaires();
+        nbMotifs = motifs.getNbMotifs();
+        nbTrajets = motifs.getNbTrajets();
+        octetsMemoire = motifs.getTailleEnOctets();
+    }
+    MotifsDeTransfert relus;
+    relus.charger(fichierMotifs, donnees);
+    auto finChargement = chrono::steady_clock::now();
+    if (relus.getNbMotifs() != nbMotifs || relus.getNbPaires() != nbPaires || relus.getNbTrajets() != nbTrajets)
+        throw logic_error("precalculerMotifs: le fichier relu ne contient pas les motifs calculés");
+    const streamoff octetsFichier = ifstream(fichierMotifs, ios::binary | ios::ate).tellg();
+
+    vector<unsigned int> station_ids;
+    for (const auto &station : donnees.getStations()) station_ids.push_back(station.first);
+    if (station_ids.size() < 2) throw logic_error("precalculerMotifs: il faut au moins deux stations");
+    std::mt19937 generateur(graine);
+    vector<double> latencesMotifs, latencesGraphe;
+    size_t nbAtteignables = 0, nbEgales = 0, nbPlusTot = 0, nbPlusTard = 0;
+    for (size_t i = 0; i < nbRequetes; ++i) {
+        const unsigned int origine = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+        const unsigned int destination = station_ids[tirer(generateur, (uint32_t) station_ids.size())];
+        const Heure depart = Heure(0, 0, 0).add_secondes(debutDesDeparts + tirer(generateur, plageDesDeparts));
+        if (destination == origine) continue;
+        Itineraire parMotifs, parGraphe;
+        StatistiquesRecherche statistiques;
+        auto t0 = chrono::steady_clock::now();
+        const unsigned int dureeMotifs = relus.calculerItineraire(origine, destination, depart, parMotifs);
+        auto t1 = chrono::steady_clock::now();
+        const unsigned int dureeGraphe =
+                reseau.calculerItineraireEntreStations(donnees, origine, destination, depart, parGraphe, statistiques);
+        auto t2 = chrono::steady_clock::now();
+        latencesMotifs.push_back(chrono::duration<double, micro>(t1 - t0).count());
+        latencesGraphe.push_back(chrono::duration<double, micro>(t2 - t1).count());
+        if (parGraphe.estAtteignable() || parMotifs.estAtteignable()) ++nbAtteignables;
+        if (dureeMotifs == dureeGraphe) ++nbEgales;
+        else if (dureeMotifs < dureeGraphe) ++nbPlusTot;
+        else ++nbPlusTard;
+    }
+    double sommeMotifs = 0, sommeGraphe = 0;
+    for (double latence : latencesMotifs) sommeMotifs += latence;
+    for (double latence : latencesGraphe) sommeGraphe += latence;
+
+    cout << fixed << setprecision(3) << "{\n";
+    cout << "  \"dossier\": \"" << chemin_dossier << "\",\n";
+    cout << "  \"fichier\": \"" << fichierMotifs << "\",\n";
+    cout << "  \"rayon_trajets_a_pied_km\": " << rayonTrajetsAPied << ",\n";
+    cout << "  \"stations\": " << donnees.getNbStations() << ",\n";
+    cout << "  \"arrets\": " << donnees.getNbArrets() << ",\n";
+    cout << "  \"fils\": " << nbFils << ",\n";
+    cout << "  \"precalcul_ms\": " << millisecondes(finPrecalcul - debut) << ",\n";
+    cout << "  \"enregistrement_ms\": " << millisecondes(finEnregistrement - finPrecalcul) << ",\n";
+    cout << "  \"chargement_ms\": " << millisecondes(finChargement - finEnregistrement) << ",\n";
+    cout << "  \"paires\": " << nbPaires << ",\n";
+    cout << "  \"motifs\": " << nbMotifs << ",\n";
+    cout << "  \"trajets\": " << nbTrajets << ",\n";
+    cout << "  \"octets_memoire\": " << octetsMemoire << ",\n";
+    cout << "  \"octets_fichier\": " << octetsFichier << ",\n";
+    cout << "  \"requetes\": " << latencesMotifs.size() << ",\n";
+    cout << "  \"atteignables\": " << nbAtteignables << ",\n";
+    cout << "  \"arrivees_egales\": " << nbEgales << ",\n";
+    cout << "  \"arrivees_plus_tot\": " << nbPlusTot << ",\n";
+    cout << "  \"arrivees_plus_tard\": " << nbPlusTard << ",\n";
+    afficherDistribution(cout, "motifs_latence_us", latencesMotifs);
+    afficherDistribution(cout, "graphe_latence_us", latencesGraphe);
+    cout << "  \"acceleration\": " << (sommeMotifs > 0 ? sommeGraphe / sommeMotifs : 0.0) << "\n";
+    cout << "}\n";
+
+    return 0;
+}
@@ -0,0 +1,407 @@
+//
+// Routage par voyages: précalcul des transferts utiles et recherche en largeur sur les segments de voyages.
+//
+
+#include "routageParVoyages.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    const uint32_t aucun = TableParcours::aucun;
+
+    Heure heureDe(uint32_t p_secondes) {
+        return Heure(0, 0, 0).add_secondes(p_secondes);
+    }
+
+    //! \brief segment du voyage voyage, du rang debut (montée) au rang fin, atteint depuis le segment parent (aucun pour
+    //! un segment de départ) en le quittant à son arrêt de rang rangQuitte
+    struct Segment {
+        uint32_t voyage;
+        uint32_t debut;
+        uint32_t fin;
+        uint32_t parent;
+        uint32_t rangQuitte;
+    };
+}
+
+RoutageParVoyages::RoutageParVoyages() : m_nbTransfertsInitiaux(0), m_nbDemiTours(0)
+{
+}
+
+//! \brief taille, en octets, des règles et des transferts (la table des parcours exclue)
+size_t RoutageParVoyages::getTailleEnOctets() const
+{
+    return sizeof(uint32_t) * (m_debutRegles.size() + m_debutReglesVers.size() + m_debutTransferts.size()) +
+           sizeof(Regle) * (m_regles.size() + m_reglesVers.size()) + sizeof(Transfert) * m_transferts.size();
+}
+
+//! \brief remplit m_regles et m_reglesVers à partir des règles directes de chaque station (par rang de station)
+//! \brief Entre deux stations distinctes, la règle retenue est la suite de règles directes la plus rapide (Dijkstra
+//! sur les stations); à la même station, c'est la plus rapide des règles directes de la station vers elle-même et des
+//! allers-retours vers d'autres stations.
+void RoutageParVoyages::fermerRegles(const vector<vector<Regle>> &p_directes)
+{
+    const size_t nbStations = p_directes.size();
+    vector<uint32_t> distance(nbStations, aucun), atteintes;
+    typedef pair<uint32_t, uint32_t> Entree; // <temps, station>
+    priority_queue<Entree, vector<Entree>, greater<Entree>> file;
+
+    m_debutRegles.assign(1, 0);
+    m_regles.clear();
+    for (uint32_t station = 0; station < nbStations; ++station)
+    {
+        uint32_t surPlace = aucun;
+        for (const Regle &regle : p_directes[station])
+            if (regle.station == station) surPlace = min(surPlace, regle.temps);
+
+        distance[station] = 0;
+        atteintes.assign(1, station);
+        file.push({0, station});
+        while (!file.empty())
+        {
+            const Entree courante = file.top();
+            file.pop();
+            if (courante.first > distance[courante.second]) continue;
+            for (const Regle &regle : p_directes[courante.second])
+            {
+                const uint32_t temps = courante.first + regle.temps;
+                if (regle.station == courante.second) continue;
+                if (regle.station == station) surPlace = min(surPlace, temps); // aller-retour à pieds
+                if (temps >= distance[regle.station]) continue;
+                if (distance[regle.station] == aucun) atteintes.push_back(regle.station);
+                distance[regle.station] = temps;
+                file.push({temps, regle.station});
+            }
+        }
+
+        sort(atteintes.begin(), atteintes.end());
+        for (uint32_t atteinte : atteintes)
+        {
+            if (atteinte != station) m_regles.push_back(Regle{atteinte, distance[atteinte]});
+            else if (surPlace != aucun) m_regles.push_back(Regle{station, surPlace});
+            distance[atteinte] = aucun;
+        }
+        m_debutRegles.push_back((uint32_t) m_regles.size());
+    }
+
+    // règles inversées, entre stations distinctes seulement
+    m_debutReglesVers.assign(nbStations + 1, 0);
+    for (uint32_t de = 0; de < nbStations; ++de)
+        for (uint32_t r = m_debutRegles[de]; r < m_debutRegles[de + 1]; ++r)
+            if (m_regles[r].station != de) m_debutReglesVers[m_regles[r].station + 1]++;
+    for (size_t s = 0; s < nbStations; ++s) m_debutReglesVers[s + 1] += m_debutReglesVers[s];
+    m_reglesVers.resize(m_debutReglesVers.back());
+    vector<uint32_t> position(m_debutReglesVers.begin(), m_debutReglesVers.end() - 1);
+    for (uint32_t de = 0; de < nbStations; ++de)
+        for (uint32_t r = m_debutRegles[de]; r < m_debutRegles[de + 1]; ++r)
+            if (m_regles[r].station != de) m_reglesVers[position[m_regles[r].station]++] = Regle{de, m_regles[r].temps};
+}
+
+//! \brief calcule les transferts utiles de chaque événement de m_horaires selon m_regles (voir la description de la
+//! classe)
+void RoutageParVoyages::calculerTransferts()
+{
+    const TableParcours &horaires = m_horaires;
+    const size_t nbStations = horaires.getNbStations();
+    vector<uint32_t> surPlace(nbStations, aucun);
+    for (uint32_t station = 0; station < nbStations; ++station)
+        for (uint32_t r = m_debutRegles[station]; r < m_debutRegles[station + 1]; ++r)
+            if (m_regles[r].station == station) surPlace[station] = m_regles[r].temps;
+
+    m_debutTransferts.assign(1, 0);
+    m_debutTransferts.reserve(horaires.getNbEvenements() + 1);
+    m_transferts.clear();
+    m_nbTransfertsInitiaux = 0;
+    m_nbDemiTours = 0;
+
+    // heures auxquelles le voyage courant et ses transferts déjà gardés atteignent chaque station: en y descendant
+    // (arriveeMin) et en pouvant y monter dans un autre voyage (changementMin); marque[s] != voyage + 1: non atteinte
+    vector<uint32_t> arriveeMin(nbStations), changementMin(nbStations), marque(nbStations, 0);
+    uint32_t numero = 0;
+    auto ameliorer = [&](uint32_t p_station, uint32_t p_heure) -> bool {
+        bool utile = false;
+        auto abaisser = [&](uint32_t p_s, uint32_t p_arrivee, uint32_t p_changement) {
+            if (marque[p_s] != numero)
+            {
+                marque[p_s] = numero;
+                arriveeMin[p_s] = changementMin[p_s] = aucun;
+            }
+            if (p_arrivee < arriveeMin[p_s])
+            {
+                arriveeMin[p_s] = p_arrivee;
+                utile = true;
+            }
+            if (p_changement < changementMin[p_s])
+            {
+                changementMin[p_s] = p_changement;
+                utile = true;
+            }
+        };
+        abaisser(p_station, p_heure, aucun);
+        for (uint32_t r = m_debutRegles[p_station]; r < m_debutRegles[p_station + 1]; ++r)
+        {
+            const Regle &regle = m_regles[r];
+            const uint32_t heure = p_heure + regle.temps;
+            abaisser(regle.station, regle.station == p_station ? aucun : heure, heure);
+        }
+        return utile;
+    };
+
+    vector<vector<Transfert>> candidats;
+    for (uint32_t voyage = 0; voyage < horaires.getNbVoyages(); ++voyage)
+    {
+        const uint32_t parcours = horaires.getParcoursDuVoyage(voyage);
+        const uint32_t longueur = horaires.getParcours(parcours).longueur;
+        const uint32_t premier = horaires.evenement(voyage, 0);
+        if (candidats.size() < longueur) candidats.resize(longueur);
+
+        // transferts initiaux: le premier voyage de chaque parcours, sauf les demi-tours
+        for (uint32_t rang = 1; rang < longueur; ++rang)
+        {
+            candidats[rang].clear();
+            const uint32_t station = horaires.getStation(parcours, rang);
+            const uint32_t precedente = horaires.getStation(parcours, rang - 1);
+            const uint32_t heure = horaires.getHeure(premier + rang);
+            for (uint32_t r = m_debutRegles[station]; r < m_debutRegles[station + 1]; ++r)
+            {
+                const Regle &regle = m_regles[r];
+                for (const TableParcours::Passage *passage = horaires.debutPassages(regle.station);
+                     passage != horaires.finPassages(regle.station); ++passage)
+                {
+                    if (passage->rang + 1 >= horaires.getParcours(passage->parcours).longueur) continue;
+                    // rester dans le voyage vaut mieux que reprendre son parcours plus loin
+                    if (passage->parcours == parcours && passage->rang >= rang) continue;
+                    const uint32_t autre = horaires.premierVoyage(passage->parcours, passage->rang, heure + regle.temps);
+                    if (autre == aucun || autre == voyage) continue;
+                    ++m_nbTransfertsInitiaux;
+                    // on ne descend pas au premier arrêt: le demi-tour suppose un transfert possible au précédent
+                    if (rang >= 2 && horaires.getStation(passage->parcours, passage->rang + 1) == precedente &&
+                        surPlace[precedente] != aucun &&
+                        horaires.getHeure(premier + rang - 1) + surPlace[precedente] <=
+                        horaires.getHeure(horaires.evenement(autre, passage->rang + 1)))
+                    {
+                        ++m_nbDemiTours;
+                        continue;
+                    }
+                    candidats[rang].push_back(Transfert{autre, passage->rang});
+                }
+            }
+            sort(candidats[rang].begin(), candidats[rang].end(), [&](const Transfert &a, const Transfert &b) {
+                return horaires.getHeure(horaires.evenement(a.voyage, a.rang)) <
+                       horaires.getHeure(horaires.evenement(b.voyage, b.rang));
+            });
+        }
+
+        // réduction: du dernier arrêt au deuxième, un transfert n'est gardé que s'il améliore une station
+        ++numero;
+        for (uint32_t rang = longueur - 1; rang >= 1; --rang)
+        {
+            ameliorer(horaires.getStation(parcours, rang), horaires.getHeure(premier + rang));
+            vector<Transfert> &transferts = candidats[rang];
+            size_t nbGardes = 0;
+            for (const Transfert &transfert : transferts)
+            {
+                const uint32_t autreParcours = horaires.getParcoursDuVoyage(transfert.voyage);
+                const uint32_t autrePremier = horaires.evenement(transfert.voyage, 0);
+                bool utile = false;
+                for (uint32_t k = transfert.rang + 1; k < horaires.getParcours(autreParcours).longueur; ++k)
+                    utile |= ameliorer(horaires.getStation(autreParcours, k), horaires.getHeure(autrePremier + k));
+                if (utile) transferts[nbGardes++] = transfert;
+            }
+            transferts.resize(nbGardes);
+        }
+
+        m_debutTransferts.push_back((uint32_t) m_transferts.size()); // aucun transfert au premier arrêt
+        for (uint32_t rang = 1; rang < longueur; ++rang)
+        {
+            m_transferts.insert(m_transferts.end(), candidats[rang].begin(), candidats[rang].end());
+            m_debutTransferts.push_back((uint32_t) m_transferts.size());
+        }
+    }
+}
+
+//! \brief Calcule l'itinéraire le plus rapide entre deux stations par un parcours en largeur sur les segments de
+//! voyages (voir la description de la classe)
+//! \brief Les étapes sont celles de MotifsDeTransfert::calculerItineraire(). La recherche se poursuit tant qu'un
+//! segment peut arriver plus tôt que le meilleur itinéraire trouvé; à égalité d'heure d'arrivée, l'itinéraire qui a le
+//! moins de trajets est retenu.
+//! \param[in] p_stationOrigine, p_stationDestination: les identifiants des stations
+//! \param[in] p_heureDepart: l'heure de départ de la station d'origine
+//! \param[out] p_itineraire: l'itinéraire trouvé (sans étapes si la destination n'est pas atteignable, ou si c'est
+//! l'origine)
+//! \param[out] p_statistiques: sommetsEmpiles compte les segments mis en file, sommetsSolutionnes les segments
+//! parcourus et arcsRelaches les transferts examinés
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si les transferts n'ont pas été précalculés, ou si l'une des stations est inconnue
+unsigned int RoutageParVoyages::calculerItineraire(unsigned int p_stationOrigine, unsigned int p_stationDestination,
+                                                   const Heure &p_heureDepart, Itineraire &p_itineraire,
+                                                   StatistiquesRecherche &p_statistiques) const
+{
+    if (m_debutTransferts.empty()) throw logic_error("RoutageParVoyages::calculerItineraire(): aucun transfert");
+    try
+    {
+        const TableParcours &horaires = m_horaires;
+        const uint32_t origine = horaires.rangDeStation(p_stationOrigine);
+        const uint32_t destination = horaires.rangDeStation(p_stationDestination);
+        p_itineraire.heureDepart = p_heureDepart;
+        p_itineraire.duree = numeric_limits<unsigned int>::max();
+        p_itineraire.etapes.clear();
+        p_statistiques = StatistiquesRecherche();
+        if (origine == destination) return p_itineraire.duree = 0;
+
+        // temps du dernier transfert vers la destination depuis chaque station
+        vector<uint32_t> versDestination(horaires.getNbStations(), aucun);
+        versDestination[destination] = 0;
+        for (uint32_t r = m_debutReglesVers[destination]; r < m_debutReglesVers[destination + 1]; ++r)
+            versDestination[m_reglesVers[r].station] = m_reglesVers[r].temps;
+
+        const uint32_t depart = (uint32_t) (p_heureDepart - Heure(0, 0, 0));
+        uint32_t meilleure = versDestination[origine] == aucun ? aucun : depart + versDestination[origine];
+        uint32_t meilleurSegment = aucun, meilleurRang = aucun;
+
+        // premierRang[v]: premier arrêt par lequel on est déjà monté dans le voyage v, ou dans un voyage plus hâtif de
+        // son parcours (aucun: sa longueur); ne décroît jamais d'un voyage au suivant d'un même parcours
+        vector<uint32_t> premierRang(horaires.getNbVoyages(), aucun);
+        vector<Segment> segments;
+        auto ajouter = [&](uint32_t p_voyage, uint32_t p_rang, uint32_t p_parent, uint32_t p_rangQuitte) {
+            const TableParcours::Parcours &parcours = horaires.getParcours(horaires.getParcoursDuVoyage(p_voyage));
+            const uint32_t fin = min(premierRang[p_voyage], parcours.longueur - 1);
+            if (p_rang >= fin) return;
+            segments.push_back(Segment{p_voyage, p_rang, fin, p_parent, p_rangQuitte});
+            p_statistiques.sommetsEmpiles++;
+            for (uint32_t v = p_voyage; v < parcours.debutVoyages + parcours.nbVoyages && premierRang[v] > p_rang; ++v)
+                premierRang[v] = p_rang;
+        };
+        auto monter = [&](uint32_t p_station, uint32_t p_heure) {
+            for (const TableParcours::Passage *passage = horaires.debutPassages(p_station);
+                 passage != horaires.finPassages(p_station); ++passage)
+            {
+                const uint32_t voyage = horaires.premierVoyage(passage->parcours, passage->rang, p_heure);
+                if (voyage != aucun && horaires.getHeure(horaires.evenement(voyage, passage->rang)) < meilleure)
+                    ajouter(voyage, passage->rang, aucun, aucun);
+            }
+        };
+        monter(origine, depart);
+        for (uint32_t r = m_debutRegles[origine]; r < m_debutRegles[origine + 1]; ++r)
+            if (m_regles[r].station != origine) monter(m_regles[r].station, depart + m_regles[r].temps);
+
+        // un rang de segments par nombre de transferts
+        for (size_t debutRang = 0; debutRang < segments.size();)
+        {
+            const size_t finRang = segments.size();
+            for (size_t indice = debutRang; indice < finRang; ++indice)
+            {
+                const Segment segment = segments[indice]; // copie: ajouter() peut déplacer le tableau
+                p_statistiques.sommetsSolutionnes++;
+                const uint32_t parcours = horaires.getParcoursDuVoyage(segment.voyage);
+                const uint32_t premier = horaires.evenement(segment.voyage, 0);
+                for (uint32_t rang = segment.debut + 1; rang <= segment.fin; ++rang)
+                {
+                    const uint32_t heure = horaires.getHeure(premier + rang);
+                    if (heure >= meilleure) break;
+                    const uint32_t dernierTransfert = versDestination[horaires.getStation(parcours, rang)];
+                    if (dernierTransfert != aucun && heure + dernierTransfert < meilleure)
+                    {
+                        meilleure = heure + dernierTransfert;
+                        meilleurSegment = (uint32_t) indice;
+                        meilleurRang = rang;
+                    }
+                    for (uint32_t t = m_debutTransferts[premier + rang]; t < m_debutTransferts[premier + rang + 1]; ++t)
+                    {
+                        p_statistiques.arcsRelaches++;
+                        const Transfert &transfert = m_transferts[t];
+                        if (horaires.getHeure(horaires.evenement(transfert.voyage, transfert.rang)) < meilleure)
+                            ajouter(transfert.voyage, transfert.rang, (uint32_t) indice, rang);
+                    }
+                }
+            }
+            debutRang = finRang;
+        }
+        if (meilleure == aucun) return p_itineraire.duree;
+
+        // reconstruction: les segments empruntés, avec le rang où l'on descend de chacun
+        vector<pair<uint32_t, uint32_t>> trajets;
+        for (uint32_t indice = meilleurSegment, rang = meilleurRang; indice != aucun;)
+        {
+            trajets.emplace_back(indice, rang);
+            rang = segments[indice].rangQuitte;
+            indice = segments[indice].parent;
+        }
+        reverse(trajets.begin(), trajets.end());
+
+        p_itineraire.duree = meilleure - depart;
+        vector<Etape> &etapes = p_itineraire.etapes;
+        etapes.emplace_back(Etape::MARCHE, Etape::pointOrigineDestination, p_stationOrigine, p_heureDepart,
+                            p_heureDepart);
+        uint32_t position = origine, heurePosition = depart;
+        for (size_t i = 0; i < trajets.size(); ++i)
+        {
+            const Segment &segment = segments[trajets[i].first];
+            const uint32_t parcours = horaires.getParcoursDuVoyage(segment.voyage);
+            const uint32_t evenementMontee = horaires.evenement(segment.voyage, segment.debut);
+            const uint32_t evenementDescente = horaires.evenement(segment.voyage, trajets[i].second);
+            const uint32_t montee = horaires.getStation(parcours, segment.debut);
+            const uint32_t descente = horaires.getStation(parcours, trajets[i].second);
+            const uint32_t heureMontee = horaires.getHeure(evenementMontee);
+            if (i > 0 || montee != position)
+                etapes.emplace_back(Etape::TRANSFERT, horaires.getIdStation(position), horaires.getIdStation(montee),
+                                    heureDe(heurePosition), heureDe(heureMontee));
+            etapes.emplace_back(Etape::TRAJET, horaires.getIdStation(montee), horaires.getIdStation(descente),
+                                heureDe(heureMontee), heureDe(horaires.getHeure(evenementDescente)));
+            Etape &etape = etapes.back();
+            etape.ligne = horaires.getLigne(segment.voyage);
+            etape.embarquement = horaires.getArret(segment.voyage, segment.debut);
+            etape.debarquement = horaires.getArret(segment.voyage, trajets[i].second);
+            position = descente;
+            heurePosition = horaires.getHeure(evenementDescente);
+        }
+        if (position != destination)
+            etapes.emplace_back(Etape::TRANSFERT, horaires.getIdStation(position), p_stationDestination,
+                                heureDe(heurePosition), heureDe(meilleure));
+        etapes.emplace_back(Etape::MARCHE, p_stationDestination, Etape::pointOrigineDestination, heureDe(meilleure),
+                            heureDe(meilleure));
+        return p_itineraire.duree;
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
+
+//! \brief Prépare le routage par voyages (voir RoutageParVoyages) à partir des horaires de p_gtfs et des règles de
+//! transfert du réseau: les transferts de transfers.txt et les trajets à pieds (m_transfertsDepuisStation), ainsi que
+//! delaisMinArcsAttente à la même station pour les stations qui n'ont pas de transfert dans transfers.txt
+//! \brief La phase "preparerRoutageParVoyages" de l'instrumentation reçoit la durée et le nombre de transferts gardés.
+//! \param[in] p_gtfs: les données GTFS à partir desquelles le réseau a été construit
+//! \throws logic_error si une station de m_transfertsDepuisStation est absente de p_gtfs
+RoutageParVoyages ReseauGTFS::preparerRoutageParVoyages(const DonneesGTFS &p_gtfs) const
+{
+    Instrumentation::MesurePhase mesure(m_instrumentation, "preparerRoutageParVoyages");
+    try
+    {
+        RoutageParVoyages routage;
+        routage.m_horaires = TableParcours(p_gtfs);
+        const TableParcours &horaires = routage.m_horaires;
+
+        vector<vector<RoutageParVoyages::Regle>> directes(horaires.getNbStations());
+        for (uint32_t station = 0; station < horaires.getNbStations(); ++station)
+        {
+            const unsigned int stationId = horaires.getIdStation(station);
+            auto itTransferts = m_transfertsDepuisStation.find(stationId);
+            if (itTransferts != m_transfertsDepuisStation.end())
+                for (const auto &transfert : itTransferts->second)
+                    directes[station].push_back(
+                            RoutageParVoyages::Regle{horaires.rangDeStation(transfert.first), transfert.second});
+            if (p_gtfs.getStationsDeTransfert().count(stationId) == 0)
+                directes[station].push_back(RoutageParVoyages::Regle{station, delaisMinArcsAttente});
+        }
+        routage.fermerRegles(directes);
+        routage.calculerTransferts();
+        mesure.terminer(routage.getNbTransferts());
+        return routage;
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
@@ -0,0 +1,86 @@
+//
+// Routage par voyages: transferts utiles précalculés d'un voyage à l'autre et recherche par segments de voyages.
+//
+
+#ifndef RTC_ROUTAGEPARVOYAGES_H
+#define RTC_ROUTAGEPARVOYAGES_H
+
+#include <cstdint>
+#include <vector>
+
+#include "DonneesGTFS.h"
+#include "graphe.h"
+#include "itineraire.h"
+#include "tableParcours.h"
+
+class ReseauGTFS;
+
+/*!
+ * \class RoutageParVoyages
+ * \brief Un autre modèle du réseau que le graphe espace-temps: les sommets sont les voyages de la table des parcours et
+ * les arcs, les transferts d'un voyage (à l'un de ses arrêts) vers un autre voyage (à l'un des siens). Ils sont
+ * produits une fois pour toutes par ReseauGTFS::preparerRoutageParVoyages(), à partir des mêmes règles de transfert que
+ * le graphe (transfers.txt, trajets à pieds, delaisMinArcsAttente à une station qui n'est pas dans transfers.txt), en
+ * trois étapes:
+ *  - pour chaque arrêt d'un voyage et chaque règle de transfert depuis sa station, le premier voyage de chaque parcours
+ *    qui passe ensuite par la station d'arrivée de la règle;
+ *  - les demi-tours sont écartés: descendre puis remonter vers l'arrêt précédent, alors qu'on pouvait changer de voyage
+ *    à cet arrêt;
+ *  - les transferts dominés sont écartés: en parcourant les arrêts d'un voyage du dernier au deuxième, un transfert
+ *    n'est gardé que s'il atteint une station plus tôt (en y descendant, ou en pouvant y changer de voyage) que le voyage
+ *    lui-même à ses arrêts suivants et que les transferts déjà examinés.
+ * \brief Les règles de transfert entre stations distinctes sont fermées transitivement (une suite de trajets à pieds
+ * devient un seul transfert), comme le suppose la recherche.
+ * \brief Une requête entre deux stations est un parcours en largeur sur les segments de voyages: le rang n contient les
+ * segments accessibles avec n transferts. Pour chaque voyage, on retient le premier arrêt par lequel on y est déjà
+ * monté; un segment ne couvre que les arrêts qui précèdent celui-là, et un voyage plus tardif du même parcours n'est
+ * jamais repris à partir du même arrêt ou plus loin. Aucune file de priorité et aucun sommet par arrêt.
+ */
+class RoutageParVoyages {
+
+public:
+
+    RoutageParVoyages();
+
+    unsigned int calculerItineraire(unsigned int, unsigned int, const Heure &, Itineraire &,
+                                    StatistiquesRecherche &) const;
+
+    size_t getNbVoyages() const { return m_horaires.getNbVoyages(); }
+    size_t getNbReglesDeTransfert() const { return m_regles.size(); }
+    size_t getNbTransfertsInitiaux() const { return m_nbTransfertsInitiaux; }
+    size_t getNbDemiTours() const { return m_nbDemiTours; }
+    size_t getNbTransferts() const { return m_transferts.size(); }
+    size_t getTailleEnOctets() const;
+
+private:
+
+    friend class ReseauGTFS; // ReseauGTFS::preparerRoutageParVoyages() fournit les règles de transfert
+
+    //! \brief transfert vers le voyage voyage, à son arrêt de rang rang
+    struct Transfert {
+        uint32_t voyage;
+        uint32_t rang;
+    };
+
+    //! \brief règle de transfert: après être descendu à une station, on peut monter à la station station au plus tôt
+    //! temps secondes plus tard
+    struct Regle {
+        uint32_t station;
+        uint32_t temps;
+    };
+
+    TableParcours m_horaires;
+    std::vector<uint32_t> m_debutRegles;       // règles depuis la station s: [m_debutRegles[s], m_debutRegles[s+1])
+    std::vector<Regle> m_regles;
+    std::vector<uint32_t> m_debutReglesVers;   // règles vers la station s, depuis une autre station (Regle::station)
+    std::vector<Regle> m_reglesVers;
+    std::vector<uint32_t> m_debutTransferts;   // transferts depuis l'événement e: [m_debutTransferts[e], ...[e+1])
+    std::vector<Transfert> m_transferts;
+    size_t m_nbTransfertsInitiaux;
+    size_t m_nbDemiTours;
+
+    void fermerRegles(const std::vector<std::vector<Regle>> &);
+    void calculerTransferts();
+};
+
+#endif //RTC_ROUTAGEPARVOYAGES_H
@@ -0,0 +1,377 @@
+//
+// Serveur de calcul d'itinéraires.
+// Le réseau est chargé une seule fois; les requêtes arrivent par un socket du domaine Unix, une par ligne:
+//
+//     <id> <latitude_origine> <longitude_origine> <latitude_destination> <longitude_destination> <HH:MM:SS>
+//
+// et chaque réponse est une ligne JSON portant le même <id>. Les requêtes de toutes les connexions sont placées dans
+// une même file; chaque travailleur en retire un lot (tout ce qui est en attente, jusqu'à tailleMaxLot requêtes), le
+// calcule sans modifier le réseau (ReseauGTFS::calculerItineraire()) et écrit les réponses du lot en un seul envoi par
+// connexion. Les réponses d'une même connexion peuvent donc arriver dans un autre ordre que les requêtes.
+//
+// Usage: serveurItineraires [dossier_gtfs] [chemin_socket] [nb_travailleurs] [date_AAAAMMJJ] [capacite_cache]
+// Avec une capacité de cache non nulle, les itinéraires passent par un CacheItineraires partagé par les travailleurs.
+// SIGINT ou SIGTERM arrête le serveur, qui affiche alors ses statistiques.
+//
+
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "cacheItineraires.h"
+#include "DonneesGTFS.h"
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    const size_t tailleMaxLot = 32;
+    const size_t tailleMaxLigne = 4096; // une requête plus longue ferme la connexion
+
+    //! \brief connexion d'un client; le socket est fermé lorsque la dernière requête en attente a reçu sa réponse
+    struct Connexion {
+        explicit Connexion(int p_socket) : socket(p_socket) {}
+        ~Connexion() { close(socket); }
+
+        //! \brief envoie p_texte en entier; les erreurs (client parti) sont ignorées
+        void envoyer(const string &p_texte) {
+            lock_guard<mutex> garde(verrouEcriture);
+            size_t envoye = 0;
+            while (envoye < p_texte.size()) {
+                ssize_t n = send(socket, p_texte.data() + envoye, p_texte.size() - envoye, MSG_NOSIGNAL);
+                if (n <= 0) return;
+                envoye += (size_t) n;
+            }
+        }
+
+        int socket;
+        mutex verrouEcriture;
+    };
+
+    struct Requete {
+        shared_ptr<Connexion> connexion;
+        string id;
+        string ligne; // le texte de la requête, analysé par le travailleur
+        chrono::steady_clock::time_point reception;
+    };
+
+    //! \brief file des requêtes partagée par les lecteurs de connexions et les travailleurs
+    class FileDeRequetes {
+    public:
+        FileDeRequetes() : m_fermee(false) {}
+
+        void ajouter(Requete &&p_requete) {
+            {
+                lock_guard<mutex> garde(m_verrou);
+                m_requetes.push_back(std::move(p_requete));
+            }
+            m_condition.notify_one();
+        }
+
+        //! \brief attend au moins une requête et retire jusqu'à p_tailleMax requêtes; faux si la file est fermée
+        bool retirerLot(vector<Requete> &p_lot, size_t p_tailleMax) {
+            p_lot.clear();
+            unique_lock<mutex> verrou(m_verrou);
+            m_condition.wait(verrou, [this] { return m_fermee || !m_requetes.empty(); });
+            if (m_requetes.empty()) return false;
+            while (!m_requetes.empty() && p_lot.size() < p_tailleMax) {
+                p_lot.push_back(std::move(m_requetes.front()));
+                m_requetes.pop_front();
+            }
+            return true;
+        }
+
+        void fermer() {
+            {
+                lock_guard<mutex> garde(m_verrou);
+                m_fermee = true;
+            }
+            m_condition.notify_all();
+        }
+
+    private:
+        mutex m_verrou;
+        condition_variable m_condition;
+        deque<Requete> m_requetes;
+        bool m_fermee;
+    };
+
+    //! \brief échappe une chaîne pour l'écrire entre guillemets en JSON
+    string echapperJSON(const string &p_texte) {
+        string resultat;
+        for (char c : p_texte) {
+            if (c == '"' || c == '\\') resultat += '\\';
+            if ((unsigned char) c < 0x20) resultat += ' ';
+            else resultat += c;
+        }
+        return resultat;
+    }
+
+    Heure heureDepuisTexte(const string &p_texte) {
+        unsigned int h, m, s;
+        char separateur1, separateur2;
+        istringstream flux(p_texte);
+        if (!(flux >> h >> separateur1 >> m >> separateur2 >> s) || separateur1 != ':' || separateur2 != ':' || m > 59 ||
+            s > 59)
+            throw logic_error("heure invalide (HH:MM:SS attendu)");
+        return Heure(0, 0, 0).add_secondes(h * 3600 + m * 60 + s);
+    }
+
+    const char *const nomsDesTypesEtape[] = {"marche", "trajet", "transfert"}; // indexé par Etape::Type
+
+    //! \brief calcule une requête (à travers p_cache s'il n'est pas nul) et retourne sa réponse JSON (terminée par une
+    //! fin de ligne)
+    string traiter(const Requete &p_requete, const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau,
+                   CacheItineraires *p_cache, Itineraire &p_itineraire) {
+        ostringstream reponse;
+        reponse << "{\"id\": \"" << echapperJSON(p_requete.id) << "\", ";
+        try {
+            istringstream flux(p_requete.ligne);
+            string id, texteHeure;
+            double latitudeOrigine, longitudeOrigine, latitudeDestination, longitudeDestination;
+            if (!(flux >> id >> latitudeOrigine >> longitudeOrigine >> latitudeDestination >> longitudeDestination >>
+                  texteHeure))
+                throw logic_error("requête invalide: <id> <lat> <lon> <lat> <lon> <HH:MM:SS> attendu");
+            const Heure depart = heureDepuisTexte(texteHeure);
+            const Coordonnees origine(latitudeOrigine, longitudeOrigine);
+            const Coordonnees destination(latitudeDestination, longitudeDestination);
+
+            StatistiquesRecherche statistiques;
+            if (p_cache)
+                p_cache->calculerItineraire(p_gtfs, p_reseau, origine, destination, depart, p_itineraire, statistiques);
+            else p_reseau.calculerItineraire(p_gtfs, origine, destination, depart, p_itineraire, statistiques);
+            if (!p_itineraire.estAtteignable()) {
+                reponse << "\"atteignable\": false}\n";
+                return reponse.str();
+            }
+            reponse << "\"atteignable\": true, \"duree\": " << p_itineraire.duree << ", \"arrivee\": \""
+                    << p_itineraire.getHeureArrivee() << "\", \"etapes\": [";
+            for (size_t i = 0; i < p_itineraire.etapes.size(); ++i) {
+                const Etape &etape = p_itineraire.etapes[i];
+                reponse << (i ? ", " : "") << "{\"type\": \"" << nomsDesTypesEtape[etape.type] << "\"";
+                if (etape.stationDepart != Etape::pointOrigineDestination)
+                    reponse << ", \"de\": " << etape.stationDepart;
+                if (etape.stationArrivee != Etape::pointOrigineDestination)
+                    reponse << ", \"a\": " << etape.stationArrivee;
+                reponse << ", \"depart\": \"" << etape.heureDepart << "\", \"arrivee\": \"" << etape.heureArrivee
+                        << "\"";
+                if (etape.type == Etape::TRAJET)
+                    reponse << ", \"ligne\": " << etape.ligne << ", \"voyage\": \""
+                            << echapperJSON(etape.embarquement->getVoyageId()) << "\"";
+                reponse << "}";
+            }
+            reponse << "]}\n";
+        } catch (exception &ex) {
+            reponse << "\"erreur\": \"" << echapperJSON(ex.what()) << "\"}\n";
+        }
+        return reponse.str();
+    }
+
+    //! \brief lit les requêtes d'une connexion jusqu'à sa fermeture et les place dans la file
+    //! \post *p_termine est vrai: le fil qui exécute cette fonction peut être joint sans attente
+    void lireConnexion(shared_ptr<Connexion> p_connexion, FileDeRequetes &p_file, shared_ptr<atomic<bool>> p_termine) {
+        string tampon;
+        char bloc[4096];
+        ssize_t n;
+        while ((n = recv(p_connexion->socket, bloc, sizeof(bloc), 0)) > 0) {
+            tampon.append(bloc, (size_t) n);
+            size_t debut = 0, fin;
+            while ((fin = tampon.find('\n', debut)) != string::npos) {
+                Requete requete;
+                requete.ligne = tampon.substr(debut, fin - debut);
+                debut = fin + 1;
+                if (!requete.ligne.empty() && requete.ligne.back() == '\r') requete.ligne.pop_back();
+                istringstream flux(requete.ligne);
+                if (!(flux >> requete.id)) continue; // ligne vide
+                requete.connexion = p_connexion;
+                requete.reception = chrono::steady_clock::now();
+                p_file.ajouter(std::move(requete));
+            }
+            tampon.erase(0, debut);
+            if (tampon.size() > tailleMaxLigne) break;
+        }
+        shutdown(p_connexion->socket, SHUT_RD);
+        *p_termine = true;
+    }
+
+    //! \brief fil de lecture d'une connexion (voir lireConnexion())
+    struct Lecteur {
+        thread fil;
+        weak_ptr<Connexion> connexion;      // pour interrompre la lecture à l'arrêt du serveur
+        shared_ptr<atomic<bool>> termine;   // vrai lorsque le fil a fini de lire
+    };
+
+    //! \brief joint les fils de lecture dont la connexion est terminée et les retire de p_lecteurs, afin qu'un serveur
+    //! de longue durée ne garde pas un fil par client servi
+    void joindreLecteursTermines(vector<Lecteur> &p_lecteurs) {
+        for (size_t i = 0; i < p_lecteurs.size();) {
+            if (!*p_lecteurs[i].termine) {
+                ++i;
+                continue;
+            }
+            p_lecteurs[i].fil.join();
+            if (i + 1 < p_lecteurs.size()) p_lecteurs[i] = std::move(p_lecteurs.back());
+            p_lecteurs.pop_back();
+        }
+    }
+
+    //! \brief statistiques du serveur, cumulées par les travailleurs
+    struct Statistiques {
+        Statistiques() : nbRequetes(0), nbLots(0), tempsDeReponseUs(0) {}
+        atomic<unsigned long> nbRequetes;
+        atomic<unsigned long> nbLots;
+        atomic<unsigned long long> tempsDeReponseUs; // de la réception à l'envoi de la réponse
+    };
+
+    void travailler(FileDeRequetes &p_file, const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau,
+                    CacheItineraires *p_cache, Statistiques &p_statistiques) {
+        vector<Requete> lot;
+        Itineraire itineraire;
+        vector<pair<Connexion *, string>> reponses; // réponses du lot, regroupées par connexion
+        while (p_file.retirerLot(lot, tailleMaxLot)) {
+            reponses.clear();
+            for (const Requete &requete : lot) {
+                const string reponse = traiter(requete, p_gtfs, p_reseau, p_cache, itineraire);
+                auto it = find_if(reponses.begin(), reponses.end(), [&](const pair<Connexion *, string> &r) {
+                    return r.first == requete.connexion.get();
+                });
+                if (it == reponses.end()) reponses.emplace_back(requete.connexion.get(), reponse);
+                else it->second += reponse;
+            }
+            for (const auto &reponse : reponses) reponse.first->envoyer(reponse.second);
+
+            const auto maintenant = chrono::steady_clock::now();
+            unsigned long long tempsDeReponse = 0;
+            for (const Requete &requete : lot)
+                tempsDeReponse += chrono::duration_cast<chrono::microseconds>(maintenant - requete.reception).count();
+            p_statistiques.tempsDeReponseUs += tempsDeReponse;
+            p_statistiques.nbRequetes += lot.size();
+            ++p_statistiques.nbLots;
+            lot.clear(); // libère les connexions terminées
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const string chemin_dossier = argc > 1 ? argv[1] : "data";
+    const string chemin_socket = argc > 2 ? argv[2] : "/tmp/rtc.sock";
+    const unsigned int nbTravailleurs = argc > 3 ? (unsigned int) stoul(argv[3])
+                                                 : max(1u, thread::hardware_concurrency());
+    const Date date = argc > 4 ? dateDepuisArgument(argv[4], "serveurItineraires") : Date(2020, 9, 25);
+    const size_t capaciteCache = argc > 5 ? stoul(argv[5]) : 0;
+
+    // les signaux d'arrêt sont attendus par un fil dédié (sigwait); tous les autres fils les bloquent
+    sigset_t signauxArret;
+    sigemptyset(&signauxArret);
+    sigaddset(&signauxArret, SIGINT);
+    sigaddset(&signauxArret, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signauxArret, nullptr);
+
+    DonneesGTFS donnees(date, Heure(0, 0, 0), Heure(23, 59, 59));
+    donnees.chargerDossier(chemin_dossier);
+    ReseauGTFS reseau(donnees);
+    cout << "Réseau chargé: " << donnees.getNbArrets() << " arrêts, " << reseau.getNbArcs() << " arcs" << endl;
+    unique_ptr<CacheItineraires> cache;
+    if (capaciteCache > 0) cache.reset(new CacheItineraires(capaciteCache));
+
+    sockaddr_un adresse;
+    memset(&adresse, 0, sizeof(adresse));
+    adresse.sun_family = AF_UNIX;
+    if (chemin_socket.size() >= sizeof(adresse.sun_path)) {
+        cerr << "serveurItineraires: chemin de socket trop long" << endl;
+        return 1;
+    }
+    strcpy(adresse.sun_path, chemin_socket.c_str());
+    const int ecoute = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(chemin_socket.c_str());
+    if (ecoute < 0 || bind(ecoute, (sockaddr *) &adresse, sizeof(adresse)) != 0 || listen(ecoute, 128) != 0) {
+        cerr << "serveurItineraires: impossible d'écouter sur " << chemin_socket << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    atomic<bool> arreter(false);
+    thread attenteSignal([&]() {
+        int signal;
+        sigwait(&signauxArret, &signal);
+        arreter = true;
+        shutdown(ecoute, SHUT_RDWR); // débloque accept()
+    });
+
+    FileDeRequetes file;
+    Statistiques statistiques;
+    vector<thread> travailleurs;
+    for (unsigned int i = 0; i < nbTravailleurs; ++i)
+        travailleurs.emplace_back(travailler, ref(file), cref(donnees), cref(reseau), cache.get(),
+                                  ref(statistiques));
+    cout << "En attente de requêtes sur " << chemin_socket << " (" << nbTravailleurs << " travailleurs)" << endl;
+
+    vector<Lecteur> lecteurs;
+    size_t nbConnexions = 0, maxLecteurs = 0;
+    const auto debut = chrono::steady_clock::now();
+    while (!arreter) {
+        const int client = accept(ecoute, nullptr, nullptr);
+        if (client < 0) {
+            if (arreter || errno != EINTR) break;
+            continue;
+        }
+        joindreLecteursTermines(lecteurs);
+        shared_ptr<Connexion> connexion = make_shared<Connexion>(client);
+        Lecteur lecteur;
+        lecteur.connexion = connexion;
+        lecteur.termine = make_shared<atomic<bool>>(false);
+        lecteur.fil = thread(lireConnexion, connexion, ref(file), lecteur.termine);
+        lecteurs.push_back(std::move(lecteur));
+        ++nbConnexions;
+        maxLecteurs = max(maxLecteurs, lecteurs.size());
+    }
+
+    // arrêt: on cesse de lire les connexions, puis les travailleurs terminent les requêtes déjà reçues
+    for (const auto &lecteur : lecteurs) {
+        shared_ptr<Connexion> active = lecteur.connexion.lock();
+        if (active) shutdown(active->socket, SHUT_RD);
+    }
+    for (auto &lecteur : lecteurs) lecteur.fil.join();
+    file.fermer();
+    for (auto &travailleur : travailleurs) travailleur.join();
+    if (!arreter) pthread_kill(attenteSignal.native_handle(), SIGTERM);
+    attenteSignal.join();
+    close(ecoute);
+    unlink(chemin_socket.c_str());
+
+    const double duree = chrono::duration<double>(chrono::steady_clock::now() - debut).count();
+    const unsigned long nbRequetes = statistiques.nbRequetes;
+    cout << fixed << setprecision(1) << nbRequetes << " requêtes en " << duree << " s, " << statistiques.nbLots
+         << " lots (" << (statistiques.nbLots ? (double) nbRequetes / statistiques.nbLots : 0.0)
+         << " requêtes par lot), temps de réponse moyen "
+         << (nbRequetes ? (double) statistiques.tempsDeReponseUs / nbRequetes : 0.0) << " µs" << endl;
+    cout << nbConnexions << " connexions servies, au plus " << maxLecteurs << " fils de lecture à la fois" << endl;
+    if (cache) {
+        const CacheItineraires::Statistiques statistiquesCache = cache->getStatistiques();
+        const size_t nbConsultations = statistiquesCache.succes + statistiquesCache.echecs + statistiquesCache.horsCache;
+        cout << "Cache: " << statistiquesCache.succes << " succès, " << statistiquesCache.echecs << " échecs, "
+             << statistiquesCache.horsCache << " hors cache (taux de succès "
+             << (nbConsultations ? 100.0 * statistiquesCache.succes / nbConsultations : 0.0) << " %), "
+             << statistiquesCache.evictions << " évictions" << endl;
+    }
+    return 0;
+}
@@ -5,6 +5,7 @@
 //
 
 #include "station.h"
+#include <utility>
 
 /*!
  * \brief Constructeur de la classe Station.
@@ -24,11 +25,14 @@
  * 		.
  * 	.
  * Dans le cadre de ce travail, nous n’utiliserons qu’une partie de ces données ; plus précisément stop_id (m_id), stop_name(m_nom), stop_desc(m_description), stop_lat et stop_long(m_coords)
+ * \param[in] p_arena : l'arène qui fournit les noeuds du conteneur des arrêts (nullptr: allocation ordinaire); elle doit
+ * survivre à la station et à ses copies
  *
  */
-Station::Station(unsigned int p_id, const std::string &p_nom, const std::string &p_description,
-                 const Coordonnees &p_coords) :
-        m_id(p_id), m_nom(p_nom), m_description(p_description), m_coords(p_coords)
+Station::Station(unsigned int p_id, std::string p_nom, std::string p_description, const Coordonnees &p_coords,
+                 ArenaMemoire *p_arena) :
+        m_id(p_id), m_nom(std::move(p_nom)), m_description(std::move(p_description)), m_coords(p_coords),
+        m_arrets(std::less<Heure>(), AllocateurArena<std::pair<const Heure, Arret::Ptr> >(p_arena))
 {
 
 }
@@ -76,8 +80,46 @@ void Station::addArret(const Arret::Ptr &p_arret)
     m_arrets.insert({p_arret->getHeureArrivee(), p_arret});
 }
 
+//! \brief retire un arrêt de la station
+//! \param[in] p_arret: l'arrêt à retirer; il est retrouvé à partir de son heure d'arrivée courante
+//! \throws logic_error si l'arrêt n'est pas présent dans la station
+void Station::retirerArret(const Arret::Ptr &p_arret)
+{
+    auto intervalle = m_arrets.equal_range(p_arret->getHeureArrivee());
+    for (auto itr = intervalle.first; itr != intervalle.second; ++itr)
+    {
+        if (itr->second == p_arret)
+        {
+            m_arrets.erase(itr);
+            return;
+        }
+    }
+    throw std::logic_error("Station::retirerArret(): cet arrêt n'est pas présent dans la station");
+}
+
+//! \brief retire de la station tous les arrêts dont l'heure de départ précède p_heure
+//! \param[in] p_heure: l'heure à partir de laquelle les arrêts sont conservés
+//! \param[out] p_arretsRetires: les arrêts retirés y sont ajoutés
+//! \note puisque l'heure d'arrivée d'un arrêt précède son heure de départ, seuls les arrêts arrivés avant p_heure sont
+//! examinés
+void Station::retirerArretsPartisAvant(const Heure &p_heure, std::vector<Arret::Ptr> &p_arretsRetires)
+{
+    auto itr = m_arrets.begin();
+    while (itr != m_arrets.end() && itr->first < p_heure)
+    {
+        if (itr->second->getHeureDepart() < p_heure)
+        {
+            p_arretsRetires.push_back(itr->second);
+            itr = m_arrets.erase(itr);
+        } else
+        {
+            ++itr;
+        }
+    }
+}
+
 //! \brief retourne le conteneur m_arrets par référence constante
-const std::multimap<Heure, Arret::Ptr> &Station::getArrets() const
+const Station::Arrets &Station::getArrets() const
 {
     return m_arrets;
 }
@@ -12,6 +12,7 @@
 #include <map>
 #include <unordered_set>
 #include <iostream>
+#include "arena.h"
 #include "coordonnees.h"
 #include "arret.h"
 #include "auxiliaires.h"
@@ -25,7 +26,9 @@ class Station {
 
 
 public:
-    Station(unsigned int p_id, const std::string & p_nom, const std::string & p_description,const Coordonnees & p_coords);
+    typedef std::multimap<Heure, Arret::Ptr, std::less<Heure>, AllocateurArena<std::pair<const Heure, Arret::Ptr> > > Arrets; //les noeuds viennent de l'arène de la station, s'il y en a une
+    Station(unsigned int p_id, std::string p_nom, std::string p_description, const Coordonnees & p_coords,
+            ArenaMemoire * p_arena = nullptr);
     Station();
     friend std::ostream& operator<<(std::ostream& flux, const Station& p_station);
 	const Coordonnees& getCoords() const;
@@ -33,15 +36,17 @@ public:
 	const std::string& getNom() const;
 	unsigned int getId() const;
     void addArret(const Arret::Ptr & p_arret);
+    void retirerArret(const Arret::Ptr & p_arret);
+    void retirerArretsPartisAvant(const Heure & p_heure, std::vector<Arret::Ptr> & p_arretsRetires);
     unsigned int getNbArrets() const;
-    const std::multimap<Heure, Arret::Ptr> & getArrets() const;
+    const Arrets & getArrets() const;
 
 private:
     unsigned int m_id;
     std::string m_nom;
     std::string m_description;
     Coordonnees m_coords;
-    std::multimap<Heure, Arret::Ptr> m_arrets;
+    Arrets m_arrets;
 
 };
 
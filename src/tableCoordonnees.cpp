@@ -0,0 +1,121 @@
+//
+// Coordonnées d'un ensemble de points rangées pour évaluer en lot leur distance à un même point.
+//
+
+#include "tableCoordonnees.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const double TableCoordonnees::rayonTerre = 6371;
+
+namespace {
+    const double radParDegre = 3.14159265358979323846 / 180.0;
+
+    // taille des lots de indicesAMoinsDe(): le tampon des cosinus reste sur la pile et dans le cache L1
+    const size_t tailleLot = 256;
+
+    // marge du filtre de indicesAMoinsDe() sur le cosinus: les deux façons de le calculer diffèrent de quelques ulp
+    // (~1e-15); 1e-12 les couvre largement et n'admet à la vérification que des points à quelques centimètres du rayon
+    const double margeCosinus = 1e-12;
+
+    struct VecteurUnitaire {
+        double x, y, z;
+    };
+
+    VecteurUnitaire vecteurUnitaire(const Coordonnees &p_point) {
+        const double latitude = p_point.getLatitude() * radParDegre;
+        const double longitude = p_point.getLongitude() * radParDegre;
+        return VecteurUnitaire{cos(latitude) * cos(longitude), cos(latitude) * sin(longitude), sin(latitude)};
+    }
+
+    // noyau vectorisable: aucun appel, aucune branche, des tableaux contigus qui ne se chevauchent pas
+    void produitsScalaires(const VecteurUnitaire &p_point, const double *__restrict p_x, const double *__restrict p_y,
+                           const double *__restrict p_z, size_t p_nb, double *__restrict p_sortie) {
+        for (size_t i = 0; i < p_nb; ++i)
+            p_sortie[i] = p_point.x * p_x[i] + p_point.y * p_y[i] + p_point.z * p_z[i];
+    }
+}
+
+void TableCoordonnees::reserver(size_t p_nbPoints)
+{
+    for (vector<double> *tableau : {&m_x, &m_y, &m_z, &m_latitude, &m_longitude, &m_cosLatitude})
+        tableau->reserve(p_nbPoints);
+    m_coordonnees.reserve(p_nbPoints);
+}
+
+//! \brief ajoute un point à la fin de la table; son indice est getTaille() avant l'ajout
+void TableCoordonnees::ajouter(const Coordonnees &p_point)
+{
+    const VecteurUnitaire vecteur = vecteurUnitaire(p_point);
+    m_x.push_back(vecteur.x);
+    m_y.push_back(vecteur.y);
+    m_z.push_back(vecteur.z);
+    m_latitude.push_back(p_point.getLatitude() * radParDegre);
+    m_longitude.push_back(p_point.getLongitude() * radParDegre);
+    m_cosLatitude.push_back(cos(m_latitude.back()));
+    m_coordonnees.push_back(p_point);
+}
+
+//! \brief calcule le cosinus de l'angle au centre entre p_point et chacun des points de la table
+//! \param[out] p_cosinus: un tableau de getTaille() éléments; p_cosinus[i] est le cosinus pour le point d'indice i
+void TableCoordonnees::cosinusAngles(const Coordonnees &p_point, double *p_cosinus) const
+{
+    produitsScalaires(vecteurUnitaire(p_point), m_x.data(), m_y.data(), m_z.data(), m_x.size(), p_cosinus);
+}
+
+//! \brief calcule la distance, en km, entre p_point et chacun des points de la table selon l'approximation
+//! équirectangulaire: rayonTerre * sqrt(dlat² + (cos(latitude moyenne) * dlon)²), où le cosinus de la latitude moyenne
+//! est pris comme la moyenne des cosinus des deux latitudes, précalculés
+//! \brief Borne d'erreur par rapport à Coordonnees::operator-(), mesurée par benchDistances sur 500 000 paires tirées
+//! à au plus 10 km l'une de l'autre, sous 70° de latitude: au plus 7,5 mm (0,35 mm en moyenne). L'erreur croît comme le
+//! cube de la distance: elle convient à l'échelle d'une ville, pas d'un continent. À ces distances, l'arc cosinus de
+//! Coordonnees::operator-() s'écarte lui-même de la référence (haversine en précision étendue) de quelques dixièmes de
+//! millimètre, et de jusqu'à 0,1 m pour des points presque confondus, où son cosinus est voisin de 1. Les longitudes ne
+//! sont pas ramenées autour de l'antiméridien.
+//! \param[out] p_distances: un tableau de getTaille() éléments; p_distances[i] est la distance au point d'indice i
+void TableCoordonnees::distancesEquirectangulaires(const Coordonnees &p_point, double *p_distances) const
+{
+    const double latitude = p_point.getLatitude() * radParDegre;
+    const double longitude = p_point.getLongitude() * radParDegre;
+    const double cosLatitude = cos(latitude);
+    const double *__restrict lat = m_latitude.data();
+    const double *__restrict lon = m_longitude.data();
+    const double *__restrict cosLat = m_cosLatitude.data();
+    const size_t nb = m_latitude.size();
+    for (size_t i = 0; i < nb; ++i)
+    {
+        const double dLatitude = lat[i] - latitude;
+        const double dLongitude = 0.5 * (cosLat[i] + cosLatitude) * (lon[i] - longitude);
+        p_distances[i] = rayonTerre * sqrt(dLatitude * dLatitude + dLongitude * dLongitude);
+    }
+}
+
+//! \brief retourne, en ordre croissant, les indices des points de la table pour lesquels
+//! p_point - getCoordonnees(indice) <= p_rayon, soit le même résultat qu'une boucle sur Coordonnees::operator-()
+//! \brief Seule exception: pour des points confondus ou presque, l'argument de l'arc cosinus de
+//! Coordonnees::operator-() peut dépasser 1 d'un arrondi, et sa distance est NaN, qu'aucune comparaison ne retient.
+//! Ces points sont ici à la distance 0: ceux dont le cosinus en lot atteint 1, et ceux dont operator-() donne NaN.
+//! \param[out] p_indices: remplacé par les indices trouvés
+void TableCoordonnees::indicesAMoinsDe(const Coordonnees &p_point, double p_rayon, vector<size_t> &p_indices) const
+{
+    p_indices.clear();
+    if (p_rayon < 0) return;
+    const VecteurUnitaire point = vecteurUnitaire(p_point);
+    const double seuil = cos(min(p_rayon / rayonTerre, 3.14159265358979323846)) - margeCosinus;
+    double cosinus[tailleLot];
+    for (size_t debut = 0; debut < m_x.size(); debut += tailleLot)
+    {
+        const size_t nb = min(tailleLot, m_x.size() - debut);
+        produitsScalaires(point, m_x.data() + debut, m_y.data() + debut, m_z.data() + debut, nb, cosinus);
+        for (size_t i = 0; i < nb; ++i)
+        {
+            if (cosinus[i] < seuil) continue;
+            double distance = cosinus[i] >= 1 ? 0 : p_point - m_coordonnees[debut + i];
+            if (distance != distance) distance = 0; // acos() d'un arrondi au-delà de 1: points confondus
+            if (distance <= p_rayon) p_indices.push_back(debut + i);
+        }
+    }
+}
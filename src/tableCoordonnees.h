@@ -0,0 +1,58 @@
+//
+// Coordonnées d'un ensemble de points (les stations) rangées pour évaluer en lot leur distance à un même point.
+//
+
+#ifndef RTC_TABLECOORDONNEES_H
+#define RTC_TABLECOORDONNEES_H
+
+#include <cstddef>
+#include <vector>
+
+#include "coordonnees.h"
+
+/*!
+ * \class TableCoordonnees
+ * \brief Conserve, pour chaque point ajouté, son vecteur unitaire (x, y, z) sur la sphère ainsi que sa latitude, sa
+ * longitude et le cosinus de sa latitude en radians, chaque grandeur dans un tableau distinct. Les conversions et les
+ * fonctions trigonométriques sont ainsi faites une fois pour toutes à l'ajout, et les noyaux qui comparent un point à
+ * toute la table sont de simples boucles sur des tableaux contigus, que le compilateur vectorise.
+ * \brief Trois évaluations sont offertes:
+ *  - cosinusAngles(): le cosinus de l'angle au centre, produit scalaire des vecteurs unitaires. C'est la quantité dont
+ *    Coordonnees::operator-() prend l'arc cosinus; une distance d est atteinte lorsque le cosinus vaut
+ *    cos(d / rayonTerre).
+ *  - distancesEquirectangulaires(): l'approximation plane de la distance, sans arc cosinus ni racine de différence
+ *    de cosinus voisins de 1. Voir sa description pour la borne d'erreur.
+ *  - indicesAMoinsDe(): les points à au plus un rayon donné, selon Coordonnees::operator-(): le cosinus filtre la
+ *    table, avec une marge qui couvre les arrondis des deux calculs, et seuls les points retenus sont évalués par
+ *    Coordonnees::operator-(). Un point confondu avec p_point, dont operator-() donne NaN (arc cosinus d'un arrondi
+ *    au-delà de 1), est à la distance 0 et toujours retenu.
+ */
+class TableCoordonnees {
+
+public:
+
+    static const double rayonTerre; // en km, celui de Coordonnees::operator-()
+
+    void reserver(size_t p_nbPoints);
+    void ajouter(const Coordonnees &p_point);
+
+    size_t getTaille() const { return m_coordonnees.size(); }
+    const Coordonnees &getCoordonnees(size_t p_indice) const { return m_coordonnees[p_indice]; }
+
+    void cosinusAngles(const Coordonnees &p_point, double *p_cosinus) const;
+    void distancesEquirectangulaires(const Coordonnees &p_point, double *p_distances) const;
+    void indicesAMoinsDe(const Coordonnees &p_point, double p_rayon, std::vector<size_t> &p_indices) const;
+
+private:
+
+    // vecteurs unitaires: x vers (0°, 0°), y vers (0°, 90° E), z vers le pôle nord
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+    std::vector<double> m_latitude;    // en radians
+    std::vector<double> m_longitude;   // en radians
+    std::vector<double> m_cosLatitude;
+    std::vector<Coordonnees> m_coordonnees; // les points tels qu'ajoutés, pour la vérification exacte
+};
+
+#endif //RTC_TABLECOORDONNEES_H
@@ -0,0 +1,133 @@
+//
+// Horaires des voyages rangés par parcours.
+//
+
+#include "tableParcours.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+const uint32_t TableParcours::aucun = numeric_limits<uint32_t>::max();
+
+TableParcours::TableParcours()
+{
+}
+
+//! \brief range les horaires des voyages de p_gtfs par parcours (voir la description de la classe)
+//! \throws logic_error si un arrêt appartient à une station absente de p_gtfs
+TableParcours::TableParcours(const DonneesGTFS &p_gtfs)
+{
+    try
+    {
+        for (const auto &station : p_gtfs.getStations()) m_idStations.push_back(station.first);
+
+        map<vector<uint32_t>, vector<const Voyage *>> voyagesParSuite;
+        for (const auto &voyage : p_gtfs.getVoyages())
+        {
+            const Voyage::Arrets &arrets = voyage.second.getArrets();
+            if (arrets.size() < 2) continue;
+            vector<uint32_t> suite;
+            suite.reserve(arrets.size());
+            for (const Arret::Ptr &arret : arrets) suite.push_back(rangDeStation(arret->getStationId()));
+            voyagesParSuite[std::move(suite)].push_back(&voyage.second);
+        }
+
+        vector<vector<uint32_t>> heures;
+        vector<vector<size_t>> groupes;
+        for (const auto &suite : voyagesParSuite)
+        {
+            const vector<const Voyage *> &voyages = suite.second;
+            const size_t longueur = suite.first.size();
+            heures.assign(voyages.size(), vector<uint32_t>());
+            vector<size_t> ordre(voyages.size());
+            for (size_t v = 0; v < voyages.size(); ++v)
+            {
+                ordre[v] = v;
+                for (const Arret::Ptr &arret : voyages[v]->getArrets())
+                    heures[v].push_back((uint32_t) (arret->getHeureArrivee() - Heure(0, 0, 0)));
+            }
+            sort(ordre.begin(), ordre.end(), [&](size_t a, size_t b) { return heures[a] < heures[b]; });
+
+            groupes.clear();
+            for (size_t v : ordre)
+            {
+                size_t g = 0;
+                for (; g < groupes.size(); ++g)
+                {
+                    const vector<uint32_t> &precedent = heures[groupes[g].back()];
+                    size_t rang = 0;
+                    while (rang < longueur && precedent[rang] <= heures[v][rang]) ++rang;
+                    if (rang == longueur) break;
+                }
+                if (g == groupes.size()) groupes.emplace_back();
+                groupes[g].push_back(v);
+            }
+
+            for (const vector<size_t> &groupe : groupes)
+            {
+                m_parcours.push_back(Parcours{(uint32_t) m_stationsDesParcours.size(), (uint32_t) longueur,
+                                              (uint32_t) m_heures.size(), (uint32_t) m_lignes.size(),
+                                              (uint32_t) groupe.size()});
+                m_stationsDesParcours.insert(m_stationsDesParcours.end(), suite.first.begin(), suite.first.end());
+                for (size_t v : groupe)
+                {
+                    m_heures.insert(m_heures.end(), heures[v].begin(), heures[v].end());
+                    m_voyages.push_back(voyages[v]);
+                    m_lignes.push_back(voyages[v]->getLigne());
+                    m_parcoursDuVoyage.push_back((uint32_t) m_parcours.size() - 1);
+                }
+            }
+        }
+
+        // passages par station, par parcours puis rang croissants
+        m_debutPassages.assign(m_idStations.size() + 1, 0);
+        for (uint32_t station : m_stationsDesParcours) m_debutPassages[station + 1]++;
+        for (size_t s = 0; s < m_idStations.size(); ++s) m_debutPassages[s + 1] += m_debutPassages[s];
+        m_passages.resize(m_stationsDesParcours.size());
+        vector<uint32_t> position(m_debutPassages.begin(), m_debutPassages.end() - 1);
+        for (uint32_t p = 0; p < m_parcours.size(); ++p)
+            for (uint32_t rang = 0; rang < m_parcours[p].longueur; ++rang)
+                m_passages[position[m_stationsDesParcours[m_parcours[p].debutStations + rang]]++] = Passage{p, rang};
+    } catch (exception &ex)
+    {
+        throw logic_error(ex.what());
+    }
+}
+
+//! \brief retourne le rang de la station p_stationId dans getStations()
+//! \throws logic_error si la station est inconnue
+uint32_t TableParcours::rangDeStation(unsigned int p_stationId) const
+{
+    auto it = lower_bound(m_idStations.begin(), m_idStations.end(), p_stationId);
+    if (it == m_idStations.end() || *it != p_stationId)
+        throw logic_error("TableParcours: station " + to_string(p_stationId) + " inconnue");
+    return (uint32_t) (it - m_idStations.begin());
+}
+
+//! \brief retourne l'arrêt de rang p_rang du voyage p_voyage
+//! \pre les voyages des données GTFS à partir desquelles la table a été construite n'ont pas changé
+const Arret::Ptr &TableParcours::getArret(uint32_t p_voyage, uint32_t p_rang) const
+{
+    // les arrêts d'un voyage sont dans un ensemble ordonné: on le parcourt depuis le bout le plus proche
+    const Voyage::Arrets &arrets = m_voyages[p_voyage]->getArrets();
+    if (p_rang < arrets.size() / 2) return *next(arrets.begin(), p_rang);
+    return *prev(arrets.end(), arrets.size() - p_rang);
+}
+
+//! \brief retourne le premier voyage du parcours p_parcours qui arrive à son arrêt de rang p_rang au plus tôt à
+//! l'heure p_heure (en secondes depuis 00:00:00), ou aucun s'il n'y en a pas
+uint32_t TableParcours::premierVoyage(uint32_t p_parcours, uint32_t p_rang, uint32_t p_heure) const
+{
+    const Parcours &parcours = m_parcours[p_parcours];
+    const uint32_t *colonne = m_heures.data() + parcours.debutHoraires + p_rang;
+    uint32_t bas = 0, haut = parcours.nbVoyages;
+    while (bas < haut)
+    {
+        const uint32_t milieu = bas + (haut - bas) / 2;
+        if (colonne[(size_t) milieu * parcours.longueur] < p_heure) bas = milieu + 1;
+        else haut = milieu;
+    }
+    return bas == parcours.nbVoyages ? aucun : parcours.debutVoyages + bas;
+}
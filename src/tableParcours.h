@@ -0,0 +1,90 @@
+//
+// Horaires des voyages rangés par parcours: les voyages qui desservent la même suite de stations sans se dépasser.
+//
+
+#ifndef RTC_TABLEPARCOURS_H
+#define RTC_TABLEPARCOURS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "DonneesGTFS.h"
+
+/*!
+ * \class TableParcours
+ * \brief Les voyages de p_gtfs qui desservent la même suite de stations sont triés par heure d'arrivée à la première
+ * station, puis répartis en parcours: un voyage rejoint le premier parcours dont le dernier voyage ne le dépasse à
+ * aucune station. Les heures d'une station d'un parcours sont donc croissantes d'un voyage au suivant, et le premier
+ * voyage qui arrive à une station après une heure donnée s'y trouve par recherche dichotomique (premierVoyage()).
+ * \brief Les horaires d'un parcours forment une matrice de nbVoyages lignes et de longueur colonnes, rangée ligne par
+ * ligne dans un tableau commun à tous les parcours. Une case de ce tableau est un événement: l'arrivée d'un voyage à
+ * l'un de ses arrêts. Les voyages sont numérotés de façon contiguë, parcours après parcours, et les stations par leur
+ * rang dans getStations(). Les voyages de moins de deux arrêts sont ignorés.
+ * \brief Un événement ne garde que son heure: l'arrêt correspondant se retrouve, au besoin, à partir du voyage
+ * (getArret()). La table suppose donc que les voyages de p_gtfs ne changent pas tant qu'elle sert.
+ */
+class TableParcours {
+
+public:
+
+    static const uint32_t aucun; // voyage ou heure absent
+
+    struct Parcours {
+        uint32_t debutStations; // dans m_stationsDesParcours, longueur stations
+        uint32_t longueur;
+        uint32_t debutHoraires; // premier événement du premier voyage
+        uint32_t debutVoyages;  // numéro du premier voyage
+        uint32_t nbVoyages;
+    };
+
+    //! \brief un passage d'un parcours par une station
+    struct Passage {
+        uint32_t parcours;
+        uint32_t rang;
+    };
+
+    TableParcours();
+    explicit TableParcours(const DonneesGTFS &);
+
+    uint32_t rangDeStation(unsigned int) const;
+    unsigned int getIdStation(uint32_t p_rang) const { return m_idStations[p_rang]; }
+    size_t getNbStations() const { return m_idStations.size(); }
+
+    size_t getNbParcours() const { return m_parcours.size(); }
+    const Parcours &getParcours(uint32_t p_parcours) const { return m_parcours[p_parcours]; }
+    uint32_t getStation(uint32_t p_parcours, uint32_t p_rang) const {
+        return m_stationsDesParcours[m_parcours[p_parcours].debutStations + p_rang];
+    }
+
+    size_t getNbVoyages() const { return m_lignes.size(); }
+    uint32_t getParcoursDuVoyage(uint32_t p_voyage) const { return m_parcoursDuVoyage[p_voyage]; }
+    unsigned int getLigne(uint32_t p_voyage) const { return m_lignes[p_voyage]; }
+
+    size_t getNbEvenements() const { return m_heures.size(); }
+    //! \brief l'événement du voyage p_voyage à son arrêt de rang p_rang
+    uint32_t evenement(uint32_t p_voyage, uint32_t p_rang) const {
+        const Parcours &parcours = m_parcours[m_parcoursDuVoyage[p_voyage]];
+        return parcours.debutHoraires + (p_voyage - parcours.debutVoyages) * parcours.longueur + p_rang;
+    }
+    uint32_t getHeure(uint32_t p_evenement) const { return m_heures[p_evenement]; }
+    const Arret::Ptr &getArret(uint32_t, uint32_t) const;
+
+    const Passage *debutPassages(uint32_t p_station) const { return m_passages.data() + m_debutPassages[p_station]; }
+    const Passage *finPassages(uint32_t p_station) const { return m_passages.data() + m_debutPassages[p_station + 1]; }
+
+    uint32_t premierVoyage(uint32_t, uint32_t, uint32_t) const;
+
+private:
+
+    std::vector<unsigned int> m_idStations;    // m_idStations[i] est l'identifiant de la station de rang i
+    std::vector<Parcours> m_parcours;
+    std::vector<uint32_t> m_stationsDesParcours;
+    std::vector<uint32_t> m_heures;            // heure d'arrivée de chaque événement, en secondes depuis 00:00:00
+    std::vector<const Voyage *> m_voyages;     // voyage de p_gtfs de chaque numéro de voyage
+    std::vector<unsigned int> m_lignes;        // numéro de ligne (route_id) de chaque voyage
+    std::vector<uint32_t> m_parcoursDuVoyage;
+    std::vector<uint32_t> m_debutPassages;     // les passages par la station s: [m_debutPassages[s], ...[s+1])
+    std::vector<Passage> m_passages;
+};
+
+#endif //RTC_TABLEPARCOURS_H
@@ -0,0 +1,50 @@
+//
+// Export de la trace d'une recherche d'itinéraire.
+//
+
+#include <iomanip>
+
+#include "traceRecherche.h"
+
+using namespace std;
+
+//! \brief écrit une trace en CSV, une ligne par sommet solutionné (avec une ligne d'en-tête)
+//! \param[in] p_flux: le flux de sortie
+//! \param[in] p_trace: la trace à écrire
+void ecrireTraceCSV(ostream &p_flux, const TraceRecherche &p_trace)
+{
+    const ios::fmtflags format = p_flux.flags();
+    const streamsize precision = p_flux.precision();
+    p_flux << "ordre,cle,sommet,station,ligne,heure_arrivee,latitude,longitude\n" << fixed << setprecision(6);
+    for (const PointDeTrace &point : p_trace.points)
+    {
+        p_flux << point.ordre << ',' << point.cle << ',' << point.sommet << ',' << point.station << ','
+               << point.ligne << ',' << point.heureArrivee << ',' << point.latitude << ',' << point.longitude << '\n';
+    }
+    p_flux.flags(format);
+    p_flux.precision(precision);
+}
+
+//! \brief écrit une trace en GeoJSON: une FeatureCollection dont chaque Feature est le point d'un sommet solutionné,
+//! avec son ordre, sa clé, sa station, sa ligne et l'heure d'arrivée de son arrêt comme propriétés
+//! \param[in] p_flux: le flux de sortie
+//! \param[in] p_trace: la trace à écrire
+void ecrireTraceGeoJSON(ostream &p_flux, const TraceRecherche &p_trace)
+{
+    const ios::fmtflags format = p_flux.flags();
+    const streamsize precision = p_flux.precision();
+    p_flux << "{\"type\": \"FeatureCollection\", \"properties\": {\"heure_depart\": \"" << p_trace.heureDepart
+           << "\"}, \"features\": [" << fixed << setprecision(6);
+    for (size_t i = 0; i < p_trace.points.size(); ++i)
+    {
+        const PointDeTrace &point = p_trace.points[i];
+        // GeoJSON place la longitude avant la latitude
+        p_flux << (i ? ",\n" : "\n") << "{\"type\": \"Feature\", \"geometry\": {\"type\": \"Point\", \"coordinates\": ["
+               << point.longitude << ", " << point.latitude << "]}, \"properties\": {\"ordre\": " << point.ordre
+               << ", \"cle\": " << point.cle << ", \"sommet\": " << point.sommet << ", \"station\": " << point.station
+               << ", \"ligne\": " << point.ligne << ", \"heure_arrivee\": \"" << point.heureArrivee << "\"}}";
+    }
+    p_flux << "\n]}\n";
+    p_flux.flags(format);
+    p_flux.precision(precision);
+}
@@ -0,0 +1,43 @@
+//
+// Trace d'une recherche d'itinéraire: les sommets solutionnés, situés par la station et l'heure de leur arrêt, et leur
+// export en CSV ou en GeoJSON afin de tracer le front de recherche d'une requête.
+//
+
+#ifndef RTC_TRACERECHERCHE_H
+#define RTC_TRACERECHERCHE_H
+
+#include <iostream>
+#include <vector>
+
+#include "auxiliaires.h"
+
+/*!
+ * \struct PointDeTrace
+ * \brief Un sommet solutionné par la recherche, dans l'ordre où il est sorti de la file de priorité
+ */
+struct PointDeTrace {
+    size_t ordre;          // rang du sommet parmi les sommets solutionnés (0 pour le premier)
+    unsigned int cle;      // clé de la file de priorité: secondes écoulées depuis le départ, plus la borne du reste
+    size_t sommet;         // le sommet du graphe
+    unsigned int station;  // la station de l'arrêt du sommet
+    unsigned int ligne;    // la ligne (route_id) du voyage de l'arrêt
+    Heure heureArrivee;    // l'heure d'arrivée de l'arrêt
+    double latitude;       // les coordonnées de la station
+    double longitude;
+};
+
+/*!
+ * \struct TraceRecherche
+ * \brief Les sommets solutionnés par une recherche tracée (voir ReseauGTFS::calculerItineraire()). Une recherche qui
+ * inonde un pôle d'échanges, s'égare loin de la destination ou s'étale sur de nombreux arcs d'attente se reconnaît à
+ * la répartition de ses points dans l'espace et dans le temps.
+ */
+struct TraceRecherche {
+    Heure heureDepart;                // l'heure de départ de la requête
+    std::vector<PointDeTrace> points; // dans l'ordre où les sommets ont été solutionnés
+};
+
+void ecrireTraceCSV(std::ostream &, const TraceRecherche &);
+void ecrireTraceGeoJSON(std::ostream &, const TraceRecherche &);
+
+#endif //RTC_TRACERECHERCHE_H
@@ -0,0 +1,104 @@
+//
+// Trace d'une requête entre deux stations (ReseauGTFS::calculerItineraire() avec TraceRecherche), pour visualiser son
+// espace de recherche. Les sommets solutionnés sont écrits sur la sortie standard en CSV ou en GeoJSON, avec leur ordre,
+// leur clé, la station, la ligne et l'heure d'arrivée de leur arrêt; un résumé de la requête est écrit sur la sortie
+// d'erreur. Une station absente de stops.txt, ou sans arrêt dans la fenêtre chargée, est signalée par son rôle
+// (origine ou destination) avant la construction du réseau.
+//
+// Usage: tracerRecherche dossier_gtfs station_origine station_destination HH:MM:SS [csv|geojson] [date_AAAAMMJJ]
+//                        [rayon_trajets_a_pied_km]
+//
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+#include "outilsMesure.h"
+#include "ReseauGTFS.h"
+
+using namespace std;
+
+namespace {
+
+    const unsigned int finDeLaFenetre = 23 * 3600 + 59 * 60 + 59;
+
+    Heure heureDepuisArgument(const string &p_texte) {
+        unsigned int heures, minutes, secondes;
+        char separateur1, separateur2;
+        istringstream flux(p_texte);
+        if (!(flux >> heures >> separateur1 >> minutes >> separateur2 >> secondes) || separateur1 != ':' ||
+            separateur2 != ':' || minutes > 59 || secondes > 59)
+            throw logic_error("tracerRecherche: l'heure doit être au format HH:MM:SS");
+        return Heure(heures, minutes, secondes);
+    }
+
+    //! \brief vérifie que la station p_station fait partie des données chargées pour la fenêtre de la requête
+    //! \param[in] p_role: "origine" ou "destination", pour le message d'erreur
+    //! \throws logic_error qui nomme la station manquante et dit si elle est absente de stops.txt ou seulement sans
+    //! arrêt dans la fenêtre
+    void verifierStation(const DonneesGTFS &p_donnees, const string &p_dossier, unsigned int p_station,
+                         const string &p_role) {
+        if (p_donnees.getStations().count(p_station)) return;
+        DonneesGTFS toutesLesStations(p_donnees.getDate(), p_donnees.getTempsDebut(), p_donnees.getTempsFin());
+        toutesLesStations.ajouterStations(p_dossier + "/stops.txt");
+        ostringstream message;
+        message << "tracerRecherche: station " << p_role << " " << p_station;
+        if (toutesLesStations.getStations().count(p_station) == 0)
+            message << " absente de " << p_dossier << "/stops.txt";
+        else
+            message << " sans arrêt le " << p_donnees.getDate() << " entre " << p_donnees.getTempsDebut() << " et "
+                    << p_donnees.getTempsFin();
+        throw logic_error(message.str());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 5)
+    {
+        cerr << "Usage: tracerRecherche dossier_gtfs station_origine station_destination HH:MM:SS [csv|geojson] "
+                "[date_AAAAMMJJ] [rayon_trajets_a_pied_km]" << endl;
+        return 1;
+    }
+    try
+    {
+        const std::string chemin_dossier = argv[1];
+        const unsigned int stationOrigine = (unsigned int) stoul(argv[2]);
+        const unsigned int stationDestination = (unsigned int) stoul(argv[3]);
+        const Heure depart = heureDepuisArgument(argv[4]);
+        const string format = argc > 5 ? argv[5] : "csv";
+        const Date date = argc > 6 ? dateDepuisArgument(argv[6], "tracerRecherche") : Date(2020, 9, 25);
+        const double rayonTrajetsAPied = argc > 7 ? stod(argv[7]) : 0.0;
+        if (format != "csv" && format != "geojson")
+            throw logic_error("tracerRecherche: le format doit être csv ou geojson");
+
+        DonneesGTFS donnees(date, depart, Heure(0, 0, 0).add_secondes(finDeLaFenetre));
+        donnees.chargerDossier(chemin_dossier);
+        verifierStation(donnees, chemin_dossier, stationOrigine, "origine");
+        verifierStation(donnees, chemin_dossier, stationDestination, "destination");
+        if (rayonTrajetsAPied > 0) donnees.calculerTrajetsAPied(rayonTrajetsAPied);
+        ReseauGTFS reseau(donnees);
+
+        Itineraire itineraire;
+        StatistiquesRecherche statistiques;
+        TraceRecherche trace;
+        const unsigned int duree = reseau.calculerItineraire(
+                donnees, donnees.getStations().at(stationOrigine).getCoords(),
+                donnees.getStations().at(stationDestination).getCoords(), depart, itineraire, statistiques, trace);
+
+        if (format == "csv") ecrireTraceCSV(cout, trace);
+        else ecrireTraceGeoJSON(cout, trace);
+
+        cerr << "stations " << stationOrigine << " -> " << stationDestination << " à " << depart << ": ";
+        if (itineraire.estAtteignable()) cerr << duree << " s, arrivée à " << itineraire.getHeureArrivee();
+        else cerr << "destination inatteignable";
+        cerr << ", " << statistiques.sommetsSolutionnes << " sommets solutionnés, " << statistiques.arcsRelaches
+             << " arcs relâchés, " << statistiques.etiquettesElaguees << " étiquettes élaguées" << endl;
+    }
+    catch (exception &ex)
+    {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    return 0;
+}
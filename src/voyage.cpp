@@ -5,6 +5,7 @@
 //
 
 #include "voyage.h"
+#include <utility>
 
 /*!
  * \brief Constructeur de la classes Voyage
@@ -12,10 +13,14 @@
  * \param[in] p_ligne_id : identificateur de la ligne desservie par le voyage
  * \param[in] p_service_id: identificateur du service auquel ce voyage appartient
  * \param[in] p_destination: destination du voyage
+ * \param[in] p_arena: l'arène qui fournit les noeuds de l'ensemble des arrêts (nullptr: allocation ordinaire); elle
+ * doit survivre au voyage et à ses copies
  */
-Voyage::Voyage(const std::string &p_id, unsigned int p_ligne_id, const std::string &p_service_id,
-               const std::string &p_destination) :
-        m_id(p_id), m_ligne(p_ligne_id), m_service_id(p_service_id), m_destination(p_destination)
+Voyage::Voyage(std::string p_id, unsigned int p_ligne_id, std::string p_service_id, std::string p_destination,
+               ArenaMemoire *p_arena) :
+        m_id(std::move(p_id)), m_ligne(p_ligne_id), m_service_id(std::move(p_service_id)),
+        m_destination(std::move(p_destination)),
+        m_arrets(compArret(), AllocateurArena<Arret::Ptr>(p_arena))
 {
 }
 
@@ -24,7 +29,7 @@ Voyage::Voyage()
 }
 
 //! \brief retourne le conteneur m_arrets par référence constante
-const std::set<Arret::Ptr, Voyage::compArret> &Voyage::getArrets() const
+const Voyage::Arrets &Voyage::getArrets() const
 {
     return m_arrets;
 }
@@ -78,6 +83,14 @@ void Voyage::ajouterArret(const Arret::Ptr &p_arret)
     m_arrets.insert(p_arret);
 }
 
+//! \brief retire un arrêt du voyage (l'arrêt est retrouvé par son numéro de séquence)
+//! \throws logic_error si l'arrêt n'est pas présent dans le voyage
+void Voyage::retirerArret(const Arret::Ptr &p_arret)
+{
+    if (m_arrets.erase(p_arret) == 0)
+        throw std::logic_error("Voyage::retirerArret(): cet arrêt n'est pas présent dans le voyage");
+}
+
 
 /*!
  * \brief Inégalité inférieure entre deux voyages.
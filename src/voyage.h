@@ -10,6 +10,7 @@
 #include <string>
 #include <set>
 #include <memory>
+#include "arena.h"
 #include "arret.h"
 #include "auxiliaires.h"
 
@@ -26,10 +27,12 @@ public:
     {
         bool operator() (Arret::Ptr i, Arret::Ptr j) const;
     };
+    typedef std::set<Arret::Ptr, compArret, AllocateurArena<Arret::Ptr> > Arrets; //les noeuds viennent de l'arène du voyage, s'il en a une
 
-    Voyage(const std::string & p_id, unsigned int p_ligne_id, const std::string & p_service_id, const std::string & p_destination);
+    Voyage(std::string p_id, unsigned int p_ligne_id, std::string p_service_id, std::string p_destination,
+           ArenaMemoire * p_arena = nullptr);
     Voyage();
-	const std::set<Arret::Ptr, compArret> & getArrets() const;
+	const Arrets & getArrets() const;
     unsigned int getNbArrets() const;
 	const std::string& getDestination() const;
 	std::string getId() const;
@@ -38,6 +41,7 @@ public:
 	Heure getHeureDepart() const;
 	Heure getHeureFin() const;
     void ajouterArret(const Arret::Ptr & p_arret);
+    void retirerArret(const Arret::Ptr & p_arret);
 	bool operator< (const Voyage & p_other) const;
 	bool operator> (const Voyage & p_other) const;
 	friend std::ostream & operator<<(std::ostream & flux, const Voyage & p_voyage);
@@ -48,7 +52,7 @@ private:
 	unsigned int m_ligne;
 	std::string m_service_id;
 	std::string m_destination;
-	std::set<Arret::Ptr, compArret> m_arrets;
+	Arrets m_arrets;
 
 };
 